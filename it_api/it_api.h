@@ -2615,6 +2615,21 @@ extern "C" {
                  OUT it_event_t     *events,
                  OUT size_t         *events_count );
 
+  // Arm a one-shot notification on an aggregate EVD: the next event
+  // (or an event that's already pending) writes an 8 byte count to fd
+  // (usually an eventfd). Lets the caller sleep on fd together with
+  // other file descriptors instead of spinning on itx_aevd_wait().
+  it_status_t
+  itx_aevd_notify( IN  it_evd_handle_t evd_handle,
+                   IN  int             fd );
+
+  // Number of threads that receive incoming data (sockets provider).
+  // Connections are distributed across the threads, all traffic of one
+  // connection is handled by the same thread. Has to be called before
+  // it_ia_create(). Providers without receiver threads ignore it.
+  it_status_t
+  itx_set_receiver_threads( IN  int             count );
+
 
   it_status_t
   itx_init_tracing( const char* aContextName, 
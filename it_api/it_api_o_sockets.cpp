@@ -610,9 +610,19 @@ iWARPEM_Object_EndPoint_t* gSockFdToEndPointMap[ SOCK_FD_TO_END_POINT_MAP_COUNT
 // ia_handles are really void*s -- easy to hand out counting numbers
 static int ape_ia_handle_next = 0;
 
+/*
+ * Incoming data is read by a pool of receiver threads, each with its own
+ * epoll set. A connection is assigned to the receiver with the fewest
+ * connections when it's added and stays there, so all messages (and the
+ * completions they generate) of one endpoint are processed in order by
+ * a single thread.
+ */
+#define IT_API_SOCKETS_MAX_RECEIVERS ( 64 )
+
 struct DataReceiverThreadArgs
 {
   int                drc_cli_socket;
+  int                mReceiverIndex;
 
 #ifdef IT_API_OVER_UNIX_DOMAIN_SOCKETS
   struct sockaddr_un drc_cli_addr;
@@ -621,7 +631,16 @@ struct DataReceiverThreadArgs
 #endif
 };
 
-DataReceiverThreadArgs gDataReceiverThreadArgs;
+DataReceiverThreadArgs gDataReceiverThreadArgs[ IT_API_SOCKETS_MAX_RECEIVERS ];
+
+int gDataReceiverCount = 1;
+
+// receiver of each socket and number of sockets per receiver
+// (protected by gDataReceiverControlSockMutex)
+int gSockFdToReceiverMap[ SOCK_FD_TO_END_POINT_MAP_COUNT ];
+int gDataReceiverSocketCount[ IT_API_SOCKETS_MAX_RECEIVERS ];
+
+void iwarpem_release_socket_receiver( int aSockFd );
 
 typedef enum
   {
@@ -910,6 +929,9 @@ iwarpem_generate_conn_termination_event( int aSocketId )
       // gSendWRLocalEndPointList.Remove( LocalEndPoint );
     }
 
+  // before close(): the fd number might get reused right away
+  iwarpem_release_socket_receiver( aSocketId );
+
   BegLogLine( FXLOG_IT_API_O_SOCKETS )
     << "Before close() "
     << " aSocketId: " << aSocketId
@@ -1690,14 +1712,15 @@ BegLogLine(FXLOG_IT_API_O_SOCKETS)
 void*
 iWARPEM_DataReceiverThread( void* args )
 {
+  DataReceiverThreadArgs* DataReceiverThreadArgsPtr = (DataReceiverThreadArgs *) args;
+
   BegLogLine( FXLOG_IT_API_O_SOCKETS )
     << "iWARPEM_DataReceiverThread(): Started!"
+    << " receiver: " << DataReceiverThreadArgsPtr->mReceiverIndex
     << EndLogLine;
 
   pthread_mutex_unlock( & gReceiveThreadStartedMutex );
 
-  DataReceiverThreadArgs* DataReceiverThreadArgsPtr = (DataReceiverThreadArgs *) args;
-
   /**********************************************
    * Connect to the listen thread
    **********************************************/
@@ -2726,7 +2749,53 @@ iWARPEM_DataSenderThread( void* args )
 }
 
 pthread_mutex_t         gDataReceiverControlSockMutex;
-int gDataReceiverControlSockFd = -1;
+int gDataReceiverControlSockFd[ IT_API_SOCKETS_MAX_RECEIVERS ];
+
+it_status_t
+itx_set_receiver_threads( IN  int count )
+{
+  pthread_mutex_lock( & gITAPI_INITMutex );
+
+  if( gITAPI_Initialized )
+    {
+      pthread_mutex_unlock( & gITAPI_INITMutex );
+
+      BegLogLine( 1 )
+        << "itx_set_receiver_threads(): ERROR:: called after it_ia_create()"
+        << " count: " << count
+        << EndLogLine;
+
+      return IT_ERR_INVALID_IA;
+    }
+
+  if( count < 1 )
+    count = 1;
+  if( count > IT_API_SOCKETS_MAX_RECEIVERS )
+    count = IT_API_SOCKETS_MAX_RECEIVERS;
+
+  gDataReceiverCount = count;
+
+  pthread_mutex_unlock( & gITAPI_INITMutex );
+
+  return IT_SUCCESS;
+}
+
+static
+void
+iwarpem_send_socket_control( int aReceiver,
+                             iWARPEM_SocketControl_Type_t aOpType,
+                             int aSockFd )
+{
+  iWARPEM_SocketControl_Hdr_t Hdr;
+  Hdr.mOpType = aOpType;
+  Hdr.mSockFd = aSockFd;
+
+  int wlen;
+  write_to_socket( gDataReceiverControlSockFd[ aReceiver ],
+		   (char *) & Hdr,
+		   sizeof( iWARPEM_SocketControl_Hdr_t ),
+		   & wlen );
+}
 
 void
 iwarpem_add_socket_to_list( int aSockFd,
@@ -2752,15 +2821,22 @@ iwarpem_add_socket_to_list( int aSockFd,
 
   gSockFdToEndPointMap[ aSockFd ] = aEP;
 
-  iWARPEM_SocketControl_Hdr_t Hdr;
-  Hdr.mOpType = IWARPEM_SOCKETCONTROL_TYPE_ADD;
-  Hdr.mSockFd = aSockFd;
+  // least loaded receiver
+  int Receiver = 0;
+  for( int r = 1; r < gDataReceiverCount; r++ )
+    if( gDataReceiverSocketCount[ r ] < gDataReceiverSocketCount[ Receiver ] )
+      Receiver = r;
 
-  int wlen;
-  write_to_socket( gDataReceiverControlSockFd,
-		   (char *) & Hdr,
-		   sizeof( iWARPEM_SocketControl_Hdr_t ),
-		   & wlen );
+  gSockFdToReceiverMap[ aSockFd ] = Receiver;
+  gDataReceiverSocketCount[ Receiver ]++;
+
+  BegLogLine(FXLOG_IT_API_O_SOCKETS_CONNECT)
+    << "aSockFd=" << aSockFd
+    << " receiver=" << Receiver
+    << " sockets=" << gDataReceiverSocketCount[ Receiver ]
+    << EndLogLine ;
+
+  iwarpem_send_socket_control( Receiver, IWARPEM_SOCKETCONTROL_TYPE_ADD, aSockFd );
 
   pthread_mutex_unlock( & gDataReceiverControlSockMutex );
 }
@@ -2785,16 +2861,30 @@ iwarpem_remove_socket_to_list( int aSockFd )
     << " aSockFd: " << aSockFd
     << EndLogLine;
 
-  iWARPEM_SocketControl_Hdr_t Hdr;
+  int Receiver = gSockFdToReceiverMap[ aSockFd ];
+  if( Receiver >= 0 )
+    {
+      gSockFdToReceiverMap[ aSockFd ] = -1;
+      gDataReceiverSocketCount[ Receiver ]--;
 
-  Hdr.mOpType = IWARPEM_SOCKETCONTROL_TYPE_REMOVE;
-  Hdr.mSockFd = aSockFd;
+      iwarpem_send_socket_control( Receiver, IWARPEM_SOCKETCONTROL_TYPE_REMOVE, aSockFd );
+    }
 
-  int wlen;
-  write_to_socket( gDataReceiverControlSockFd,
-		   (char *) & Hdr,
-		   sizeof( iWARPEM_SocketControl_Hdr_t ),
-		   &wlen );
+  pthread_mutex_unlock( & gDataReceiverControlSockMutex );
+}
+
+// the receiver already dropped the socket from its epoll set
+void
+iwarpem_release_socket_receiver( int aSockFd )
+{
+  pthread_mutex_lock( & gDataReceiverControlSockMutex );
+
+  int Receiver = gSockFdToReceiverMap[ aSockFd ];
+  if( Receiver >= 0 )
+    {
+      gSockFdToReceiverMap[ aSockFd ] = -1;
+      gDataReceiverSocketCount[ Receiver ]--;
+    }
 
   pthread_mutex_unlock( & gDataReceiverControlSockMutex );
 }
@@ -2989,21 +3079,6 @@ it_status_t it_ia_create (
   int drc_cli_addr_len       = sizeof( drc_cli_addr.sun_family ) + strlen( drc_cli_addr.sun_path );
 #endif
 
-  if((drc_cli_socket = socket(IT_API_SOCKET_FAMILY, SOCK_STREAM, 0)) < 0)
-    {
-    perror("Data Receiver Control socket() open");
-    StrongAssertLogLine( 0 ) << EndLogLine;
-    }
-
-  True = 1;
-  setsockopt( drc_cli_socket, SOL_TCP, TCP_NODELAY, (char*)&True, sizeof(True));
-
-  StrongAssertLogLine( drc_cli_socket >= 0 )
-    << "it_ia_create(): ERROR: "
-    << " Failed to create Data Receiver Control socket "
-    << " Errno " << errno
-    << EndLogLine;
-
   /*************************************************/
 
 
@@ -3019,103 +3094,136 @@ it_status_t it_ia_create (
     << "Listening"
     << EndLogLine ;
 
+  for( int fd = 0; fd < SOCK_FD_TO_END_POINT_MAP_COUNT; fd++ )
+    gSockFdToReceiverMap[ fd ] = -1;
+
+  pthread_mutex_init( & gDataReceiverControlSockMutex, NULL );
+
   /***********************************************
-   * Start the data receive thread
+   * Start the data receive threads, each one
+   * gets its own control socket
    ***********************************************/
-  pthread_t DataReceiverTID;
+  int rc = 0;
+  for( int r = 0; r < gDataReceiverCount; r++ )
+  {
+    if((drc_cli_socket = socket(IT_API_SOCKET_FAMILY, SOCK_STREAM, 0)) < 0)
+      {
+        perror("Data Receiver Control socket() open");
+        StrongAssertLogLine( 0 ) << EndLogLine;
+      }
 
-  gDataReceiverThreadArgs.drc_cli_socket = drc_cli_socket;
-  memcpy( & gDataReceiverThreadArgs.drc_cli_addr,
-	  & drc_cli_addr,
-	   drc_cli_addr_len );
+    True = 1;
+    setsockopt( drc_cli_socket, SOL_TCP, TCP_NODELAY, (char*)&True, sizeof(True));
 
-  BegLogLine(FXLOG_IT_API_O_SOCKETS)
-    << "iWARPEM_DataReceiverThread:: Before connect()"
-    << " drc_client_socket: " << drc_cli_socket
-    << EndLogLine;
+    StrongAssertLogLine( drc_cli_socket >= 0 )
+      << "it_ia_create(): ERROR: "
+      << " Failed to create Data Receiver Control socket "
+      << " Errno " << errno
+      << EndLogLine;
 
-  while( 1 )
-    {
-      int conn_rc = connect( drc_cli_socket,
-           (struct sockaddr *) & (gDataReceiverThreadArgs.drc_cli_addr),
-           sizeof( gDataReceiverThreadArgs.drc_cli_addr ) );
-      int err=errno ;
-      BegLogLine(FXLOG_IT_API_O_SOCKETS)
-        << "conn_rc=" << conn_rc
-        << " errno=" << errno
-        << EndLogLine ;
+    pthread_t DataReceiverTID;
 
-      if( conn_rc == 0 )
-  break;
-      else if( conn_rc < 0 )
-  {
-    if( errno != EAGAIN )
+    gDataReceiverThreadArgs[ r ].drc_cli_socket = drc_cli_socket;
+    gDataReceiverThreadArgs[ r ].mReceiverIndex = r;
+    memcpy( & gDataReceiverThreadArgs[ r ].drc_cli_addr,
+            & drc_cli_addr,
+            drc_cli_addr_len );
+    gDataReceiverSocketCount[ r ] = 0;
+
+    BegLogLine(FXLOG_IT_API_O_SOCKETS)
+      << "iWARPEM_DataReceiverThread:: Before connect()"
+      << " drc_client_socket: " << drc_cli_socket
+      << " receiver: " << r
+      << EndLogLine;
+
+    while( 1 )
       {
-        perror( "connect failed" );
-        StrongAssertLogLine( 0 )
-    << "iWARPEM_DataReceiverThread:: Error after connect(): "
-    << " errno: " << err
-    << " conn_rc: " << conn_rc
-    << EndLogLine;
+        int conn_rc = connect( drc_cli_socket,
+                               (struct sockaddr *) & (gDataReceiverThreadArgs[ r ].drc_cli_addr),
+                               sizeof( gDataReceiverThreadArgs[ r ].drc_cli_addr ) );
+        int err=errno ;
+        BegLogLine(FXLOG_IT_API_O_SOCKETS)
+          << "conn_rc=" << conn_rc
+          << " errno=" << errno
+          << EndLogLine ;
+
+        if( conn_rc == 0 )
+          break;
+        else if( conn_rc < 0 )
+          {
+            if( errno != EAGAIN )
+              {
+                perror( "connect failed" );
+                StrongAssertLogLine( 0 )
+                  << "iWARPEM_DataReceiverThread:: Error after connect(): "
+                  << " errno: " << err
+                  << " conn_rc: " << conn_rc
+                  << EndLogLine;
+              }
+          }
       }
-  }
-    }
-  pthread_mutex_lock( & gReceiveThreadStartedMutex );
+    pthread_mutex_lock( & gReceiveThreadStartedMutex );
 
-  int rc = pthread_create( & DataReceiverTID,
-                           NULL,
-                           iWARPEM_DataReceiverThread,
-                           (void *) & gDataReceiverThreadArgs );
+    rc = pthread_create( & DataReceiverTID,
+                         NULL,
+                         iWARPEM_DataReceiverThread,
+                         (void *) & gDataReceiverThreadArgs[ r ] );
 
-  pthread_mutex_lock( & gReceiveThreadStartedMutex );
-  pthread_mutex_unlock( & gReceiveThreadStartedMutex );
+    pthread_mutex_lock( & gReceiveThreadStartedMutex );
+    pthread_mutex_unlock( & gReceiveThreadStartedMutex );
 
-  StrongAssertLogLine( rc == 0 )
-    << "it_ia_create(): ERROR: "
-    << " Failed to create a receiver thread "
-    << " Errno " << errno
-    << EndLogLine;
-  /***********************************************/
+    StrongAssertLogLine( rc == 0 )
+      << "it_ia_create(): ERROR: "
+      << " Failed to create a receiver thread "
+      << " receiver: " << r
+      << " Errno " << errno
+      << EndLogLine;
+    /***********************************************/
 
 
 
 
-  /***********************************************
-   * Accept connection from the DataReceiverThread
-   ***********************************************/
+    /***********************************************
+     * Accept connection from the DataReceiverThread
+     ***********************************************/
 #ifdef IT_API_OVER_UNIX_DOMAIN_SOCKETS
-  struct sockaddr_un   drc_serv_addr_tmp;
+    struct sockaddr_un   drc_serv_addr_tmp;
 #else
-  struct sockaddr_in   drc_serv_addr_tmp;
+    struct sockaddr_in   drc_serv_addr_tmp;
 #endif
 
-//  sleep(1) ;
-  socklen_t drc_serv_addr_tmp_len = sizeof( drc_serv_addr_tmp );
-  BegLogLine(FXLOG_IT_API_O_SOCKETS)
-    << "Before accept()"
-    << EndLogLine ;
+    socklen_t drc_serv_addr_tmp_len = sizeof( drc_serv_addr_tmp );
+    BegLogLine(FXLOG_IT_API_O_SOCKETS)
+      << "Before accept()"
+      << EndLogLine ;
 
-  int new_drc_serv_sock = accept( drc_serv_socket,
-				  (struct sockaddr *) & drc_serv_addr_tmp,
-                                  & drc_serv_addr_tmp_len );
+    int new_drc_serv_sock = accept( drc_serv_socket,
+                                    (struct sockaddr *) & drc_serv_addr_tmp,
+                                    & drc_serv_addr_tmp_len );
 
-  StrongAssertLogLine( new_drc_serv_sock > 0 )
-    << "it_ia_create(): after accept(): "
-    << " errno: " << errno
-    << " drc_serv_socket: " << drc_serv_socket
-    << EndLogLine;
+    StrongAssertLogLine( new_drc_serv_sock > 0 )
+      << "it_ia_create(): after accept(): "
+      << " errno: " << errno
+      << " drc_serv_socket: " << drc_serv_socket
+      << EndLogLine;
 #if defined(SPINNING_RECEIVE)
-  socket_nonblock_on(new_drc_serv_sock) ;
+    socket_nonblock_on(new_drc_serv_sock) ;
 #endif
 
-  BegLogLine(FXLOG_IT_API_O_SOCKETS)
-    << "it_ia_create(): after accept(): "
-    << " new_drc_serv_sock: " << new_drc_serv_sock
-    << " drc_serv_socket: " << drc_serv_socket
+    BegLogLine(FXLOG_IT_API_O_SOCKETS)
+      << "it_ia_create(): after accept(): "
+      << " new_drc_serv_sock: " << new_drc_serv_sock
+      << " drc_serv_socket: " << drc_serv_socket
+      << " receiver: " << r
+      << EndLogLine;
+
+    gDataReceiverControlSockFd[ r ] = new_drc_serv_sock;
+  }
+
+  BegLogLine( FXLOG_IT_API_O_SOCKETS )
+    << "it_ia_create(): started " << gDataReceiverCount << " receiver thread(s)"
     << EndLogLine;
 
-  gDataReceiverControlSockFd = new_drc_serv_sock;
-  pthread_mutex_init( & gDataReceiverControlSockMutex, NULL );
   close( drc_serv_socket );
   /***********************************************/
 
@@ -5190,9 +5298,24 @@ static void it_api_o_sockets_signal_accept(void)
     pthread_mutex_lock( &gAEVD->mEventCounterMutex );
     (gAEVD->mEventCounter)++;
     pthread_cond_signal( &gAEVD->mMainCond );
+    gAEVD->Notify();
     pthread_mutex_unlock( &gAEVD->mEventCounterMutex );
   }
 it_status_t
+itx_aevd_notify( IN  it_evd_handle_t evd_handle,
+                 IN  int             fd )
+{
+  it_api_o_sockets_aevd_mgr_t* AEVD = (it_api_o_sockets_aevd_mgr_t *) evd_handle;
+
+  pthread_mutex_lock( & ( AEVD->mEventCounterMutex ) );
+  AEVD->mNotifyFd = fd;
+  if( AEVD->mEventCounter > 0 )
+    AEVD->Notify();
+  pthread_mutex_unlock( & ( AEVD->mEventCounterMutex ) );
+
+  return IT_SUCCESS;
+}
+it_status_t
 itx_aevd_wait( IN  it_evd_handle_t evd_handle,
 	       IN  uint64_t        timeout,
 	       IN  size_t          max_event_count,
@@ -5892,10 +5892,25 @@ static void it_api_o_sockets_signal_aevd(void)
     pthread_mutex_lock( &gAEVD->mEventCounterMutex );
     (gAEVD->mEventCounter)++;
     pthread_cond_signal( &gAEVD->mMainCond );
+    gAEVD->Notify();
     pthread_mutex_unlock( &gAEVD->mEventCounterMutex );
 
   }
 it_status_t
+itx_aevd_notify( IN  it_evd_handle_t evd_handle,
+                 IN  int             fd )
+{
+  it_api_o_sockets_aevd_mgr_t* AEVD = (it_api_o_sockets_aevd_mgr_t *) evd_handle;
+
+  pthread_mutex_lock( & ( AEVD->mEventCounterMutex ) );
+  AEVD->mNotifyFd = fd;
+  if( AEVD->mEventCounter > 0 )
+    AEVD->Notify();
+  pthread_mutex_unlock( & ( AEVD->mEventCounterMutex ) );
+
+  return IT_SUCCESS;
+}
+it_status_t
 itx_aevd_wait( IN  it_evd_handle_t evd_handle,
 	       IN  uint64_t        timeout,
 	       IN  size_t          max_event_count,
@@ -6505,6 +6520,13 @@ it_status_t itx_ep_connect_with_rmr (
 }
 
 
+// the routed provider keeps a single receiver thread
+it_status_t
+itx_set_receiver_threads( IN  int count )
+{
+  return IT_SUCCESS;
+}
+
 it_status_t
 itx_init_tracing( const char* aContextName,
 		  int   aTraceRank )
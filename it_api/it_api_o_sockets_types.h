@@ -15,6 +15,7 @@
 #define __IT_API_O_SOCKETS_TYPES_H__
 
 #include <pthread.h>
+#include <unistd.h>
 
 #define IT_API_O_SOCKETS_LISTEN_BACKLOG    2048
 #define IT_API_O_SOCKETS_MAX_SGE_LIST_SIZE 64
@@ -105,9 +106,24 @@ struct it_api_o_sockets_aevd_mgr_t
   pthread_cond_t      mMainCond;
   pthread_mutex_t     mEventCounterMutex;
   volatile int        mEventCounter;
+  volatile int        mNotifyFd;     // armed by itx_aevd_notify(), -1 if not armed
 
   iWARPEM_Object_EventQueue_t *mCMMEVQObj ;
 
+  // fire the one-shot notification armed by itx_aevd_notify()
+  // the caller has to hold mEventCounterMutex
+  void
+  Notify()
+  {
+    if( mNotifyFd >= 0 )
+      {
+        uint64_t one = 1;
+        ssize_t rc = write( mNotifyFd, & one, sizeof( one ) );
+        (void) rc;
+        mNotifyFd = -1;
+      }
+  }
+
   void
   Init( it_api_o_sockets_device_mgr_t*  aDevice )
   {
@@ -119,6 +135,7 @@ struct it_api_o_sockets_aevd_mgr_t
     pthread_cond_init( & mMainCond, NULL );
     pthread_mutex_init( & mEventCounterMutex, NULL );
     mEventCounter = 0;
+    mNotifyFd = -1;
 
     mDevice = aDevice;
 
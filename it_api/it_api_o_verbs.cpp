@@ -1476,6 +1476,7 @@ it_status_t it_evd_create (
       CQ->mCMThreadArgs.mMainCond          = & CQ->mMainCond;
       CQ->mCMThreadArgs.mEventCounterMutex = & CQ->mEventCounterMutex;
       CQ->mCMThreadArgs.mEventCounter      = & CQ->mEventCounter;
+      CQ->mCMThreadArgs.mNotifyFd          = & CQ->mNotifyFd;
       CQ->mCMThreadArgs.mCmChannel         = CQ->mDevice->cm_channel;
 
       int rc = pthread_create( & CQ->mCMQueueTID,
@@ -1502,6 +1503,7 @@ it_status_t it_evd_create (
           CQ->mAffThreadArgs[ i ].mMainCond          = & CQ->mMainCond;
           CQ->mAffThreadArgs[ i ].mEventCounterMutex = & CQ->mEventCounterMutex;
           CQ->mAffThreadArgs[ i ].mEventCounter      = & CQ->mEventCounter;
+          CQ->mAffThreadArgs[ i ].mNotifyFd          = & CQ->mNotifyFd;
 
           rc = pthread_create( & CQ->mAffQueuesTIDs[ i ],
                                NULL,
@@ -1518,6 +1520,7 @@ it_status_t it_evd_create (
           CQ->mSendThreadArgs[ i ].mMainCond          = & CQ->mMainCond;
           CQ->mSendThreadArgs[ i ].mEventCounterMutex = & CQ->mEventCounterMutex;
           CQ->mSendThreadArgs[ i ].mEventCounter      = & CQ->mEventCounter;
+          CQ->mSendThreadArgs[ i ].mNotifyFd          = & CQ->mNotifyFd;
 
           rc = pthread_create( & CQ->mSendQueuesTIDs[ i ],
                                NULL,
@@ -1534,6 +1537,7 @@ it_status_t it_evd_create (
           CQ->mRecvThreadArgs[ i ].mMainCond          = & CQ->mMainCond;
           CQ->mRecvThreadArgs[ i ].mEventCounterMutex = & CQ->mEventCounterMutex;
           CQ->mRecvThreadArgs[ i ].mEventCounter      = & CQ->mEventCounter;
+          CQ->mRecvThreadArgs[ i ].mNotifyFd          = & CQ->mNotifyFd;
 
           rc = pthread_create( & CQ->mRecvQueuesTIDs[ i ],
                                NULL,
@@ -3428,6 +3432,25 @@ itx_bind_ep_to_device( IN  it_ep_handle_t          ep_handle,
   return IT_SUCCESS;
 }
 
+/***
+ * evd_handle has to be an aevd
+ * fires right away if there are events pending already
+ ***/
+it_status_t
+itx_aevd_notify( IN  it_evd_handle_t evd_handle,
+                 IN  int             fd )
+{
+  it_api_o_verbs_aevd_mgr_t* AEVD = (it_api_o_verbs_aevd_mgr_t *) evd_handle;
+
+  pthread_mutex_lock( & ( AEVD->mEventCounterMutex ) );
+  AEVD->mNotifyFd = fd;
+  if( AEVD->mEventCounter > 0 )
+    it_api_o_verbs_aevd_notify( & AEVD->mNotifyFd );
+  pthread_mutex_unlock( & ( AEVD->mEventCounterMutex ) );
+
+  return IT_SUCCESS;
+}
+
 /***
  * evd_handle has to be an aevd
  ***/
@@ -3655,6 +3678,13 @@ itx_aevd_wait( IN  it_evd_handle_t evd_handle,
 }
 /**************************************************************************************/
 
+// completions are polled by the cq processing threads, no receiver threads
+it_status_t
+itx_set_receiver_threads( IN  int count )
+{
+  return IT_SUCCESS;
+}
+
 it_status_t
 itx_init_tracing( const char* aContextName,
                   int   aTraceRank )
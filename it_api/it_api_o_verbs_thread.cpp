@@ -36,6 +36,7 @@ void* it_api_o_verbs_aff_processing_thread( void* aArgs )
   pthread_cond_t*     MainCond          = Args->mMainCond;
   pthread_mutex_t*    EventCounterMutex = Args->mEventCounterMutex;
   volatile int*       EventCounter      = Args->mEventCounter;
+  volatile int*       NotifyFd          = Args->mNotifyFd;
 
   while( 1 )
     {
@@ -76,6 +77,7 @@ void* it_api_o_verbs_aff_processing_thread( void* aArgs )
       pthread_mutex_lock( EventCounterMutex );
       (*EventCounter)++;
       pthread_cond_signal( MainCond );
+      it_api_o_verbs_aevd_notify( NotifyFd );
       pthread_mutex_unlock( EventCounterMutex );
     }
 }
@@ -92,6 +94,7 @@ void* it_api_o_verbs_cm_processing_thread( void* aArgs )
 
   pthread_mutex_t* EventCounterMutex   = Args->mEventCounterMutex;
   volatile int*    EventCounter        = Args->mEventCounter;
+  volatile int*    NotifyFd            = Args->mNotifyFd;
 
   struct rdma_event_channel* CmChannel = Args->mCmChannel;
 
@@ -151,6 +154,7 @@ void* it_api_o_verbs_cm_processing_thread( void* aArgs )
       pthread_mutex_lock( EventCounterMutex );
       (*EventCounter)++;
       pthread_cond_signal( MainCond );
+      it_api_o_verbs_aevd_notify( NotifyFd );
       pthread_mutex_unlock( EventCounterMutex );
     }
 }
@@ -176,6 +180,7 @@ void* it_api_o_verbs_dto_processing_thread( void* aArgs )
 
   pthread_mutex_t*         EventCounterMutex = Args->mEventCounterMutex;
   volatile int*            EventCounter      = Args->mEventCounter;
+  volatile int*            NotifyFd          = Args->mNotifyFd;
 
   int ret = ibv_req_notify_cq( CQ, Args->mSolicitedEventsOnly );
   StrongAssertLogLine( ! ret ) 
@@ -264,6 +269,7 @@ void* it_api_o_verbs_dto_processing_thread( void* aArgs )
       pthread_mutex_lock( EventCounterMutex );
       (*EventCounter) += event_count;
       pthread_cond_signal( MainCond );
+      it_api_o_verbs_aevd_notify( NotifyFd );
       pthread_mutex_unlock( EventCounterMutex );
     }
 }
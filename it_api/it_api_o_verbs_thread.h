@@ -17,6 +17,7 @@
 #include <FxLogger.hpp>
 
 #include <rdma/rdma_cma.h>
+#include <unistd.h>
 
 extern "C"
 {
@@ -38,6 +39,7 @@ struct it_api_o_verbs_cq_processing_thread_args_t
   pthread_cond_t*          mMainCond;
   pthread_mutex_t*         mEventCounterMutex;
   volatile int*            mEventCounter;
+  volatile int*            mNotifyFd;
 
   pthread_mutex_t*         mCQReadyMutex;
   struct ibv_cq*           mCQ;
@@ -51,6 +53,23 @@ struct it_api_o_verbs_cq_processing_thread_args_t
 
 #include <it_api_o_verbs_types.h>
 
+/***
+ * Fire the one-shot notification armed by itx_aevd_notify()
+ * The caller has to hold the event counter mutex.
+ ***/
+static inline
+void
+it_api_o_verbs_aevd_notify( volatile int* aNotifyFd )
+{
+  if( *aNotifyFd >= 0 )
+    {
+      uint64_t one = 1;
+      ssize_t rc = write( *aNotifyFd, & one, sizeof( one ) );
+      (void) rc;
+      *aNotifyFd = -1;
+    }
+}
+
 
 void* it_api_o_verbs_aff_processing_thread( void* aArgs );
 void* it_api_o_verbs_cm_processing_thread( void* aArgs );
@@ -100,6 +100,7 @@ struct it_api_o_verbs_aevd_mgr_t
   pthread_cond_t      mMainCond;
   pthread_mutex_t     mEventCounterMutex;
   volatile int        mEventCounter;
+  volatile int        mNotifyFd;     // armed by itx_aevd_notify(), -1 if not armed
 
   void
   Init( it_api_o_verbs_device_mgr_t*  aDevice )
@@ -108,6 +109,7 @@ struct it_api_o_verbs_aevd_mgr_t
     pthread_cond_init( & mMainCond, NULL );
     pthread_mutex_init( & mEventCounterMutex, NULL );
     mEventCounter = 0;
+    mNotifyFd = -1;
 
     mDevice = aDevice;
 
@@ -186,6 +186,52 @@ SKV_Remove( skv_hdl_t               aClient,
 
 
 
+skv_status_t
+SKV_MultiRetrieve( skv_hdl_t            aClient,
+                   skv_pds_hdl_t        aPDSId,
+                   int                  aCount,
+                   char               **aKeyBuffers,
+                   int                 *aKeyBufferSizes,
+                   char               **aValueBuffers,
+                   int                 *aValueBufferSizes,
+                   int                 *aValueRetrievedSizes,
+                   skv_status_t        *aStatus,
+                   skv_cmd_RIU_flags_t  aFlags )
+  {
+  return ((skv_client_internal_t *)aClient)->MultiRetrieve( (skv_pds_id_t*)aPDSId,
+                                                             aCount,
+                                                             aKeyBuffers,
+                                                             aKeyBufferSizes,
+                                                             aValueBuffers,
+                                                             aValueBufferSizes,
+                                                             aValueRetrievedSizes,
+                                                             aStatus,
+                                                             aFlags );
+  }
+
+
+skv_status_t
+SKV_MultiInsert( skv_hdl_t            aClient,
+                 skv_pds_hdl_t        aPDSId,
+                 int                  aCount,
+                 char               **aKeyBuffers,
+                 int                 *aKeyBufferSizes,
+                 char               **aValueBuffers,
+                 int                 *aValueBufferSizes,
+                 skv_status_t        *aStatus,
+                 skv_cmd_RIU_flags_t  aFlags )
+  {
+  return ((skv_client_internal_t *)aClient)->MultiInsert( (skv_pds_id_t*)aPDSId,
+                                                           aCount,
+                                                           aKeyBuffers,
+                                                           aKeyBufferSizes,
+                                                           aValueBuffers,
+                                                           aValueBufferSizes,
+                                                           aStatus,
+                                                           aFlags );
+  }
+
+
 skv_status_t
 SKV_Close( skv_hdl_t       aClient,
             skv_pds_hdl_t   aPDSId )
@@ -365,6 +411,67 @@ SKV_Test( skv_hdl_t                 aClient,
   }
 
 
+skv_status_t
+SKV_SetCompletionCallback( skv_hdl_t                   aClient,
+                           skv_client_cmd_ext_hdl_t    aCmdHdl,
+                           skv_client_completion_cb_t  aCallback,
+                           void                       *aContext )
+  {
+  return ((skv_client_internal_t *)aClient)->SetCompletionCallback( (skv_client_cmd_hdl_t) aCmdHdl,
+                                                                     aCallback,
+                                                                     aContext );
+  }
+
+
+skv_status_t
+SKV_CreateCompletionQueue( skv_hdl_t                 aClient,
+                           skv_client_cq_ext_hdl_t  *aCQ,
+                           int                      *aEventFD )
+  {
+  return ((skv_client_internal_t *)aClient)->CreateCompletionQueue( (skv_client_completion_queue_t **) aCQ,
+                                                                     aEventFD );
+  }
+
+
+skv_status_t
+SKV_DestroyCompletionQueue( skv_hdl_t                aClient,
+                            skv_client_cq_ext_hdl_t  aCQ )
+  {
+  return ((skv_client_internal_t *)aClient)->DestroyCompletionQueue( (skv_client_completion_queue_t *) aCQ );
+  }
+
+
+skv_status_t
+SKV_SetCompletionQueue( skv_hdl_t                 aClient,
+                        skv_client_cmd_ext_hdl_t  aCmdHdl,
+                        skv_client_cq_ext_hdl_t   aCQ,
+                        void                     *aContext )
+  {
+  return ((skv_client_internal_t *)aClient)->SetCompletionQueue( (skv_client_cmd_hdl_t) aCmdHdl,
+                                                                  (skv_client_completion_queue_t *) aCQ,
+                                                                  aContext );
+  }
+
+
+skv_status_t
+SKV_PollCompletionQueue( skv_hdl_t                  aClient,
+                         skv_client_cq_ext_hdl_t    aCQ,
+                         skv_client_cmd_ext_hdl_t  *aCmdHdl,
+                         void                     **aContext )
+  {
+  return ((skv_client_internal_t *)aClient)->PollCompletionQueue( (skv_client_completion_queue_t *) aCQ,
+                                                                   (skv_client_cmd_hdl_t *) aCmdHdl,
+                                                                   aContext );
+  }
+
+
+skv_status_t
+SKV_Progress( skv_hdl_t aClient )
+  {
+  return ((skv_client_internal_t *)aClient)->Progress();
+  }
+
+
 
 /******************************************************************************
  * Pure Key / Value Cursor Interface
@@ -45,7 +45,11 @@ extern "C"
     SKV_COMMAND_OPEN_FLAGS_EXCLUSIVE  = 0x0002,
 
     // PDS has duplicates
-    SKV_COMMAND_OPEN_FLAGS_DUP        = 0x0003
+    SKV_COMMAND_OPEN_FLAGS_DUP        = 0x0003,
+
+    // Keep a hash index next to the ordered index (inmem/asyncmem backends)
+    // speeds up exact-key retrieve/remove, cursors still use the ordered index
+    SKV_COMMAND_OPEN_FLAGS_HASH_INDEX = 0x0004
 
     } skv_cmd_open_flags_t;
 
@@ -101,7 +105,12 @@ extern "C"
     SKV_COMMAND_RIU_APPEND                           = 0x0100,
 
     // enable overlapping inserts (e.g. for EXPANDS_VALUE case)
-    SKV_COMMAND_RIU_INSERT_OVERLAPPING               = 0x0200
+    SKV_COMMAND_RIU_INSERT_OVERLAPPING               = 0x0200,
+
+    // insert: the server verifies a crc32c of the value after the transfer
+    // and fails with SKV_ERRNO_CHECKSUM_MISMATCH (the stored value has to be
+    // considered invalid and needs to be inserted again)
+    SKV_COMMAND_RIU_VALUE_CHECKSUM                   = 0x0400
     } skv_cmd_RIU_flags_t;
 
   typedef enum
@@ -160,7 +169,12 @@ extern "C"
 // Bulk Inserter related structures
   typedef enum
     {
-    SKV_BULK_INSERTER_FLAGS_NONE  = 0x0000
+    SKV_BULK_INSERTER_FLAGS_NONE  = 0x0000,
+
+    /* Each buffer gets sorted by key (bytewise) before it's sent. Servers
+     * take a sorted-run fast path: appending index nodes (inmem/asyncmem)
+     * or ingesting SST files for large buffers (rocksdb) */
+    SKV_BULK_INSERTER_FLAGS_SORTED = 0x0001
     } skv_bulk_inserter_flags_t;
 
   typedef char skv_pdsname_string_t;
@@ -185,6 +199,14 @@ extern "C"
   typedef void* skv_client_relational_cursor_ext_hdl_t;
   typedef void* skv_client_index_ext_hdl_t;
   typedef void* skv_client_bulk_inserter_ext_hdl_t;
+  typedef uint64_t skv_client_bulk_flush_ext_hdl_t;
+  typedef void* skv_client_cq_ext_hdl_t;
+
+  /* completion callback of an async command: the handle is released
+   * after the callback returns */
+  typedef void (*skv_client_completion_cb_t)( skv_client_cmd_ext_hdl_t aCmdHdl,
+                                              skv_status_t             aStatus,
+                                              void                    *aContext );
 
 
 /**
@@ -274,6 +296,29 @@ extern "C"
                skv_cmd_remove_flags_t  aFlags );
 
 
+  skv_status_t
+  SKV_MultiRetrieve( skv_hdl_t            aClient,
+                     skv_pds_hdl_t        aPDSId,
+                     int                  aCount,
+                     char               **aKeyBuffers,
+                     int                 *aKeyBufferSizes,
+                     char               **aValueBuffers,
+                     int                 *aValueBufferSizes,
+                     int                 *aValueRetrievedSizes,
+                     skv_status_t        *aStatus,
+                     skv_cmd_RIU_flags_t  aFlags );
+
+  skv_status_t
+  SKV_MultiInsert( skv_hdl_t            aClient,
+                   skv_pds_hdl_t        aPDSId,
+                   int                  aCount,
+                   char               **aKeyBuffers,
+                   int                 *aKeyBufferSizes,
+                   char               **aValueBuffers,
+                   int                 *aValueBufferSizes,
+                   skv_status_t        *aStatus,
+                   skv_cmd_RIU_flags_t  aFlags );
+
   skv_status_t
   SKV_Close( skv_hdl_t     aClient,
               skv_pds_hdl_t aPDSId );
@@ -362,6 +407,37 @@ extern "C"
   SKV_Test( skv_hdl_t                 aClient,
              skv_client_cmd_ext_hdl_t  aCmdHdl );
 
+// Completion notification
+  skv_status_t
+  SKV_SetCompletionCallback( skv_hdl_t                   aClient,
+                             skv_client_cmd_ext_hdl_t    aCmdHdl,
+                             skv_client_completion_cb_t  aCallback,
+                             void                       *aContext );
+
+  skv_status_t
+  SKV_CreateCompletionQueue( skv_hdl_t                 aClient,
+                             skv_client_cq_ext_hdl_t  *aCQ,
+                             int                      *aEventFD );
+
+  skv_status_t
+  SKV_DestroyCompletionQueue( skv_hdl_t                aClient,
+                              skv_client_cq_ext_hdl_t  aCQ );
+
+  skv_status_t
+  SKV_SetCompletionQueue( skv_hdl_t                 aClient,
+                          skv_client_cmd_ext_hdl_t  aCmdHdl,
+                          skv_client_cq_ext_hdl_t   aCQ,
+                          void                     *aContext );
+
+  skv_status_t
+  SKV_PollCompletionQueue( skv_hdl_t                  aClient,
+                           skv_client_cq_ext_hdl_t    aCQ,
+                           skv_client_cmd_ext_hdl_t  *aCmdHdl,
+                           void                     **aContext );
+
+  skv_status_t
+  SKV_Progress( skv_hdl_t aClient );
+
 
 /******************************************************************************
  * Pure Key / Value Cursor Interface
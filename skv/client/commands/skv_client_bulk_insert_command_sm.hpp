@@ -96,11 +96,7 @@ public:
                     char* LocalBuffer     = aCCB->mCommand.mCommandBundle.mCommandBulkInsert.mBuffer;
                     int   LocalBufferSize = aCCB->mCommand.mCommandBundle.mCommandBulkInsert.mBufferSize;
 
-                    uint64_t Checksum = 0;
-                    for( int i = 0; i < LocalBufferSize; i++ )
-                      {
-                        Checksum += LocalBuffer[ i ];
-                      }
+                    uint64_t Checksum = skv_crc32c( 0, LocalBuffer, LocalBufferSize );
 
                     BegLogLine( 1 )
                       << "skv_client_bulk_insert_command_sm::Execute():: ERROR:: Checksum mismatch: "
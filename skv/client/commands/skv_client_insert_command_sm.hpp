@@ -48,14 +48,14 @@ public:
         it_lmr_handle_t lmrHdl = aCCB->mCommand.mCommandBundle.mCommandInsert.mValueLMR;
 
         BegLogLine( SKV_CLIENT_INSERT_COMMAND_SM_LOG )
-          << "skv_client_insert_command_sm::Release():: About to call it_lmr_free( ): "
+          << "skv_client_insert_command_sm::Release():: About to release value lmr: "
           << " lmr: " << (void *) lmrHdl
           << EndLogLine;
 
-        it_status_t status = it_lmr_free( lmrHdl );
+        it_status_t status = aCCB->mCCBMgrIF->GetMRCache()->Release( lmrHdl );
 
         AssertLogLine( status == IT_SUCCESS )
-          << "skv_client_insert_command_sm::Release():: ERROR:: it_lmr_free() failed"
+          << "skv_client_insert_command_sm::Release():: ERROR:: releasing the value lmr failed"
           << " lmr: " << (void *) lmrHdl
           << " status: " << status
           << EndLogLine;	
@@ -44,10 +44,10 @@ public:
         // Release LMRs
         it_lmr_handle_t lmrHdl = aCCB->mCommand.mCommandBundle.mCommandRetrieve.mValueLMR;
 
-        it_status_t status = it_lmr_free( lmrHdl );
+        it_status_t status = aCCB->mCCBMgrIF->GetMRCache()->Release( lmrHdl );
 
         AssertLogLine( status == IT_SUCCESS )
-          << "skv_client_release_command_sm::Release():: ERROR:: it_lmr_free() failed"
+          << "skv_client_release_command_sm::Release():: ERROR:: releasing the value lmr failed"
           << " lmr: " << (void *) lmrHdl
           << " status: " << status
           << EndLogLine;	
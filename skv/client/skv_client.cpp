@@ -288,6 +288,98 @@ Wait( skv_client_cmd_ext_hdl_t aCmdHdl )
   return mSKVClientInternalPtr->Wait( (skv_client_cmd_hdl_t) aCmdHdl );
 }
 
+/***
+ * skv_client_t::SetCompletionCallback::
+ * Desc: Run a callback when the command completes
+ * input:
+ * returns: SKV_SUCCESS on success or error code
+ ***/
+skv_status_t
+skv_client_t::
+SetCompletionCallback( skv_client_cmd_ext_hdl_t aCmdHdl,
+                       skv_client_completion_cb_t aCallback,
+                       void* aContext )
+{
+  return mSKVClientInternalPtr->SetCompletionCallback( (skv_client_cmd_hdl_t) aCmdHdl,
+                                                       aCallback,
+                                                       aContext );
+}
+
+/***
+ * skv_client_t::CreateCompletionQueue::
+ * Desc: Create a completion queue with an eventfd
+ * input:
+ * returns: SKV_SUCCESS on success or error code
+ ***/
+skv_status_t
+skv_client_t::
+CreateCompletionQueue( skv_client_cq_ext_hdl_t* aCQ,
+                       int* aEventFD )
+{
+  return mSKVClientInternalPtr->CreateCompletionQueue( (skv_client_completion_queue_t **) aCQ,
+                                                       aEventFD );
+}
+
+/***
+ * skv_client_t::DestroyCompletionQueue::
+ * Desc: Release a completion queue and its undelivered commands
+ * input:
+ * returns: SKV_SUCCESS on success or error code
+ ***/
+skv_status_t
+skv_client_t::
+DestroyCompletionQueue( skv_client_cq_ext_hdl_t aCQ )
+{
+  return mSKVClientInternalPtr->DestroyCompletionQueue( (skv_client_completion_queue_t *) aCQ );
+}
+
+/***
+ * skv_client_t::SetCompletionQueue::
+ * Desc: Queue the command to aCQ when it completes
+ * input:
+ * returns: SKV_SUCCESS on success or error code
+ ***/
+skv_status_t
+skv_client_t::
+SetCompletionQueue( skv_client_cmd_ext_hdl_t aCmdHdl,
+                    skv_client_cq_ext_hdl_t aCQ,
+                    void* aContext )
+{
+  return mSKVClientInternalPtr->SetCompletionQueue( (skv_client_cmd_hdl_t) aCmdHdl,
+                                                    (skv_client_completion_queue_t *) aCQ,
+                                                    aContext );
+}
+
+/***
+ * skv_client_t::PollCompletionQueue::
+ * Desc: Fetch the next completed command from aCQ
+ * input:
+ * returns: status of the command or SKV_ERRNO_NOT_DONE
+ ***/
+skv_status_t
+skv_client_t::
+PollCompletionQueue( skv_client_cq_ext_hdl_t aCQ,
+                     skv_client_cmd_ext_hdl_t* aCmdHdl,
+                     void** aContext )
+{
+  return mSKVClientInternalPtr->PollCompletionQueue( (skv_client_completion_queue_t *) aCQ,
+                                                     (skv_client_cmd_hdl_t *) aCmdHdl,
+                                                     aContext );
+}
+
+/***
+ * skv_client_t::Progress::
+ * Desc: Process responses and deliver completions
+ * input:
+ * returns: SKV_SUCCESS on success or error code
+ ***/
+skv_status_t
+skv_client_t::
+Progress()
+{
+  return mSKVClientInternalPtr->Progress();
+}
+
 /***
  * skv_client_t::Open::
  * Desc: Create or open a new PDS (partition data set)
@@ -659,6 +751,33 @@ Flush( skv_client_bulk_inserter_ext_hdl_t aBulkInserterHandle )
   return mSKVClientInternalPtr->Flush( (skv_client_bulk_inserter_hdl_t) aBulkInserterHandle );
 }
 
+skv_status_t
+skv_client_t::
+iFlush( skv_client_bulk_inserter_ext_hdl_t aBulkInserterHandle,
+        skv_client_bulk_flush_ext_hdl_t*   aFlushHandle )
+{
+  return mSKVClientInternalPtr->iFlush( (skv_client_bulk_inserter_hdl_t) aBulkInserterHandle,
+                                        (skv_client_bulk_flush_hdl_t *) aFlushHandle );
+}
+
+skv_status_t
+skv_client_t::
+TestFlush( skv_client_bulk_inserter_ext_hdl_t aBulkInserterHandle,
+           skv_client_bulk_flush_ext_hdl_t    aFlushHandle )
+{
+  return mSKVClientInternalPtr->TestFlush( (skv_client_bulk_inserter_hdl_t) aBulkInserterHandle,
+                                           (skv_client_bulk_flush_hdl_t) aFlushHandle );
+}
+
+skv_status_t
+skv_client_t::
+WaitFlush( skv_client_bulk_inserter_ext_hdl_t aBulkInserterHandle,
+           skv_client_bulk_flush_ext_hdl_t    aFlushHandle )
+{
+  return mSKVClientInternalPtr->WaitFlush( (skv_client_bulk_inserter_hdl_t) aBulkInserterHandle,
+                                           (skv_client_bulk_flush_hdl_t) aFlushHandle );
+}
+
 skv_status_t
 skv_client_t::
 CloseBulkInserter( skv_client_bulk_inserter_ext_hdl_t aBulkInserterHandle )
@@ -666,10 +785,80 @@ CloseBulkInserter( skv_client_bulk_inserter_ext_hdl_t aBulkInserterHandle )
   return mSKVClientInternalPtr->CloseBulkInserter( (skv_client_bulk_inserter_hdl_t) aBulkInserterHandle );
 }
 
+/***
+ * skv_client_t::MultiRetrieve::
+ * Desc: Retrieve a set of records with one request per server
+ * input:
+ * returns: SKV_SUCCESS if all keys were retrieved or the first per-key error
+ ***/
+skv_status_t
+skv_client_t::
+MultiRetrieve( skv_pds_id_t*         aPDSId,
+               int                   aCount,
+               char**                aKeyBuffers,
+               int*                  aKeyBufferSizes,
+               char**                aValueBuffers,
+               int*                  aValueBufferSizes,
+               int*                  aValueRetrievedSizes,
+               skv_status_t*         aStatus,
+               skv_cmd_RIU_flags_t   aFlags )
+{
+  return mSKVClientInternalPtr->MultiRetrieve( aPDSId,
+                                               aCount,
+                                               aKeyBuffers,
+                                               aKeyBufferSizes,
+                                               aValueBuffers,
+                                               aValueBufferSizes,
+                                               aValueRetrievedSizes,
+                                               aStatus,
+                                               aFlags );
+}
+
+/***
+ * skv_client_t::MultiInsert::
+ * Desc: Insert a set of records with one request per server
+ * input:
+ * returns: SKV_SUCCESS if all keys were inserted or the first per-key error
+ ***/
+skv_status_t
+skv_client_t::
+MultiInsert( skv_pds_id_t*         aPDSId,
+             int                   aCount,
+             char**                aKeyBuffers,
+             int*                  aKeyBufferSizes,
+             char**                aValueBuffers,
+             int*                  aValueBufferSizes,
+             skv_status_t*         aStatus,
+             skv_cmd_RIU_flags_t   aFlags )
+{
+  return mSKVClientInternalPtr->MultiInsert( aPDSId,
+                                             aCount,
+                                             aKeyBuffers,
+                                             aKeyBufferSizes,
+                                             aValueBuffers,
+                                             aValueBufferSizes,
+                                             aStatus,
+                                             aFlags );
+}
+
 skv_status_t
 skv_client_t::
 DumpPersistentImage( char* aPath )
 {
   return mSKVClientInternalPtr->DumpPersistentImage( aPath );
 }
+
+skv_status_t
+skv_client_t::
+RegisterMemory( void* aBuffer, size_t aSize )
+{
+  return mSKVClientInternalPtr->RegisterMemory( aBuffer, aSize );
+}
+
+skv_status_t
+skv_client_t::
+DeregisterMemory( void* aBuffer, size_t aSize )
+{
+  return mSKVClientInternalPtr->DeregisterMemory( aBuffer, aSize );
+}
 /*****************************************************************************/
@@ -159,6 +159,41 @@ public:
 
   skv_status_t Test( skv_client_cmd_ext_hdl_t aCmdHdl );
 
+  /***
+   * Completion notification for async commands
+   *
+   * Instead of Test/Wait, a pending command can get a completion callback
+   * or be attached to a completion queue (one per command, at most one of both).
+   * Handlers are run by whichever thread drives the client progress
+   * (Progress(), Test*(), Wait*(), PollCompletionQueue() or any blocking call).
+   * Responses are placed into client memory by the servers without an
+   * event, so one thread has to keep driving progress while commands are
+   * pending. Don't Test/Wait on a handle with a handler.
+   ***/
+  // the handle is released when the callback returns
+  skv_status_t SetCompletionCallback( skv_client_cmd_ext_hdl_t aCmdHdl,
+                                      skv_client_completion_cb_t aCallback,
+                                      void* aContext );
+
+  // aEventFD is readable (level) while the queue has completions
+  skv_status_t CreateCompletionQueue( skv_client_cq_ext_hdl_t* aCQ,
+                                      int* aEventFD );
+
+  skv_status_t DestroyCompletionQueue( skv_client_cq_ext_hdl_t aCQ );
+
+  skv_status_t SetCompletionQueue( skv_client_cmd_ext_hdl_t aCmdHdl,
+                                   skv_client_cq_ext_hdl_t aCQ,
+                                   void* aContext );
+
+  // returns the status of the completed command (handle is released)
+  // or SKV_ERRNO_NOT_DONE if the queue is empty
+  skv_status_t PollCompletionQueue( skv_client_cq_ext_hdl_t aCQ,
+                                    skv_client_cmd_ext_hdl_t* aCmdHdl,
+                                    void** aContext );
+
+  // process responses and deliver completions without blocking
+  skv_status_t Progress();
+
   /******************************************************************************
    * Pure Key / Value Cursor Interface
    *****************************************************************************/
@@ -232,15 +267,67 @@ public:
 
   skv_status_t Flush( skv_client_bulk_inserter_ext_hdl_t aBulkInserterHandle );
 
+  /* non-blocking flush: sends the partially filled buffers and returns a
+   * handle that completes once everything inserted before is stored;
+   * Insert() can continue in the meantime. Errors are sticky: TestFlush()
+   * and WaitFlush() report the first failed buffer of the bulk inserter */
+  skv_status_t iFlush( skv_client_bulk_inserter_ext_hdl_t aBulkInserterHandle,
+                       skv_client_bulk_flush_ext_hdl_t* aFlushHandle );
+
+  // SKV_ERRNO_NOT_DONE while the flush is in progress
+  skv_status_t TestFlush( skv_client_bulk_inserter_ext_hdl_t aBulkInserterHandle,
+                          skv_client_bulk_flush_ext_hdl_t aFlushHandle );
+
+  skv_status_t WaitFlush( skv_client_bulk_inserter_ext_hdl_t aBulkInserterHandle,
+                          skv_client_bulk_flush_ext_hdl_t aFlushHandle );
+
   skv_status_t CloseBulkInserter( skv_client_bulk_inserter_ext_hdl_t aBulkInserterHandle );
   /*****************************************************************************/
 
+  /******************************************************************************
+   * Multi-Key Interface
+   * Keys are grouped by server and sent with one request per server.
+   * aStatus returns the status of each key. The call returns SKV_SUCCESS
+   * if all keys succeeded or the status of the first failed key.
+   * Duplicates are rejected by MultiInsert unless SKV_COMMAND_RIU_UPDATE or
+   * SKV_COMMAND_RIU_INSERT_OVERWRITE_VALUE_ON_DUP is set.
+   *****************************************************************************/
+  skv_status_t MultiRetrieve( skv_pds_id_t* aPDSId,
+                              int aCount,
+                              char** aKeyBuffers,
+                              int* aKeyBufferSizes,
+                              char** aValueBuffers,
+                              int* aValueBufferSizes,
+                              int* aValueRetrievedSizes,
+                              skv_status_t* aStatus,
+                              skv_cmd_RIU_flags_t aFlags );
+
+  skv_status_t MultiInsert( skv_pds_id_t* aPDSId,
+                            int aCount,
+                            char** aKeyBuffers,
+                            int* aKeyBufferSizes,
+                            char** aValueBuffers,
+                            int* aValueBufferSizes,
+                            skv_status_t* aStatus,
+                            skv_cmd_RIU_flags_t aFlags );
+  /*****************************************************************************/
+
   /******************************************************************************
    * Persistence
    *****************************************************************************/
   skv_status_t DumpPersistentImage( char* aPath );
   /*****************************************************************************/
 
+  /******************************************************************************
+   * Memory Registration
+   * Large insert/retrieve values from within a registered buffer don't
+   * need to be registered/deregistered with every request.
+   * DeregisterMemory() has to be called before the buffer is freed.
+   *****************************************************************************/
+  skv_status_t RegisterMemory( void* aBuffer, size_t aSize );
+  skv_status_t DeregisterMemory( void* aBuffer, size_t aSize );
+  /*****************************************************************************/
+
   // Debugging
   skv_status_t DumpPDS( skv_pds_id_t aPDSId,
                         int aMaxKeySize,
@@ -0,0 +1,400 @@
+/************************************************
+ * Copyright (c) IBM Corp. 2014
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * which accompanies this distribution, and is available at
+ * http://www.eclipse.org/legal/epl-v10.html
+ *************************************************/
+
+/*
+ * Future/continuation interface on top of the async client commands
+ *
+ *   skv_client_async_t Async( Client );
+ *
+ *   Async.Retrieve( &PDS, IndexKey, ... )
+ *     .Then( [&]( skv_status_t s ) { return Async.Retrieve( &PDS, RecordKey, ... ); } )
+ *     .OnComplete( [&]( skv_status_t s ) { ... } );
+ *   Async.Run();
+ *
+ * With C++20 coroutines (i.e. in applications built with -std=c++20; the
+ * skv libraries don't need it, the test is test_skv_client_async_coro),
+ * futures are awaitable and skv_client_task_t can be used as coroutine
+ * return type:
+ *
+ *   skv_client_task_t Lookup( skv_client_async_t& aAsync, ... )
+ *   {
+ *     skv_status_t status = co_await aAsync.Retrieve( ... );
+ *     if( status == SKV_SUCCESS )
+ *       status = co_await aAsync.Retrieve( ... );
+ *     co_return status;
+ *   }
+ *
+ * Commands complete through completion callbacks, i.e. continuations and
+ * coroutines are resumed by the thread that drives the client progress
+ * (Run()/RunOnce()/Get() or any other client call that processes responses).
+ * Buffers passed to a command have to stay valid until it completes.
+ */
+
+#ifndef __SKV_CLIENT_ASYNC_HPP__
+#define __SKV_CLIENT_ASYNC_HPP__
+
+#include <vector>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <atomic>
+
+#include <skv/client/skv_client.hpp>
+
+#if defined( __cpp_impl_coroutine ) && ( __cplusplus >= 202002L )
+#include <coroutine>
+#include <exception>
+#define SKV_CLIENT_COROUTINES
+#endif
+
+/***
+ * completion state shared between a future, its continuations and the
+ * completion callback of the command
+ ***/
+class skv_client_future_state_t
+{
+  std::mutex                                          mLock;
+  bool                                                mDone;
+  skv_status_t                                        mStatus;
+  std::vector< std::function< void( skv_status_t ) > > mContinuations;
+
+public:
+  skv_client_t*                                       mClient;   // progress engine for Get()
+
+  skv_client_future_state_t( skv_client_t* aClient )
+    : mDone( false ), mStatus( SKV_ERRNO_NOT_DONE ), mClient( aClient ) {}
+
+  bool
+  IsDone()
+  {
+    std::lock_guard< std::mutex > Guard( mLock );
+    return mDone;
+  }
+
+  skv_status_t
+  GetStatus()
+  {
+    std::lock_guard< std::mutex > Guard( mLock );
+    return mStatus;
+  }
+
+  void
+  Complete( skv_status_t aStatus )
+  {
+    std::vector< std::function< void( skv_status_t ) > > Continuations;
+    {
+      std::lock_guard< std::mutex > Guard( mLock );
+      mDone = true;
+      mStatus = aStatus;
+      Continuations.swap( mContinuations );
+    }
+    for( size_t i = 0; i < Continuations.size(); i++ )
+      Continuations[ i ]( aStatus );
+  }
+
+  // returns false (and doesn't queue) if the state is complete already
+  bool
+  AddContinuationIfPending( const std::function< void( skv_status_t ) >& aContinuation )
+  {
+    std::lock_guard< std::mutex > Guard( mLock );
+    if( mDone )
+      return false;
+    mContinuations.push_back( aContinuation );
+    return true;
+  }
+
+  void
+  AddContinuation( const std::function< void( skv_status_t ) >& aContinuation )
+  {
+    if( !AddContinuationIfPending( aContinuation ) )
+      aContinuation( GetStatus() );
+  }
+};
+
+typedef std::shared_ptr< skv_client_future_state_t > skv_client_future_state_ptr_t;
+
+class skv_client_future_t
+{
+  skv_client_future_state_ptr_t mState;
+
+public:
+  skv_client_future_t() {}
+  skv_client_future_t( const skv_client_future_state_ptr_t& aState ) : mState( aState ) {}
+
+  // already completed future, e.g. for commands that failed to issue
+  static skv_client_future_t
+  Ready( skv_status_t aStatus, skv_client_t* aClient = NULL )
+  {
+    skv_client_future_state_ptr_t State = std::make_shared< skv_client_future_state_t >( aClient );
+    State->Complete( aStatus );
+    return skv_client_future_t( State );
+  }
+
+  bool IsValid() const { return mState.get() != NULL; }
+  bool IsReady() const { return mState->IsDone(); }
+  const skv_client_future_state_ptr_t& GetState() const { return mState; }
+
+  // drive the client progress until the command completed
+  skv_status_t
+  Get() const
+  {
+    while( !mState->IsDone() )
+      if( mState->mClient != NULL )
+        mState->mClient->Progress();
+    return mState->GetStatus();
+  }
+
+  // run aFunc( status ) on completion
+  const skv_client_future_t&
+  OnComplete( const std::function< void( skv_status_t ) >& aFunc ) const
+  {
+    mState->AddContinuation( aFunc );
+    return *this;
+  }
+
+  // chain a dependent command: aFunc( status ) returns the future of the
+  // next command, the returned future completes with that command
+  skv_client_future_t
+  Then( const std::function< skv_client_future_t( skv_status_t ) >& aFunc ) const
+  {
+    skv_client_future_state_ptr_t Next = std::make_shared< skv_client_future_state_t >( mState->mClient );
+    mState->AddContinuation( [ Next, aFunc ]( skv_status_t aStatus )
+    {
+      skv_client_future_t Inner = aFunc( aStatus );
+      if( Inner.IsValid() )
+        Inner.OnComplete( [ Next ]( skv_status_t aInnerStatus ) { Next->Complete( aInnerStatus ); } );
+      else
+        Next->Complete( aStatus );
+    } );
+    return skv_client_future_t( Next );
+  }
+
+#ifdef SKV_CLIENT_COROUTINES
+  bool await_ready() const noexcept { return mState->IsDone(); }
+
+  bool
+  await_suspend( std::coroutine_handle<> aWaiter ) const
+  {
+    return mState->AddContinuationIfPending( [ aWaiter ]( skv_status_t ) { aWaiter.resume(); } );
+  }
+
+  skv_status_t await_resume() const noexcept { return mState->GetStatus(); }
+#endif
+};
+
+/***
+ * issues async commands as futures and drives the progress of all of them
+ ***/
+class skv_client_async_t
+{
+  skv_client_t&         mClient;
+  std::atomic< int >    mPending;
+
+  struct completion_context_t
+  {
+    skv_client_future_state_ptr_t mState;
+    skv_client_async_t*           mAsync;
+  };
+
+  static void
+  CompletionCallback( skv_client_cmd_ext_hdl_t aCmdHdl, skv_status_t aStatus, void* aContext )
+  {
+    completion_context_t* Context = (completion_context_t*) aContext;
+    Context->mAsync->mPending--;
+    Context->mState->Complete( aStatus );
+    delete Context;
+  }
+
+  skv_client_future_t
+  Track( skv_status_t aIssueStatus, skv_client_cmd_ext_hdl_t aCmdHdl )
+  {
+    if( aIssueStatus != SKV_SUCCESS )
+      return skv_client_future_t::Ready( aIssueStatus, &mClient );
+
+    completion_context_t* Context = new completion_context_t;
+    Context->mState = std::make_shared< skv_client_future_state_t >( &mClient );
+    Context->mAsync = this;
+    skv_client_future_t Future( Context->mState );
+
+    mPending++;
+    skv_status_t status = mClient.SetCompletionCallback( aCmdHdl, CompletionCallback, Context );
+    if( status != SKV_SUCCESS )
+    {
+      mPending--;
+      delete Context;
+      return skv_client_future_t::Ready( status, &mClient );
+    }
+    return Future;
+  }
+
+public:
+  skv_client_async_t( skv_client_t& aClient ) : mClient( aClient ), mPending( 0 ) {}
+
+  skv_client_t& GetClient() { return mClient; }
+  int GetPendingCount() const { return mPending; }
+
+  skv_client_future_t
+  Open( char* aPDSName, skv_pds_priv_t aPrivs, skv_cmd_open_flags_t aFlags, skv_pds_id_t* aPDSId )
+  {
+    skv_client_cmd_ext_hdl_t CmdHdl;
+    skv_status_t status = mClient.iOpen( aPDSName, aPrivs, aFlags, aPDSId, &CmdHdl );
+    return Track( status, CmdHdl );
+  }
+
+  skv_client_future_t
+  Retrieve( skv_pds_id_t* aPDSId,
+            char* aKeyBuffer, int aKeyBufferSize,
+            char* aValueBuffer, int aValueBufferSize,
+            int* aValueRetrievedSize, int aOffset,
+            skv_cmd_RIU_flags_t aFlags )
+  {
+    skv_client_cmd_ext_hdl_t CmdHdl;
+    skv_status_t status = mClient.iRetrieve( aPDSId, aKeyBuffer, aKeyBufferSize,
+                                             aValueBuffer, aValueBufferSize,
+                                             aValueRetrievedSize, aOffset, aFlags, &CmdHdl );
+    return Track( status, CmdHdl );
+  }
+
+  skv_client_future_t
+  Update( skv_pds_id_t* aPDSId,
+          char* aKeyBuffer, int aKeyBufferSize,
+          char* aValueBuffer, int aValueUpdateSize, int aOffset,
+          skv_cmd_RIU_flags_t aFlags )
+  {
+    skv_client_cmd_ext_hdl_t CmdHdl;
+    skv_status_t status = mClient.iUpdate( aPDSId, aKeyBuffer, aKeyBufferSize,
+                                           aValueBuffer, aValueUpdateSize, aOffset, aFlags, &CmdHdl );
+    return Track( status, CmdHdl );
+  }
+
+  skv_client_future_t
+  Insert( skv_pds_id_t* aPDSId,
+          char* aKeyBuffer, int aKeyBufferSize,
+          char* aValueBuffer, int aValueBufferSize, int aValueBufferOffset,
+          skv_cmd_RIU_flags_t aFlags )
+  {
+    skv_client_cmd_ext_hdl_t CmdHdl;
+    skv_status_t status = mClient.iInsert( aPDSId, aKeyBuffer, aKeyBufferSize,
+                                           aValueBuffer, aValueBufferSize, aValueBufferOffset, aFlags, &CmdHdl );
+    return Track( status, CmdHdl );
+  }
+
+  skv_client_future_t
+  Remove( skv_pds_id_t* aPDSId,
+          char* aKeyBuffer, int aKeyBufferSize,
+          skv_cmd_remove_flags_t aFlags )
+  {
+    skv_client_cmd_ext_hdl_t CmdHdl;
+    skv_status_t status = mClient.iRemove( aPDSId, aKeyBuffer, aKeyBufferSize, aFlags, &CmdHdl );
+    return Track( status, CmdHdl );
+  }
+
+  skv_client_future_t
+  Close( skv_pds_id_t* aPDSId )
+  {
+    skv_client_cmd_ext_hdl_t CmdHdl;
+    skv_status_t status = mClient.iClose( aPDSId, &CmdHdl );
+    return Track( status, CmdHdl );
+  }
+
+  // one round of response processing; returns the number of pending commands
+  int
+  RunOnce()
+  {
+    mClient.Progress();
+    return mPending;
+  }
+
+  // drive progress until all commands issued through this object completed,
+  // including commands issued by continuations and coroutines
+  void
+  Run()
+  {
+    while( mPending > 0 )
+      mClient.Progress();
+  }
+};
+
+#ifdef SKV_CLIENT_COROUTINES
+/***
+ * coroutine return type: starts eagerly, completes with the co_returned status
+ * a task that is destroyed before it finished keeps running detached
+ ***/
+class skv_client_task_t
+{
+public:
+  struct promise_type
+  {
+    skv_status_t               mStatus = SKV_ERRNO_NOT_DONE;
+    std::coroutine_handle<>    mWaiter;
+    bool                       mDetached = false;
+
+    skv_client_task_t
+    get_return_object()
+    {
+      return skv_client_task_t( std::coroutine_handle< promise_type >::from_promise( *this ) );
+    }
+
+    std::suspend_never initial_suspend() noexcept { return {}; }
+
+    struct final_awaiter_t
+    {
+      bool await_ready() noexcept { return false; }
+
+      std::coroutine_handle<>
+      await_suspend( std::coroutine_handle< promise_type > aSelf ) noexcept
+      {
+        promise_type& Promise = aSelf.promise();
+        if( Promise.mWaiter )
+          return Promise.mWaiter;
+        if( Promise.mDetached )
+          aSelf.destroy();
+        return std::noop_coroutine();
+      }
+
+      void await_resume() noexcept {}
+    };
+
+    final_awaiter_t final_suspend() noexcept { return {}; }
+
+    void return_value( skv_status_t aStatus ) { mStatus = aStatus; }
+    void unhandled_exception() { std::terminate(); }
+  };
+
+private:
+  std::coroutine_handle< promise_type > mHandle;
+
+  explicit skv_client_task_t( std::coroutine_handle< promise_type > aHandle ) : mHandle( aHandle ) {}
+
+public:
+  skv_client_task_t( skv_client_task_t&& aOther ) noexcept : mHandle( aOther.mHandle ) { aOther.mHandle = nullptr; }
+  skv_client_task_t( const skv_client_task_t& ) = delete;
+  skv_client_task_t& operator=( const skv_client_task_t& ) = delete;
+
+  ~skv_client_task_t()
+  {
+    if( !mHandle )
+      return;
+    if( mHandle.done() )
+      mHandle.destroy();
+    else
+      mHandle.promise().mDetached = true;
+  }
+
+  bool IsDone() const { return mHandle.done(); }
+  skv_status_t GetStatus() const { return mHandle.promise().mStatus; }
+
+  // awaiting a task from another coroutine; the waiter is resumed by the
+  // final suspend of this task
+  bool await_ready() const noexcept { return mHandle.done(); }
+  void await_suspend( std::coroutine_handle<> aWaiter ) noexcept { mHandle.promise().mWaiter = aWaiter; }
+  skv_status_t await_resume() const noexcept { return mHandle.promise().mStatus; }
+};
+#endif // SKV_CLIENT_COROUTINES
+
+#endif // __SKV_CLIENT_ASYNC_HPP__
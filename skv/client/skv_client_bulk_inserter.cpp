@@ -12,6 +12,7 @@
  */
 
 #include <skv/client/skv_client_internal.hpp>
+#include <climits>
 
 TraceClient gSKVClientiBulkInsertStart;
 TraceClient gSKVClientiBulkInsertFinis;
@@ -36,6 +37,7 @@ iBulkInsert( int                 aNodeId,
              int                 aBufferSize,
              it_lmr_handle_t     aBufferLMR,
              it_rmr_context_t    aBufferRMR,
+             skv_bulk_inserter_flags_t aFlags,
              skv_client_ccb_t** aCCB )
 {
   BegLogLine( SKV_CLIENT_BULK_INSERT_LOG )
@@ -45,6 +47,7 @@ iBulkInsert( int                 aNodeId,
     << " aBuffer: " << (void *) aBuffer
     << " aBufferSize: " << aBufferSize
     << " aBufferRMR: " << (void *) aBufferRMR
+    << " aFlags: " << aFlags
     << EndLogLine;
 
 #if 0
@@ -107,9 +110,6 @@ iBulkInsert( int                 aNodeId,
     << "skv_client_internal_t::iBulkInsert(): ERROR: "
     << EndLogLine;
 
-  if( aBufferSize > SKV_BULK_INSERT_LIMIT )
-    return SKV_ERRNO_BULK_INSERT_LIMIT_EXCEEDED;
-
   skv_client_ccb_t* CmdCtrlBlk;
   skv_status_t rsrv_status = mCommandMgrIF.Reserve( & CmdCtrlBlk );
   if( rsrv_status != SKV_SUCCESS )
@@ -123,10 +123,7 @@ iBulkInsert( int                 aNodeId,
 
   uint64_t BufferChecksum = 0;
 #ifdef SKV_BULK_LOAD_CHECKSUM
-  for( int i = 0; i < aBufferSize; i++)
-  {
-    BufferChecksum += aBuffer[ i ];
-  }
+  BufferChecksum = skv_crc32c( 0, aBuffer, aBufferSize );
 
   BegLogLine( 1 )
     << "On client: BufferChecksum: " << BufferChecksum
@@ -144,6 +141,7 @@ iBulkInsert( int                 aNodeId,
              aBufferSize,
              aBufferLMR,
              // aBufferRMR,
+             aFlags,
              BufferChecksum );
   /*****************************************************/
   Req->EndianConvert() ;
@@ -200,16 +198,184 @@ CreateBulkInserter( skv_pds_id_t*                       aPDSId,
     << "skv_client_internal_t::CreateBulkInserter(): ERROR: "
     << EndLogLine;
 
+  uint64_t BufferSize = SKV_CLIENT_BULK_INSERT_BUFFER_SIZE;
+  uint64_t BuffersPerNode = SKV_CLIENT_BULK_INSERT_BUFFERS_PER_NODE;
+  if( mSKVConfiguration )
+  {
+    BufferSize = mSKVConfiguration->GetClientBulkInsertBufferSize();
+    BuffersPerNode = mSKVConfiguration->GetClientBulkInsertBuffers();
+  }
+
+  // the server streams each buffer in chunks, the size only has to fit the request
+  BufferSize = std::min( BufferSize, (uint64_t) INT_MAX );
+  BufferSize = std::max( BufferSize, (uint64_t) 4096 );
+  BuffersPerNode = std::max( BuffersPerNode, (uint64_t) 1 );
+
+  BegLogLine( SKV_CLIENT_BULK_INSERT_LOG )
+    << "skv_client_internal_t::CreateBulkInserter(): "
+    << " BufferSize: " << BufferSize
+    << " BuffersPerNode: " << BuffersPerNode
+    << EndLogLine;
+
   BulkInsertControlBlock->Init( mPZ_Hdl,
                                 aPDSId,
                                 aFlags,
-                                mConnMgrIF.GetServerConnCount() );
+                                mConnMgrIF.GetServerConnCount(),
+                                (int) BufferSize,
+                                (int) BuffersPerNode );
 
   *aBulkInserterHandle = BulkInsertControlBlock;
 
   return SKV_SUCCESS;
 }
 
+/***
+ * skv_client_internal_t::BulkInsertReap::
+ * Desc: Recycle the completed in-flight buffers of a server.
+ *       Buffers complete in ring order, so reaping stops at the first
+ *       one that's not done yet.
+ * input:
+ *   aBlock: wait for the oldest buffer if it's not done yet
+ * returns: SKV_SUCCESS or SKV_ERRNO_NOT_DONE if no buffer could be recycled
+ ***/
+skv_status_t
+skv_client_internal_t::
+BulkInsertReap( skv_client_bulk_inserter_hdl_t         aBulkInserterHandle,
+                skv_client_bulk_insert_buffer_list_t*  aBufferList,
+                bool                                    aBlock )
+{
+  skv_status_t status = SKV_ERRNO_NOT_DONE;
+
+  while( aBufferList->mPendingCount > 0 )
+  {
+    skv_client_bulk_insert_buffer_t* Buffer = aBufferList->mOldestPending;
+
+    skv_status_t wstatus = aBlock ? Wait( Buffer->mCommandHandle ) : Test( Buffer->mCommandHandle );
+    if( wstatus == SKV_ERRNO_NOT_DONE )
+      break;
+
+    if( wstatus == SKV_ERRNO_RECORD_ALREADY_EXISTS )
+    {
+      BegLogLine( 1 )
+        << "skv_client_internal_t::BulkInsertReap(): WARNING: "
+        << " Buffer: " << (void *) Buffer
+        << " wstatus: " << skv_status_to_string( wstatus )
+        << EndLogLine;
+    }
+    else if( wstatus != SKV_SUCCESS )
+    {
+      BegLogLine( 1 )
+        << "skv_client_internal_t::BulkInsertReap(): ERROR: "
+        << " Buffer: " << (void *) Buffer
+        << " DispatchSeq: " << Buffer->mDispatchSeq
+        << " wstatus: " << skv_status_to_string( wstatus )
+        << EndLogLine;
+
+      if( aBulkInserterHandle->mStatus == SKV_SUCCESS )
+        aBulkInserterHandle->mStatus = wstatus;
+    }
+
+    Buffer->mState = SKV_CLIENT_BULK_INSERTER_BUFFER_STATE_READY;
+    Buffer->mCurrentIndex = 0;
+
+    aBufferList->mOldestPending = aBufferList->NextInRing( Buffer );
+    aBufferList->mPendingCount--;
+
+    // only block for one buffer, pick up the others if they're done
+    aBlock = false;
+    status = SKV_SUCCESS;
+  }
+
+  return status;
+}
+
+/***
+ * skv_client_internal_t::BulkInsertDispatch::
+ * Desc: Send the current buffer of a server and move on to the next
+ *       buffer of the ring. Doesn't wait for any completion.
+ * input:
+ * returns: SKV_SUCCESS on success or error code
+ ***/
+skv_status_t
+skv_client_internal_t::
+BulkInsertDispatch( skv_client_bulk_inserter_hdl_t         aBulkInserterHandle,
+                    int                                     aNodeId,
+                    skv_client_bulk_insert_buffer_list_t*  aBufferList )
+{
+  skv_client_bulk_insert_buffer_t* Buffer = aBufferList->mCurrentBuffer;
+
+  AssertLogLine( Buffer->mState == SKV_CLIENT_BULK_INSERTER_BUFFER_STATE_READY &&
+                 Buffer->mCurrentIndex > 0 )
+    << "skv_client_internal_t::BulkInsertDispatch(): ERROR: "
+    << " Buffer: " << (void *) Buffer
+    << " mState: " << Buffer->mState
+    << " mCurrentIndex: " << Buffer->mCurrentIndex
+    << EndLogLine;
+
+  if( aBulkInserterHandle->mFlags & SKV_BULK_INSERTER_FLAGS_SORTED )
+  {
+    int Rows = skv_bulk_insert_sort( Buffer->mBufferData,
+                                     Buffer->mCurrentIndex,
+                                     aBulkInserterHandle->mSortBuffer );
+
+    BegLogLine( SKV_CLIENT_BULK_INSERT_LOG )
+      << "skv_client_internal_t::BulkInsertDispatch(): sorted "
+      << " Rows: " << Rows
+      << " Bytes: " << Buffer->mCurrentIndex
+      << EndLogLine;
+  }
+
+  skv_status_t bulk_status;
+  do
+  {
+    bulk_status = iBulkInsert( aNodeId,
+                               &aBulkInserterHandle->mPDSId,
+                               Buffer->mBufferData,
+                               Buffer->mCurrentIndex,
+                               Buffer->mBufferLMR,
+                               Buffer->mBufferRMR,
+                               aBulkInserterHandle->mFlags,
+                               &Buffer->mCommandHandle );
+
+    // out of command slots: recycle whatever is done and retry
+    if( bulk_status == SKV_ERRNO_COMMAND_LIMIT_REACHED )
+    {
+      mConnMgrIF.ProcessConnectionsRqSq();
+      for( int i = 0; i < aBulkInserterHandle->mServerNodeCount; i++ )
+        BulkInsertReap( aBulkInserterHandle,
+                        &aBulkInserterHandle->mBufferListPerServer[ i ],
+                        false );
+    }
+  } while( bulk_status == SKV_ERRNO_COMMAND_LIMIT_REACHED );
+
+  if( bulk_status != SKV_SUCCESS )
+  {
+    BegLogLine( 1 )
+      << "skv_client_internal_t::BulkInsertDispatch(): ERROR: "
+      << " NodeId: " << aNodeId
+      << " bulk_status: " << skv_status_to_string( bulk_status )
+      << EndLogLine;
+
+    return bulk_status;
+  }
+
+  Buffer->mState = SKV_CLIENT_BULK_INSERTER_BUFFER_STATE_PENDING;
+  Buffer->mDispatchSeq = ++aBulkInserterHandle->mDispatchSeq;
+
+  aBufferList->mPendingCount++;
+  aBufferList->mCurrentBuffer = aBufferList->NextInRing( Buffer );
+
+  BegLogLine( SKV_CLIENT_BULK_INSERT_LOG )
+    << "skv_client_internal_t::BulkInsertDispatch(): "
+    << " NodeId: " << aNodeId
+    << " Buffer: " << (void *) Buffer
+    << " DispatchSeq: " << Buffer->mDispatchSeq
+    << " PendingCount: " << aBufferList->mPendingCount
+    << EndLogLine;
+
+  return SKV_SUCCESS;
+}
+
 skv_status_t
 skv_client_internal_t::
 Insert( skv_client_bulk_inserter_hdl_t                  aBulkInserterHandle,
@@ -265,82 +431,57 @@ Insert( skv_client_bulk_inserter_hdl_t                  aBulkInserterHandle,
 
   skv_client_bulk_insert_buffer_t*      Buffer     = BufferList->mCurrentBuffer;
 
-  int   CurrentIndex   = Buffer->mCurrentIndex;
-  char* BufferDataPtr  = Buffer->mBufferData;
+  if( TotalSize > Buffer->mBufferSize )
+  {
+    BegLogLine( 1 )
+      << "skv_client_internal_t::Insert(): ERROR: record doesn't fit into a bulk insert buffer."
+      << " Please increase the bulk insert buffer size."
+      << " TotalSize: " << TotalSize
+      << " Buffer->mBufferSize: " << Buffer->mBufferSize
+      << EndLogLine;
+
+    return SKV_ERRNO_VALUE_TOO_LARGE;
+  }
 
   BegLogLine( SKV_CLIENT_BULK_INSERT_LOG )
     << "skv_client_internal_t::Insert(): "
     << " NodeId: " << NodeId
     << " TotalSize: " << TotalSize
-    << " CurrentIndex: " << CurrentIndex
+    << " CurrentIndex: " << Buffer->mCurrentIndex
     << " Buffer->mBufferSize: " << Buffer->mBufferSize
-    << " BufferDataPtr: " << BufferDataPtr
     << " BufferList->mCurrentBuffer: " << BufferList->mCurrentBuffer
+    << " BufferList->mPendingCount: " << BufferList->mPendingCount
     << " Buffer: " << (void *) Buffer
     << " BufferList: " << (void *) BufferList
     << EndLogLine;
 
-  if( CurrentIndex + TotalSize > Buffer->mBufferSize )
+  if( Buffer->mState == SKV_CLIENT_BULK_INSERTER_BUFFER_STATE_READY &&
+      Buffer->mCurrentIndex + TotalSize > Buffer->mBufferSize )
   {
-    AssertLogLine( CurrentIndex > 0 )
-      << "skv_client_internal_t::Insert(): ERROR: Buffer size is smaller the first element."
-      << " Please increase the bulk insert buffer size."
-      << EndLogLine;
-
-    skv_status_t bulk_status = iBulkInsert( NodeId,
-                                            &aBulkInserterHandle->mPDSId,
-                                            BufferDataPtr,
-                                            CurrentIndex,
-                                            Buffer->mBufferLMR,
-                                            Buffer->mBufferRMR,
-                                            &Buffer->mCommandHandle );
-
-    Buffer->mState = SKV_CLIENT_BULK_INSERTER_BUFFER_STATE_PENDING;
-
-    AssertLogLine( bulk_status == SKV_SUCCESS )
-      << "skv_client_internal_t::Insert(): ERROR: "
-      << " bulk_status: " << skv_status_to_string( bulk_status )
-      << EndLogLine;
-
-    if( BufferList->mCurrentBuffer->mNext == NULL )
-    {
-      BufferList->mCurrentBuffer = BufferList->mHead;
-    }
-    else
-    {
-      BufferList->mCurrentBuffer = BufferList->mCurrentBuffer->mNext;
-    }
+    skv_status_t bulk_status = BulkInsertDispatch( aBulkInserterHandle, NodeId, BufferList );
+    if( bulk_status != SKV_SUCCESS )
+      return bulk_status;
 
     Buffer = BufferList->mCurrentBuffer;
+  }
 
-    if( Buffer->mState == SKV_CLIENT_BULK_INSERTER_BUFFER_STATE_PENDING )
-    {
-      skv_status_t wstatus = Wait( Buffer->mCommandHandle );
-
-      if( wstatus == SKV_ERRNO_RECORD_ALREADY_EXISTS )
-      {
-        BegLogLine( 1 )
-          << "skv_client_internal_t::Flush(): WARNING: "
-          << " Buffer: " << (void *) Buffer
-          << " wstatus: " << skv_status_to_string( wstatus )
-          << EndLogLine;
-      }
-      else
-      AssertLogLine( wstatus == SKV_SUCCESS )
-        << "skv_client_internal_t::Insert(): ERROR: "
-        << " wstatus: " << skv_status_to_string( wstatus )
-        << EndLogLine;
-
-      // 	  if( wstatus != SKV_SUCCESS )
-      // 	    return wstatus;
-
-      Buffer->mState = SKV_CLIENT_BULK_INSERTER_BUFFER_STATE_READY;
-    }
+  /*****************************************
+   * The current buffer is only in flight if all buffers of
+   * this server are. Try to recycle without blocking first.
+   *****************************************/
+  if( Buffer->mState == SKV_CLIENT_BULK_INSERTER_BUFFER_STATE_PENDING )
+  {
+    if( BulkInsertReap( aBulkInserterHandle, BufferList, false ) != SKV_SUCCESS )
+      BulkInsertReap( aBulkInserterHandle, BufferList, true );
 
-    Buffer->mCurrentIndex = 0;
-    BufferDataPtr = Buffer->mBufferData;
+    AssertLogLine( Buffer->mState == SKV_CLIENT_BULK_INSERTER_BUFFER_STATE_READY )
+      << "skv_client_internal_t::Insert(): ERROR: buffer still in flight"
+      << " Buffer: " << (void *) Buffer
+      << EndLogLine;
   }
 
+  char* BufferDataPtr = Buffer->mBufferData;
+
   int TotalLength = skv_bulk_insert_pack( &BufferDataPtr[Buffer->mCurrentIndex],
                                           aKeyBuffer,
                                           aKeyBufferSize,
@@ -365,107 +506,147 @@ Insert( skv_client_bulk_inserter_hdl_t                  aBulkInserterHandle,
   return SKV_SUCCESS;
 }
 
+/***
+ * skv_client_internal_t::iFlush::
+ * Desc: Send all partially filled buffers without waiting for completion.
+ *       Inserts can continue into the remaining buffers of the ring.
+ * input:
+ * returns: SKV_SUCCESS and a handle for TestFlush()/WaitFlush() that
+ *          covers everything inserted before this call
+ ***/
 skv_status_t
 skv_client_internal_t::
-Flush( skv_client_bulk_inserter_hdl_t aBulkInserterHandle )
+iFlush( skv_client_bulk_inserter_hdl_t   aBulkInserterHandle,
+        skv_client_bulk_flush_hdl_t*     aFlushHandle )
 {
   BegLogLine( SKV_CLIENT_BULK_INSERT_FLUSH_LOG )
-    << "skv_client_internal_t::Flush(): Entering... "
+    << "skv_client_internal_t::iFlush(): Entering... "
     << " aBulkInserterHandle: " << (void *) aBulkInserterHandle
     << EndLogLine;
 
-  /****
-   * Trigger inserts of all the bulk load buffers
-   ***/
+  skv_status_t status = SKV_SUCCESS;
 
+  // only the current buffer of a server can hold unsent data
   int ServerNodeCount = aBulkInserterHandle->mServerNodeCount;
   for( int i = 0; i < ServerNodeCount; i++ )
   {
     skv_client_bulk_insert_buffer_list_t* BufferList = &aBulkInserterHandle->mBufferListPerServer[i];
 
-    skv_client_bulk_insert_buffer_t* Buffer = BufferList->mHead;
+    skv_client_bulk_insert_buffer_t* Buffer = BufferList->mCurrentBuffer;
 
-    while( Buffer != NULL )
+    if( (Buffer->mState != SKV_CLIENT_BULK_INSERTER_BUFFER_STATE_PENDING) &&
+        (Buffer->mCurrentIndex > 0) )
     {
-      if( (Buffer->mState != SKV_CLIENT_BULK_INSERTER_BUFFER_STATE_PENDING) &&
-          (Buffer->mCurrentIndex > 0) )
-      {
-        skv_status_t bulk_status = iBulkInsert( i,
-                                                &aBulkInserterHandle->mPDSId,
-                                                Buffer->mBufferData,
-                                                Buffer->mCurrentIndex,
-                                                Buffer->mBufferLMR,
-                                                Buffer->mBufferRMR,
-                                                &Buffer->mCommandHandle );
-
-        AssertLogLine( bulk_status == SKV_SUCCESS )
-          << "skv_client_internal_t::Flush(): ERROR: "
-          << " bulk_status: " << skv_status_to_string( bulk_status )
-          << EndLogLine;
-
-        Buffer->mState = SKV_CLIENT_BULK_INSERTER_BUFFER_STATE_PENDING;
-      }
-
-      Buffer = Buffer->mNext;
+      skv_status_t bulk_status = BulkInsertDispatch( aBulkInserterHandle, i, BufferList );
+      if( bulk_status != SKV_SUCCESS && status == SKV_SUCCESS )
+        status = bulk_status;
     }
   }
 
-  /****
-   * Make sure that all the buffers are completed
-   ***/
+  *aFlushHandle = aBulkInserterHandle->mDispatchSeq;
+
+  BegLogLine( SKV_CLIENT_BULK_INSERT_FLUSH_LOG )
+    << "skv_client_internal_t::iFlush(): Leaving "
+    << " FlushHandle: " << *aFlushHandle
+    << " status: " << skv_status_to_string( status )
+    << EndLogLine;
+
+  return status;
+}
+
+/***
+ * skv_client_internal_t::TestFlush::
+ * Desc: Check if all buffers covered by a flush handle are done
+ * input:
+ * returns: SKV_ERRNO_NOT_DONE while buffers are in flight,
+ *          otherwise SKV_SUCCESS or the first error of any buffer
+ ***/
+skv_status_t
+skv_client_internal_t::
+TestFlush( skv_client_bulk_inserter_hdl_t   aBulkInserterHandle,
+           skv_client_bulk_flush_hdl_t      aFlushHandle )
+{
+  skv_status_t status = aBulkInserterHandle->mStatus;
+
+  int ServerNodeCount = aBulkInserterHandle->mServerNodeCount;
   for( int i = 0; i < ServerNodeCount; i++ )
   {
     skv_client_bulk_insert_buffer_list_t* BufferList = &aBulkInserterHandle->mBufferListPerServer[i];
 
-    skv_client_bulk_insert_buffer_t* Buffer = BufferList->mHead;
+    BulkInsertReap( aBulkInserterHandle, BufferList, false );
+
+    if( BufferList->mPendingCount > 0 &&
+        BufferList->mOldestPending->mDispatchSeq <= aFlushHandle )
+      status = SKV_ERRNO_NOT_DONE;
+  }
+
+  if( status == SKV_ERRNO_NOT_DONE )
+    return status;
+
+  return aBulkInserterHandle->mStatus;
+}
+
+/***
+ * skv_client_internal_t::WaitFlush::
+ * Desc: Wait until all buffers covered by a flush handle are done
+ * input:
+ * returns: SKV_SUCCESS or the first error of any buffer
+ ***/
+skv_status_t
+skv_client_internal_t::
+WaitFlush( skv_client_bulk_inserter_hdl_t   aBulkInserterHandle,
+           skv_client_bulk_flush_hdl_t      aFlushHandle )
+{
+  // Wait() progresses all connections, so the buffers of the other
+  // servers keep completing while we wait on this one
+  int ServerNodeCount = aBulkInserterHandle->mServerNodeCount;
+  for( int i = 0; i < ServerNodeCount; i++ )
+  {
+    skv_client_bulk_insert_buffer_list_t* BufferList = &aBulkInserterHandle->mBufferListPerServer[i];
 
-    while( Buffer != NULL )
+    while( BufferList->mPendingCount > 0 &&
+           BufferList->mOldestPending->mDispatchSeq <= aFlushHandle )
     {
-      if( Buffer->mState == SKV_CLIENT_BULK_INSERTER_BUFFER_STATE_PENDING )
-      {
-        BegLogLine( SKV_CLIENT_BULK_INSERT_FLUSH_LOG )
-          << "skv_client_internal_t::Flush(): About to Wait "
-          << " Buffer->mCommandHandle: " << (void *) Buffer->mCommandHandle
-          << EndLogLine;
-
-        skv_status_t wait_status = Wait( Buffer->mCommandHandle );
-
-        BegLogLine( SKV_CLIENT_BULK_INSERT_FLUSH_LOG )
-          << "skv_client_internal_t::Flush(): Done waiting on "
-          << " Buffer->mCommandHandle: " << (void *) Buffer->mCommandHandle
-          << " wait_status: " << skv_status_to_string( wait_status )
-          << EndLogLine;
-#if 1
-        // 	      if( wait_status != SKV_SUCCESS )
-        // 		return wait_status;
-        if( wait_status == SKV_ERRNO_RECORD_ALREADY_EXISTS )
-        {
-          BegLogLine( 1 )
-            << "skv_client_internal_t::Flush(): WARNING: "
-            << " NodeId: " << i
-            << " Buffer: " << (void *) Buffer
-            << " wait_status: " << skv_status_to_string( wait_status )
-            << EndLogLine;
-        }
-        else
-          AssertLogLine( wait_status == SKV_SUCCESS )
-            << "skv_client_internal_t::Flush(): ERROR: "
-            << " wait_status: " << skv_status_to_string( wait_status )
-            << EndLogLine;
-#endif
-        Buffer->mState = SKV_CLIENT_BULK_INSERTER_BUFFER_STATE_READY;
-        Buffer->mCurrentIndex = 0;
-      }
+      BegLogLine( SKV_CLIENT_BULK_INSERT_FLUSH_LOG )
+        << "skv_client_internal_t::WaitFlush(): About to Wait "
+        << " NodeId: " << i
+        << " Buffer->mCommandHandle: " << (void *) BufferList->mOldestPending->mCommandHandle
+        << EndLogLine;
 
-      Buffer = Buffer->mNext;
+      BulkInsertReap( aBulkInserterHandle, BufferList, true );
     }
   }
 
+  BegLogLine( SKV_CLIENT_BULK_INSERT_FLUSH_LOG )
+    << "skv_client_internal_t::WaitFlush(): Leaving "
+    << " status: " << skv_status_to_string( aBulkInserterHandle->mStatus )
+    << EndLogLine;
+
+  return aBulkInserterHandle->mStatus;
+}
+
+skv_status_t
+skv_client_internal_t::
+Flush( skv_client_bulk_inserter_hdl_t aBulkInserterHandle )
+{
+  BegLogLine( SKV_CLIENT_BULK_INSERT_FLUSH_LOG )
+    << "skv_client_internal_t::Flush(): Entering... "
+    << " aBulkInserterHandle: " << (void *) aBulkInserterHandle
+    << EndLogLine;
+
+  skv_client_bulk_flush_hdl_t FlushHandle;
+  skv_status_t status = iFlush( aBulkInserterHandle, &FlushHandle );
+
+  skv_status_t wait_status = WaitFlush( aBulkInserterHandle, FlushHandle );
+  if( status == SKV_SUCCESS )
+    status = wait_status;
+
   BegLogLine( SKV_CLIENT_BULK_INSERT_FLUSH_LOG )
     << "skv_client_internal_t::Flush(): Leaving "
+    << " status: " << skv_status_to_string( status )
     << EndLogLine;
 
-  return SKV_SUCCESS;
+  return status;
 }
 
 skv_status_t
@@ -7,6 +7,11 @@
  *************************************************/
 
 /*
+ * Each server gets a ring of insert buffers. A full buffer is
+ * dispatched and filling continues in the next ready buffer of the ring
+ * while the previous ones are still in flight. Completions are reaped
+ * without blocking unless all buffers of a server are in flight.
+ *
  * Contributors:
  *     arayshu, lschneid - initial implementation
  */
@@ -14,11 +19,15 @@
 #ifndef __SKV_BULK_INSERTER_MANAGER_IF_HPP__
 #define __SKV_BULK_INSERTER_MANAGER_IF_HPP__
 
+// defaults, overridden by SKV_CLIENT_BULK_INSERT_BUFFER_SIZE/_BUFFERS in the config file
 #define SKV_CLIENT_BULK_INSERT_BUFFER_SIZE ( 64 * 1024 )
 #define SKV_CLIENT_BULK_INSERT_BUFFERS_PER_NODE ( 4 )
 // #define SKV_CLIENT_BULK_INSERT_BUFFER_SIZE ( 512 * 1024 )
 // #define SKV_CLIENT_BULK_INSERT_BUFFERS_PER_NODE ( 2 )
 
+// completes once all buffers dispatched up to (and including) this sequence number are done
+typedef uint64_t skv_client_bulk_flush_hdl_t;
+
 #ifndef SKV_BULK_INSERTER_MANAGER_IF_LOG
 #define SKV_BULK_INSERTER_MANAGER_IF_LOG ( 0 | SKV_LOGGING_ALL )
 #endif
@@ -37,6 +46,7 @@ struct skv_client_bulk_insert_buffer_t
   it_lmr_handle_t                               mBufferLMR;
 
   skv_client_cmd_hdl_t                         mCommandHandle;
+  uint64_t                                      mDispatchSeq;
 
   skv_client_bulk_insert_buffer_t*             mNext;
   skv_client_bulk_insert_buffer_t*             mPrev;
@@ -59,6 +69,7 @@ struct skv_client_bulk_insert_buffer_t
     mNext         = aNext;
     mPrev 	  = aPrev;
     mCurrentIndex = 0;
+    mDispatchSeq  = 0;
 
     BegLogLine( SKV_BULK_INSERTER_MANAGER_IF_LOG )
       << "skv_client_bulk_insert_buffer_t::Init(): "
@@ -81,6 +92,16 @@ struct skv_client_bulk_insert_buffer_list_t
 
   int                                mBufferCount;
 
+  // oldest in-flight buffer (ring order == dispatch order)
+  skv_client_bulk_insert_buffer_t*  mOldestPending;
+  int                                mPendingCount;
+
+  skv_client_bulk_insert_buffer_t*
+  NextInRing( skv_client_bulk_insert_buffer_t* aBuffer )
+  {
+    return ( aBuffer->mNext == NULL ) ? mHead : aBuffer->mNext;
+  }
+
   void
   Init( char*            aWorkingBuffer, 
         int              aSizePerBuffer, 
@@ -107,6 +128,8 @@ struct skv_client_bulk_insert_buffer_list_t
 
     mHead = (skv_client_bulk_insert_buffer_t *) aWorkingBuffer;
     mCurrentBuffer = mHead;
+    mOldestPending = mHead;
+    mPendingCount  = 0;
 
     skv_client_bulk_insert_buffer_t * Buffer  = (skv_client_bulk_insert_buffer_t *) (aWorkingBuffer);
 
@@ -145,6 +168,7 @@ struct skv_client_bulk_insert_buffer_list_t
   {
     mHead          = NULL;
     mCurrentBuffer = NULL;
+    mOldestPending = NULL;
   }  
 };
 
@@ -158,22 +182,32 @@ struct skv_client_bulk_insert_control_block_t
 
   skv_client_bulk_insert_buffer_list_t*    mBufferListPerServer;
 
-  int                                       mWorkingBufferSize;
+  size_t                                    mWorkingBufferSize;
   char*                                     mWorkingBuffer;
   it_lmr_handle_t                           mWorkingBuffer_LMRHdl;
   it_rmr_context_t                          mWorkingBuffer_RMRHdl;
 
+  uint64_t                                  mDispatchSeq;   // number of buffers dispatched so far
+  skv_status_t                              mStatus;        // first error of any buffer
+
+  char*                                     mSortBuffer;    // scratch for SKV_BULK_INSERTER_FLAGS_SORTED
+
 public:
 
   void
   Init( it_pz_handle_t                           aPZ_Hdl, 
         skv_pds_id_t*                           aPDSId,
         skv_bulk_inserter_flags_t               aFlags,
-        int                                      aServerNodeCount )
+        int                                      aServerNodeCount,
+        int                                      aBufferSize = SKV_CLIENT_BULK_INSERT_BUFFER_SIZE,
+        int                                      aBuffersPerNode = SKV_CLIENT_BULK_INSERT_BUFFERS_PER_NODE )
   {
     mFlags = aFlags;
     mPDSId = *aPDSId;
     mServerNodeCount = aServerNodeCount;
+    mDispatchSeq = 0;
+    mStatus = SKV_SUCCESS;
+    mSortBuffer = NULL;
 
     mBufferListPerServer = (skv_client_bulk_insert_buffer_list_t *) 
       malloc( sizeof( skv_client_bulk_insert_buffer_list_t ) * mServerNodeCount );
@@ -187,13 +221,15 @@ public:
     // double MultFactor        = 4.0 / aServerNodeCount;
     // double MultFactor        = 0.25;
     //int SizeOfBufferData     = (int) ( MultFactor * SKV_CLIENT_BULK_INSERT_BUFFER_SIZE );
-    int SizeOfBufferData     = SKV_CLIENT_BULK_INSERT_BUFFER_SIZE;
+    int SizeOfBufferData     = aBufferSize;
     int SizePerBuffer        = SizeOfBufferMetadata + SizeOfBufferData;
+    // keep the buffer headers aligned
+    SizePerBuffer            = ( SizePerBuffer + 7 ) & ~7;
 
-    int BuffersPerNodeCount  = SKV_CLIENT_BULK_INSERT_BUFFERS_PER_NODE;
+    int BuffersPerNodeCount  = aBuffersPerNode;
     int SizePerNode          = SizePerBuffer * BuffersPerNodeCount;
 
-    mWorkingBufferSize       = aServerNodeCount * SizePerNode;
+    mWorkingBufferSize       = (size_t) aServerNodeCount * SizePerNode;
     mWorkingBuffer           = (char *) malloc( mWorkingBufferSize );
 
     StrongAssertLogLine( mWorkingBuffer )
@@ -206,6 +242,16 @@ public:
       << " mWorkingBufferSize: " << mWorkingBufferSize
       << EndLogLine;
 
+    if( mFlags & SKV_BULK_INSERTER_FLAGS_SORTED )
+    {
+      mSortBuffer = (char *) malloc( SizeOfBufferData );
+
+      StrongAssertLogLine( mSortBuffer )
+        << "skv_client_bulk_insert_control_block_t::Init(): ERROR:: "
+        << " SizeOfBufferData: " << SizeOfBufferData
+        << EndLogLine;
+    }
+
     it_mem_priv_t privs     = (it_mem_priv_t) ( IT_PRIV_LOCAL | IT_PRIV_REMOTE );
     it_lmr_flag_t lmr_flags = IT_LMR_FLAG_NON_SHAREABLE;
 
@@ -227,7 +273,7 @@ public:
 
     for( int i = 0; i < mServerNodeCount; i++ )
       {
-        int WorkingBufferIndex = i * SizePerNode;
+        size_t WorkingBufferIndex = (size_t) i * SizePerNode;
 
         mBufferListPerServer[ i ].Init( & mWorkingBuffer[ WorkingBufferIndex ],
                                         SizePerBuffer,
@@ -257,6 +303,9 @@ public:
 
     free( mWorkingBuffer );
     mWorkingBuffer = NULL;
+
+    free( mSortBuffer );
+    mSortBuffer = NULL;
   }
 };
 
@@ -97,7 +97,7 @@ Test( skv_client_cmd_hdl_t aCmdHdl )
   // mConnMgrIF->ProcessConnections();
 
   skv_status_t status = SKV_SUCCESS;
-  if( aCmdHdl->mState == SKV_CLIENT_COMMAND_STATE_DONE )
+  if( aCmdHdl->GetState() == SKV_CLIENT_COMMAND_STATE_DONE )
   {
     status = aCmdHdl->mStatus;
     ReleaseAssumeDone( aCmdHdl );
@@ -125,16 +125,22 @@ skv_status_t
 skv_client_command_manager_if_t::
 WaitAny( skv_client_cmd_hdl_t* aCmdHdl )
 {
+  skv_client_wait_backoff_t Backoff( __atomic_load_n( &mPollSpinLimit, __ATOMIC_RELAXED ),
+                                     mPollMaxSleep );
   while( 1 )
   {
     skv_status_t status = TestAny( aCmdHdl );
 
     if( status == SKV_ERRNO_NOT_DONE )
     {
+      Backoff.Idle();
       continue;
     }
     else
+    {
+      AdaptSpinLimit( Backoff );
       return status;
+    }
   }
 
   return SKV_SUCCESS;
@@ -155,22 +161,24 @@ Wait( skv_client_cmd_hdl_t aCmdHdl )
     << "skv_client_internal_t::Wait():: Entering "
     << EndLogLine;
 
+  skv_client_wait_backoff_t Backoff( __atomic_load_n( &mPollSpinLimit, __ATOMIC_RELAXED ),
+                                     mPollMaxSleep );
   while( 1 )
   {
     skv_status_t status = Test( aCmdHdl );
 
     if( status == SKV_ERRNO_NOT_DONE )
     {
-      //sleep( 1 );
-
-      // sched_yield();
-
+      Backoff.Idle();
       continue;
     }
     else
     {
+      AdaptSpinLimit( Backoff );
+
       BegLogLine( SKV_CLIENT_WAIT_LOG )
         << "skv_client_internal_t::Wait():: Leaving status=" << status
+        << " polls: " << Backoff.GetPolls()
         << EndLogLine;
       return status;
     }
@@ -184,6 +192,77 @@ Wait( skv_client_cmd_hdl_t aCmdHdl )
 }
 
 
+/***
+ * skv_client_command_manager_if_t::SetCompletionHandler::
+ * Desc: attach a callback or completion queue to a pending command
+ * input:
+ * returns: SKV_SUCCESS on success or error code
+ ***/
+skv_status_t
+skv_client_command_manager_if_t::
+SetCompletionHandler( skv_client_cmd_hdl_t aCmdHdl,
+                      skv_client_completion_cb_t aCallback,
+                      skv_client_completion_queue_t* aCQ,
+                      void* aContext )
+{
+  if(( aCmdHdl == SKV_CLIENT_COMMAND_HANDLE_NULL ) ||
+     (( aCallback == NULL ) == ( aCQ == NULL )) )
+    return SKV_ERRNO_STATE_MACHINE_ERROR;
+
+  skv_status_t status = mCCBMgrIF->SetCompletionHandler( aCmdHdl, aCallback, aCQ, aContext );
+
+  BegLogLine( SKV_CLIENT_WAIT_LOG )
+    << "skv_client_command_manager_if_t::SetCompletionHandler():: "
+    << " CCB: " << (void*)aCmdHdl
+    << " callback: " << (void*)aCallback
+    << " CQ: " << (void*)aCQ
+    << " status: " << skv_status_to_string( status )
+    << EndLogLine;
+
+  // deliver right away if the command was already done
+  mCCBMgrIF->DeliverCompletions();
+  return status;
+}
+
+/***
+ * skv_client_command_manager_if_t::PollCompletionQueue::
+ * Desc: drive progress and fetch the next completion of aCQ
+ * input:
+ * returns: status of the completed command or SKV_ERRNO_NOT_DONE
+ ***/
+skv_status_t
+skv_client_command_manager_if_t::
+PollCompletionQueue( skv_client_completion_queue_t* aCQ,
+                     skv_client_cmd_hdl_t* aCmdHdl,
+                     void** aContext )
+{
+  skv_client_ccb_t* CCB = aCQ->Pop();
+  if( CCB == NULL )
+  {
+    mConnMgrIF->ProcessConnectionsRqSq();
+    CCB = aCQ->Pop();
+    if( CCB == NULL )
+      return SKV_ERRNO_NOT_DONE;
+  }
+
+  *aCmdHdl = CCB;
+  if( aContext != NULL )
+    *aContext = CCB->mCallbackContext;
+
+  skv_status_t status = CCB->mStatus;
+  mCCBMgrIF->AddToFreeCCBQueue( CCB );
+
+  return status;
+}
+
+skv_status_t
+skv_client_command_manager_if_t::
+Progress()
+{
+  mConnMgrIF->ProcessConnectionsRqSq();
+  return SKV_SUCCESS;
+}
+
 skv_status_t
 skv_client_command_manager_if_t::
 Dispatch( int aNodeId, skv_client_ccb_t* aCCB )
@@ -14,12 +14,80 @@
 #ifndef __SKV_CLIENT_COMMAND_MANAGER_IF_HPP__
 #define __SKV_CLIENT_COMMAND_MANAGER_IF_HPP__
 
+#include <sched.h>
+#include <unistd.h>
+#include <algorithm>
+
 typedef skv_client_ccb_t* skv_client_cmd_hdl_t;
 
 #define SKV_CLIENT_COMMAND_HANDLE_NULL ((skv_client_cmd_hdl_t) NULL)
 
+#define SKV_CLIENT_POLL_SPIN_MIN ( 64 )     // lower bound of the adaptive spin phase
+#define SKV_CLIENT_POLL_YIELD_LOOPS ( 16 )  // sched_yield() rounds between spinning and sleeping
+
+/***
+ * idle strategy of a single Wait()/WaitAny() call:
+ * spin for mSpinLimit empty polls, then yield, then sleep with
+ * exponential backoff up to mMaxSleep usec (0: keep spinning)
+ ***/
+class skv_client_wait_backoff_t
+{
+  uint64_t mSpinLimit;
+  uint64_t mMaxSleep;
+  uint64_t mPolls;
+  uint64_t mSleep;
+
+public:
+  skv_client_wait_backoff_t( uint64_t aSpinLimit, uint64_t aMaxSleep )
+  {
+    mSpinLimit = aSpinLimit;
+    mMaxSleep = aMaxSleep;
+    mPolls = 0;
+    mSleep = 0;
+  }
+
+  void
+  Idle()
+  {
+    mPolls++;
+    if(( mPolls <= mSpinLimit ) || ( mMaxSleep == 0 ))
+      return;
+
+    if( mPolls <= mSpinLimit + SKV_CLIENT_POLL_YIELD_LOOPS )
+    {
+      sched_yield();
+      return;
+    }
+
+    mSleep = ( mSleep == 0 ) ? 1 : std::min( mSleep * 2, mMaxSleep );
+    usleep( mSleep );
+  }
+
+  uint64_t GetPolls() const { return mPolls; }
+  bool SpinWasEnough() const { return mPolls <= mSpinLimit; }
+};
+
 class skv_client_command_manager_if_t
 {
+  uint64_t                                  mPollSpinLimit;    // adaptive, updated after each wait
+  uint64_t                                  mPollSpinMax;
+  uint64_t                                  mPollMaxSleep;
+
+  // moves the spin limit towards twice the polls of waits that completed
+  // while spinning and back to the minimum if the spinning was wasted
+  void
+  AdaptSpinLimit( const skv_client_wait_backoff_t& aBackoff )
+  {
+    int64_t Limit = __atomic_load_n( &mPollSpinLimit, __ATOMIC_RELAXED );
+    int64_t Target = aBackoff.SpinWasEnough() ? 2 * aBackoff.GetPolls() : SKV_CLIENT_POLL_SPIN_MIN;
+
+    Limit += ( Target - Limit ) / 8;
+    Limit = std::max( Limit, (int64_t)SKV_CLIENT_POLL_SPIN_MIN );
+    Limit = std::min( Limit, (int64_t)mPollSpinMax );
+
+    __atomic_store_n( &mPollSpinLimit, (uint64_t)Limit, __ATOMIC_RELAXED );
+  }
+
 public:
 
   skv_client_conn_manager_if_t*             mConnMgrIF;
@@ -27,10 +95,16 @@ public:
 
   void
   Init( skv_client_conn_manager_if_t*             aConnMgrIF,
-        skv_client_ccb_manager_if_t*              aCCBMgrIF )
+        skv_client_ccb_manager_if_t*              aCCBMgrIF,
+        uint64_t                                  aPollSpin = DEFAULT_SKV_CLIENT_POLL_SPIN,
+        uint64_t                                  aPollMaxSleep = DEFAULT_SKV_CLIENT_POLL_MAX_SLEEP )
   {
     mConnMgrIF = aConnMgrIF;
     mCCBMgrIF = aCCBMgrIF;
+
+    mPollSpinMax = std::max( aPollSpin, (uint64_t)SKV_CLIENT_POLL_SPIN_MIN );
+    mPollSpinLimit = mPollSpinMax;
+    mPollMaxSleep = aPollMaxSleep;
   }
 
   void  Finalize() {}
@@ -46,6 +120,18 @@ public:
 
   skv_status_t Test( skv_client_cmd_hdl_t aCmdHdl );
 
+  // completion handlers instead of Test/Wait
+  skv_status_t SetCompletionHandler( skv_client_cmd_hdl_t aCmdHdl,
+                                     skv_client_completion_cb_t aCallback,
+                                     skv_client_completion_queue_t* aCQ,
+                                     void* aContext );
+
+  skv_status_t PollCompletionQueue( skv_client_completion_queue_t* aCQ,
+                                    skv_client_cmd_hdl_t* aCmdHdl,
+                                    void** aContext );
+
+  skv_status_t Progress();
+
   skv_status_t Dispatch( int aNodeId, skv_client_ccb_t* aCCB );
 
   skv_status_t ReleaseAssumeDone( skv_client_cmd_hdl_t aCmdHdl );
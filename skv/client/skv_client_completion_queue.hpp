@@ -0,0 +1,122 @@
+/************************************************
+ * Copyright (c) IBM Corp. 2014
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * which accompanies this distribution, and is available at
+ * http://www.eclipse.org/legal/epl-v10.html
+ *************************************************/
+
+/*
+ * Completion queue for async client commands
+ *
+ * Completed commands that were attached to a queue are appended by the
+ * thread that drives the client progress. The eventfd stays readable
+ * as long as the queue is not empty, so it can be added to an epoll set
+ * (level triggered) of an application event loop.
+ */
+
+#ifndef __SKV_CLIENT_COMPLETION_QUEUE_HPP__
+#define __SKV_CLIENT_COMPLETION_QUEUE_HPP__
+
+#include <deque>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+
+#include <FxLogger.hpp>
+#include <skv/common/skv_errno.hpp>
+#include <skv/common/skv_mutex.hpp>
+
+#ifndef SKV_CLIENT_COMPLETION_QUEUE_LOG
+#define SKV_CLIENT_COMPLETION_QUEUE_LOG ( 0 )
+#endif
+
+struct skv_client_ccb_t;
+
+class skv_client_completion_queue_t
+{
+  skv_mutex_t                      mLock;
+  std::deque<skv_client_ccb_t*>    mCompleted;
+  int                              mEventFD;
+
+public:
+  skv_client_completion_queue_t() : mEventFD( -1 ) {}
+
+  skv_status_t
+  Init()
+  {
+    mEventFD = eventfd( 0, EFD_NONBLOCK | EFD_CLOEXEC );
+    if( mEventFD < 0 )
+    {
+      BegLogLine( 1 )
+        << "skv_client_completion_queue_t::Init(): ERROR: eventfd() failed"
+        << " errno: " << errno
+        << EndLogLine;
+      return SKV_ERRNO_UNSPECIFIED_ERROR;
+    }
+    return SKV_SUCCESS;
+  }
+
+  void
+  Finalize()
+  {
+    if( mEventFD >= 0 )
+      close( mEventFD );
+    mEventFD = -1;
+  }
+
+  int
+  GetEventFD() const
+  {
+    return mEventFD;
+  }
+
+  // the eventfd counter is only touched on empty <-> non-empty transitions
+  void
+  Push( skv_client_ccb_t* aCCB )
+  {
+    mLock.lock();
+    mCompleted.push_back( aCCB );
+    if( mCompleted.size() == 1 )
+    {
+      uint64_t one = 1;
+      ssize_t rc = write( mEventFD, &one, sizeof( one ) );
+
+      AssertLogLine( rc == sizeof( one ) )
+        << "skv_client_completion_queue_t::Push(): ERROR: eventfd write failed"
+        << " errno: " << errno
+        << EndLogLine;
+    }
+    mLock.unlock();
+
+    BegLogLine( SKV_CLIENT_COMPLETION_QUEUE_LOG )
+      << "skv_client_completion_queue_t::Push(): "
+      << " CCB: " << (void*)aCCB
+      << " FD: " << mEventFD
+      << EndLogLine;
+  }
+
+  skv_client_ccb_t*
+  Pop()
+  {
+    skv_client_ccb_t* CCB = NULL;
+
+    mLock.lock();
+    if( !mCompleted.empty() )
+    {
+      CCB = mCompleted.front();
+      mCompleted.pop_front();
+      if( mCompleted.empty() )
+      {
+        uint64_t count;
+        ssize_t rc = read( mEventFD, &count, sizeof( count ) );
+        (void)rc;
+      }
+    }
+    mLock.unlock();
+
+    return CCB;
+  }
+};
+
+#endif // __SKV_CLIENT_COMPLETION_QUEUE_HPP__
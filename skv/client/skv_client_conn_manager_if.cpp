@@ -28,6 +28,7 @@
 #include <skv/client/commands/skv_client_retrieve_dist_command_sm.hpp>
 #include <skv/client/commands/skv_client_insert_command_sm.hpp>
 #include <skv/client/commands/skv_client_bulk_insert_command_sm.hpp>
+#include <skv/client/commands/skv_client_multi_key_command_sm.hpp>
 #include <skv/client/commands/skv_client_retrieve_command_sm.hpp>
 #include <skv/client/commands/skv_client_retrieve_n_keys_command_sm.hpp>
 #include <skv/client/commands/skv_client_remove_command_sm.hpp>
@@ -111,6 +112,8 @@ Init( skv_client_group_id_t         aClientGroupId,
 
   mServerConnCount = 0;
   mServerConns = NULL;
+  mActiveConns = NULL;
+  mActiveConnWords = 0;
 
   mCCBMgrIF = aCCBMgrIF;
 
@@ -125,6 +128,7 @@ Init( skv_client_group_id_t         aClientGroupId,
   mCookieSeq.mSeq = 0;
 
   mEventLoops = 0;
+  mLastActiveWord = 0;
 
   /************************************************************
    * Initialize the Event Dispatchers (evds)
@@ -271,6 +275,12 @@ Finalize()
     free( mServerConns );
     mServerConns = NULL;
   }
+
+  if( mActiveConns != NULL )
+  {
+    free( mActiveConns );
+    mActiveConns = NULL;
+  }
   return SKV_SUCCESS;
 }
 
@@ -392,6 +402,15 @@ Connect( const char* aConfigFile,
     << " bytes"
     << EndLogLine;
 
+  mActiveConnWords = ( mServerConnCount + 63 ) >> 6;
+  mActiveConns = (uint64_t *) calloc( mActiveConnWords, sizeof( uint64_t ) );
+
+  StrongAssertLogLine( mActiveConns != NULL )
+    << "skv_client_conn_manager_if_t::Connect():: ERROR: "
+    << " Not enough memory to allocate active connection mask for "
+    << mServerConnCount << " connections"
+    << EndLogLine;
+
   skv_server_addr_t* ServerAddrs = (skv_server_addr_t *) malloc( mServerConnCount * sizeof( skv_server_addr_t ) );
   StrongAssertLogLine( ServerAddrs != NULL )
     << "skv_client_conn_manager_if_t::Connect():: ERROR:: ServerAddrs != NULL"
@@ -552,7 +571,14 @@ Disconnect()
     mServerConns = NULL;
   }
 
+  if( mActiveConns != NULL )
+  {
+    free( mActiveConns );
+    mActiveConns = NULL;
+  }
+
   mServerConnCount = 0;
+  mActiveConnWords = 0;
 
   return SKV_SUCCESS;
 }
@@ -1116,6 +1142,9 @@ Dispatch( skv_client_server_conn_t*    aConn,
   // Set the command ordinal in the CCB
   aCCB->SetCmdOrd( CmdOrd );
 
+  // a response is pending from now on
+  SetConnActive( aConn );
+
   skv_client_to_server_cmd_hdr_t* Hdr = (skv_client_to_server_cmd_hdr_t *) aCCB->GetSendBuff();
   Hdr->SetCmdOrd( CmdOrd );
   BegLogLine(SKV_CLIENT_ENDIAN_LOG)
@@ -1231,7 +1260,11 @@ Dispatch( int                   aNodeId,
 
   skv_client_server_conn_t* Conn = & mServerConns[ aNodeId ];
 
-  return Dispatch( Conn, aCCB );
+  mProgressLock.lock();
+  skv_status_t status = Dispatch( Conn, aCCB );
+  mProgressLock.unlock();
+
+  return status;
 }
 
 /***
@@ -1337,6 +1370,11 @@ ProcessCCB( skv_client_server_conn_t*    aConn,
       status = skv_client_bulk_insert_command_sm::Execute( this, aConn, aCCB );
       break;
     }
+    case SKV_COMMAND_MULTI_KEY:
+    {
+      status = skv_client_multi_key_command_sm::Execute( this, aConn, aCCB );
+      break;
+    }
     case SKV_COMMAND_RETRIEVE:
     {
       status = skv_client_retrieve_command_sm::Execute( this, aConn, aCCB );
@@ -1538,6 +1576,43 @@ InitializeFromResponseData( skv_client_ccb_t* aCCB,
 
 #define SKV_CLIENT_SKIP_EVENT_CHECK ( (SKV_CLIENT_RQ_EVENTS_TO_DEQUEUE_COUNT>>1) )
 
+/***
+ * skv_client_conn_manager_if_t::ProcessResponses::
+ * Desc: reap up to SKV_CLIENT_RESPONSE_REAP_PER_EP responses of one connection
+ * returns: number of processed responses
+ ***/
+int
+skv_client_conn_manager_if_t::
+ProcessResponses( skv_client_server_conn_t* aConn )
+{
+  skv_server_to_client_cmd_hdr_t *RdmaHdr;
+
+  int commandsCount = 0;
+  while( ((RdmaHdr = aConn->CheckForNewResponse()) != NULL) &&
+         (commandsCount < SKV_CLIENT_RESPONSE_REAP_PER_EP) )   // run max one batch for one EP
+  {
+    skv_client_ccb_t *CCB = (skv_client_ccb_t *) RdmaHdr->mCmdCtrlBlk;
+
+    StrongAssertLogLine( CCB != NULL )
+      << "skv_client_conn_manager_if_t::ProcessResponses(): ERROR: CmdCtrlBlk = " << (void*)CCB
+      << " in response hdr @" << (void*)RdmaHdr
+      << " Cmd: " << RdmaHdr->mCmdType
+      << EndLogLine
+
+    InitializeFromResponseData( CCB, RdmaHdr );
+
+    ProcessCCB( aConn, CCB );
+
+    RdmaHdr->Reset();
+    aConn->ResponseSlotAdvance();
+
+    ProcessOverflow( aConn );
+
+    ++commandsCount;
+  }
+  return commandsCount;
+}
+
 skv_status_t
 skv_client_conn_manager_if_t::
 ProcessConnectionsRqSq()
@@ -1563,52 +1638,51 @@ ProcessConnectionsRqSq()
   //   << "skv_client_conn_manager_if_t::ProcessConnectionsRqSq(): Entering"
   //   << EndLogLine;
 
+  // another thread is already processing responses
+  if( mProgressLock.trylock() != 0 )
+  {
+    mCCBMgrIF->DeliverCompletions();
+    return SKV_SUCCESS;
+  }
+
   bool empty_poll = true;
   int DequeuedEventCount;
   it_status_t status;
-  static int last_server = 0;
 
+  // walk the active connections round robin starting with the word after the last one
+  // a connection only becomes active through Dispatch() under the progress lock,
+  // so an all-zero mask means there's no response to wait for
   for( int pollLoops=0;
       ( empty_poll ) && (pollLoops < SKV_CLIENT_RESPONSE_POLL_LOOPS);
       pollLoops++ )
   {
-    int server = last_server;
+    bool any_active = false;
 
-    do
+    for( int w = 0; w < mActiveConnWords; w++ )
     {
-      skv_client_server_conn_t& Connection = mServerConns[ server ];
-      skv_server_to_client_cmd_hdr_t *RdmaHdr;
+      int word = ( mLastActiveWord + w ) % mActiveConnWords;
+      uint64_t active = mActiveConns[ word ];
 
-      int commandsCount = 0;
-      while( ((RdmaHdr = Connection.CheckForNewResponse()) != NULL) &&
-             (commandsCount < SKV_CLIENT_RESPONSE_REAP_PER_EP) )   // run max one batch for one EP
+      while( active != 0 )
       {
-        skv_client_ccb_t *CCB = (skv_client_ccb_t *) RdmaHdr->mCmdCtrlBlk;
-
-        StrongAssertLogLine( CCB != NULL )
-          << "skv_client_conn_manager_if_t::ProcessConnectionsRqSq(): ERROR: CmdCtrlBlk = " << (void*)CCB
-          << " in response hdr @" << (void*)RdmaHdr
-          << " Cmd: " << RdmaHdr->mCmdType
-          << EndLogLine
-
-        InitializeFromResponseData( CCB, RdmaHdr );
-
-        ProcessCCB( &Connection, CCB );
-
-        RdmaHdr->Reset();
-        Connection.ResponseSlotAdvance();
+        int bit = __builtin_ctzll( active );
+        active &= active - 1;
+        any_active = true;
 
-        ProcessOverflow( &Connection );
+        int server = ( word << 6 ) + bit;
+        if( ProcessResponses( &mServerConns[ server ] ) > 0 )
+          empty_poll = false;
 
-        ++commandsCount;
-        empty_poll = false;
+        if( mServerConns[ server ].mUnretiredRecvCount == 0 )
+          ClearConnActive( server );
       }
-
-      server = (server+1) % mServerConnCount;
     }
-    while( ( server != last_server ) );
 
-    last_server = server;
+    if( mActiveConnWords > 0 )
+      mLastActiveWord = ( mLastActiveWord + 1 ) % mActiveConnWords;
+
+    if( !any_active )
+      break;
   }
 
   mEventLoops++;
@@ -1639,6 +1713,11 @@ ProcessConnectionsRqSq()
       << " DequeuedEventCount: " << DequeuedEventCount
       << EndLogLine;
   }
+
+  mProgressLock.unlock();
+
+  // handlers may issue new commands, so they run without the progress lock
+  mCCBMgrIF->DeliverCompletions();
   return SKV_SUCCESS;
 }
 
@@ -69,6 +69,35 @@ class skv_client_conn_manager_if_t
 
   skv_client_ccb_manager_if_t* mCCBMgrIF;
 
+  /***
+   * serializes posting of requests and the progress engine
+   * (connection state, response slots, overflow queues)
+   * client threads that wait for completions don't block on it, they
+   * either run the progress engine or check their own ccb state
+   ***/
+  skv_mutex_t                   mProgressLock;
+  int                           mLastActiveWord;
+
+  /***
+   * one bit per server connection with unretired commands
+   * the progress engine only polls the response slots of those
+   * (protected by mProgressLock)
+   ***/
+  uint64_t*                     mActiveConns;
+  int                           mActiveConnWords;
+
+  inline void SetConnActive( skv_client_server_conn_t* aConn )
+  {
+    int Index = aConn - mServerConns;
+    mActiveConns[ Index >> 6 ] |= ( 1ull << ( Index & 63 ) );
+  }
+  inline void ClearConnActive( int aIndex )
+  {
+    mActiveConns[ aIndex >> 6 ] &= ~( 1ull << ( aIndex & 63 ) );
+  }
+
+  int ProcessResponses( skv_client_server_conn_t* aConn );
+
   skv_status_t ConnectToServer( int                        aServerRank,
                                  skv_server_addr_t         aServerAddr,
                                  skv_client_server_conn_t* aServerConn );
@@ -145,7 +145,8 @@ Init( skv_client_group_id_t aCommGroupId,
   /************************************************************
    * Initialize the manager of command control blocks
    ***********************************************************/
-  mCCBMgrIF.Init( mPZ_Hdl );
+  mCCBMgrIF.Init( mPZ_Hdl,
+                  mSKVConfiguration ? mSKVConfiguration->GetClientMRCacheSize() : 0 );
   /***********************************************************/
 
   /************************************************************
@@ -162,7 +163,10 @@ Init( skv_client_group_id_t aCommGroupId,
   /************************************************************
    * Initialize the cursor manager
    ***********************************************************/
-  mCommandMgrIF.Init( & mConnMgrIF, & mCCBMgrIF );
+  mCommandMgrIF.Init( & mConnMgrIF,
+                      & mCCBMgrIF,
+                      mSKVConfiguration ? mSKVConfiguration->GetClientPollSpin() : DEFAULT_SKV_CLIENT_POLL_SPIN,
+                      mSKVConfiguration ? mSKVConfiguration->GetClientPollMaxSleep() : DEFAULT_SKV_CLIENT_POLL_MAX_SLEEP );
   /***********************************************************/
 
   BegLogLine( SKV_CLIENT_INIT_LOG )
@@ -498,7 +502,7 @@ iRetrieve( skv_pds_id_t*          aPDSId,
              aKeyBuffer,
              aValueBufferSize,
              aValueBuffer,
-             mPZ_Hdl,
+             mCCBMgrIF.GetMRCache(),
              & KeyLMR,
              & ValueLMR );
   /*****************************************************/
@@ -639,7 +643,7 @@ iUpdate( skv_pds_id_t*          aPDSId,
              aKeyBuffer,
              aValueUpdateSize,
              aValueBuffer,
-             mPZ_Hdl,
+             mCCBMgrIF.GetMRCache(),
              & KeyLMR,
              & ValueLMR );
   /*****************************************************/
@@ -775,7 +779,7 @@ iInsert( skv_pds_id_t*          aPDSId,
              aKeyBuffer,
              aValueBufferSize,
              aValueBuffer,
-             mPZ_Hdl,
+             mCCBMgrIF.GetMRCache(),
              & KeyLMR,
              & ValueLMR );
   Req->EndianConvert() ;
@@ -1024,6 +1028,111 @@ Wait( skv_client_cmd_hdl_t aCmdHdl )
   return mCommandMgrIF.Wait( aCmdHdl );
 }
 
+/***
+ * skv_client_internal_t::SetCompletionCallback::
+ * Desc: Run aCallback when the command completes
+ * input:
+ * returns: SKV_SUCCESS on success or error code
+ ***/
+skv_status_t
+skv_client_internal_t::
+SetCompletionCallback( skv_client_cmd_hdl_t aCmdHdl,
+                       skv_client_completion_cb_t aCallback,
+                       void* aContext )
+{
+  return mCommandMgrIF.SetCompletionHandler( aCmdHdl, aCallback, NULL, aContext );
+}
+
+/***
+ * skv_client_internal_t::CreateCompletionQueue::
+ * Desc: Create a completion queue with an eventfd
+ * input:
+ * returns: SKV_SUCCESS on success or error code
+ ***/
+skv_status_t
+skv_client_internal_t::
+CreateCompletionQueue( skv_client_completion_queue_t** aCQ, int* aEventFD )
+{
+  skv_client_completion_queue_t* CQ = new skv_client_completion_queue_t;
+
+  skv_status_t status = CQ->Init();
+  if( status != SKV_SUCCESS )
+  {
+    delete CQ;
+    return status;
+  }
+
+  *aCQ = CQ;
+  if( aEventFD != NULL )
+    *aEventFD = CQ->GetEventFD();
+
+  return SKV_SUCCESS;
+}
+
+/***
+ * skv_client_internal_t::DestroyCompletionQueue::
+ * Desc: Release a completion queue, undelivered commands are released too
+ * Commands that are still pending must not reference the queue any more
+ * input:
+ * returns: SKV_SUCCESS on success or error code
+ ***/
+skv_status_t
+skv_client_internal_t::
+DestroyCompletionQueue( skv_client_completion_queue_t* aCQ )
+{
+  skv_client_ccb_t* CCB;
+  while( ( CCB = aCQ->Pop() ) != NULL )
+    mCCBMgrIF.AddToFreeCCBQueue( CCB );
+
+  aCQ->Finalize();
+  delete aCQ;
+
+  return SKV_SUCCESS;
+}
+
+/***
+ * skv_client_internal_t::SetCompletionQueue::
+ * Desc: Queue the command to aCQ when it completes
+ * input:
+ * returns: SKV_SUCCESS on success or error code
+ ***/
+skv_status_t
+skv_client_internal_t::
+SetCompletionQueue( skv_client_cmd_hdl_t aCmdHdl,
+                    skv_client_completion_queue_t* aCQ,
+                    void* aContext )
+{
+  return mCommandMgrIF.SetCompletionHandler( aCmdHdl, NULL, aCQ, aContext );
+}
+
+/***
+ * skv_client_internal_t::PollCompletionQueue::
+ * Desc: Fetch the next completed command from aCQ
+ * input:
+ * returns: status of the command or SKV_ERRNO_NOT_DONE
+ ***/
+skv_status_t
+skv_client_internal_t::
+PollCompletionQueue( skv_client_completion_queue_t* aCQ,
+                     skv_client_cmd_hdl_t* aCmdHdl,
+                     void** aContext )
+{
+  return mCommandMgrIF.PollCompletionQueue( aCQ, aCmdHdl, aContext );
+}
+
+/***
+ * skv_client_internal_t::Progress::
+ * Desc: Process responses and deliver completions
+ * input:
+ * returns: SKV_SUCCESS on success or error code
+ ***/
+skv_status_t
+skv_client_internal_t::
+Progress()
+{
+  return mCommandMgrIF.Progress();
+}
+
 /***
  * skv_client_internal_t::Open::
  * Desc: Create or open a new PDS (partition data set)
@@ -1474,6 +1583,31 @@ DumpPersistentImage( char* aPath )
   return status;
 }
 
+/** \brief register a user buffer for RDMA transfers of large values
+ * param[in]  aBuffer   start of the buffer
+ * param[in]  aSize     size of the buffer
+ *
+ * \return returns SKV_SUCCESS or error code
+ */
+skv_status_t
+skv_client_internal_t::
+RegisterMemory( void* aBuffer, size_t aSize )
+{
+  return mCCBMgrIF.GetMRCache()->Register( aBuffer, aSize );
+}
+
+/** \brief drop all registrations overlapping a user buffer
+ * has to be called before the memory gets freed or unmapped
+ *
+ * \return returns SKV_SUCCESS or SKV_ERRNO_ELEM_NOT_FOUND
+ */
+skv_status_t
+skv_client_internal_t::
+DeregisterMemory( void* aBuffer, size_t aSize )
+{
+  return mCCBMgrIF.GetMRCache()->Deregister( aBuffer, aSize );
+}
+
 skv_status_t
 skv_client_internal_t::
 Finalize()
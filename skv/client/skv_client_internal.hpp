@@ -98,8 +98,40 @@ class skv_client_internal_t
                              int aBufferSize,
                              it_lmr_handle_t aBufferLMR,
                              it_rmr_context_t aBufferRMR,
+                             skv_bulk_inserter_flags_t aFlags,
                              skv_client_ccb_t** aCCB);
 
+    skv_status_t BulkInsertDispatch(skv_client_bulk_inserter_hdl_t aBulkInserterHandle,
+                                    int aNodeId,
+                                    skv_client_bulk_insert_buffer_list_t* aBufferList);
+
+    skv_status_t BulkInsertReap(skv_client_bulk_inserter_hdl_t aBulkInserterHandle,
+                                skv_client_bulk_insert_buffer_list_t* aBufferList,
+                                bool aBlock);
+
+    skv_status_t iMultiKey(int aNodeId,
+                           skv_pds_id_t* aPDSId,
+                           skv_command_type_t aOp,
+                           skv_cmd_RIU_flags_t aFlags,
+                           int aKeyCount,
+                           char* aRequestBuffer,
+                           int aRequestSize,
+                           char* aResultBuffer,
+                           int aResultSize,
+                           it_lmr_handle_t aBufferLMR,
+                           skv_client_ccb_t** aCCB);
+
+    skv_status_t MultiKey(skv_command_type_t aOp,
+                          skv_pds_id_t* aPDSId,
+                          int aCount,
+                          char** aKeyBuffers,
+                          int* aKeyBufferSizes,
+                          char** aValueBuffers,
+                          int* aValueBufferSizes,
+                          int* aValueRetrievedSizes,
+                          skv_status_t* aStatus,
+                          skv_cmd_RIU_flags_t aFlags);
+
   public:
     skv_client_internal_t()
       {
@@ -164,6 +196,26 @@ class skv_client_internal_t
 
     skv_status_t PDScntl(skv_pdscntl_cmd_t aCmd, skv_pds_attr_t *aPDSAttr);
 
+    // Multi-key interface: one request per server, per-key status in aStatus
+    skv_status_t MultiRetrieve(skv_pds_id_t* aPDSId,
+                               int aCount,
+                               char** aKeyBuffers,
+                               int* aKeyBufferSizes,
+                               char** aValueBuffers,
+                               int* aValueBufferSizes,
+                               int* aValueRetrievedSizes,
+                               skv_status_t* aStatus,
+                               skv_cmd_RIU_flags_t aFlags);
+
+    skv_status_t MultiInsert(skv_pds_id_t* aPDSId,
+                             int aCount,
+                             char** aKeyBuffers,
+                             int* aKeyBufferSizes,
+                             char** aValueBuffers,
+                             int* aValueBufferSizes,
+                             skv_status_t* aStatus,
+                             skv_cmd_RIU_flags_t aFlags);
+
     // Async interface
     skv_status_t iOpen(char* aPDSName,
                        skv_pds_priv_t aPrivs,
@@ -222,6 +274,25 @@ class skv_client_internal_t
 
     skv_status_t Test(skv_client_cmd_hdl_t aCmdHdl);
 
+    // Completion notification
+    skv_status_t SetCompletionCallback(skv_client_cmd_hdl_t aCmdHdl,
+                                       skv_client_completion_cb_t aCallback,
+                                       void* aContext);
+
+    skv_status_t CreateCompletionQueue(skv_client_completion_queue_t** aCQ, int* aEventFD);
+
+    skv_status_t DestroyCompletionQueue(skv_client_completion_queue_t* aCQ);
+
+    skv_status_t SetCompletionQueue(skv_client_cmd_hdl_t aCmdHdl,
+                                    skv_client_completion_queue_t* aCQ,
+                                    void* aContext);
+
+    skv_status_t PollCompletionQueue(skv_client_completion_queue_t* aCQ,
+                                     skv_client_cmd_hdl_t* aCmdHdl,
+                                     void** aContext);
+
+    skv_status_t Progress();
+
     /******************************************************************************
      * Pure Key / Value Cursor Interface
      *****************************************************************************/
@@ -291,6 +362,15 @@ class skv_client_internal_t
 
     skv_status_t Flush(skv_client_bulk_inserter_hdl_t aBulkInserterHandle);
 
+    skv_status_t iFlush(skv_client_bulk_inserter_hdl_t aBulkInserterHandle,
+                        skv_client_bulk_flush_hdl_t* aFlushHandle);
+
+    skv_status_t TestFlush(skv_client_bulk_inserter_hdl_t aBulkInserterHandle,
+                           skv_client_bulk_flush_hdl_t aFlushHandle);
+
+    skv_status_t WaitFlush(skv_client_bulk_inserter_hdl_t aBulkInserterHandle,
+                           skv_client_bulk_flush_hdl_t aFlushHandle);
+
     skv_status_t CloseBulkInserter(skv_client_bulk_inserter_hdl_t aBulkInserterHandle);
     /*****************************************************************************/
 
@@ -301,5 +381,9 @@ class skv_client_internal_t
     skv_status_t DumpPDS(skv_pds_id_t aPDSId, int aMaxKeySize, int aMaxValueSize);
 
     skv_status_t DumpPersistentImage(char* aPath);
+
+    // Memory registration
+    skv_status_t RegisterMemory(void* aBuffer, size_t aSize);
+    skv_status_t DeregisterMemory(void* aBuffer, size_t aSize);
   };
 #endif
@@ -0,0 +1,463 @@
+/************************************************
+ * Copyright (c) IBM Corp. 2014
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * which accompanies this distribution, and is available at
+ * http://www.eclipse.org/legal/epl-v10.html
+ *************************************************/
+
+/*
+ * skv_client_mr_cache.hpp
+ *
+ * Keeps the memory registrations (LMR) of user buffers of large
+ * insert/retrieve requests so that repeated requests from the same
+ * buffers don't pay it_lmr_create()/it_lmr_free() every time.
+ *
+ * Two kinds of entries:
+ *  - pinned: registered explicitly via Register(); they stay until
+ *    Deregister() or Finalize()
+ *  - cached: created on demand by Acquire(); idle entries are kept in
+ *    LRU order and evicted once the cached bytes exceed the limit.
+ *    With a limit of 0, on-demand registrations are freed at Release()
+ *    (previous behavior)
+ *
+ * The cache can't observe free()/munmap() of user memory. Applications
+ * that enable the cache have to call Deregister() for a buffer range
+ * before releasing it to the system. Entries that are in use by a
+ * pending request are only marked invalid and freed by the last Release().
+ */
+
+#ifndef SKV_CLIENT_MR_CACHE_HPP_
+#define SKV_CLIENT_MR_CACHE_HPP_
+
+#ifndef SKV_CLIENT_MR_CACHE_LOG
+#define SKV_CLIENT_MR_CACHE_LOG ( 0 | SKV_LOGGING_ALL )
+#endif
+
+#include <map>
+#include <list>
+#include <FxLogger.hpp>
+#include <it_api.h>
+#include <skv/common/skv_errno.hpp>
+#include <skv/common/skv_mutex.hpp>
+
+struct skv_client_mr_entry_t;
+
+typedef std::multimap< uintptr_t, skv_client_mr_entry_t* > skv_client_mr_range_map_t;
+typedef std::map< it_lmr_handle_t, skv_client_mr_entry_t* > skv_client_mr_lmr_map_t;
+typedef std::list< skv_client_mr_entry_t* > skv_client_mr_lru_t;
+
+struct skv_client_mr_entry_t
+{
+  uintptr_t                     mAddr;
+  size_t                        mLen;
+  it_lmr_handle_t               mLMR;
+
+  // rmr context of the endpoint this entry was last used with
+  it_ep_handle_t                mEP;
+  it_rmr_context_t              mRMR;
+
+  int                           mRefCount;
+  bool                          mPinned;
+  bool                          mValid;    // false: deregistered while in use
+
+  skv_client_mr_range_map_t::iterator mRangePos;
+  skv_client_mr_lru_t::iterator       mLRUPos;
+  bool                          mInLRU;
+
+  bool
+  Contains( uintptr_t aAddr, size_t aLen ) const
+  {
+    return ( aAddr >= mAddr ) && ( aAddr + aLen <= mAddr + mLen );
+  }
+
+  bool
+  Overlaps( uintptr_t aAddr, size_t aLen ) const
+  {
+    return ( aAddr < mAddr + mLen ) && ( mAddr < aAddr + aLen );
+  }
+};
+
+class skv_client_mr_cache_t
+{
+  it_pz_handle_t                mPZ_Hdl;
+  uint64_t                      mLimit;        // bytes of idle+busy cached entries, 0: no on-demand caching
+  uint64_t                      mCachedBytes;
+  size_t                        mMaxLen;       // longest registered range; bounds the lookup
+
+  skv_client_mr_range_map_t     mRanges;       // valid entries by start address
+  skv_client_mr_lmr_map_t       mEntries;      // all entries by LMR
+  skv_client_mr_lru_t           mLRU;          // idle cached entries, most recent first
+
+  uint64_t                      mHits;
+  uint64_t                      mMisses;
+  uint64_t                      mEvictions;
+
+  // requests are issued by client threads and released by the progressing thread
+  skv_mutex_t                   mLock;
+
+  it_status_t
+  CreateLMR( uintptr_t aAddr, size_t aLen, it_lmr_handle_t* aLMR )
+  {
+    it_rmr_context_t rmrHandle;
+    it_mem_priv_t privs = (it_mem_priv_t) (IT_PRIV_LOCAL | IT_PRIV_REMOTE);
+    it_lmr_flag_t lmr_flags = IT_LMR_FLAG_NON_SHAREABLE;
+
+    return it_lmr_create( mPZ_Hdl,
+                          (void*) aAddr,
+                          NULL,
+                          aLen,
+                          IT_ADDR_MODE_ABSOLUTE,
+                          privs,
+                          lmr_flags,
+                          0,
+                          aLMR,
+                          &rmrHandle );
+  }
+
+  it_status_t
+  GetRMR( skv_client_mr_entry_t* aEntry, it_ep_handle_t aEP, it_rmr_context_t* aRMR )
+  {
+    if( aEntry->mEP != aEP )
+    {
+      it_status_t status = itx_get_rmr_context_for_ep( aEP, aEntry->mLMR, & aEntry->mRMR );
+      if( status != IT_SUCCESS )
+        return status;
+      aEntry->mEP = aEP;
+    }
+    *aRMR = aEntry->mRMR;
+    return IT_SUCCESS;
+  }
+
+  skv_client_mr_entry_t*
+  Lookup( uintptr_t aAddr, size_t aLen )
+  {
+    // any entry containing the range starts in [ aAddr - mMaxLen, aAddr ]
+    skv_client_mr_range_map_t::iterator it = mRanges.upper_bound( aAddr );
+    while( it != mRanges.begin() )
+    {
+      --it;
+      if( it->first + mMaxLen < aAddr )
+        break;
+      if( it->second->Contains( aAddr, aLen ) )
+        return it->second;
+    }
+    return NULL;
+  }
+
+  skv_client_mr_entry_t*
+  AddEntry( uintptr_t aAddr, size_t aLen, it_lmr_handle_t aLMR, bool aPinned )
+  {
+    skv_client_mr_entry_t* Entry = new skv_client_mr_entry_t;
+    Entry->mAddr = aAddr;
+    Entry->mLen = aLen;
+    Entry->mLMR = aLMR;
+    Entry->mEP = (it_ep_handle_t)IT_NULL_HANDLE;
+    Entry->mRMR = 0;
+    Entry->mRefCount = 0;
+    Entry->mPinned = aPinned;
+    Entry->mValid = true;
+    Entry->mInLRU = false;
+    Entry->mRangePos = mRanges.insert( std::make_pair( aAddr, Entry ) );
+    mEntries[ aLMR ] = Entry;
+
+    if( aLen > mMaxLen )
+      mMaxLen = aLen;
+    if( ! aPinned )
+      mCachedBytes += aLen;
+    return Entry;
+  }
+
+  // takes the entry out of the lookup; frees it unless it's still in use
+  void
+  Invalidate( skv_client_mr_entry_t* aEntry )
+  {
+    if( aEntry->mValid )
+    {
+      mRanges.erase( aEntry->mRangePos );
+      aEntry->mValid = false;
+      if( ! aEntry->mPinned )
+        mCachedBytes -= aEntry->mLen;
+    }
+    if( aEntry->mInLRU )
+    {
+      mLRU.erase( aEntry->mLRUPos );
+      aEntry->mInLRU = false;
+    }
+    if( aEntry->mRefCount == 0 )
+      Destroy( aEntry );
+  }
+
+  void
+  Destroy( skv_client_mr_entry_t* aEntry )
+  {
+    BegLogLine( SKV_CLIENT_MR_CACHE_LOG )
+      << "skv_client_mr_cache_t::Destroy(): "
+      << " addr: " << (void*)aEntry->mAddr
+      << " len: " << aEntry->mLen
+      << " lmr: " << (void*)aEntry->mLMR
+      << EndLogLine;
+
+    it_status_t status = it_lmr_free( aEntry->mLMR );
+
+    AssertLogLine( status == IT_SUCCESS )
+      << "skv_client_mr_cache_t::Destroy(): ERROR:: it_lmr_free() failed"
+      << " lmr: " << (void *) aEntry->mLMR
+      << " status: " << status
+      << EndLogLine;
+
+    mEntries.erase( aEntry->mLMR );
+    delete aEntry;
+  }
+
+  void
+  Evict()
+  {
+    while(( mCachedBytes > mLimit ) && ( ! mLRU.empty() ))
+    {
+      skv_client_mr_entry_t* Victim = mLRU.back();
+      mEvictions++;
+      Invalidate( Victim );
+    }
+  }
+
+  it_status_t
+  AcquireEntry( void* aAddr,
+                size_t aLen,
+                it_ep_handle_t aEP,
+                it_lmr_handle_t* aLMR,
+                it_rmr_context_t* aRMR )
+  {
+    uintptr_t Addr = (uintptr_t)aAddr;
+    skv_client_mr_entry_t* Entry = Lookup( Addr, aLen );
+
+    if( Entry != NULL )
+    {
+      mHits++;
+      if( Entry->mInLRU )
+      {
+        mLRU.erase( Entry->mLRUPos );
+        Entry->mInLRU = false;
+      }
+    }
+    else
+    {
+      mMisses++;
+
+      it_lmr_handle_t lmrHandle;
+      it_status_t status = CreateLMR( Addr, aLen, &lmrHandle );
+      if( status != IT_SUCCESS )
+        return status;
+
+      // too large for the cache: plain per-request registration
+      if( aLen > mLimit )
+      {
+        *aLMR = lmrHandle;
+        status = itx_get_rmr_context_for_ep( aEP, lmrHandle, aRMR );
+        if( status != IT_SUCCESS )
+          it_lmr_free( lmrHandle );
+        return status;
+      }
+
+      Entry = AddEntry( Addr, aLen, lmrHandle, false );
+    }
+
+    it_status_t status = GetRMR( Entry, aEP, aRMR );
+    if( status != IT_SUCCESS )
+    {
+      if(( Entry->mRefCount == 0 ) && ( ! Entry->mPinned ))
+        Invalidate( Entry );
+      return status;
+    }
+
+    Entry->mRefCount++;
+    *aLMR = Entry->mLMR;
+
+    BegLogLine( SKV_CLIENT_MR_CACHE_LOG )
+      << "skv_client_mr_cache_t::Acquire(): "
+      << " addr: " << aAddr
+      << " len: " << aLen
+      << " lmr: " << (void*)Entry->mLMR
+      << " refs: " << Entry->mRefCount
+      << " pinned: " << Entry->mPinned
+      << EndLogLine;
+
+    Evict();
+    return IT_SUCCESS;
+  }
+
+  it_status_t
+  ReleaseEntry( it_lmr_handle_t aLMR )
+  {
+    skv_client_mr_lmr_map_t::iterator it = mEntries.find( aLMR );
+    if( it == mEntries.end() )
+      return it_lmr_free( aLMR );
+
+    skv_client_mr_entry_t* Entry = it->second;
+
+    AssertLogLine( Entry->mRefCount > 0 )
+      << "skv_client_mr_cache_t::Release(): ERROR:: unbalanced release"
+      << " lmr: " << (void*)aLMR
+      << EndLogLine;
+
+    Entry->mRefCount--;
+    if( Entry->mRefCount > 0 )
+      return IT_SUCCESS;
+
+    if( ! Entry->mValid )
+      Destroy( Entry );
+    else if( ! Entry->mPinned )
+    {
+      mLRU.push_front( Entry );
+      Entry->mLRUPos = mLRU.begin();
+      Entry->mInLRU = true;
+      Evict();
+    }
+    return IT_SUCCESS;
+  }
+
+public:
+  skv_client_mr_cache_t()
+    : mPZ_Hdl( (it_pz_handle_t)IT_NULL_HANDLE ),
+      mLimit( 0 ),
+      mCachedBytes( 0 ),
+      mMaxLen( 0 ),
+      mHits( 0 ),
+      mMisses( 0 ),
+      mEvictions( 0 )
+  {}
+
+  void
+  Init( it_pz_handle_t aPZ_Hdl, uint64_t aLimit )
+  {
+    mPZ_Hdl = aPZ_Hdl;
+    mLimit = aLimit;
+
+    BegLogLine( SKV_CLIENT_MR_CACHE_LOG )
+      << "skv_client_mr_cache_t::Init(): "
+      << " limit: " << mLimit
+      << EndLogLine;
+  }
+
+  void
+  Finalize()
+  {
+    mLock.lock();
+
+    BegLogLine( SKV_CLIENT_MR_CACHE_LOG )
+      << "skv_client_mr_cache_t::Finalize(): "
+      << " entries: " << mEntries.size()
+      << " hits: " << mHits
+      << " misses: " << mMisses
+      << " evictions: " << mEvictions
+      << EndLogLine;
+
+    while( ! mEntries.empty() )
+    {
+      skv_client_mr_entry_t* Entry = mEntries.begin()->second;
+      Entry->mRefCount = 0;
+      Invalidate( Entry );
+    }
+    mMaxLen = 0;
+
+    mLock.unlock();
+  }
+
+  /***
+   * Returns a registration covering [ aAddr, aAddr+aLen ) and the rmr
+   * context of that registration for endpoint aEP.
+   * Every successful Acquire() has to be matched by a Release( *aLMR )
+   ***/
+  it_status_t
+  Acquire( void* aAddr,
+           size_t aLen,
+           it_ep_handle_t aEP,
+           it_lmr_handle_t* aLMR,
+           it_rmr_context_t* aRMR )
+  {
+    mLock.lock();
+    it_status_t status = AcquireEntry( aAddr, aLen, aEP, aLMR, aRMR );
+    mLock.unlock();
+    return status;
+  }
+
+  it_status_t
+  Release( it_lmr_handle_t aLMR )
+  {
+    mLock.lock();
+    it_status_t status = ReleaseEntry( aLMR );
+    mLock.unlock();
+    return status;
+  }
+
+  /***
+   * registers a user buffer for the lifetime of the client or until
+   * Deregister(). Requests from within the buffer reuse the registration
+   ***/
+  skv_status_t
+  Register( void* aAddr, size_t aLen )
+  {
+    if(( aAddr == NULL ) || ( aLen == 0 ))
+      return SKV_ERRNO_UNSPECIFIED_ERROR;
+
+    it_lmr_handle_t lmrHandle;
+    it_status_t status = CreateLMR( (uintptr_t)aAddr, aLen, &lmrHandle );
+    if( status != IT_SUCCESS )
+    {
+      BegLogLine( 1 )
+        << "skv_client_mr_cache_t::Register(): ERROR:: it_lmr_create() failed"
+        << " addr: " << aAddr
+        << " len: " << aLen
+        << " status: " << status
+        << EndLogLine;
+      return SKV_ERRNO_UNSPECIFIED_ERROR;
+    }
+
+    mLock.lock();
+    AddEntry( (uintptr_t)aAddr, aLen, lmrHandle, true );
+    mLock.unlock();
+    return SKV_SUCCESS;
+  }
+
+  /***
+   * drops all registrations that overlap [ aAddr, aAddr+aLen )
+   * has to be called before the memory is freed or unmapped
+   ***/
+  skv_status_t
+  Deregister( void* aAddr, size_t aLen )
+  {
+    uintptr_t Addr = (uintptr_t)aAddr;
+    int Count = 0;
+
+    mLock.lock();
+
+    skv_client_mr_range_map_t::iterator it = mRanges.lower_bound( Addr > mMaxLen ? Addr - mMaxLen : 0 );
+    while(( it != mRanges.end() ) && ( it->first < Addr + aLen ))
+    {
+      skv_client_mr_entry_t* Entry = it->second;
+      ++it;
+      if( Entry->Overlaps( Addr, aLen ) )
+      {
+        Invalidate( Entry );
+        Count++;
+      }
+    }
+
+    mLock.unlock();
+
+    BegLogLine( SKV_CLIENT_MR_CACHE_LOG )
+      << "skv_client_mr_cache_t::Deregister(): "
+      << " addr: " << aAddr
+      << " len: " << aLen
+      << " dropped: " << Count
+      << EndLogLine;
+
+    return ( Count > 0 ) ? SKV_SUCCESS : SKV_ERRNO_ELEM_NOT_FOUND;
+  }
+
+  uint64_t GetHits() const { return mHits; }
+  uint64_t GetMisses() const { return mMisses; }
+  uint64_t GetEvictions() const { return mEvictions; }
+};
+
+#endif /* SKV_CLIENT_MR_CACHE_HPP_ */
@@ -0,0 +1,424 @@
+/************************************************
+ * Copyright (c) IBM Corp. 2014
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * which accompanies this distribution, and is available at
+ * http://www.eclipse.org/legal/epl-v10.html
+ *************************************************/
+
+/*
+ * Multi-key insert/retrieve
+ *  - keys are grouped by their owning server
+ *  - each group is packed into one buffer region and sent as a single
+ *    SKV_COMMAND_MULTI_KEY request (split if it exceeds the per-command limits)
+ *  - the server rdma-reads the rows and rdma-writes per-key results back
+ */
+
+#include <vector>
+#include <skv/client/skv_client_internal.hpp>
+
+#ifndef SKV_CLIENT_MULTI_KEY_LOG
+#define SKV_CLIENT_MULTI_KEY_LOG ( 0 | SKV_LOGGING_ALL )
+#endif
+
+// keep the result entries of each command aligned
+#define SKV_MULTI_KEY_ALIGN( x ) ( ( (x) + 7 ) & ~7 )
+
+struct skv_client_multi_key_chunk_t
+{
+  int               mNodeId;
+  int               mFirst;        // index into the key order list
+  int               mCount;
+  size_t            mOffset;       // position of the request rows in the buffer
+  int               mRequestSize;
+  int               mResultSize;
+  skv_client_ccb_t* mCCB;
+  skv_status_t      mStatus;
+};
+
+skv_status_t
+skv_client_internal_t::
+iMultiKey( int                 aNodeId,
+           skv_pds_id_t*       aPDSId,
+           skv_command_type_t  aOp,
+           skv_cmd_RIU_flags_t aFlags,
+           int                 aKeyCount,
+           char*               aRequestBuffer,
+           int                 aRequestSize,
+           char*               aResultBuffer,
+           int                 aResultSize,
+           it_lmr_handle_t     aBufferLMR,
+           skv_client_ccb_t**  aCCB )
+{
+  BegLogLine( SKV_CLIENT_MULTI_KEY_LOG )
+    << "skv_client_internal_t::iMultiKey(): Entering "
+    << " aNodeId: " << aNodeId
+    << " aPDSId: " << *aPDSId
+    << " aOp: " << skv_command_type_to_string( aOp )
+    << " aKeyCount: " << aKeyCount
+    << " aRequestSize: " << aRequestSize
+    << " aResultSize: " << aResultSize
+    << EndLogLine;
+
+  skv_client_ccb_t* CmdCtrlBlk;
+  skv_status_t rsrv_status = mCommandMgrIF.Reserve( & CmdCtrlBlk );
+  if( rsrv_status != SKV_SUCCESS )
+    return rsrv_status;
+
+  /******************************************************
+   * Set the client-server protocol send ctrl msg buffer
+   *****************************************************/
+  char* SendCtrlMsgBuff = CmdCtrlBlk->GetSendBuff();
+  skv_cmd_multi_key_req_t* Req = (skv_cmd_multi_key_req_t *) SendCtrlMsgBuff;
+
+  Req->Init( aNodeId,
+             & mConnMgrIF,
+             aPDSId,
+             SKV_COMMAND_MULTI_KEY,
+             SKV_SERVER_EVENT_TYPE_IT_DTO_MULTI_KEY_CMD,
+             CmdCtrlBlk,
+             aOp,
+             aFlags,
+             aKeyCount,
+             aRequestBuffer,
+             aRequestSize,
+             aResultBuffer,
+             aResultSize,
+             aBufferLMR );
+  Req->EndianConvert() ;
+  /*****************************************************/
+
+  /******************************************************
+   * Set the local client state used on response
+   *****************************************************/
+  CmdCtrlBlk->mCommand.mType                                      = SKV_COMMAND_MULTI_KEY;
+  CmdCtrlBlk->mCommand.mCommandBundle.mCommandMultiKey.mOp        = aOp;
+  CmdCtrlBlk->mCommand.mCommandBundle.mCommandMultiKey.mKeyCount  = aKeyCount;
+  /*****************************************************/
+
+  CmdCtrlBlk->Transit( SKV_CLIENT_COMMAND_STATE_WAITING_FOR_CMPL );
+
+  skv_status_t status = mConnMgrIF.Dispatch( aNodeId, CmdCtrlBlk );
+
+  AssertLogLine( status == SKV_SUCCESS )
+    << "skv_client_internal_t::iMultiKey():: "
+    << " status: " << skv_status_to_string( status )
+    << EndLogLine;
+
+  *aCCB = CmdCtrlBlk;
+  return status;
+}
+
+/***
+ * skv_client_internal_t::MultiKey::
+ * Desc: insert or retrieve aCount keys with one request per server
+ * input: per-key arrays; aValueRetrievedSizes may be NULL
+ * returns: SKV_SUCCESS if all keys succeeded, otherwise the
+ *          status of the first failed key; aStatus holds the per-key status
+ ***/
+skv_status_t
+skv_client_internal_t::
+MultiKey( skv_command_type_t    aOp,
+          skv_pds_id_t*         aPDSId,
+          int                   aCount,
+          char**                aKeyBuffers,
+          int*                  aKeyBufferSizes,
+          char**                aValueBuffers,
+          int*                  aValueBufferSizes,
+          int*                  aValueRetrievedSizes,
+          skv_status_t*         aStatus,
+          skv_cmd_RIU_flags_t   aFlags )
+{
+  BegLogLine( SKV_CLIENT_MULTI_KEY_LOG )
+    << "skv_client_internal_t::MultiKey(): Entering "
+    << " aOp: " << skv_command_type_to_string( aOp )
+    << " aCount: " << aCount
+    << " aFlags: " << aFlags
+    << EndLogLine;
+
+  StrongAssertLogLine( mState == SKV_CLIENT_STATE_CONNECTED )
+    << "skv_client_internal_t::MultiKey():: "
+    << " mState: " << mState
+    << EndLogLine;
+
+  if( aCount <= 0 )
+    return SKV_SUCCESS;
+
+  /*****************************************
+   * Check limits and sort keys by owner
+   *****************************************/
+  int ServerCount = mConnMgrIF.GetServerConnCount();
+  std::vector< std::vector< int > > KeysPerNode( ServerCount );
+
+  for( int i = 0; i < aCount; i++ )
+  {
+    aStatus[ i ] = SKV_SUCCESS;
+    if( aValueRetrievedSizes != NULL )
+      aValueRetrievedSizes[ i ] = 0;
+
+    if( aKeyBufferSizes[ i ] <= 0 || aKeyBufferSizes[ i ] > SKV_KEY_LIMIT )
+      aStatus[ i ] = SKV_ERRNO_KEY_TOO_LARGE;
+    else if( aValueBufferSizes[ i ] < 0 || aValueBufferSizes[ i ] > SKV_VALUE_LIMIT )
+      aStatus[ i ] = SKV_ERRNO_VALUE_TOO_LARGE;
+    if( aStatus[ i ] != SKV_SUCCESS )
+      continue;
+
+    skv_key_t UserKey;
+    UserKey.Init( aKeyBuffers[ i ], aKeyBufferSizes[ i ] );
+
+    KeysPerNode[ mDistribution.GetNode( &UserKey ) ].push_back( i );
+  }
+
+  /*****************************************
+   * Split the per-server lists into commands
+   *****************************************/
+  std::vector< int > Order;
+  std::vector< skv_client_multi_key_chunk_t > Chunks;
+  size_t TotalSize = 0;
+
+  for( int n = 0; n < ServerCount; n++ )
+  {
+    skv_client_multi_key_chunk_t Chunk;
+    Chunk.mCount = 0;
+
+    for( size_t k = 0; k < KeysPerNode[ n ].size(); k++ )
+    {
+      int i = KeysPerNode[ n ][ k ];
+      int RowSize = aKeyBufferSizes[ i ] + 2 * sizeof( int );
+      int ResultSize = sizeof( skv_multi_key_result_t );
+      if( aOp == SKV_COMMAND_INSERT )
+        RowSize += aValueBufferSizes[ i ];
+      else
+        ResultSize += aValueBufferSizes[ i ];
+
+      if( ( Chunk.mCount > 0 ) &&
+          ( ( Chunk.mCount == SKV_MULTI_KEY_LIMIT ) ||
+            ( (size_t)Chunk.mRequestSize + Chunk.mResultSize + RowSize + ResultSize + 16 > SKV_MULTI_KEY_TRANSFER_LIMIT ) ) )
+      {
+        Chunks.push_back( Chunk );
+        Chunk.mCount = 0;
+      }
+
+      if( Chunk.mCount == 0 )
+      {
+        Chunk.mNodeId = n;
+        Chunk.mFirst = Order.size();
+        Chunk.mRequestSize = 0;
+        Chunk.mResultSize = 0;
+        Chunk.mCCB = NULL;
+        Chunk.mStatus = SKV_SUCCESS;
+      }
+
+      Order.push_back( i );
+      Chunk.mCount++;
+      Chunk.mRequestSize += RowSize;
+      Chunk.mResultSize += ResultSize;
+    }
+    if( Chunk.mCount > 0 )
+      Chunks.push_back( Chunk );
+  }
+
+  if( Chunks.empty() )
+    return aStatus[ 0 ];
+
+  for( size_t c = 0; c < Chunks.size(); c++ )
+  {
+    Chunks[ c ].mRequestSize = SKV_MULTI_KEY_ALIGN( Chunks[ c ].mRequestSize );
+    Chunks[ c ].mResultSize = SKV_MULTI_KEY_ALIGN( Chunks[ c ].mResultSize );
+    Chunks[ c ].mOffset = TotalSize;
+    TotalSize += Chunks[ c ].mRequestSize + Chunks[ c ].mResultSize;
+  }
+
+  /*****************************************
+   * One registered buffer for all commands
+   *****************************************/
+  char* Buffer = (char*) malloc( TotalSize );
+  if( Buffer == NULL )
+    return SKV_ERRNO_OUT_OF_MEMORY;
+
+  it_lmr_handle_t BufferLMR;
+  it_rmr_context_t BufferRMR;
+  it_mem_priv_t privs     = (it_mem_priv_t) ( IT_PRIV_LOCAL | IT_PRIV_REMOTE );
+  it_lmr_flag_t lmr_flags = IT_LMR_FLAG_NON_SHAREABLE;
+
+  it_status_t istatus = it_lmr_create( mPZ_Hdl,
+                                       Buffer,
+                                       NULL,
+                                       TotalSize,
+                                       IT_ADDR_MODE_ABSOLUTE,
+                                       privs,
+                                       lmr_flags,
+                                       0,
+                                       & BufferLMR,
+                                       & BufferRMR );
+  if( istatus != IT_SUCCESS )
+  {
+    BegLogLine( 1 )
+      << "skv_client_internal_t::MultiKey(): ERROR:: it_lmr_create() failed"
+      << " TotalSize: " << TotalSize
+      << " istatus: " << istatus
+      << EndLogLine;
+
+    free( Buffer );
+    return SKV_ERRNO_OUT_OF_MEMORY;
+  }
+
+  /*****************************************
+   * Pack and issue, waiting for the oldest
+   * command if we run out of command slots
+   *****************************************/
+  size_t Oldest = 0;
+  for( size_t c = 0; c < Chunks.size(); c++ )
+  {
+    skv_client_multi_key_chunk_t *Chunk = &Chunks[ c ];
+    char* Row = Buffer + Chunk->mOffset;
+    for( int k = 0; k < Chunk->mCount; k++ )
+    {
+      int i = Order[ Chunk->mFirst + k ];
+      if( aOp == SKV_COMMAND_INSERT )
+        Row += skv_bulk_insert_pack( Row,
+                                     aKeyBuffers[ i ], aKeyBufferSizes[ i ],
+                                     aValueBuffers[ i ], aValueBufferSizes[ i ] );
+      else
+        Row += skv_multi_key_pack_retrieve( Row,
+                                            aKeyBuffers[ i ], aKeyBufferSizes[ i ],
+                                            aValueBufferSizes[ i ] );
+    }
+
+    skv_status_t status;
+    do
+    {
+      status = iMultiKey( Chunk->mNodeId,
+                          aPDSId,
+                          aOp,
+                          aFlags,
+                          Chunk->mCount,
+                          Buffer + Chunk->mOffset,
+                          Chunk->mRequestSize,
+                          Buffer + Chunk->mOffset + Chunk->mRequestSize,
+                          Chunk->mResultSize,
+                          BufferLMR,
+                          & Chunk->mCCB );
+
+      if( ( status == SKV_ERRNO_COMMAND_LIMIT_REACHED ) && ( Oldest < c ) )
+      {
+        Chunks[ Oldest ].mStatus = Wait( Chunks[ Oldest ].mCCB );
+        Chunks[ Oldest ].mCCB = NULL;
+        Oldest++;
+      }
+      else
+        break;
+    } while( 1 );
+
+    if( status != SKV_SUCCESS )
+    {
+      Chunk->mStatus = status;
+      Chunk->mCCB = NULL;
+    }
+  }
+
+  for( size_t c = Oldest; c < Chunks.size(); c++ )
+    if( Chunks[ c ].mCCB != NULL )
+      Chunks[ c ].mStatus = Wait( Chunks[ c ].mCCB );
+
+  /*****************************************
+   * Unpack the per-key results
+   *****************************************/
+  for( size_t c = 0; c < Chunks.size(); c++ )
+  {
+    skv_client_multi_key_chunk_t *Chunk = &Chunks[ c ];
+    skv_multi_key_result_t* Results = (skv_multi_key_result_t*) ( Buffer + Chunk->mOffset + Chunk->mRequestSize );
+    char* ValueSpace = (char*) &Results[ Chunk->mCount ];
+
+    for( int k = 0; k < Chunk->mCount; k++ )
+    {
+      int i = Order[ Chunk->mFirst + k ];
+      if( Chunk->mStatus != SKV_SUCCESS )
+      {
+        aStatus[ i ] = Chunk->mStatus;
+        continue;
+      }
+
+      Results[ k ].EndianConvert();
+      aStatus[ i ] = Results[ k ].mStatus;
+
+      int RetrievedSize = Results[ k ].mValueSize;
+      if( ( aOp == SKV_COMMAND_RETRIEVE ) && ( aStatus[ i ] == SKV_SUCCESS ) )
+      {
+        int CopySize = RetrievedSize < aValueBufferSizes[ i ] ? RetrievedSize : aValueBufferSizes[ i ];
+        memcpy( aValueBuffers[ i ], ValueSpace, CopySize );
+
+        // same as single retrieve: report the stored size unless only the requested size is of interest
+        if( aFlags & SKV_COMMAND_RIU_RETRIEVE_SPECIFIC_VALUE_LEN )
+          RetrievedSize = CopySize;
+      }
+      if( aValueRetrievedSizes != NULL )
+        aValueRetrievedSizes[ i ] = RetrievedSize;
+
+      if( aOp == SKV_COMMAND_RETRIEVE )
+        ValueSpace += aValueBufferSizes[ i ];
+    }
+  }
+
+  it_lmr_free( BufferLMR );
+  free( Buffer );
+
+  skv_status_t status = SKV_SUCCESS;
+  for( int i = 0; ( i < aCount ) && ( status == SKV_SUCCESS ); i++ )
+    status = aStatus[ i ];
+
+  BegLogLine( SKV_CLIENT_MULTI_KEY_LOG )
+    << "skv_client_internal_t::MultiKey(): Leaving "
+    << " commands: " << Chunks.size()
+    << " status: " << skv_status_to_string( status )
+    << EndLogLine;
+
+  return status;
+}
+
+skv_status_t
+skv_client_internal_t::
+MultiRetrieve( skv_pds_id_t*         aPDSId,
+               int                   aCount,
+               char**                aKeyBuffers,
+               int*                  aKeyBufferSizes,
+               char**                aValueBuffers,
+               int*                  aValueBufferSizes,
+               int*                  aValueRetrievedSizes,
+               skv_status_t*         aStatus,
+               skv_cmd_RIU_flags_t   aFlags )
+{
+  return MultiKey( SKV_COMMAND_RETRIEVE,
+                   aPDSId,
+                   aCount,
+                   aKeyBuffers,
+                   aKeyBufferSizes,
+                   aValueBuffers,
+                   aValueBufferSizes,
+                   aValueRetrievedSizes,
+                   aStatus,
+                   aFlags );
+}
+
+skv_status_t
+skv_client_internal_t::
+MultiInsert( skv_pds_id_t*         aPDSId,
+             int                   aCount,
+             char**                aKeyBuffers,
+             int*                  aKeyBufferSizes,
+             char**                aValueBuffers,
+             int*                  aValueBufferSizes,
+             skv_status_t*         aStatus,
+             skv_cmd_RIU_flags_t   aFlags )
+{
+  return MultiKey( SKV_COMMAND_INSERT,
+                   aPDSId,
+                   aCount,
+                   aKeyBuffers,
+                   aKeyBufferSizes,
+                   aValueBuffers,
+                   aValueBufferSizes,
+                   NULL,
+                   aStatus,
+                   aFlags );
+}
@@ -36,8 +36,13 @@
 #define SKV_CLIENT_MAX_CURSOR_KEYS_TO_CACHE   ( 2 )
 
 #include <skv/common/skv_types.hpp>
+#include <skv/common/skv_mutex.hpp>
 #include <skv/common/skv_distribution_manager.hpp>
 #include <skv/client/skv_c2s_active_broadcast.hpp>
+#include <skv/client/skv_client_mr_cache.hpp>
+#include <skv/client/skv_client_completion_queue.hpp>
+
+#include <sched.h>
 
 struct skv_client_command_open_t
 {
@@ -90,6 +95,13 @@ struct skv_client_command_bulk_insert_t
   uint64_t      mBufferChecksum;
 };
 
+struct skv_client_command_multi_key_t
+{
+  // Needed for debugging
+  skv_command_type_t mOp;
+  int                mKeyCount;
+};
+
 struct skv_client_command_retrieve_n_keys_t
 {
   int           mCachedKeysCountMax;
@@ -128,6 +140,7 @@ struct skv_client_command_t
     skv_client_command_open_t              mCommandOpen;
     skv_client_command_insert_t            mCommandInsert;
     skv_client_command_bulk_insert_t       mCommandBulkInsert;
+    skv_client_command_multi_key_t         mCommandMultiKey;
     skv_client_command_retrieve_t          mCommandRetrieve;
     skv_client_command_retrieve_n_keys_t   mCommandRetrieveNKeys;
     skv_client_command_retrieve_dist_t     mCommandRetrieveDist;
@@ -255,6 +268,16 @@ struct skv_client_ccb_t
   uint64_t                      mCmdReadyForDone;
   skv_status_t                  mStatus;
   int                           mCmdOrd;
+  int                           mPartition;      // ccb partition of the issuing thread (done queue)
+  int                           mHomePartition;  // ccb partition of the free queue the ccb belongs to
+  uint64_t                      mOwner;      // thread token of the issuing thread
+
+  // completion handler: instead of the done queue, a completed command is
+  // handed to the callback or to the completion queue (protected by the partition lock)
+  skv_client_completion_cb_t       mCallback;
+  void*                            mCallbackContext;
+  skv_client_completion_queue_t*   mCompletionQueue;
+  bool                             mCompleted;
 
 public:
   void
@@ -269,16 +292,26 @@ public:
     return mCmdOrd;
   }
 
+  // state changes are the completion signal for threads waiting on this ccb
   skv_client_command_state_t
   GetState()
   {
-    return mState;
+    return __atomic_load_n( &mState, __ATOMIC_ACQUIRE );
+  }
+
+  // the state machines queue a completed ccb before its state transits to DONE;
+  // a thread that takes it off a queue waits for the progress thread to finish the transition
+  void
+  WaitForDoneState()
+  {
+    while( GetState() != SKV_CLIENT_COMMAND_STATE_DONE )
+      ::sched_yield();
   }
 
   void
   Transit( skv_client_command_state_t aState )
   {
-    mState = aState;
+    __atomic_store_n( &mState, aState, __ATOMIC_RELEASE );
   }
 
   char*
@@ -307,6 +340,12 @@ public:
   void SetRequestWithWrite() { mCmdReadyForDone |= 2; }
   bool CheckRequestWithWrite() { return ( mCmdReadyForDone & 2 ) != 0; }
 
+  bool
+  HasCompletionHandler() const
+  {
+    return ( mCallback != NULL ) || ( mCompletionQueue != NULL );
+  }
+
   void
   Init( it_lmr_handle_t aBaseLMR, skv_client_ccb_manager_if_t* aCCBMgrIF )
   {
@@ -320,6 +359,9 @@ public:
     mPrev = NULL;
 
     mCCBMgrIF = aCCBMgrIF;
+    mPartition = 0;
+    mHomePartition = 0;
+    mOwner = 0;
 
     Reset();
   }
@@ -338,10 +380,28 @@ public:
     mCmdOrd        = -1;
     mCmdReadyForDone = 0;
     mRecvCtrlMsgBuff = NULL;
+    mCallback = NULL;
+    mCallbackContext = NULL;
+    mCompletionQueue = NULL;
+    mCompleted = false;
   }
 };
 
-class skv_client_ccb_manager_if_t
+/***
+ * Command control blocks are partitioned to allow concurrent client
+ * threads. Each thread sticks to one partition (assigned round robin
+ * at its first command) for reserving ccbs and for collecting its
+ * completed commands. The partition lock is only shared with the thread
+ * that currently runs the progress engine and with other threads that
+ * got assigned the same partition. Since partitions can be shared (more
+ * threads than partitions), each ccb carries the token of the thread
+ * that issued it and only that thread collects it from the done queue.
+ ***/
+#ifndef SKV_CLIENT_CCB_PARTITIONS
+#define SKV_CLIENT_CCB_PARTITIONS ( 16 )
+#endif
+
+struct skv_client_ccb_partition_t
 {
   skv_client_ccb_t*                        mFreeCommandCtrlBlocks;
 
@@ -351,16 +411,110 @@ class skv_client_ccb_manager_if_t
    ***/
   skv_client_ccb_t*                        mDoneCommandCtrlBlocks;
 
+  skv_mutex_t                              mLock;
+} __attribute__(( aligned( 64 ) ));
+
+class skv_client_ccb_manager_if_t
+{
+  skv_client_ccb_partition_t               mPartitions[ SKV_CLIENT_CCB_PARTITIONS ];
+  int                                      mNextPartition;
+
   skv_client_ccb_t                         mCommandCtrlBlockHeap[ SKV_CLIENT_COMMAND_LIMIT ];
 
+  // completed commands with a completion handler, waiting for delivery
+  skv_client_ccb_t*                        mNotifyHead;
+  skv_client_ccb_t*                        mNotifyTail;
+  skv_mutex_t                              mNotifyLock;
+
   it_lmr_handle_t                           mBaseHandle;
 
+  // registrations of large user buffers
+  skv_client_mr_cache_t                     mMRCache;
+
+  int
+  GetThreadPartition()
+  {
+    static __thread int tPartition = -1;
+    if( tPartition < 0 )
+      tPartition = __atomic_fetch_add( &mNextPartition, 1, __ATOMIC_RELAXED ) % SKV_CLIENT_CCB_PARTITIONS;
+    return tPartition;
+  }
+
+  // process-wide unique per thread (unlike the partition)
+  static uint64_t
+  GetThreadToken()
+  {
+    static uint64_t sNextToken = 0;
+    static __thread uint64_t tToken = 0;
+    if( tToken == 0 )
+      tToken = __atomic_add_fetch( &sNextToken, 1, __ATOMIC_RELAXED );
+    return tToken;
+  }
+
+  void
+  AddToNotifyQueue( skv_client_ccb_t* aCCB )
+  {
+    aCCB->mNext = NULL;
+    aCCB->mPrev = NULL;
+
+    mNotifyLock.lock();
+    if( mNotifyTail == NULL )
+      mNotifyHead = aCCB;
+    else
+      mNotifyTail->mNext = aCCB;
+    mNotifyTail = aCCB;
+    mNotifyLock.unlock();
+  }
+
+  // unlink from the done queue, partition lock has to be held
+  void
+  UnlinkDoneCCB( skv_client_ccb_partition_t* aPartition, skv_client_ccb_t* aCCB )
+  {
+    if( aPartition->mDoneCommandCtrlBlocks == aCCB )
+      aPartition->mDoneCommandCtrlBlocks = aCCB->mNext;
+
+    if( aCCB->mPrev != NULL )
+      aCCB->mPrev->mNext = aCCB->mNext;
+    if( aCCB->mNext != NULL )
+      aCCB->mNext->mPrev = aCCB->mPrev;
+
+    aCCB->mPrev = NULL;
+    aCCB->mNext = NULL;
+  }
+
+  skv_client_ccb_t*
+  RemoveFromFrontFreeCCBQueue( skv_client_ccb_partition_t* aPartition )
+  {
+    aPartition->mLock.lock();
+
+    skv_client_ccb_t* FreeBlock = aPartition->mFreeCommandCtrlBlocks;
+    if( FreeBlock != NULL )
+    {
+      aPartition->mFreeCommandCtrlBlocks = FreeBlock->mNext;
+
+      AssertLogLine( FreeBlock->mPrev == NULL )
+        << "skv_client_ccb_manager_if_t::RemoveFromFrontFreeCCBQueue(): "
+        << " FreeBlock: " << (void *) FreeBlock
+        << EndLogLine;
+
+      if( aPartition->mFreeCommandCtrlBlocks != NULL )
+        aPartition->mFreeCommandCtrlBlocks->mPrev = NULL;
+
+      // Detach the first block from the list
+      FreeBlock->mPrev = NULL;
+      FreeBlock->mNext = NULL;
+    }
+
+    aPartition->mLock.unlock();
+    return FreeBlock;
+  }
 
 public:
 
   void
-  Init( it_pz_handle_t aPZ_Hdl )
+  Init( it_pz_handle_t aPZ_Hdl, uint64_t aMRCacheLimit = 0 )
   {
+    mMRCache.Init( aPZ_Hdl, aMRCacheLimit );
 
     it_mem_priv_t privs         = (it_mem_priv_t) (IT_PRIV_LOCAL_READ | IT_PRIV_LOCAL_WRITE);
     it_lmr_flag_t lmr_flags     = IT_LMR_FLAG_NON_SHAREABLE;
@@ -388,9 +542,10 @@ public:
       << " status: " << istatus
       << EndLogLine;
 
-    StrongAssertLogLine( SKV_CLIENT_COMMAND_LIMIT >=2 )
+    StrongAssertLogLine( SKV_CLIENT_COMMAND_LIMIT >= 2 * SKV_CLIENT_CCB_PARTITIONS )
       << "skv_client_ccb_manager_if_t::Init(): ERROR:: "
       << " SKV_CLIENT_COMMAND_LIMIT: " << SKV_CLIENT_COMMAND_LIMIT
+      << " SKV_CLIENT_CCB_PARTITIONS: " << SKV_CLIENT_CCB_PARTITIONS
       << EndLogLine;
 
     BegLogLine( SKV_CLIENT_CCB_MANAGER_LOG )
@@ -399,34 +554,36 @@ public:
       << " BaseLMR: " << ( void * )mBaseHandle
       << EndLogLine;
 
-
-    mCommandCtrlBlockHeap[ 0 ].Init( mBaseHandle, this );
-    mCommandCtrlBlockHeap[ 0 ].mPrev = NULL;
-    mCommandCtrlBlockHeap[ 0 ].mNext = & mCommandCtrlBlockHeap[ 1 ];
-
-    for( int i = 1; i < SKV_CLIENT_COMMAND_LIMIT-1; i++ )
+    // each partition gets a contiguous range of ccbs as its free list
+    int PerPartition = SKV_CLIENT_COMMAND_LIMIT / SKV_CLIENT_CCB_PARTITIONS;
+    for( int p = 0; p < SKV_CLIENT_CCB_PARTITIONS; p++ )
     {
-      mCommandCtrlBlockHeap[ i ].Init( mBaseHandle, this );
+      int First = p * PerPartition;
+      int Last = ( p == SKV_CLIENT_CCB_PARTITIONS - 1 ) ? SKV_CLIENT_COMMAND_LIMIT - 1 : First + PerPartition - 1;
 
-      mCommandCtrlBlockHeap[ i ].mNext = & mCommandCtrlBlockHeap[ i+1 ];
-      mCommandCtrlBlockHeap[ i ].mPrev = & mCommandCtrlBlockHeap[ i-1 ];
-    }
-
-    mCommandCtrlBlockHeap[ SKV_CLIENT_COMMAND_LIMIT-1 ].Init( mBaseHandle, this );
-    mCommandCtrlBlockHeap[ SKV_CLIENT_COMMAND_LIMIT-1 ].mPrev = & mCommandCtrlBlockHeap[ SKV_CLIENT_COMMAND_LIMIT-2 ];
-    mCommandCtrlBlockHeap[ SKV_CLIENT_COMMAND_LIMIT-1 ].mNext = NULL;
+      for( int i = First; i <= Last; i++ )
+      {
+        mCommandCtrlBlockHeap[ i ].Init( mBaseHandle, this );
+        mCommandCtrlBlockHeap[ i ].mPartition = p;
+        mCommandCtrlBlockHeap[ i ].mHomePartition = p;
+        mCommandCtrlBlockHeap[ i ].mPrev = ( i == First ) ? NULL : & mCommandCtrlBlockHeap[ i-1 ];
+        mCommandCtrlBlockHeap[ i ].mNext = ( i == Last ) ? NULL : & mCommandCtrlBlockHeap[ i+1 ];
+      }
 
-    mDoneCommandCtrlBlocks = NULL;
+      mPartitions[ p ].mFreeCommandCtrlBlocks = & mCommandCtrlBlockHeap[ First ];
+      mPartitions[ p ].mDoneCommandCtrlBlocks = NULL;
+    }
+    mNextPartition = 0;
 
-    mFreeCommandCtrlBlocks = & mCommandCtrlBlockHeap[ 0 ];
+    mNotifyHead = NULL;
+    mNotifyTail = NULL;
   }
 
   /***
    * AddToDoneCCBQueue::
-   * Desc:
+   * Desc: queues a completed command for the partition of the issuing thread
    * input:
-   * returns: Returns a free command control block
-   * Or NULL if none are available
+   * returns:
    ***/
   void
   AddToDoneCCBQueue( skv_client_ccb_t* aCCB )
@@ -434,19 +591,33 @@ public:
     BegLogLine( SKV_CLIENT_DONE_QUEUE_LOG )
       << "skv_client_ccb_manager_if_t::AddToDoneCCBQueue(): Entering "
       << " aCCB: " << (void *) aCCB
+      << " partition: " << aCCB->mPartition
       << EndLogLine;
 
-    if( mDoneCommandCtrlBlocks == NULL )
+    skv_client_ccb_partition_t* Partition = & mPartitions[ aCCB->mPartition ];
+    Partition->mLock.lock();
+
+    aCCB->mCompleted = true;
+    if( aCCB->HasCompletionHandler() )
     {
-      mDoneCommandCtrlBlocks = aCCB;
+      Partition->mLock.unlock();
+      AddToNotifyQueue( aCCB );
+      return;
+    }
+
+    if( Partition->mDoneCommandCtrlBlocks == NULL )
+    {
+      Partition->mDoneCommandCtrlBlocks = aCCB;
     }
     else
     {
-      mDoneCommandCtrlBlocks->mPrev = aCCB;
-      aCCB->mNext = mDoneCommandCtrlBlocks;
-      mDoneCommandCtrlBlocks = aCCB;
+      Partition->mDoneCommandCtrlBlocks->mPrev = aCCB;
+      aCCB->mNext = Partition->mDoneCommandCtrlBlocks;
+      Partition->mDoneCommandCtrlBlocks = aCCB;
     }
 
+    Partition->mLock.unlock();
+
     BegLogLine( SKV_CLIENT_DONE_QUEUE_LOG )
       << "skv_client_ccb_manager_if_t::AddToDoneCCBQueue(): Leaving "
       << EndLogLine;
@@ -456,8 +627,7 @@ public:
    * skv_client_ccb_manager_if_t::RemoveFromDoneCCBQueue::
    * Desc:
    * input:
-   * returns: Returns a free command control block
-   * Or NULL if none are available
+   * returns:
    ***/
   void
   RemoveFromDoneCCBQueue( skv_client_ccb_t* aCCB )
@@ -467,12 +637,15 @@ public:
       << " aCCB: " << (void *) aCCB
       << EndLogLine;
 
-    if( mDoneCommandCtrlBlocks == aCCB )
+    skv_client_ccb_partition_t* Partition = & mPartitions[ aCCB->mPartition ];
+    Partition->mLock.lock();
+
+    if( Partition->mDoneCommandCtrlBlocks == aCCB )
     {
-      mDoneCommandCtrlBlocks = aCCB->mNext;
+      Partition->mDoneCommandCtrlBlocks = aCCB->mNext;
 
-      if( mDoneCommandCtrlBlocks != NULL )
-        mDoneCommandCtrlBlocks->mPrev = NULL;
+      if( Partition->mDoneCommandCtrlBlocks != NULL )
+        Partition->mDoneCommandCtrlBlocks->mPrev = NULL;
     }
 
     // Remove the CCB from the Done queue
@@ -497,6 +670,8 @@ public:
     aCCB->mPrev = NULL;
     aCCB->mNext = NULL;
 
+    Partition->mLock.unlock();
+
     BegLogLine( SKV_CLIENT_DONE_QUEUE_LOG )
       << "skv_client_ccb_manager_if_t::RemoveFromDoneCCBQueue(): Leaving "
       << EndLogLine;
@@ -506,10 +681,9 @@ public:
 
   /***
    * skv_client_ccb_manager_if_t::AddToFreeCCBQueue::
-   * Desc:
+   * Desc: returns the ccb to the partition it was reserved from
    * input:
-   * returns: Returns a free command control block
-   * Or NULL if none are available
+   * returns:
    ***/
   void
   AddToFreeCCBQueue( skv_client_ccb_t* aCCB )
@@ -518,36 +692,31 @@ public:
       << "skv_client_ccb_manager_if_t::AddToFreeCCBQueue(): Entering "
       << EndLogLine;
 
-    // AssertLogLine( aCCB->mPrev == NULL )
-    //   << "skv_client_ccb_manager_if_t::AddToFreeCCBQueue(): ERROR: "
-    //   << " aCCB->mPrev: " << (void *) aCCB->mPrev
-    //   << EndLogLine;
+    // Bring back to idle state
+    aCCB->Reset();
 
-    // AssertLogLine( aCCB->mNext == NULL )
-    //   << "skv_client_ccb_manager_if_t::AddToFreeCCBQueue(): ERROR: "
-    //   << " aCCB->mNext: " << (void *) aCCB->mNext
-    //   << EndLogLine;
+    skv_client_ccb_partition_t* Partition = & mPartitions[ aCCB->mHomePartition ];
+    Partition->mLock.lock();
 
-    if( mFreeCommandCtrlBlocks == NULL )
+    if( Partition->mFreeCommandCtrlBlocks == NULL )
     {
-      mFreeCommandCtrlBlocks = aCCB;
+      Partition->mFreeCommandCtrlBlocks = aCCB;
     }
     else
     {
-      mFreeCommandCtrlBlocks->mPrev = aCCB;
+      Partition->mFreeCommandCtrlBlocks->mPrev = aCCB;
 
-      aCCB->mNext = mFreeCommandCtrlBlocks;
+      aCCB->mNext = Partition->mFreeCommandCtrlBlocks;
 
-      mFreeCommandCtrlBlocks = aCCB;
+      Partition->mFreeCommandCtrlBlocks = aCCB;
 
-      AssertLogLine( mFreeCommandCtrlBlocks->mPrev == NULL )
+      AssertLogLine( Partition->mFreeCommandCtrlBlocks->mPrev == NULL )
         << "skv_client_ccb_manager_if_t::AddToFreeCCBQueue(): ERROR: "
-        << " mFreeCommandCtrlBlocks->mPrev: " << (void *) mFreeCommandCtrlBlocks->mPrev
+        << " mFreeCommandCtrlBlocks->mPrev: " << (void *) Partition->mFreeCommandCtrlBlocks->mPrev
         << EndLogLine;
     }
 
-    // Bring back to idle state
-    aCCB->Reset();
+    Partition->mLock.unlock();
 
     BegLogLine( SKV_CLIENT_FREE_QUEUE_LOG )
       << "skv_client_ccb_manager_if_t::AddToFreeCCBQueue(): Leaving "
@@ -556,7 +725,8 @@ public:
 
   /***
    * skv_client_ccb_manager_if_t::RemoveFromFrontDoneCCBQueue::
-   * Desc:
+   * Desc: next completed command that the calling thread issued
+   *       (other threads may share the partition)
    * input/output: aCCB
    * returns:
    * Or NULL if none are available
@@ -568,36 +738,35 @@ public:
       << "skv_client_ccb_manager_if_t::RemoveFromFrontDoneCCBQueue(): Entering "
       << EndLogLine;
 
-    if( mDoneCommandCtrlBlocks == NULL )
-    {
-      BegLogLine( SKV_CLIENT_DONE_QUEUE_LOG )
-        << "skv_client_ccb_manager_if_t::RemoveFromFrontDoneCCBQueue(): Leaving "
-        << EndLogLine;
+    skv_client_ccb_partition_t* Partition = & mPartitions[ GetThreadPartition() ];
 
+    // unlocked peek: most calls find an empty queue
+    if( __atomic_load_n( &Partition->mDoneCommandCtrlBlocks, __ATOMIC_RELAXED ) == NULL )
       return NULL;
-    }
 
-    skv_client_ccb_t* DoneBlock = mDoneCommandCtrlBlocks;
+    uint64_t MyToken = GetThreadToken();
+    Partition->mLock.lock();
 
-    AssertLogLine( DoneBlock->mPrev == NULL )
+    AssertLogLine( ( Partition->mDoneCommandCtrlBlocks == NULL ) || ( Partition->mDoneCommandCtrlBlocks->mPrev == NULL ) )
       << "skv_client_ccb_manager_if_t::RemoveFromFrontDoneCCBQueue(): "
-      << " DoneBlock: " << (void *) DoneBlock
+      << " DoneBlock: " << (void *) Partition->mDoneCommandCtrlBlocks
       << EndLogLine;
 
-    mDoneCommandCtrlBlocks = mDoneCommandCtrlBlocks->mNext;
+    skv_client_ccb_t* DoneBlock = Partition->mDoneCommandCtrlBlocks;
+    while(( DoneBlock != NULL ) && ( DoneBlock->mOwner != MyToken ))
+      DoneBlock = DoneBlock->mNext;
 
-    if( mDoneCommandCtrlBlocks != NULL )
-      mDoneCommandCtrlBlocks->mPrev = NULL;
+    if( DoneBlock != NULL )
+      UnlinkDoneCCB( Partition, DoneBlock );
 
-    DoneBlock->mNext = NULL;
+    Partition->mLock.unlock();
 
-    AssertLogLine( DoneBlock->mState == SKV_CLIENT_COMMAND_STATE_DONE )
-      << "skv_client_ccb_manager_if_t::RemoveFromFrontDoneCCBQueue(): "
-      << " DoneBlock->mState: " << DoneBlock->mState
-      << EndLogLine;
+    if( DoneBlock != NULL )
+      DoneBlock->WaitForDoneState();
 
     BegLogLine( SKV_CLIENT_DONE_QUEUE_LOG )
       << "skv_client_ccb_manager_if_t::RemoveFromFrontDoneCCBQueue(): Leaving "
+      << " DoneBlock: " << (void *) DoneBlock
       << EndLogLine;
 
     return DoneBlock;
@@ -605,7 +774,10 @@ public:
 
   /***
    * skv_client_ccb_manager_if_t::RemoveFromFrontFreeCCBQueue::
-   * Desc:
+   * Desc: reserves a ccb from the calling thread's partition,
+   *       takes one from another partition if that one is exhausted;
+   *       completions go to the caller's partition, the ccb itself
+   *       still returns to its home partition when it's released
    * input/output: aCCB
    * returns:
    * Or NULL if none are available
@@ -617,46 +789,123 @@ public:
       << "skv_client_ccb_manager_if_t::RemoveFromFrontFreeCCBQueue(): Entering "
       << EndLogLine;
 
-    if( mFreeCommandCtrlBlocks == NULL )
+    int MyPartition = GetThreadPartition();
+    skv_client_ccb_t* FreeBlock = NULL;
+
+    for( int i = 0; ( FreeBlock == NULL ) && ( i < SKV_CLIENT_CCB_PARTITIONS ); i++ )
+      FreeBlock = RemoveFromFrontFreeCCBQueue( & mPartitions[ ( MyPartition + i ) % SKV_CLIENT_CCB_PARTITIONS ] );
+
+    if( FreeBlock != NULL )
     {
-      BegLogLine( SKV_CLIENT_FREE_QUEUE_LOG )
-        << "skv_client_ccb_manager_if_t::RemoveFromFrontFreeCCBQueue(): FreeCommandCtrlBlocks is empty. Leaving... "
-        << EndLogLine;
+      FreeBlock->mPartition = MyPartition;
+      FreeBlock->mOwner = GetThreadToken();
+    }
 
-      return NULL;
+    BegLogLine( SKV_CLIENT_FREE_QUEUE_LOG )
+      << "skv_client_ccb_manager_if_t::RemoveFromFrontFreeCCBQueue(): Leaving "
+      << " FreeBlock: " << (void *) FreeBlock
+      << " partition: " << MyPartition
+      << EndLogLine;
+
+    return FreeBlock;
+  }
+
+  /***
+   * skv_client_ccb_manager_if_t::SetCompletionHandler::
+   * Desc: attach a callback or a completion queue to a pending command
+   * a command that already completed is moved from the done queue to delivery
+   * returns: SKV_SUCCESS or SKV_ERRNO_STATE_MACHINE_ERROR if the handle is
+   *          idle or has a handler already
+   ***/
+  skv_status_t
+  SetCompletionHandler( skv_client_ccb_t*                aCCB,
+                        skv_client_completion_cb_t       aCallback,
+                        skv_client_completion_queue_t*   aCompletionQueue,
+                        void*                            aContext )
+  {
+    skv_client_ccb_partition_t* Partition = & mPartitions[ aCCB->mPartition ];
+    Partition->mLock.lock();
+
+    if(( aCCB->GetState() == SKV_CLIENT_COMMAND_STATE_IDLE ) || aCCB->HasCompletionHandler() )
+    {
+      Partition->mLock.unlock();
+      return SKV_ERRNO_STATE_MACHINE_ERROR;
     }
 
-    skv_client_ccb_t* FreeBlock = mFreeCommandCtrlBlocks;
+    aCCB->mCallback = aCallback;
+    aCCB->mCompletionQueue = aCompletionQueue;
+    aCCB->mCallbackContext = aContext;
 
-    mFreeCommandCtrlBlocks = mFreeCommandCtrlBlocks->mNext;
+    bool Completed = aCCB->mCompleted;
+    if( Completed )
+      UnlinkDoneCCB( Partition, aCCB );
 
-    AssertLogLine( FreeBlock->mPrev == NULL )
-      << "skv_client_ccb_manager_if_t::RemoveFromFrontFreeCCBQueue(): "
-      << " FreeBlock: " << (void *) FreeBlock
-      << EndLogLine;
+    Partition->mLock.unlock();
 
-    // Detach the first block from the list
-    FreeBlock->mPrev = NULL;
-    FreeBlock->mNext = NULL;
+    if( Completed )
+      AddToNotifyQueue( aCCB );
 
-    if( mFreeCommandCtrlBlocks != NULL )
-      mFreeCommandCtrlBlocks->mPrev = NULL;
+    return SKV_SUCCESS;
+  }
 
-    AssertLogLine( FreeBlock->mState == SKV_CLIENT_COMMAND_STATE_IDLE )
-      << "skv_client_ccb_manager_if_t::RemoveFromFrontFreeCCBQueue(): "
-      << " FreeBlock->mState: " << FreeBlock->mState
-      << EndLogLine;
+  /***
+   * skv_client_ccb_manager_if_t::DeliverCompletions::
+   * Desc: runs the callbacks or fills the completion queues of completed
+   * commands with a handler; callback handles are released after the callback
+   * returns: number of delivered commands
+   ***/
+  int
+  DeliverCompletions()
+  {
+    if( __atomic_load_n( &mNotifyHead, __ATOMIC_RELAXED ) == NULL )
+      return 0;
 
-    BegLogLine( SKV_CLIENT_FREE_QUEUE_LOG )
-      << "skv_client_ccb_manager_if_t::RemoveFromFrontFreeCCBQueue(): Leaving "
-      << EndLogLine;
+    mNotifyLock.lock();
+    skv_client_ccb_t* CCB = mNotifyHead;
+    mNotifyHead = NULL;
+    mNotifyTail = NULL;
+    mNotifyLock.unlock();
 
-    return FreeBlock;
+    int Count = 0;
+    while( CCB != NULL )
+    {
+      skv_client_ccb_t* Next = CCB->mNext;
+      CCB->mNext = NULL;
+
+      CCB->WaitForDoneState();
+
+      BegLogLine( SKV_CLIENT_DONE_QUEUE_LOG )
+        << "skv_client_ccb_manager_if_t::DeliverCompletions(): "
+        << " CCB: " << (void *) CCB
+        << " status: " << skv_status_to_string( CCB->mStatus )
+        << " callback: " << (void *) CCB->mCallback
+        << " CQ: " << (void *) CCB->mCompletionQueue
+        << EndLogLine;
+
+      if( CCB->mCompletionQueue != NULL )
+        CCB->mCompletionQueue->Push( CCB );
+      else
+      {
+        CCB->mCallback( (skv_client_cmd_ext_hdl_t) CCB, CCB->mStatus, CCB->mCallbackContext );
+        AddToFreeCCBQueue( CCB );
+      }
+
+      Count++;
+      CCB = Next;
+    }
+    return Count;
+  }
+
+  skv_client_mr_cache_t*
+  GetMRCache()
+  {
+    return & mMRCache;
   }
 
   void
   Finalize()
   {
+    mMRCache.Finalize();
     it_lmr_free( mBaseHandle );
   }
 };
@@ -22,6 +22,7 @@
 #include <skv/server/skv_server_event_type.hpp>
 
 #include <skv/common/skv_client_server_headers.hpp>
+#include <skv/common/skv_crc32c.hpp>
 
 //#include <skv/server/skv_server_types.hpp>
 //#include <skv/server/skv_server_cursor_manager_if.hpp>
@@ -194,6 +195,7 @@ struct skv_cmd_RIU_req_t
   skv_pds_id_t                         mPDSId;
 
   skv_rmr_triplet_t                    mRMRTriplet;
+  uint32_t                             mValueChecksum;  // crc32c with SKV_COMMAND_RIU_VALUE_CHECKSUM
 
   /// CAREFUL!!! KeyInCtrlMsg can be a char[ 0 ]
   // This has to be the last field.
@@ -214,7 +216,7 @@ struct skv_cmd_RIU_req_t
         char* aKeyData,
         int aValueSize,
         char* aValueData,
-        it_pz_handle_t aPZHdl,
+        skv_client_mr_cache_t* aMRCache,
         it_lmr_handle_t* aKeyLMR,
         it_lmr_handle_t* aValueLMR )
   {
@@ -224,6 +226,10 @@ struct skv_cmd_RIU_req_t
     mOffset = aOffset;
     mFlags = aFlags;
 
+    mValueChecksum = 0;
+    if( ( aFlags & SKV_COMMAND_RIU_VALUE_CHECKSUM ) && ( aCmdType == SKV_COMMAND_INSERT ) )
+      mValueChecksum = skv_crc32c( 0, aValueData, aValueSize );
+
     mKeyValue.mKeySize = aKeySize;
     mKeyValue.mValueSize = aValueSize;
 
@@ -258,32 +264,11 @@ struct skv_cmd_RIU_req_t
       inlineDataSize += aValueSize;
     }
 
-    // create lmr for larger requests
+    // get (cached) lmr for larger requests
     if( aFlags & SKV_COMMAND_RIU_INSERT_KEY_FITS_IN_CTL_MSG )
     {
       it_lmr_handle_t lmrHandle;
-      it_rmr_context_t rmrHandle;   // watch out for ambiguous usage of this: with lmr_create it's the handle, with rmr_get_context it's the rkey!!
-
-      it_mem_priv_t privs = (it_mem_priv_t) (IT_PRIV_LOCAL | IT_PRIV_REMOTE);
-      it_lmr_flag_t lmr_flags = IT_LMR_FLAG_NON_SHAREABLE;
-
-      it_status_t status = it_lmr_create( aPZHdl,
-                                          aValueData,
-                                          NULL,
-                                          aValueSize,
-                                          IT_ADDR_MODE_ABSOLUTE,
-                                          privs,
-                                          lmr_flags,
-                                          0,
-                                          &lmrHandle,
-                                          &rmrHandle );
-
-      StrongAssertLogLine( status == IT_SUCCESS )
-          << "skv_cmd_retrieve_req_t::Init():: "
-          << " status: " << status
-          << EndLogLine;
-
-      *aValueLMR = lmrHandle;
+      it_rmr_context_t rmrHandle;
 
       /**
        * Need to get the actual rmr context for a given end point (ep)
@@ -296,11 +281,18 @@ struct skv_cmd_RIU_req_t
         << "ERROR: skv status: " << skv_status_to_string( pstatus )
         << EndLogLine;
 
-      status = itx_get_rmr_context_for_ep( epHandle, lmrHandle, & rmrHandle );  // here we put in the rmrHandle and get back the rkey!!
+      it_status_t status = aMRCache->Acquire( aValueData,
+                                              aValueSize,
+                                              epHandle,
+                                              &lmrHandle,
+                                              &rmrHandle );
 
-      AssertLogLine( status == IT_SUCCESS )
-        << "ERROR: status: " << status
-        << EndLogLine;
+      StrongAssertLogLine( status == IT_SUCCESS )
+          << "skv_cmd_RIU_req_t::Init():: "
+          << " status: " << status
+          << EndLogLine;
+
+      *aValueLMR = lmrHandle;
 
       mRMRTriplet.Init( rmrHandle, aValueData, aValueSize );
     }
@@ -320,6 +312,7 @@ struct skv_cmd_RIU_req_t
     mKeyValue.mValueSize=htonl(mKeyValue.mValueSize) ;
     mOffset=htonl(mOffset) ;
     mFlags=(skv_cmd_RIU_flags_t)htonl(mFlags) ;
+    mValueChecksum=htonl(mValueChecksum) ;
   }
 
   static size_t GetMaxPayloadSize()
@@ -396,6 +389,7 @@ struct skv_cmd_bulk_insert_req_t
 
   skv_pds_id_t                         mPDSId;
   int                                  mBufferSize;
+  int                                  mFlags;      // skv_bulk_inserter_flags_t
   it_rmr_context_t                     mBufferRMR;
   uint64_t                             mBuffer;
 
@@ -414,6 +408,7 @@ struct skv_cmd_bulk_insert_req_t
         int aBufferSize,
         it_lmr_handle_t aBufferLMR,
         // it_rmr_context_t               aBufferRMR,
+        int aFlags,
         uint64_t aBufferChecksum )
   {
     AssertLogLine( sizeof( skv_cmd_bulk_insert_req_t ) < SKV_CONTROL_MESSAGE_SIZE )
@@ -435,6 +430,7 @@ struct skv_cmd_bulk_insert_req_t
     mPDSId = *aPDSId;
     mBuffer = (uint64_t) ((uintptr_t) aBuffer);
     mBufferSize = aBufferSize;
+    mFlags = aFlags;
 
     /**
      * Need to get the actual rmr context for a given end point (ep)
@@ -462,6 +458,91 @@ struct skv_cmd_bulk_insert_req_t
       << "Endian convert mBufferSize=" << mBufferSize
       << EndLogLine ;
     mBufferSize=htonl(mBufferSize) ;
+    mFlags=htonl(mFlags) ;
+  }
+};
+
+/***************************************************
+ * one request per server for a set of keys
+ * the server rdma-reads the packed rows from mRequestBuffer
+ * and rdma-writes the per-key results into mResultBuffer
+ * (see skv_multi_key_* in skv_types.hpp)
+ **************************************************/
+struct skv_cmd_multi_key_req_t
+{
+  skv_client_to_server_cmd_hdr_t       mHdr;
+
+  skv_pds_id_t                         mPDSId;
+  skv_command_type_t                   mOp;         // SKV_COMMAND_INSERT or SKV_COMMAND_RETRIEVE
+  skv_cmd_RIU_flags_t                  mFlags;
+  int                                  mKeyCount;
+  int                                  mRequestSize;
+  int                                  mResultSize;
+  it_rmr_context_t                     mBufferRMR;  // covers request and result buffer
+  uint64_t                             mRequestBuffer;
+  uint64_t                             mResultBuffer;
+
+  void
+  Init( int aNodeId,
+        skv_client_conn_manager_if_t* aConnMgr,
+        skv_pds_id_t* aPDSId,
+        skv_command_type_t aCmdType,
+        skv_server_event_type_t aEventType,
+        skv_client_ccb_t* aCmdCtrlBlk,
+        skv_command_type_t aOp,
+        skv_cmd_RIU_flags_t aFlags,
+        int aKeyCount,
+        char* aRequestBuffer,
+        int aRequestSize,
+        char* aResultBuffer,
+        int aResultSize,
+        it_lmr_handle_t aBufferLMR )
+  {
+    AssertLogLine( sizeof( skv_cmd_multi_key_req_t ) < SKV_CONTROL_MESSAGE_SIZE )
+      << "ERROR: "
+      << " sizeof( skv_cmd_multi_key_req_t ): " << sizeof( skv_cmd_multi_key_req_t )
+      << " SKV_CONTROL_MESSAGE_SIZE: " << SKV_CONTROL_MESSAGE_SIZE
+      << EndLogLine;
+
+    mHdr.Init( aEventType, aCmdCtrlBlk, aCmdType );
+
+    mPDSId = *aPDSId;
+    mOp = aOp;
+    mFlags = aFlags;
+    mKeyCount = aKeyCount;
+    mRequestBuffer = (uint64_t) ((uintptr_t) aRequestBuffer);
+    mRequestSize = aRequestSize;
+    mResultBuffer = (uint64_t) ((uintptr_t) aResultBuffer);
+    mResultSize = aResultSize;
+
+    // rmr keys are specific to the network device of the ep
+    it_ep_handle_t epHandle;
+    skv_status_t pstatus = aConnMgr->GetEPHandle( aNodeId, &epHandle );
+    AssertLogLine( pstatus == SKV_SUCCESS )
+      << "ERROR: skv status: " << skv_status_to_string( pstatus )
+      << EndLogLine;
+
+    it_status_t status = itx_get_rmr_context_for_ep( epHandle, aBufferLMR, & mBufferRMR );
+
+    AssertLogLine( status == IT_SUCCESS )
+      << "ERROR: status: " << status
+      << EndLogLine;
+
+    mHdr.SetCmdLength( sizeof(skv_cmd_multi_key_req_t) );
+  }
+  void
+  EndianConvert(void)
+  {
+    BegLogLine(SKV_CLIENT_ENDIAN_LOG)
+      << "Endian convert mKeyCount=" << mKeyCount
+      << " mRequestSize=" << mRequestSize
+      << " mResultSize=" << mResultSize
+      << EndLogLine ;
+    mOp=(skv_command_type_t)htonl(mOp) ;
+    mFlags=(skv_cmd_RIU_flags_t)htonl(mFlags) ;
+    mKeyCount=htonl(mKeyCount) ;
+    mRequestSize=htonl(mRequestSize) ;
+    mResultSize=htonl(mResultSize) ;
   }
 };
 
@@ -53,6 +53,19 @@ skv_configuration_t::skv_configuration_t( )
   mPersistentFileLocalPath = DEFAULT_SKV_PERSISTENT_FILE_LOCAL_PATH;
 
   mRdmaMemoryLimit = DEFAULT_SKV_RDMA_MEMORY_LIMIT;
+
+  mWriteBatchSize = DEFAULT_SKV_WRITE_BATCH_SIZE;
+  mWriteBatchDelay = DEFAULT_SKV_WRITE_BATCH_DELAY;
+  mWriteSync = DEFAULT_SKV_WRITE_SYNC;
+  mServerReactors = DEFAULT_SKV_SERVER_REACTORS;
+  mServerPollSpin = DEFAULT_SKV_SERVER_POLL_SPIN;
+  mServerPollMaxSleep = DEFAULT_SKV_SERVER_POLL_MAX_SLEEP;
+  mServerSocketReceivers = DEFAULT_SKV_SERVER_SOCKET_RECEIVERS;
+  mClientMRCacheSize = DEFAULT_SKV_CLIENT_MR_CACHE_SIZE;
+  mClientPollSpin = DEFAULT_SKV_CLIENT_POLL_SPIN;
+  mClientPollMaxSleep = DEFAULT_SKV_CLIENT_POLL_MAX_SLEEP;
+  mClientBulkInsertBufferSize = DEFAULT_SKV_CLIENT_BULK_INSERT_BUFFER_SIZE;
+  mClientBulkInsertBuffers = DEFAULT_SKV_CLIENT_BULK_INSERT_BUFFERS;
 }
 
 // get the location and name of the config file
@@ -204,6 +217,82 @@ skv_configuration_t::ReadConfigurationFile( const char *aConfigFile )
             mRdmaMemoryLimit = std::strtoll( cline.substr( valueIndex ).c_str(), NULL, 10 ) * 1024 * 1024;
             break;
 
+          case SKV_CONFIG_SETTING_WRITE_BATCH_SIZE:
+            mWriteBatchSize = std::strtoll( cline.substr( valueIndex ).c_str(), NULL, 10 ) * 1024;
+            break;
+
+          case SKV_CONFIG_SETTING_WRITE_BATCH_DELAY:
+            mWriteBatchDelay = std::strtoll( cline.substr( valueIndex ).c_str(), NULL, 10 );
+            break;
+
+          case SKV_CONFIG_SETTING_WRITE_SYNC:
+            mWriteSync = ( atoi( cline.substr( valueIndex ).c_str() ) != 0 );
+            break;
+
+          case SKV_CONFIG_SETTING_PDS_OPTIONS:
+          {
+            // <PDS name prefix|*> <options>
+            string value = cline.substr( valueIndex );
+            size_t split = value.find_first_of( " \t" );
+            size_t options = value.find_first_not_of( " \t", split );
+            if( options == string::npos )
+            {
+              BegLogLine( 1 )
+                << "skv_configuration_t::ReadConfigurationFile():: missing options in"
+                << " line: " << line_number
+                << " : " << cline.c_str()
+                << EndLogLine;
+              break;
+            }
+            string prefix = value.substr( 0, split );
+            if( prefix == "*" )
+              prefix.clear();
+            mPDSOptions.push_back( make_pair( prefix, value.substr( options ) ) );
+            break;
+          }
+
+          case SKV_CONFIG_SETTING_CLIENT_MR_CACHE_SIZE:
+            mClientMRCacheSize = std::strtoll( cline.substr( valueIndex ).c_str(), NULL, 10 ) * 1024 * 1024;
+            break;
+
+          case SKV_CONFIG_SETTING_SERVER_REACTORS:
+          {
+            long long reactors = std::strtoll( cline.substr( valueIndex ).c_str(), NULL, 10 );
+            mServerReactors = ( reactors < 1 ) ? 1 : reactors;
+            break;
+          }
+
+          case SKV_CONFIG_SETTING_SERVER_POLL_SPIN:
+            mServerPollSpin = std::strtoll( cline.substr( valueIndex ).c_str(), NULL, 10 );
+            break;
+
+          case SKV_CONFIG_SETTING_SERVER_POLL_MAX_SLEEP:
+            mServerPollMaxSleep = std::strtoll( cline.substr( valueIndex ).c_str(), NULL, 10 );
+            break;
+
+          case SKV_CONFIG_SETTING_SERVER_SOCKET_RECEIVERS:
+          {
+            long long receivers = std::strtoll( cline.substr( valueIndex ).c_str(), NULL, 10 );
+            mServerSocketReceivers = ( receivers < 1 ) ? 1 : receivers;
+            break;
+          }
+
+          case SKV_CONFIG_SETTING_CLIENT_POLL_SPIN:
+            mClientPollSpin = std::strtoll( cline.substr( valueIndex ).c_str(), NULL, 10 );
+            break;
+
+          case SKV_CONFIG_SETTING_CLIENT_POLL_MAX_SLEEP:
+            mClientPollMaxSleep = std::strtoll( cline.substr( valueIndex ).c_str(), NULL, 10 );
+            break;
+
+          case SKV_CONFIG_SETTING_CLIENT_BULK_INSERT_BUFFER_SIZE:
+            mClientBulkInsertBufferSize = std::strtoll( cline.substr( valueIndex ).c_str(), NULL, 10 ) * 1024;
+            break;
+
+          case SKV_CONFIG_SETTING_CLIENT_BULK_INSERT_BUFFERS:
+            mClientBulkInsertBuffers = std::strtoll( cline.substr( valueIndex ).c_str(), NULL, 10 );
+            break;
+
           default:
             BegLogLine( 1 )
               << "skv_configuration_t::ReadConfigurationFile():: unknown parameter in"
@@ -243,6 +332,19 @@ skv_configuration_t::ReadConfigurationFile( const char *aConfigFile )
     << " persLocalFile: " << mPersistentFileLocalPath.c_str()
     << " commIF: " << mCommIF.c_str()
     << " RDMAmemLimit: " << mRdmaMemoryLimit
+    << " writeBatch: " << mWriteBatchSize
+    << " writeDelay: " << mWriteBatchDelay
+    << " writeSync: " << mWriteSync
+    << " PDSOptions: " << mPDSOptions.size()
+    << " reactors: " << mServerReactors
+    << " serverPollSpin: " << mServerPollSpin
+    << " serverPollMaxSleep: " << mServerPollMaxSleep
+    << " socketReceivers: " << mServerSocketReceivers
+    << " clientMRCache: " << mClientMRCacheSize
+    << " clientPollSpin: " << mClientPollSpin
+    << " clientPollMaxSleep: " << mClientPollMaxSleep
+    << " clientBulkBufferSize: " << mClientBulkInsertBufferSize
+    << " clientBulkBuffers: " << mClientBulkInsertBuffers
     << EndLogLine;
 
   return status;
@@ -275,10 +377,48 @@ skv_configuration_t::GetVariableCase( const string s, size_t *valueIndex )
 
     if( s.find( "RDMA_MEMORY") != string::npos )
       setting = SKV_CONFIG_SETTING_RDMA_MEMORY_LIMIT;
+
+    if( s.find( "WRITE_BATCH_SIZE") != string::npos )
+      setting = SKV_CONFIG_SETTING_WRITE_BATCH_SIZE;
+
+    if( s.find( "WRITE_BATCH_DELAY") != string::npos )
+      setting = SKV_CONFIG_SETTING_WRITE_BATCH_DELAY;
+
+    if( s.find( "WRITE_SYNC") != string::npos )
+      setting = SKV_CONFIG_SETTING_WRITE_SYNC;
+
+    if( s.find( "PDS_OPTIONS") != string::npos )
+      setting = SKV_CONFIG_SETTING_PDS_OPTIONS;
+
+    if( s.find( "REACTORS") != string::npos )
+      setting = SKV_CONFIG_SETTING_SERVER_REACTORS;
+
+    if( s.find( "POLL_SPIN") != string::npos )
+      setting = SKV_CONFIG_SETTING_SERVER_POLL_SPIN;
+
+    if( s.find( "POLL_MAX_SLEEP") != string::npos )
+      setting = SKV_CONFIG_SETTING_SERVER_POLL_MAX_SLEEP;
+
+    if( s.find( "SOCKET_RECEIVERS") != string::npos )
+      setting = SKV_CONFIG_SETTING_SERVER_SOCKET_RECEIVERS;
   }
   // client variables
   else if( s.find( "SKV_CLIENT" ) != string::npos )
   {
+    if( s.find( "MR_CACHE_SIZE" ) != string::npos )
+      setting = SKV_CONFIG_SETTING_CLIENT_MR_CACHE_SIZE;
+
+    if( s.find( "POLL_SPIN" ) != string::npos )
+      setting = SKV_CONFIG_SETTING_CLIENT_POLL_SPIN;
+
+    if( s.find( "POLL_MAX_SLEEP" ) != string::npos )
+      setting = SKV_CONFIG_SETTING_CLIENT_POLL_MAX_SLEEP;
+
+    if( s.find( "BULK_INSERT_BUFFER_SIZE" ) != string::npos )
+      setting = SKV_CONFIG_SETTING_CLIENT_BULK_INSERT_BUFFER_SIZE;
+
+    if( s.find( "BULK_INSERT_BUFFERS" ) != string::npos )
+      setting = SKV_CONFIG_SETTING_CLIENT_BULK_INSERT_BUFFERS;
   }
 
   // other/general variables
@@ -377,6 +517,94 @@ skv_configuration_t::GetRdmaMemoryLimit() const
   return mRdmaMemoryLimit;
 }
 
+const uint64_t
+skv_configuration_t::GetWriteBatchSize() const
+{
+  return mWriteBatchSize;
+}
+
+const uint64_t
+skv_configuration_t::GetWriteBatchDelay() const
+{
+  return mWriteBatchDelay;
+}
+
+const bool
+skv_configuration_t::GetWriteSync() const
+{
+  return mWriteSync;
+}
+
+const uint64_t
+skv_configuration_t::GetServerReactors() const
+{
+  return mServerReactors;
+}
+
+const uint64_t
+skv_configuration_t::GetServerPollSpin() const
+{
+  return mServerPollSpin;
+}
+
+const uint64_t
+skv_configuration_t::GetServerPollMaxSleep() const
+{
+  return mServerPollMaxSleep;
+}
+
+const uint64_t
+skv_configuration_t::GetServerSocketReceivers() const
+{
+  return mServerSocketReceivers;
+}
+
+const uint64_t
+skv_configuration_t::GetClientMRCacheSize() const
+{
+  return mClientMRCacheSize;
+}
+
+const uint64_t
+skv_configuration_t::GetClientPollSpin() const
+{
+  return mClientPollSpin;
+}
+
+const uint64_t
+skv_configuration_t::GetClientPollMaxSleep() const
+{
+  return mClientPollMaxSleep;
+}
+
+const uint64_t
+skv_configuration_t::GetClientBulkInsertBufferSize() const
+{
+  return mClientBulkInsertBufferSize;
+}
+
+const uint64_t
+skv_configuration_t::GetClientBulkInsertBuffers() const
+{
+  return mClientBulkInsertBuffers;
+}
+
+const string
+skv_configuration_t::GetPDSOptions( const char* aPDSName ) const
+{
+  string PDSName( aPDSName );
+  size_t best = string::npos;
+  for( size_t i = 0; i < mPDSOptions.size(); i++ )
+  {
+    if( ( PDSName.compare( 0, mPDSOptions[ i ].first.length(), mPDSOptions[ i ].first ) == 0 ) &&
+        ( ( best == string::npos ) || ( mPDSOptions[ i ].first.length() > mPDSOptions[ best ].first.length() ) ) )
+      best = i;
+  }
+  if( best == string::npos )
+    return string();
+  return mPDSOptions[ best ].second;
+}
+
 const string
 skv_configuration_t::GetConfigFileName() const
 {
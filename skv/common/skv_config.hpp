@@ -15,6 +15,8 @@
 #define __SKV_CONFIG_HPP__
 
 #include <string>
+#include <vector>
+#include <utility>
 using namespace std;            // that's a bad place for using... ;-)...
 
 #define DEFAULT_SKV_CONFIG_FILE_NAME "skv_server.conf"
@@ -31,6 +33,18 @@ using namespace std;            // that's a bad place for using... ;-)...
 #define DEFAULT_SKV_PERSISTENT_FILE_LOCAL_PATH "/tmp/skv_store"
 #define DEFAULT_SKV_COMM_IF "roq0"
 #define DEFAULT_SKV_RDMA_MEMORY_LIMIT ( 2 * 1024 * 1024 * 1024 )
+#define DEFAULT_SKV_WRITE_BATCH_SIZE ( 1024 * 1024 )
+#define DEFAULT_SKV_WRITE_BATCH_DELAY ( 500 )
+#define DEFAULT_SKV_WRITE_SYNC ( false )
+#define DEFAULT_SKV_SERVER_REACTORS ( 1 )
+#define DEFAULT_SKV_SERVER_POLL_SPIN ( 16384 )
+#define DEFAULT_SKV_SERVER_POLL_MAX_SLEEP ( 0 )
+#define DEFAULT_SKV_SERVER_SOCKET_RECEIVERS ( 1 )
+#define DEFAULT_SKV_CLIENT_MR_CACHE_SIZE ( 0 )
+#define DEFAULT_SKV_CLIENT_POLL_SPIN ( 4096 )
+#define DEFAULT_SKV_CLIENT_POLL_MAX_SLEEP ( 256 )
+#define DEFAULT_SKV_CLIENT_BULK_INSERT_BUFFER_SIZE ( 64 * 1024 )
+#define DEFAULT_SKV_CLIENT_BULK_INSERT_BUFFERS ( 4 )
 
 typedef enum {
   SKV_CONFIG_SETTING_UNDEFINED,
@@ -41,7 +55,20 @@ typedef enum {
   SKV_CONFIG_SETTING_PERSISTENT_FILENAME,
   SKV_CONFIG_SETTING_PERSISTENT_FILE_LOCAL_PATH,
   SKV_CONFIG_SETTING_COMM_IF,
-  SKV_CONFIG_SETTING_RDMA_MEMORY_LIMIT
+  SKV_CONFIG_SETTING_RDMA_MEMORY_LIMIT,
+  SKV_CONFIG_SETTING_WRITE_BATCH_SIZE,
+  SKV_CONFIG_SETTING_WRITE_BATCH_DELAY,
+  SKV_CONFIG_SETTING_WRITE_SYNC,
+  SKV_CONFIG_SETTING_PDS_OPTIONS,
+  SKV_CONFIG_SETTING_SERVER_REACTORS,
+  SKV_CONFIG_SETTING_SERVER_POLL_SPIN,
+  SKV_CONFIG_SETTING_SERVER_POLL_MAX_SLEEP,
+  SKV_CONFIG_SETTING_SERVER_SOCKET_RECEIVERS,
+  SKV_CONFIG_SETTING_CLIENT_MR_CACHE_SIZE,
+  SKV_CONFIG_SETTING_CLIENT_POLL_SPIN,
+  SKV_CONFIG_SETTING_CLIENT_POLL_MAX_SLEEP,
+  SKV_CONFIG_SETTING_CLIENT_BULK_INSERT_BUFFER_SIZE,
+  SKV_CONFIG_SETTING_CLIENT_BULK_INSERT_BUFFERS
 } skv_config_setting_t;
 
 
@@ -58,6 +85,19 @@ class skv_configuration_t
   string    mPersistentFileLocalPath;
   string    mCommIF;
   uint64_t  mRdmaMemoryLimit;
+  uint64_t  mWriteBatchSize;    // bytes
+  uint64_t  mWriteBatchDelay;   // usec
+  bool      mWriteSync;
+  vector< pair< string, string > > mPDSOptions;  // { PDS name prefix, backend options }
+  uint64_t  mServerReactors;    // server threads that each own a subset of the endpoints
+  uint64_t  mServerPollSpin;    // empty main loops before the server sleeps
+  uint64_t  mServerPollMaxSleep; // usec
+  uint64_t  mServerSocketReceivers; // receiver threads of the sockets transport
+  uint64_t  mClientMRCacheSize; // bytes
+  uint64_t  mClientPollSpin;    // empty polls before a waiting client backs off
+  uint64_t  mClientPollMaxSleep; // usec
+  uint64_t  mClientBulkInsertBufferSize; // bytes
+  uint64_t  mClientBulkInsertBuffers;    // in-flight buffers per server
 
   string    mConfigFile;
 
@@ -86,6 +126,24 @@ public:
 
   const uint64_t GetRdmaMemoryLimit() const;
 
+  const uint64_t GetWriteBatchSize() const;
+  const uint64_t GetWriteBatchDelay() const;
+  const bool GetWriteSync() const;
+
+  // backend options of the longest matching PDS name prefix ("" if none)
+  const string GetPDSOptions( const char* aPDSName ) const;
+
+  const uint64_t GetServerReactors() const;
+  const uint64_t GetServerPollSpin() const;
+  const uint64_t GetServerPollMaxSleep() const;
+  const uint64_t GetServerSocketReceivers() const;
+
+  const uint64_t GetClientMRCacheSize() const;
+  const uint64_t GetClientPollSpin() const;
+  const uint64_t GetClientPollMaxSleep() const;
+  const uint64_t GetClientBulkInsertBufferSize() const;
+  const uint64_t GetClientBulkInsertBuffers() const;
+
   const string GetConfigFileName() const;
 };
 
@@ -0,0 +1,207 @@
+/************************************************
+ * Copyright (c) IBM Corp. 2014
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * which accompanies this distribution, and is available at
+ * http://www.eclipse.org/legal/epl-v10.html
+ *************************************************/
+
+/*
+ * CRC32C (Castagnoli) checksum of bulk insert buffers and values
+ *  - SSE4.2 crc32 instruction on x86_64
+ *  - ARMv8 crc32c instructions on aarch64
+ *  - slicing-by-8 table lookup everywhere else
+ * The instruction set is checked once at runtime, so the binary doesn't
+ * need to be built with -msse4.2 or +crc.
+ *
+ * The crc is streamable:
+ *   skv_crc32c( skv_crc32c( 0, A, a ), B, b ) == skv_crc32c( 0, AB, a+b )
+ */
+
+#ifndef __SKV_CRC32C_HPP__
+#define __SKV_CRC32C_HPP__
+
+#include <cstddef>
+#include <stdint.h>
+#include <string.h>
+
+#if defined( __x86_64__ ) && defined( __GNUC__ )
+#define SKV_CRC32C_HW_X86
+#include <nmmintrin.h>
+#elif defined( __aarch64__ ) && defined( __GNUC__ ) && defined( __linux__ )
+#define SKV_CRC32C_HW_ARM
+#include <arm_acle.h>
+#include <sys/auxv.h>
+#include <asm/hwcap.h>
+#endif
+
+#define SKV_CRC32C_POLY ( 0x82F63B78 )   // reflected Castagnoli polynomial
+
+struct skv_crc32c_table_t
+{
+  uint32_t mTable[ 8 ][ 256 ];
+
+  skv_crc32c_table_t()
+  {
+    for( int n = 0; n < 256; n++ )
+    {
+      uint32_t crc = n;
+      for( int k = 0; k < 8; k++ )
+        crc = ( crc & 1 ) ? ( crc >> 1 ) ^ SKV_CRC32C_POLY : ( crc >> 1 );
+      mTable[ 0 ][ n ] = crc;
+    }
+    for( int n = 0; n < 256; n++ )
+      for( int t = 1; t < 8; t++ )
+        mTable[ t ][ n ] = ( mTable[ t - 1 ][ n ] >> 8 ) ^ mTable[ 0 ][ mTable[ t - 1 ][ n ] & 0xff ];
+  }
+};
+
+static inline
+const skv_crc32c_table_t&
+skv_crc32c_table()
+{
+  static const skv_crc32c_table_t Table;
+  return Table;
+}
+
+/***
+ * skv_crc32c_sw::
+ * Desc: table based crc32c, processes 8 bytes per step
+ * input: crc of the preceding data (0 to start), data and length
+ * returns: crc including aData
+ ***/
+static inline
+uint32_t
+skv_crc32c_sw( uint32_t aCRC, const void* aData, size_t aLen )
+{
+  const uint32_t (*T)[ 256 ] = skv_crc32c_table().mTable;
+  const unsigned char* p = (const unsigned char*) aData;
+  uint32_t crc = ~aCRC;
+
+  for( ; aLen && ( (uintptr_t) p & 7 ); aLen--, p++ )
+    crc = ( crc >> 8 ) ^ T[ 0 ][ ( crc ^ *p ) & 0xff ];
+
+  for( ; aLen >= 8; aLen -= 8, p += 8 )
+  {
+    uint32_t lo, hi;
+    memcpy( &lo, p, 4 );
+    memcpy( &hi, p + 4, 4 );
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    lo = __builtin_bswap32( lo );
+    hi = __builtin_bswap32( hi );
+#endif
+    lo ^= crc;
+    crc = T[ 7 ][ lo & 0xff ] ^ T[ 6 ][ ( lo >> 8 ) & 0xff ] ^
+          T[ 5 ][ ( lo >> 16 ) & 0xff ] ^ T[ 4 ][ lo >> 24 ] ^
+          T[ 3 ][ hi & 0xff ] ^ T[ 2 ][ ( hi >> 8 ) & 0xff ] ^
+          T[ 1 ][ ( hi >> 16 ) & 0xff ] ^ T[ 0 ][ hi >> 24 ];
+  }
+
+  for( ; aLen; aLen--, p++ )
+    crc = ( crc >> 8 ) ^ T[ 0 ][ ( crc ^ *p ) & 0xff ];
+
+  return ~crc;
+}
+
+#if defined( SKV_CRC32C_HW_X86 )
+
+__attribute__(( target( "sse4.2" ) ))
+static inline
+uint32_t
+skv_crc32c_hw( uint32_t aCRC, const void* aData, size_t aLen )
+{
+  const unsigned char* p = (const unsigned char*) aData;
+  uint64_t crc = (uint32_t) ~aCRC;
+
+  for( ; aLen && ( (uintptr_t) p & 7 ); aLen--, p++ )
+    crc = _mm_crc32_u8( (uint32_t) crc, *p );
+
+  for( ; aLen >= 8; aLen -= 8, p += 8 )
+  {
+    uint64_t v;
+    memcpy( &v, p, 8 );
+    crc = _mm_crc32_u64( crc, v );
+  }
+
+  for( ; aLen; aLen--, p++ )
+    crc = _mm_crc32_u8( (uint32_t) crc, *p );
+
+  return ~(uint32_t) crc;
+}
+
+static inline
+bool
+skv_crc32c_hw_available()
+{
+  static const bool Available = __builtin_cpu_supports( "sse4.2" );
+  return Available;
+}
+
+#elif defined( SKV_CRC32C_HW_ARM )
+
+__attribute__(( target( "+crc" ) ))
+static inline
+uint32_t
+skv_crc32c_hw( uint32_t aCRC, const void* aData, size_t aLen )
+{
+  const unsigned char* p = (const unsigned char*) aData;
+  uint32_t crc = ~aCRC;
+
+  for( ; aLen && ( (uintptr_t) p & 7 ); aLen--, p++ )
+    crc = __crc32cb( crc, *p );
+
+  for( ; aLen >= 8; aLen -= 8, p += 8 )
+  {
+    uint64_t v;
+    memcpy( &v, p, 8 );
+    crc = __crc32cd( crc, v );
+  }
+
+  for( ; aLen; aLen--, p++ )
+    crc = __crc32cb( crc, *p );
+
+  return ~crc;
+}
+
+static inline
+bool
+skv_crc32c_hw_available()
+{
+  static const bool Available = ( getauxval( AT_HWCAP ) & HWCAP_CRC32 ) != 0;
+  return Available;
+}
+
+#else
+
+static inline
+uint32_t
+skv_crc32c_hw( uint32_t aCRC, const void* aData, size_t aLen )
+{
+  return skv_crc32c_sw( aCRC, aData, aLen );
+}
+
+static inline
+bool
+skv_crc32c_hw_available()
+{
+  return false;
+}
+
+#endif
+
+/***
+ * skv_crc32c::
+ * Desc: crc32c of a buffer, uses the crc instructions if the cpu has them
+ * input: crc of the preceding data (0 to start), data and length
+ * returns: crc including aData
+ ***/
+static inline
+uint32_t
+skv_crc32c( uint32_t aCRC, const void* aData, size_t aLen )
+{
+  if( skv_crc32c_hw_available() )
+    return skv_crc32c_hw( aCRC, aData, aLen );
+  return skv_crc32c_sw( aCRC, aData, aLen );
+}
+
+#endif // __SKV_CRC32C_HPP__
@@ -114,6 +114,25 @@ GetNode( const char** aListOfDataElem, int* aListOfSizesOfData, int aListElement
   return  ( hashValue % mCount );
 }
 
+/***
+ * skv_distribution_hash_t::GetShard::
+ * Desc: Selects one of aShardCount local partitions for a key
+ * Uses the hash bits above the node selection, since all keys
+ * stored on one node share the same ( hash % mCount )
+ * returns: shard index in [ 0, aShardCount )
+ ***/
+int
+skv_distribution_hash_t::
+GetShard( const char* aData, int aLen, int aShardCount ) const
+{
+  if( aShardCount <= 1 )
+    return 0;
+
+  HashKeyT hashValue = mHashFunc.GetHash( aData, aLen );
+
+  return ( hashValue / mCount ) % aShardCount;
+}
+
 /******************
  * Random-based distirbution
  *****************/
@@ -180,6 +180,9 @@ struct skv_distribution_hash_t
   // Input is a list of points to data
   // with a parallel list of data lengths
   int GetNode( const char** aListOfDataElem, int* aListOfSizesOfData, int aListElementCount ) const;
+
+  // local partition of a key within the owning node
+  int GetShard( const char* aData, int aLen, int aShardCount ) const;
 };
 
 template<class streamclass>
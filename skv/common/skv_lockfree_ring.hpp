@@ -0,0 +1,252 @@
+/************************************************
+ * Copyright (c) IBM Corp. 2014
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * which accompanies this distribution, and is available at
+ * http://www.eclipse.org/legal/epl-v10.html
+ *************************************************/
+
+/*
+ * Bounded lock-free rings for the hand-off between the server main loop
+ * and the local-kv worker threads
+ *  - skv_spsc_ring_t: exactly one producer thread and one consumer thread
+ *  - skv_mpsc_ring_t: any number of producer threads, one consumer thread
+ * The capacity is rounded up to the next power of 2.
+ */
+
+#ifndef __SKV_LOCKFREE_RING_HPP__
+#define __SKV_LOCKFREE_RING_HPP__
+
+#include <atomic>
+#include <cstddef>
+#include <FxLogger.hpp>
+
+#ifndef SKV_CACHE_LINE_SIZE
+#define SKV_CACHE_LINE_SIZE ( 64 )
+#endif
+
+static inline
+size_t
+skv_ring_capacity( size_t aMinCapacity )
+{
+  size_t Capacity = 2;
+  while( Capacity < aMinCapacity )
+    Capacity <<= 1;
+  return Capacity;
+}
+
+/***
+ * Producer and consumer each own one index on its own cache line and keep
+ * a cached copy of the other side's index, so the shared line is only read
+ * when the ring looks full (producer) or empty (consumer)
+ ***/
+template<class T>
+class skv_spsc_ring_t
+{
+  T*                  mRing;
+  size_t              mMask;
+  char                mPad0[ SKV_CACHE_LINE_SIZE ];
+
+  // producer side
+  std::atomic<size_t> mTail;
+  size_t              mHeadCache;
+  char                mPad1[ SKV_CACHE_LINE_SIZE ];
+
+  // consumer side
+  std::atomic<size_t> mHead;
+  size_t              mTailCache;
+  char                mPad2[ SKV_CACHE_LINE_SIZE ];
+
+public:
+  skv_spsc_ring_t( const size_t aCapacity )
+  {
+    mMask = skv_ring_capacity( aCapacity ) - 1;
+    mRing = new T[ mMask + 1 ];
+    mTail.store( 0, std::memory_order_relaxed );
+    mHead.store( 0, std::memory_order_relaxed );
+    mHeadCache = 0;
+    mTailCache = 0;
+  }
+  ~skv_spsc_ring_t()
+  {
+    delete [] mRing;
+  }
+
+  size_t capacity() const
+  {
+    return mMask + 1;
+  }
+
+  // producer only
+  bool push( const T& aElement )
+  {
+    size_t Tail = mTail.load( std::memory_order_relaxed );
+    if( Tail - mHeadCache > mMask )
+    {
+      mHeadCache = mHead.load( std::memory_order_acquire );
+      if( Tail - mHeadCache > mMask )
+        return false;
+    }
+    mRing[ Tail & mMask ] = aElement;
+    mTail.store( Tail + 1, std::memory_order_release );
+    return true;
+  }
+
+  // consumer only
+  bool pop( T& aElement )
+  {
+    size_t Head = mHead.load( std::memory_order_relaxed );
+    if( Head == mTailCache )
+    {
+      mTailCache = mTail.load( std::memory_order_acquire );
+      if( Head == mTailCache )
+        return false;
+    }
+    aElement = mRing[ Head & mMask ];
+    mHead.store( Head + 1, std::memory_order_release );
+    return true;
+  }
+
+  // consumer only: oldest element without removing it or NULL if there is none
+  const T* front()
+  {
+    size_t Head = mHead.load( std::memory_order_relaxed );
+    if( Head == mTailCache )
+    {
+      mTailCache = mTail.load( std::memory_order_acquire );
+      if( Head == mTailCache )
+        return NULL;
+    }
+    return &mRing[ Head & mMask ];
+  }
+
+  // approximate if called concurrently with push/pop
+  size_t size() const
+  {
+    return mTail.load( std::memory_order_acquire ) - mHead.load( std::memory_order_acquire );
+  }
+
+  bool empty() const
+  {
+    return size() == 0;
+  }
+};
+
+/***
+ * Bounded multi-producer ring with a sequence number per slot
+ * (D. Vyukov's bounded queue, reduced to a single consumer).
+ * Elements are stored by value, the consumer accesses the oldest
+ * element in place with front() and releases it with pop()
+ ***/
+template<class T>
+class skv_mpsc_ring_t
+{
+  struct slot_t
+  {
+    std::atomic<size_t> mSeq;
+    T                   mData;
+  };
+
+  slot_t*             mRing;
+  size_t              mMask;
+  char                mPad0[ SKV_CACHE_LINE_SIZE ];
+
+  // shared by the producers
+  std::atomic<size_t> mTail;
+  char                mPad1[ SKV_CACHE_LINE_SIZE ];
+
+  // consumer side
+  size_t              mHead;
+  char                mPad2[ SKV_CACHE_LINE_SIZE ];
+
+public:
+  skv_mpsc_ring_t( const size_t aCapacity )
+  {
+    mMask = skv_ring_capacity( aCapacity ) - 1;
+    mRing = new slot_t[ mMask + 1 ];
+    for( size_t i = 0; i <= mMask; i++ )
+      mRing[ i ].mSeq.store( i, std::memory_order_relaxed );
+    mTail.store( 0, std::memory_order_relaxed );
+    mHead = 0;
+  }
+  ~skv_mpsc_ring_t()
+  {
+    delete [] mRing;
+  }
+
+  size_t capacity() const
+  {
+    return mMask + 1;
+  }
+
+  // any thread
+  bool push( const T& aElement )
+  {
+    size_t Tail = mTail.load( std::memory_order_relaxed );
+    slot_t *Slot;
+    for( ;; )
+    {
+      Slot = &mRing[ Tail & mMask ];
+      size_t Seq = Slot->mSeq.load( std::memory_order_acquire );
+      ptrdiff_t Diff = (ptrdiff_t)Seq - (ptrdiff_t)Tail;
+      if( Diff == 0 )
+      {
+        if( mTail.compare_exchange_weak( Tail, Tail + 1, std::memory_order_relaxed ) )
+          break;
+      }
+      else if( Diff < 0 )
+        return false;   // full
+      else
+        Tail = mTail.load( std::memory_order_relaxed );
+    }
+    Slot->mData = aElement;
+    Slot->mSeq.store( Tail + 1, std::memory_order_release );
+    return true;
+  }
+
+  // consumer only: oldest element or NULL if there is none
+  T* front()
+  {
+    slot_t *Slot = &mRing[ mHead & mMask ];
+    if( Slot->mSeq.load( std::memory_order_acquire ) != mHead + 1 )
+      return NULL;
+    return &Slot->mData;
+  }
+
+  // consumer only: releases the element returned by front()
+  void pop()
+  {
+    slot_t *Slot = &mRing[ mHead & mMask ];
+
+    AssertLogLine( Slot->mSeq.load( std::memory_order_relaxed ) == mHead + 1 )
+      << "skv_mpsc_ring_t::pop(): ring underflow"
+      << EndLogLine;
+
+    Slot->mSeq.store( mHead + mMask + 1, std::memory_order_release );
+    mHead++;
+  }
+
+  // consumer only
+  bool pop( T& aElement )
+  {
+    T* Element = front();
+    if( Element == NULL )
+      return false;
+    aElement = *Element;
+    pop();
+    return true;
+  }
+
+  // approximate
+  size_t size() const
+  {
+    return mTail.load( std::memory_order_acquire ) - mHead;
+  }
+
+  bool empty() const
+  {
+    return const_cast<skv_mpsc_ring_t*>( this )->front() == NULL;
+  }
+};
+
+#endif // __SKV_LOCKFREE_RING_HPP__
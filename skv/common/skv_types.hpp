@@ -22,6 +22,8 @@ extern "C"
 }
 
 #include <cstdint>
+#include <vector>
+#include <algorithm>
 #include <FxLogger.hpp>
 #include <Trace.hpp>
 #include <skv/common/skv_errno.hpp>
@@ -96,7 +98,8 @@ extern "C"
 #define SKV_MAX_DATA_LOAD      ( 1024 ) // MB of heap
 #define SKV_KEY_LIMIT          ( 1024 )
 #define SKV_VALUE_LIMIT        ( 10 * 1024 * 1024 )
-#define SKV_BULK_INSERT_LIMIT  ( 100 * 1024 * 1024 )
+#define SKV_MULTI_KEY_TRANSFER_LIMIT  ( 100 * 1024 * 1024 )  // request + result bytes of a multi-key command
+#define SKV_MULTI_KEY_LIMIT    ( 4096 )  // max keys per multi-key command
 
 #define SKV_MAX_SERVER_PER_NODE         ( 16 )
 #define SKV_MAX_SERVER_ADDR_NAME_LENGTH ( 256 )
@@ -312,7 +315,8 @@ typedef enum
   SKV_COMMAND_CONN_EST        = 0x0000000b ,
   SKV_COMMAND_ACTIVE_BCAST    = 0x0000000c ,
   SKV_COMMAND_CURSOR_PREFETCH = 0x0000000d ,
-  SKV_COMMAND_PDSCNTL         = 0x0000000e // = 14
+  SKV_COMMAND_PDSCNTL         = 0x0000000e ,// = 14
+  SKV_COMMAND_MULTI_KEY       = 0x0000000f
 } skv_command_type_t;
 
 static
@@ -335,6 +339,7 @@ skv_command_type_to_string( skv_command_type_t aCommandType )
     case SKV_COMMAND_ACTIVE_BCAST:       { return "SKV_COMMAND_ACTIVE_BCAST"; }
     case SKV_COMMAND_CURSOR_PREFETCH:    { return "SKV_COMMAND_CURSOR_PREFETCH"; }
     case SKV_COMMAND_PDSCNTL:            { return "SKV_COMMAND_PDSCNTL"; }
+    case SKV_COMMAND_MULTI_KEY:          { return "SKV_COMMAND_MULTI_KEY"; }
     default:
     {
       StrongAssertLogLine( 0 )
@@ -663,6 +668,210 @@ skv_bulk_insert_pack( char *aRow, char *Key, int KeyLength, char *Value, int Val
 
   return TotalSize;
 }
+
+// bytewise key order (shorter key first on equal prefix), same as the server indices
+static inline
+int
+skv_bulk_insert_key_compare( const char *aKeyA, int aKeyLengthA, const char *aKeyB, int aKeyLengthB )
+{
+  int rc = memcmp( aKeyA, aKeyB, std::min( aKeyLengthA, aKeyLengthB ) );
+  if( rc != 0 )
+    return rc;
+  return aKeyLengthA - aKeyLengthB;
+}
+
+/***************************************************
+ * Sort the rows of a bulk buffer by key
+ * aScratch needs aBufferSize bytes
+ * stable: rows with equal keys keep their order (the first one wins)
+ * returns the number of rows
+ **************************************************/
+static
+int
+skv_bulk_insert_sort( char *aBuffer, int aBufferSize, char *aScratch )
+{
+  struct row_t
+  {
+    char *mKey;
+    int   mKeyLength;
+    int   mOffset;
+    int   mRowLength;
+  };
+
+  std::vector< row_t > Rows;
+  bool Sorted = true;
+
+  int Offset = 0;
+  while( Offset < aBufferSize )
+  {
+    row_t Row;
+    char *Value;
+    int   ValueLength;
+
+    Row.mOffset = Offset;
+    Row.mRowLength = skv_bulk_insert_get_key_value_refs( &aBuffer[ Offset ], &Row.mKey, Row.mKeyLength, &Value, ValueLength );
+
+    if( Sorted && !Rows.empty() &&
+        ( skv_bulk_insert_key_compare( Rows.back().mKey, Rows.back().mKeyLength, Row.mKey, Row.mKeyLength ) > 0 ) )
+      Sorted = false;
+
+    Rows.push_back( Row );
+    Offset += Row.mRowLength;
+  }
+
+  if( Sorted )
+    return Rows.size();
+
+  std::stable_sort( Rows.begin(), Rows.end(),
+                    []( const row_t &a, const row_t &b )
+                    {
+                      return skv_bulk_insert_key_compare( a.mKey, a.mKeyLength, b.mKey, b.mKeyLength ) < 0;
+                    } );
+
+  Offset = 0;
+  for( size_t i = 0; i < Rows.size(); i++ )
+  {
+    memcpy( &aScratch[ Offset ], &aBuffer[ Rows[ i ].mOffset ], Rows[ i ].mRowLength );
+    Offset += Rows[ i ].mRowLength;
+  }
+  memcpy( aBuffer, aScratch, Offset );
+
+  return Rows.size();
+}
+/**************************************************/
+
+/***************************************************
+ * Layout of the multi-key command buffers
+ * request rows:
+ *   insert:   { key_size, key, value_size, value } (same as bulk row)
+ *   retrieve: { key_size, key, value_size }
+ *             value_size is the max size the client accepts
+ * results:
+ *   one skv_multi_key_result_t per row, followed by the
+ *   retrieved values; each row owns value_size bytes there
+ **************************************************/
+struct skv_multi_key_result_t
+{
+  skv_status_t mStatus;
+  int          mValueSize;   // stored size of the value (can be larger than the copied part)
+
+  void
+  EndianConvert(void)
+  {
+    mStatus = skv_status_byte_swap( mStatus );
+    mValueSize = htonl( mValueSize );
+  }
+};
+
+static
+int
+skv_multi_key_pack_retrieve( char *aRow, char *Key, int KeyLength, int ValueLength )
+{
+  int TotalSize = 0;
+
+  int* KeyPtr = (int *) &aRow[TotalSize];
+  *KeyPtr = htonl(KeyLength);
+  TotalSize += sizeof(int);
+
+  memcpy( &aRow[TotalSize],
+          Key,
+          KeyLength );
+
+  TotalSize += KeyLength;
+
+  int* ValuePtr = (int *) &aRow[TotalSize];
+  *ValuePtr = htonl(ValueLength);
+  TotalSize += sizeof(int);
+
+  return TotalSize;
+}
+
+/*
+ * returns the length of the row, Value is NULL for retrieve rows
+ */
+static
+int
+skv_multi_key_get_row( char *aRow, skv_command_type_t aOp, char **Key, int &KeyLength, char **Value, int &ValueLength )
+{
+  int RowLen = skv_bulk_insert_get_key_value_refs( aRow, Key, KeyLength, Value, ValueLength );
+  if( aOp == SKV_COMMAND_INSERT )
+    return RowLen;
+
+  *Value = NULL;
+  return KeyLength + 2 * sizeof(int);
+}
+
+static inline
+int
+skv_multi_key_result_size( skv_command_type_t aOp, int aKeyCount, int aValueSpace )
+{
+  int Size = aKeyCount * sizeof( skv_multi_key_result_t );
+  if( aOp == SKV_COMMAND_RETRIEVE )
+    Size += aValueSpace;
+  return Size;
+}
+
+/*
+ * checks the client provided key count and buffer sizes of a multi-key request;
+ * the sizes are rejected if negative and added in 64 bit so they can't wrap past the limit
+ */
+static inline
+skv_status_t
+skv_multi_key_check_sizes( int aKeyCount, int aRequestSize, int aResultSize )
+{
+  if( ( aKeyCount <= 0 ) || ( aKeyCount > SKV_MULTI_KEY_LIMIT ) ||
+      ( aRequestSize <= 0 ) || ( aResultSize <= 0 ) )
+    return SKV_ERRNO_BULK_INSERT_LIMIT_EXCEEDED;
+  if( (uint64_t)aRequestSize + (uint64_t)aResultSize > (uint64_t)SKV_MULTI_KEY_TRANSFER_LIMIT )
+    return SKV_ERRNO_BULK_INSERT_LIMIT_EXCEEDED;
+  return SKV_SUCCESS;
+}
+
+/*
+ * checks all rows of a request against the transferred request and result
+ * sizes before any row is processed (the row sizes are client provided)
+ */
+static inline
+skv_status_t
+skv_multi_key_check_rows( const char *aRequestBuffer, int aRequestSize, int aResultSize,
+                          skv_command_type_t aOp, int aKeyCount )
+{
+  int64_t RequestOffset = 0;
+  int64_t ResultOffset = (int64_t)aKeyCount * sizeof( skv_multi_key_result_t );
+  if( ResultOffset > aResultSize )
+    return SKV_ERRNO_BULK_INSERT_LIMIT_EXCEEDED;
+
+  for( int i = 0; i < aKeyCount; i++ )
+  {
+    if( RequestOffset + (int64_t)sizeof(int) > aRequestSize )
+      return SKV_ERRNO_BULK_INSERT_LIMIT_EXCEEDED;
+    int KeyLength;
+    memcpy( &KeyLength, &aRequestBuffer[ RequestOffset ], sizeof(int) );
+    KeyLength = ntohl( KeyLength );
+    if( ( KeyLength < 0 ) || ( KeyLength > SKV_KEY_LIMIT ) )
+      return SKV_ERRNO_KEY_TOO_LARGE;
+    RequestOffset += sizeof(int) + KeyLength;
+
+    if( RequestOffset + (int64_t)sizeof(int) > aRequestSize )
+      return SKV_ERRNO_BULK_INSERT_LIMIT_EXCEEDED;
+    int ValueLength;
+    memcpy( &ValueLength, &aRequestBuffer[ RequestOffset ], sizeof(int) );
+    ValueLength = ntohl( ValueLength );
+    if( ( ValueLength < 0 ) || ( ValueLength > SKV_VALUE_LIMIT ) )
+      return SKV_ERRNO_VALUE_TOO_LARGE;
+    RequestOffset += sizeof(int);
+
+    // insert rows carry the value, retrieve rows reserve it in the result buffer
+    if( aOp == SKV_COMMAND_INSERT )
+      RequestOffset += ValueLength;
+    else
+      ResultOffset += ValueLength;
+
+    if( ( RequestOffset > aRequestSize ) || ( ResultOffset > aResultSize ) )
+      return SKV_ERRNO_BULK_INSERT_LIMIT_EXCEEDED;
+  }
+  return SKV_SUCCESS;
+}
 /**************************************************/
 
 #endif
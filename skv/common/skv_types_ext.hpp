@@ -29,6 +29,11 @@ struct skv_pds_id_t
   FILE* mPDSFileFd;
 };
 #else
+
+// PDS was created with SKV_COMMAND_OPEN_FLAGS_HASH_INDEX
+// kept in the id so that every server knows without a lookup
+#define SKV_PDS_ID_HASH_INDEX_FLAG ( 0x80000000 )
+
 struct skv_pds_id_t
 {
   unsigned int mOwnerNodeId;
@@ -41,6 +46,12 @@ struct skv_pds_id_t
     mIdOnOwner = aId;
   }
 
+  bool
+  HasHashIndex() const
+  {
+    return ( mIdOnOwner & SKV_PDS_ID_HASH_INDEX_FLAG ) != 0;
+  }
+
   bool
   operator==(const skv_pds_id_t & aPDSId ) const
   {
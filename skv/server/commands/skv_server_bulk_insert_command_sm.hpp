@@ -7,6 +7,10 @@
  *************************************************/
 
 /*
+ * The client buffer is streamed in row-aligned chunks: as soon as a chunk
+ * arrived, the next RDMA read is posted and the chunk goes to the local kv.
+ * See skv_server_command_bulk_insert_t for the credit window.
+ *
  * Contributors:
  *     arayshu, lschneid - initial implementation
  */
@@ -30,8 +34,7 @@ public:
                                    skv_local_kv_t *aLocalKV,
                                    skv_server_ccb_t *aCommand,
                                    int aCommandOrdinal,
-                                   skv_cmd_bulk_insert_req_t *aReq,
-                                   skv_lmr_triplet_t *aNewRecordAllocRep )
+                                   skv_cmd_bulk_insert_req_t *aReq )
   {
     skv_status_t status = SKV_SUCCESS;
 
@@ -47,24 +50,29 @@ public:
     /*******************************************************************
      * Save local command state
      ******************************************************************/
-    aCommand->mCommandState.mCommandBulkInsert.mHdr             = aReq->mHdr;
-    aCommand->mCommandState.mCommandBulkInsert.mLocalBuffer.Init( *aNewRecordAllocRep );
-    aCommand->mCommandState.mCommandBulkInsert.mPDSId           = aReq->mPDSId;
-
-    // This is for debugging
-    aCommand->mCommandState.mCommandBulkInsert.mRemoteBufferRMR      = aReq->mBufferRMR;
-    aCommand->mCommandState.mCommandBulkInsert.mRemoteBufferAddr     = aReq->mBuffer;
+    skv_server_command_bulk_insert_t *BI = &aCommand->mCommandState.mCommandBulkInsert;
+    BI->mHdr             = aReq->mHdr;
+    BI->mPDSId           = aReq->mPDSId;
+    BI->mFlags           = aReq->mFlags;
+
+    BI->mRemoteBufferRMR      = aReq->mBufferRMR;
+    BI->mRemoteBufferAddr     = aReq->mBuffer;
+    BI->mRemoteBufferSize     = aReq->mBufferSize;
+
+    BI->mReadOffset      = 0;
+    BI->mReadLen         = std::min( aReq->mBufferSize, SKV_SERVER_BULK_INSERT_CHUNK_SIZE );
+    BI->mChunkFirst      = 0;
+    BI->mChunkCount      = 0;
+    BI->mChunksHeld      = 0;
+    BI->mReading         = false;
+    BI->mInserting       = false;
+    BI->mRetryPending    = false;
+    BI->mTransferStatus  = SKV_SUCCESS;
+    BI->mInsertStatus    = SKV_SUCCESS;
 
 #ifdef SKV_BULK_LOAD_CHECKSUM
-            aCommand->mCommandState.mCommandBulkInsert.mRemoteBufferChecksum = aReq->mBufferChecksum;
-            /******************************************************************/
-
-            BegLogLine( 0 )
-              << "skv_server_bulk_insert_command_sm::Execute(): "
-              << " RemoteBufferChecksum: "
-              << aCommand->mCommandState.mCommandBulkInsert.mRemoteBufferChecksum
-              << " Req->mBufferChecksum: " << aReq->mBufferChecksum
-              << EndLogLine;
+    BI->mRemoteBufferChecksum = aReq->mBufferChecksum;
+    BI->mBufferChecksum       = 0;
 #endif
 
     /******************************************************************/
@@ -117,18 +125,63 @@ public:
     return status;
   }
 
+  /*******************************************************************
+   * Length of the row at aRow with aLen bytes available.
+   * returns 0 if the row header isn't complete, -1 for a corrupt key
+   * size and -2 for a corrupt or too large value size
+   ******************************************************************/
   static inline
-  void bulk_insert_post_rdma( skv_server_ep_state_t *aEPState,
-                              skv_local_kv_t *aLocalKV,
-                              int aCommandOrdinal,
-                              skv_cmd_bulk_insert_req_t *aReq,
-                              skv_lmr_triplet_t *aNewRecordAllocRep,
-                              int* aSeqNo,
-                              int aMyRank )
+  int64_t row_length( const char *aRow, int aLen )
   {
-    /*******************************************************************
-     * Issue an rdma read from the client
-     ******************************************************************/
+    if( aLen < (int)sizeof( int ) )
+      return 0;
+
+    int KeySize = ntohl( *(int*)aRow );
+    if( ( KeySize <= 0 ) || ( KeySize > SKV_KEY_LIMIT ) )
+      return -1;
+
+    if( aLen < (int)( 2 * sizeof( int ) ) + KeySize )
+      return 0;
+
+    int ValueSize = ntohl( *(int*)( aRow + sizeof( int ) + KeySize ) );
+    if( ( ValueSize < 0 ) || ( ValueSize > SKV_VALUE_LIMIT ) )
+      return -2;
+
+    return (int64_t)( 2 * sizeof( int ) ) + KeySize + ValueSize;
+  }
+
+  /*******************************************************************
+   * Issue the rdma read of the next chunk from the client
+   * returns SKV_ERRNO_NO_BUFFER_AVAILABLE if there's no memory for the
+   * chunk while other chunks are held (retried when one is released)
+   ******************************************************************/
+  static inline
+  skv_status_t post_chunk_read( skv_server_ep_state_t *aEPState,
+                                skv_local_kv_t *aLocalKV,
+                                skv_server_ccb_t *aCommand,
+                                int aCommandOrdinal,
+                                int* aSeqNo,
+                                int aMyRank )
+  {
+    skv_server_command_bulk_insert_t *BI = &aCommand->mCommandState.mCommandBulkInsert;
+
+    skv_status_t status = aLocalKV->Allocate( BI->mReadLen, &BI->mReadChunk.mBuffer );
+    if( status != SKV_SUCCESS )
+    {
+      BegLogLine( SKV_SERVER_BULK_INSERT_LOG )
+        << "skv_server_bulk_insert_command_sm:: no chunk buffer available"
+        << " ReadLen: " << BI->mReadLen
+        << " ChunksHeld: " << BI->mChunksHeld
+        << " status: " << skv_status_to_string( status )
+        << EndLogLine;
+
+      if( BI->mChunksHeld > 0 )
+        return SKV_ERRNO_NO_BUFFER_AVAILABLE;
+      return status;
+    }
+    BI->mChunksHeld++;
+    BI->mReading = true;
+
     skv_server_cookie_t Cookie;
     Cookie.Init( aEPState,
                  *aSeqNo,
@@ -142,14 +195,13 @@ public:
                                                 aMyRank,
                                                 gSKVServerBulk_InsertAboutToRDMARead );
 
-    // rdma_write the value
     it_status_t itstatus = it_post_rdma_read( aEPState->mEPHdl,
-                                              aNewRecordAllocRep->GetTripletPtr(),
+                                              BI->mReadChunk.mBuffer.GetTripletPtr(),
                                               1,
                                               *DtoCookie,
                                               dto_flags,
-                                              (it_rdma_addr_t) aReq->mBuffer,
-                                              aReq->mBufferRMR );
+                                              (it_rdma_addr_t) ( BI->mRemoteBufferAddr + BI->mReadOffset ),
+                                              BI->mRemoteBufferRMR );
 
     AssertLogLine( itstatus == IT_SUCCESS )
       << "skv_server_bulk_insert_command_sm::Execute():: ERROR: "
@@ -159,15 +211,208 @@ public:
     BegLogLine( SKV_SERVER_BULK_INSERT_LOG )
       << "skv_server_bulk_insert_command_sm::Execute():: called it_post_rdma_read() on: "
       << " EP: " << (void *) aEPState->mEPHdl
-      << " Remote Buffer: " << (void *) aReq->mBuffer
-      << " Remote RMR: " << (void *) aReq->mBufferRMR
-      << " BufferSize: " << aReq->mBufferSize
-      << " LocalBuffer: " << aReq->mBuffer
+      << " Remote Buffer: " << (void *) BI->mRemoteBufferAddr
+      << " Remote RMR: " << (void *) BI->mRemoteBufferRMR
+      << " BufferSize: " << BI->mRemoteBufferSize
+      << " Offset: " << BI->mReadOffset
+      << " Len: " << BI->mReadLen
+      << " LocalBuffer: " << BI->mReadChunk.mBuffer
       << EndLogLine;
-    /******************************************************************/
+
+    return SKV_SUCCESS;
   }
 
+  /*******************************************************************
+   * A chunk arrived: keep its complete rows for the local kv and
+   * continue the next read right after them
+   ******************************************************************/
+  static inline
+  void chunk_read_done( skv_local_kv_t *aLocalKV,
+                        skv_server_ccb_t *aCommand )
+  {
+    skv_server_command_bulk_insert_t *BI = &aCommand->mCommandState.mCommandBulkInsert;
+    BI->mReading = false;
+
+    char *Data = (char*)BI->mReadChunk.mBuffer.GetAddr();
+    int Used = 0;
+    int64_t RowLen = 0;
+    while( Used < BI->mReadLen )
+    {
+      RowLen = row_length( &Data[ Used ], BI->mReadLen - Used );
+      if( ( RowLen <= 0 ) || ( Used + RowLen > BI->mReadLen ) )
+        break;
+      Used += RowLen;
+    }
+
+    int Remaining = BI->mRemoteBufferSize - BI->mReadOffset;
+    if( Used > 0 )
+    {
+#ifdef SKV_BULK_LOAD_CHECKSUM
+      BI->mBufferChecksum = skv_crc32c( BI->mBufferChecksum, Data, Used );
+#endif
+      BI->mReadChunk.mDataLen = Used;
+      BI->mChunks[ ( BI->mChunkFirst + BI->mChunkCount ) % SKV_SERVER_BULK_INSERT_CHUNKS ] = BI->mReadChunk;
+      BI->mChunkCount++;
+
+      BI->mReadOffset += Used;
+      BI->mReadLen = std::min( Remaining - Used, SKV_SERVER_BULK_INSERT_CHUNK_SIZE );
+      return;
+    }
+
+    aLocalKV->Deallocate( &BI->mReadChunk.mBuffer );
+    BI->mChunksHeld--;
+
+    // the chunk starts with a row that doesn't fit: read that row on its own
+    if( ( RowLen > BI->mReadLen ) && ( RowLen <= Remaining ) )
+    {
+      BI->mReadLen = RowLen;
+      return;
+    }
+
+    BegLogLine( 1 )
+      << "skv_server_bulk_insert_command_sm:: ERROR: corrupt row in bulk buffer"
+      << " PDSId: " << BI->mPDSId
+      << " Offset: " << BI->mReadOffset
+      << " RowLen: " << RowLen
+      << " Remaining: " << Remaining
+      << EndLogLine;
+
+    BI->mTransferStatus = ( RowLen == -1 ) ? SKV_ERRNO_KEY_TOO_LARGE : SKV_ERRNO_VALUE_TOO_LARGE;
+  }
+
+  static inline
+  void chunk_insert_done( skv_local_kv_t *aLocalKV,
+                          skv_server_ccb_t *aCommand,
+                          skv_status_t aRC )
+  {
+    skv_server_command_bulk_insert_t *BI = &aCommand->mCommandState.mCommandBulkInsert;
+
+    aLocalKV->Deallocate( &BI->mChunks[ BI->mChunkFirst ].mBuffer );
+    BI->mChunkFirst = ( BI->mChunkFirst + 1 ) % SKV_SERVER_BULK_INSERT_CHUNKS;
+    BI->mChunkCount--;
+    BI->mChunksHeld--;
+    BI->mInserting = false;
+
+    // like a single buffer insert: rows continue after a failed one, the last error is reported
+    if( aRC != SKV_SUCCESS )
+      BI->mInsertStatus = aRC;
+  }
+
+  /*******************************************************************
+   * Keep a read and an insert going as long as there's data and credit.
+   * Completes the command once everything is read and inserted.
+   ******************************************************************/
+  static inline
+  skv_status_t stream_progress( skv_server_internal_event_manager_if_t* aEventQueueManager,
+                                skv_local_kv_t *aLocalKV,
+                                skv_server_ep_state_t *aEPState,
+                                skv_server_ccb_t *aCommand,
+                                int aCommandOrdinal,
+                                int* aSeqNo,
+                                int aMyRank )
+  {
+    skv_server_command_bulk_insert_t *BI = &aCommand->mCommandState.mCommandBulkInsert;
+    skv_status_t status = SKV_SUCCESS;
+
+    if( ( ! BI->mReading ) &&
+        ( BI->mTransferStatus == SKV_SUCCESS ) &&
+        ( BI->mReadOffset < BI->mRemoteBufferSize ) &&
+        ( BI->mChunksHeld < SKV_SERVER_BULK_INSERT_CHUNKS ) )
+    {
+      skv_status_t rstatus = post_chunk_read( aEPState, aLocalKV, aCommand, aCommandOrdinal, aSeqNo, aMyRank );
+      if(( rstatus != SKV_SUCCESS ) && ( rstatus != SKV_ERRNO_NO_BUFFER_AVAILABLE ))
+        BI->mTransferStatus = rstatus;
+    }
+
+    while( ( ! BI->mInserting ) && ( ! BI->mRetryPending ) && ( BI->mChunkCount > 0 ) )
+    {
+      skv_server_bulk_insert_chunk_t *Chunk = &BI->mChunks[ BI->mChunkFirst ];
+      BI->mLocalBuffer.Init( Chunk->mBuffer );
+      BI->mLocalBuffer.SetLenIfSmaller( Chunk->mDataLen );
+
+      skv_local_kv_cookie_t *cookie = &aCommand->mLocalKVCookie;
+      cookie->Set( aCommandOrdinal, aEPState );
+
+      gSKVServerBulk_InsertSendingRDMAReadAck.HitOE( SKV_SERVER_BULK_INSERT_TRACE,
+                                                     "SKVServerBulk_InsertRdmaRead",
+                                                     aMyRank,
+                                                     gSKVServerBulk_InsertSendingRDMAReadAck );
+
+      skv_status_t istatus = aLocalKV->BulkInsert( BI->mPDSId,
+                                                   &BI->mLocalBuffer,
+                                                   (skv_bulk_inserter_flags_t) BI->mFlags,
+                                                   cookie );
+      switch( istatus )
+      {
+        case SKV_ERRNO_LOCAL_KV_EVENT:
+          BI->mInserting = true;
+          break;
+
+        case SKV_ERRNO_COMMAND_LIMIT_REACHED:
+        {
+          // come back with a retry event, it doesn't carry a completion
+          skv_server_event_t RetryEvent;
+          RetryEvent.Init( SKV_SERVER_EVENT_TYPE_IT_DTO_RDMA_READ_CMPL,
+                           aEPState,
+                           aCommandOrdinal,
+                           SKV_SERVER_EVENT_TYPE_IT_DTO_BULK_INSERT_CMD );
+          BI->mRetryPending = true;
+          status = aEventQueueManager->Enqueue( &RetryEvent );
+          break;
+        }
+        default:
+          chunk_insert_done( aLocalKV, aCommand, istatus );
+          break;
+      }
+    }
+
+    // a new read might have been blocked by the chunks that were just inserted
+    if( ( ! BI->mReading ) &&
+        ( BI->mTransferStatus == SKV_SUCCESS ) &&
+        ( BI->mReadOffset < BI->mRemoteBufferSize ) &&
+        ( BI->mChunksHeld < SKV_SERVER_BULK_INSERT_CHUNKS ) )
+    {
+      skv_status_t rstatus = post_chunk_read( aEPState, aLocalKV, aCommand, aCommandOrdinal, aSeqNo, aMyRank );
+      if(( rstatus != SKV_SUCCESS ) && ( rstatus != SKV_ERRNO_NO_BUFFER_AVAILABLE ))
+        BI->mTransferStatus = rstatus;
+    }
+
+    bool TransferDone = ( BI->mTransferStatus != SKV_SUCCESS ) || ( BI->mReadOffset >= BI->mRemoteBufferSize );
+    if( ( ! TransferDone ) || BI->mReading || BI->mInserting || BI->mRetryPending || ( BI->mChunkCount > 0 ) )
+      return status;
+
+    skv_status_t rc = ( BI->mTransferStatus != SKV_SUCCESS ) ? BI->mTransferStatus : BI->mInsertStatus;
 
+#ifdef SKV_BULK_LOAD_CHECKSUM
+    if( ( rc == SKV_SUCCESS ) && ( BI->mBufferChecksum != BI->mRemoteBufferChecksum ) )
+    {
+      BegLogLine( 1 )
+        << "skv_server_bulk_insert_command_sm::Execute(): ERROR: "
+        << " BufferChecksum: " << BI->mBufferChecksum
+        << " RemoteBufferChecksum: " << BI->mRemoteBufferChecksum
+        << " PDSId: " << BI->mPDSId
+        << " BufferSize: " << BI->mRemoteBufferSize
+        << EndLogLine;
+      rc = SKV_ERRNO_CHECKSUM_MISMATCH;
+    }
+#endif
+
+    BegLogLine( SKV_SERVER_BULK_INSERT_LOG )
+      << "skv_server_bulk_insert_command_sm:: stream complete"
+      << " BufferSize: " << BI->mRemoteBufferSize
+      << " Transferred: " << BI->mReadOffset
+      << " status: " << skv_status_to_string( rc )
+      << EndLogLine;
+
+    command_completion( rc,
+                        aEPState,
+                        (skv_cmd_insert_cmpl_t*)aCommand->GetSendBuff(),
+                        aCommand,
+                        aCommandOrdinal,
+                        aSeqNo );
+    aCommand->Transit( SKV_SERVER_COMMAND_STATE_INIT );
+    return status;
+  }
 
   static skv_status_t
   Execute( skv_server_internal_event_manager_if_t* aEventQueueManager,
@@ -214,42 +459,17 @@ public:
               Req->EndianConvert() ;
 
             AssertLogLine( ( ((void *) Req->mBuffer) != NULL ) &&
-                           ( Req->mBufferSize >= 0 && Req->mBufferSize < SKV_BULK_INSERT_LIMIT ) )
+                           ( Req->mBufferSize >= 0 ) )
               << "skv_server_bulk_insert_command_sm:: Execute():: ERROR: "
               << " Req->mBuffer: " << Req->mBuffer
               << " BufferSize: " << Req->mBufferSize
               << EndLogLine;
 
-            // allocate a temporary buffer for RDMA transfer and then kick off the rdma
-            skv_lmr_triplet_t NewRecordAllocRep;
-            skv_status_t status = aLocalKV->Allocate( Req->mBufferSize,
-                                                      & NewRecordAllocRep );
-            BegLogLine(SKV_SERVER_BULK_INSERT_LOG)
-              << "Allocated the temporary buffer"
-              << EndLogLine ;
-
-            if( status != SKV_SUCCESS )
-            {
-              command_completion( status,
-                                  aEPState,
-                                  (skv_cmd_insert_cmpl_t*)Command->GetSendBuff(),
-                                  Command,
-                                  aCommandOrdinal,
-                                  aSeqNo );
-              Command->Transit( SKV_SERVER_COMMAND_STATE_INIT );
-              break;
-            }
-
-            create_multi_stage( aEPState, aLocalKV, Command, aCommandOrdinal, Req, &NewRecordAllocRep );
-            bulk_insert_post_rdma( aEPState,
-                                   aLocalKV,
-                                   aCommandOrdinal,
-                                   (skv_cmd_bulk_insert_req_t *)Command->GetSendBuff(),
-                                   &NewRecordAllocRep,
-                                   aSeqNo,
-                                   aMyRank );
-            Command->Transit( SKV_SERVER_COMMAND_STATE_WAITING_RDMA_READ_CMPL );
+            create_multi_stage( aEPState, aLocalKV, Command, aCommandOrdinal, Req );
+            Command->Transit( SKV_SERVER_COMMAND_STATE_DATA_STREAMING );
 
+            rc_status = stream_progress( aEventQueueManager, aLocalKV, aEPState, Command, aCommandOrdinal,
+                                         aSeqNo, aMyRank );
             break;
           }
           default:
@@ -266,145 +486,22 @@ public:
 
         break;
       }
-      case SKV_SERVER_COMMAND_STATE_WAITING_RDMA_READ_CMPL:
+      case SKV_SERVER_COMMAND_STATE_DATA_STREAMING:
       {
         switch( EventType )
         {
           case SKV_SERVER_EVENT_TYPE_IT_DTO_RDMA_READ_CMPL:
-          {
-
-            gSKVServerBulk_InsertSendingRDMAReadAck.HitOE( SKV_SERVER_BULK_INSERT_TRACE,
-                                                           "SKVServerBulk_InsertRdmaRead",
-                                                           aMyRank,
-                                                           gSKVServerBulk_InsertSendingRDMAReadAck );
-
-            skv_local_kv_cookie_t *cookie = &Command->mLocalKVCookie;
-            cookie->Set( aCommandOrdinal, aEPState );
-
-
-#ifdef SKV_BULK_LOAD_CHECKSUM
-  uint64_t  LocalBufferSize = Command->mCommandState.mCommandBulkInsert.mLocalBuffer.GetLen();
-  char* LocalBufferAddr = (char*)Command->mCommandState.mCommandBulkInsert.mLocalBuffer.GetAddr();
-  it_lmr_handle_t LocalBufferLMR = Command->mCommandState.mCommandBulkInsert.mLocalBuffer.GetLMRHandle();
-
-  uint64_t  BufferChecksum       = 0;
-  uint64_t  RemoteBufferChecksum = Command->mCommandState.mCommandBulkInsert.mRemoteBufferChecksum;
-  for( int i=0; i < LocalBufferSize; i++)
-  {
-    BufferChecksum += LocalBufferAddr[ i ];
-  }
-
-  if( BufferChecksum != RemoteBufferChecksum )
-  {
-    BegLogLine( 1 )
-      << "skv_server_bulk_insert_command_sm::Execute(): ERROR: "
-      << " BufferChecksum: " << BufferChecksum
-      << " RemoteBufferChecksum: " << RemoteBufferChecksum
-      << " PDSId: " << Command->mCommandState.mCommandBulkInsert.mPDSId
-      << " LocalBufferSize: " << LocalBufferSize
-      << " LocalBuffer: " << (void *) LocalBufferAddr
-      << " LocalBufferLMR: " << (void *) LocalBufferLMR
-//      << " RemoteBufferRMR: " << (void *) RemoteBufferRMR
-//      << " RemoteBufferAddr: " << (void *) RemoteBufferAddr
-      << EndLogLine;
-
-    int BytesProcessed = 0;
-    char* BufferToReport = LocalBufferAddr;
-    int RowsProcessed = 0;
-    while( BytesProcessed < LocalBufferSize )
-    {
-      int KeySize   = -1;
-      int ValueSize = -1;
-      char* KeyPtr    = NULL;
-      char* ValuePtr  = NULL;
-
-      int RowLen = skv_bulk_insert_get_key_value_refs( BufferToReport,
-                                                       &KeyPtr,
-                                                       KeySize,
-                                                       &ValuePtr,
-                                                       ValueSize );
-
-      int TotalSize = KeySize + ValueSize;
-
-      int BytesInRow = skv_bulk_insert_get_total_len( BufferToReport );
-
-      HexDump FxString( LocalBufferAddr, BytesInRow );
-
-      BegLogLine( 1 )
-        << "skv_server_bulk_insert_command_sm::Execute(): "
-        << " TotalSize: " << TotalSize
-        << " KeySize: " << KeySize
-        << " ValueSize: " << ValueSize
-        << " RowsProcessed: " << RowsProcessed
-        << " BytesInRow: " << BytesInRow
-        << " FxString: " << FxString
-        << EndLogLine;
-
-      RowsProcessed++;
-      BufferToReport += BytesInRow;
-      BytesProcessed += BytesInRow;
-    }
-
-    command_completion( SKV_ERRNO_CHECKSUM_MISMATCH,
-                        aEPState,
-                        (skv_cmd_insert_cmpl_t*)Command->GetSendBuff(),
-                        Command,
-                        aCommandOrdinal,
-                        aSeqNo );
-  }
-#if 0
-  StrongAssertLogLine( BufferChecksum == RemoteBufferChecksum )
-    << "skv_server_bulk_insert_command_sm::Execute(): ERROR: "
-    << " BufferChecksum: " << BufferChecksum
-    << " RemoteBufferChecksum: " << RemoteBufferChecksum
-    << " PDSId: " << Command->mCommandState.mCommandBulkInsert.mPDSId
-    << " LocalBufferSize: " << LocalBufferSize
-    << " LocalBuffer: " << (void *) LocalBufferAddr
-    << " LocalBufferLMR: " << (void *) LocalBufferLMR
-    << EndLogLine;
-#endif
-#endif
-
-
-            skv_status_t status = aLocalKV->BulkInsert( Command->mCommandState.mCommandBulkInsert.mPDSId,
-                                                        &Command->mCommandState.mCommandBulkInsert.mLocalBuffer,
-                                                        cookie );
+            chunk_read_done( aLocalKV, Command );
+            break;
 
-            switch( status )
-            {
-              case SKV_ERRNO_LOCAL_KV_EVENT:
-                Command->Transit( SKV_SERVER_COMMAND_STATE_LOCAL_KV_DATA_OP );
-                status = SKV_SUCCESS;
-                break;
-
-              case SKV_ERRNO_COMMAND_LIMIT_REACHED:
-                status = aEventQueueManager->Enqueue( aEvent );
-                break;
-
-              default:
-              case SKV_SUCCESS:
-                // Return the temporary buffer to the store
-                BegLogLine(SKV_SERVER_BULK_INSERT_LOG)
-                    << "Returning the temporary buffer"
-                    << EndLogLine ;
-                aLocalKV->Deallocate( & Command->mCommandState.mCommandBulkInsert.mLocalBuffer );
-                BegLogLine(SKV_SERVER_BULK_INSERT_LOG)
-                  << "Returned the temporary buffer"
-                  << EndLogLine ;
-
-                command_completion( status,
-                                    aEPState,
-                                    (skv_cmd_insert_cmpl_t*)Command->GetSendBuff(),
-                                    Command,
-                                    aCommandOrdinal,
-                                    aSeqNo );
-
-                Command->Transit( SKV_SERVER_COMMAND_STATE_INIT );
-                break;
-            }
+          case SKV_SERVER_EVENT_TYPE_LOCAL_KV_CMPL:
+            chunk_insert_done( aLocalKV, Command, Command->mLocalKVrc );
+            break;
 
+          case SKV_SERVER_EVENT_TYPE_IT_DTO_BULK_INSERT_CMD:   // retry of a rejected local kv request
+            Command->mCommandState.mCommandBulkInsert.mRetryPending = false;
             break;
-          }
+
           default:
           {
             StrongAssertLogLine( 0 )
@@ -414,37 +511,10 @@ public:
           }
         }
 
+        rc_status = stream_progress( aEventQueueManager, aLocalKV, aEPState, Command, aCommandOrdinal,
+                                     aSeqNo, aMyRank );
         break;
       }
-      case SKV_SERVER_COMMAND_STATE_LOCAL_KV_DATA_OP:
-        switch( EventType )
-        {
-          case SKV_SERVER_EVENT_TYPE_LOCAL_KV_CMPL:
-          {
-            // Return the temporary buffer to the store
-            BegLogLine(SKV_SERVER_BULK_INSERT_LOG)
-                << "Returning the temporary buffer"
-                << EndLogLine ;
-            aLocalKV->Deallocate( & Command->mCommandState.mCommandBulkInsert.mLocalBuffer );
-            BegLogLine(SKV_SERVER_BULK_INSERT_LOG)
-              << "Returned the temporary buffer"
-              << EndLogLine ;
-
-            command_completion( Command->mLocalKVrc,
-                                aEPState,
-                                (skv_cmd_insert_cmpl_t*)Command->GetSendBuff(),
-                                Command,
-                                aCommandOrdinal,
-                                aSeqNo );
-
-            Command->Transit( SKV_SERVER_COMMAND_STATE_INIT );
-            break;
-          }
-          default:
-            rc_status = SKV_ERRNO_STATE_MACHINE_ERROR;
-            break;
-        }
-        break;
       default:
       {
         StrongAssertLogLine( 0 )
@@ -102,6 +102,29 @@ private:
     return SKV_SUCCESS;
   }
 
+  static inline
+  skv_status_t check_value_checksum( const skv_cmd_RIU_req_t *aReq,
+                                     const char *aValue,
+                                     int aValueLen )
+  {
+    if( !( aReq->mFlags & SKV_COMMAND_RIU_VALUE_CHECKSUM ) )
+      return SKV_SUCCESS;
+
+    uint32_t Checksum = skv_crc32c( 0, aValue, aValueLen );
+    if( Checksum == aReq->mValueChecksum )
+      return SKV_SUCCESS;
+
+    BegLogLine( 1 )
+      << "skv_server_insert_command_sm::check_value_checksum(): ERROR: "
+      << " Checksum: " << (void*)(uintptr_t)Checksum
+      << " ClientChecksum: " << (void*)(uintptr_t)aReq->mValueChecksum
+      << " ValueLen: " << aValueLen
+      << " PDSId: " << aReq->mPDSId
+      << EndLogLine;
+
+    return SKV_ERRNO_CHECKSUM_MISMATCH;
+  }
+
   static inline
   skv_status_t insert_lookup_sequence( skv_local_kv_t *aLocalKV,
                                        skv_server_ccb_t *aCommand,
@@ -113,9 +136,21 @@ private:
     skv_cmd_RIU_req_t *Req = (skv_cmd_RIU_req_t *) aCommand->GetSendBuff();
 
     // convert only if it's the first time we arrive here...
+    *aReq = Req;
     if( aCommand->GetCommandClass() == SKV_COMMAND_CLASS_IMMEDIATE )
+    {
       Req->EndianConvert() ;
-    *aReq = Req;
+
+      // values that don't fit are verified after the rdma read
+      if( Req->mFlags & SKV_COMMAND_RIU_INSERT_KEY_VALUE_FIT_IN_CTL_MSG )
+      {
+        skv_status_t status = check_value_checksum( Req,
+                                                    &Req->mKeyValue.mData[ Req->mKeyValue.mKeySize ],
+                                                    Req->mKeyValue.mValueSize );
+        if( status != SKV_SUCCESS )
+          return status;
+      }
+    }
 
     if( FlagBasedLock( aLocalKV, Req, aCommand ) != SKV_SUCCESS )
     {
@@ -397,6 +432,12 @@ public:
               case SKV_ERRNO_RECORD_ALREADY_EXISTS:
               case SKV_ERRNO_ELEM_NOT_FOUND:
                 break;
+
+              case SKV_ERRNO_CHECKSUM_MISMATCH:
+                status = insert_command_completion( aLocalKV, status, aEPState, Req, Command, aCommandOrdinal, aSeqNo );
+                Command->Transit( SKV_SERVER_COMMAND_STATE_INIT );
+                return status;
+
               default:
                 return status;
             }
@@ -425,6 +466,8 @@ public:
                  * Issue an rdma read from the client
                  ******************************************************************/
                 status = insert_create_multi_stage( aEPState, aLocalKV, Command, aCommandOrdinal, Req );
+                // keep the rdma target for the checksum (the other paths already read into it)
+                Command->mLocalKVData.mRDMA.mValueRDMADest = ValueRepInStore;
                 insert_post_rdma( aEPState,
                                   aLocalKV,
                                   aCommandOrdinal,
@@ -618,11 +661,26 @@ public:
               << " Ord: " << aCommandOrdinal
               << EndLogLine;
 
+            // a corrupted value must not be committed: cancel the insert instead
+            // (in-memory stores already have it in place and remove the record)
+            skv_cmd_RIU_req_t *Req = (skv_cmd_RIU_req_t *) Command->GetSendBuff();
+            skv_lmr_triplet_t *ValueRDMADest = &(Command->mLocalKVData.mRDMA.mValueRDMADest);
+            Command->mCommandState.mCommandInsert.mValueStatus =
+                check_value_checksum( Req,
+                                      (const char *) ValueRDMADest->GetAddr(),
+                                      ValueRDMADest->GetLen() );
+
             skv_local_kv_cookie_t *cookie = &Command->mLocalKVCookie;
             cookie->Set( aCommandOrdinal, aEPState );
-            status = aLocalKV->InsertPostProcess( Command->mLocalKVData.mRDMA.mReqCtx,
-                                                  &(Command->mLocalKVData.mRDMA.mValueRDMADest),
-                                                  cookie );
+            if( Command->mCommandState.mCommandInsert.mValueStatus == SKV_SUCCESS )
+              status = aLocalKV->InsertPostProcess( Command->mLocalKVData.mRDMA.mReqCtx,
+                                                    ValueRDMADest,
+                                                    cookie );
+            else
+              status = aLocalKV->InsertCancel( Req,
+                                               Command->mLocalKVData.mRDMA.mReqCtx,
+                                               ValueRDMADest,
+                                               cookie );
 
             if( status == SKV_ERRNO_LOCAL_KV_EVENT )
             {
@@ -630,6 +688,9 @@ public:
               return SKV_SUCCESS;
             }
 
+            if( Command->mCommandState.mCommandInsert.mValueStatus != SKV_SUCCESS )
+              status = Command->mCommandState.mCommandInsert.mValueStatus;
+
             gSKVServerInsertSendingRDMAReadAck.HitOE( SKV_SERVER_INSERT_TRACE,
                                                       "SKVServerInsertRdmaRead",
                                                       aMyRank,
@@ -674,7 +735,8 @@ public:
                                                       gSKVServerInsertSendingRDMAReadAck );
 
             insert_command_completion( aLocalKV,
-                                       Command->mLocalKVrc,
+                                       ( Command->mCommandState.mCommandInsert.mValueStatus != SKV_SUCCESS ) ?
+                                           Command->mCommandState.mCommandInsert.mValueStatus : Command->mLocalKVrc,
                                        aEPState,
                                        (skv_cmd_RIU_req_t *) Command->GetSendBuff(),
                                        Command,
@@ -0,0 +1,403 @@
+/************************************************
+ * Copyright (c) IBM Corp. 2014
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * which accompanies this distribution, and is available at
+ * http://www.eclipse.org/legal/epl-v10.html
+ *************************************************/
+
+/*
+ * Insert or retrieve of a set of keys with a single command
+ *  - rdma_read of the packed request rows from the client
+ *  - local kv processes all rows and fills the result buffer
+ *  - rdma_write of the results back to the client
+ *  - completion message
+ */
+
+#ifndef __SKV_SERVER_MULTI_KEY_COMMAND_SM_HPP__
+#define __SKV_SERVER_MULTI_KEY_COMMAND_SM_HPP__
+
+#ifndef SKV_SERVER_MULTI_KEY_LOG
+#define SKV_SERVER_MULTI_KEY_LOG  ( 0 | SKV_LOGGING_ALL )
+#endif
+
+class skv_server_multi_key_command_sm
+{
+public:
+  static inline
+  skv_status_t create_multi_stage( skv_server_ep_state_t *aEPState,
+                                   skv_server_ccb_t *aCommand,
+                                   int aCommandOrdinal,
+                                   skv_cmd_multi_key_req_t *aReq,
+                                   skv_lmr_triplet_t *aLocalBuffer )
+  {
+    skv_status_t status = SKV_SUCCESS;
+
+    // check if we're already multi-stage class command
+    if ( aCommand->GetCommandClass() == SKV_COMMAND_CLASS_MULTI_STAGE )
+      return status;
+
+    /*******************************************************************
+     * Save local command state
+     ******************************************************************/
+    skv_server_command_multi_key_t *MKState = &aCommand->mCommandState.mCommandMultiKey;
+    MKState->mHdr             = aReq->mHdr;
+    MKState->mLocalBuffer.Init( *aLocalBuffer );
+    MKState->mPDSId           = aReq->mPDSId;
+    MKState->mOp              = aReq->mOp;
+    MKState->mFlags           = aReq->mFlags;
+    MKState->mKeyCount        = aReq->mKeyCount;
+    MKState->mRequestSize     = aReq->mRequestSize;
+    MKState->mResultSize      = aReq->mResultSize;
+    MKState->mRemoteResultAddr = aReq->mResultBuffer;
+    MKState->mRemoteRMR       = aReq->mBufferRMR;
+    /******************************************************************/
+
+    aEPState->ReplaceAndInitCommandBuffer( aCommand, aCommandOrdinal );
+
+    return status;
+  }
+
+  static inline
+  skv_status_t command_completion( skv_status_t aRC,
+                                   skv_server_ep_state_t *aEPState,
+                                   skv_cmd_insert_cmpl_t *aCmpl,
+                                   skv_server_ccb_t *aCommand,
+                                   int aCommandOrdinal,
+                                   int *aSeqNo )
+  {
+    if( aRC == SKV_SUCCESS )
+      aCmpl->mHdr.mEvent = SKV_CLIENT_EVENT_CMD_COMPLETE;
+    else
+      aCmpl->mHdr.mEvent = SKV_CLIENT_EVENT_ERROR;
+
+    BegLogLine( SKV_SERVER_MULTI_KEY_LOG )
+      << "skv_server_multi_key_command_sm::"
+      << " completing multi-key with status: " << skv_status_to_string( aRC )
+      << EndLogLine;
+
+    aCmpl->mStatus = aRC;
+    aCmpl->EndianConvert() ;
+
+    skv_status_t status = aEPState->Dispatch( aCommand,
+                                              aSeqNo,
+                                              aCommandOrdinal );
+
+    AssertLogLine( status == SKV_SUCCESS )
+      << "skv_server_multi_key_command_sm:: ERROR: "
+      << " status: " << skv_status_to_string( status )
+      << EndLogLine;
+
+    return status;
+  }
+
+  // fetch the request rows into the front of the local buffer
+  static inline
+  void post_rdma_read( skv_server_ep_state_t *aEPState,
+                       int aCommandOrdinal,
+                       skv_cmd_multi_key_req_t *aReq,
+                       skv_lmr_triplet_t *aLocalBuffer,
+                       int* aSeqNo )
+  {
+    skv_server_cookie_t Cookie;
+    Cookie.Init( aEPState,
+                 *aSeqNo,
+                 aCommandOrdinal );
+
+    it_dto_cookie_t* DtoCookie = (it_dto_cookie_t* ) & Cookie;
+    it_dto_flags_t dto_flags = (it_dto_flags_t) ( IT_COMPLETION_FLAG | IT_NOTIFY_FLAG );
+
+    skv_lmr_triplet_t RequestRep;
+    RequestRep.InitAbs( aLocalBuffer->GetLMRHandle(),
+                        (char*)aLocalBuffer->GetAddr(),
+                        aReq->mRequestSize );
+
+    it_status_t itstatus = it_post_rdma_read( aEPState->mEPHdl,
+                                              RequestRep.GetTripletPtr(),
+                                              1,
+                                              *DtoCookie,
+                                              dto_flags,
+                                              (it_rdma_addr_t) aReq->mRequestBuffer,
+                                              aReq->mBufferRMR );
+
+    AssertLogLine( itstatus == IT_SUCCESS )
+      << "skv_server_multi_key_command_sm::Execute():: ERROR: "
+      << " istatus: " << itstatus
+      << EndLogLine;
+
+    BegLogLine( SKV_SERVER_MULTI_KEY_LOG )
+      << "skv_server_multi_key_command_sm::Execute():: called it_post_rdma_read() on: "
+      << " EP: " << (void *) aEPState->mEPHdl
+      << " Remote Buffer: " << (void *) aReq->mRequestBuffer
+      << " Remote RMR: " << (void *) aReq->mBufferRMR
+      << " RequestSize: " << aReq->mRequestSize
+      << EndLogLine;
+  }
+
+  // push the per-key results back into the client's result buffer
+  static inline
+  void post_rdma_write( skv_server_ep_state_t *aEPState,
+                        int aCommandOrdinal,
+                        skv_server_command_multi_key_t *aMKState )
+  {
+    skv_server_rdma_write_cmpl_cookie_t Cookie;
+    Cookie.Init( aEPState,
+                 NULL,
+                 aCommandOrdinal );
+
+    it_dto_flags_t dto_flags = (it_dto_flags_t) (IT_COMPLETION_FLAG | IT_NOTIFY_FLAG);
+
+    skv_lmr_triplet_t ResultRep;
+    ResultRep.InitAbs( aMKState->mLocalBuffer.GetLMRHandle(),
+                       (char*)aMKState->mLocalBuffer.GetAddr() + aMKState->mRequestSize,
+                       aMKState->mResultSize );
+
+    it_status_t itstatus = it_post_rdma_write( aEPState->mEPHdl,
+                                               ResultRep.GetTripletPtr(),
+                                               1,
+                                               Cookie.GetCookie(),
+                                               dto_flags,
+                                               (it_rdma_addr_t) aMKState->mRemoteResultAddr,
+                                               aMKState->mRemoteRMR );
+
+    AssertLogLine( itstatus == IT_SUCCESS )
+      << "skv_server_multi_key_command_sm::Execute():: ERROR: "
+      << " istatus: " << itstatus
+      << EndLogLine;
+  }
+
+  // kick off the result transfer or report an error
+  static inline
+  skv_status_t process_local_kv_result( skv_status_t aRC,
+                                        skv_local_kv_t *aLocalKV,
+                                        skv_server_ep_state_t *aEPState,
+                                        skv_server_ccb_t *aCommand,
+                                        int aCommandOrdinal,
+                                        int *aSeqNo )
+  {
+    skv_server_command_multi_key_t *MKState = &aCommand->mCommandState.mCommandMultiKey;
+
+    if( aRC == SKV_SUCCESS )
+    {
+      post_rdma_write( aEPState, aCommandOrdinal, MKState );
+      aCommand->Transit( SKV_SERVER_COMMAND_STATE_WAITING_RDMA_WRITE_CMPL );
+      return SKV_SUCCESS;
+    }
+
+    aLocalKV->Deallocate( & MKState->mLocalBuffer );
+    skv_status_t status = command_completion( aRC,
+                                              aEPState,
+                                              (skv_cmd_insert_cmpl_t*)aCommand->GetSendBuff(),
+                                              aCommand,
+                                              aCommandOrdinal,
+                                              aSeqNo );
+    aCommand->Transit( SKV_SERVER_COMMAND_STATE_INIT );
+    return status;
+  }
+
+  static skv_status_t
+  Execute( skv_server_internal_event_manager_if_t* aEventQueueManager,
+           skv_local_kv_t*                         aLocalKV,
+           skv_server_ep_state_t*                  aEPState,
+           int                                     aCommandOrdinal,
+           skv_server_event_t*                     aEvent,
+           int*                                    aSeqNo )
+  {
+    skv_server_ccb_t* Command = aEPState->GetCommandForOrdinal( aCommandOrdinal );
+
+    skv_server_command_state_t State = Command->mState;
+
+    skv_server_event_type_t EventType = aEvent->mCmdEventType;
+
+    BegLogLine( SKV_SERVER_MULTI_KEY_LOG )
+      << "skv_server_multi_key_command_sm::Execute():: Entering "
+      << " EP: " << (void *) aEPState->mEPHdl
+      << " Command: " << (void *) Command
+      << " State: " << skv_server_command_state_to_string( State )
+      << " Event: " << skv_server_event_type_to_string( EventType )
+      << EndLogLine;
+
+    skv_status_t rc_status = SKV_SUCCESS;
+
+    switch( State )
+    {
+      case SKV_SERVER_COMMAND_STATE_INIT:
+      {
+        switch( EventType )
+        {
+          case SKV_SERVER_EVENT_TYPE_IT_DTO_MULTI_KEY_CMD:
+          {
+            skv_cmd_multi_key_req_t* Req = (skv_cmd_multi_key_req_t *) Command->GetSendBuff();
+
+            if( Command->GetCommandClass() == SKV_COMMAND_CLASS_IMMEDIATE )
+              Req->EndianConvert() ;
+
+            skv_status_t status = SKV_SUCCESS;
+            if( ( Req->mOp != SKV_COMMAND_INSERT ) && ( Req->mOp != SKV_COMMAND_RETRIEVE ) )
+              status = SKV_ERRNO_NOT_IMPLEMENTED;
+            else
+              status = skv_multi_key_check_sizes( Req->mKeyCount, Req->mRequestSize, Req->mResultSize );
+
+            // one temporary buffer for the request rows and the results
+            skv_lmr_triplet_t LocalBuffer;
+            if( status == SKV_SUCCESS )
+              status = aLocalKV->Allocate( Req->mRequestSize + Req->mResultSize,
+                                           & LocalBuffer );
+
+            if( status != SKV_SUCCESS )
+            {
+              BegLogLine( SKV_SERVER_MULTI_KEY_LOG )
+                << "skv_server_multi_key_command_sm::Execute():: rejecting request"
+                << " KeyCount: " << Req->mKeyCount
+                << " RequestSize: " << Req->mRequestSize
+                << " ResultSize: " << Req->mResultSize
+                << " status: " << skv_status_to_string( status )
+                << EndLogLine;
+
+              command_completion( status,
+                                  aEPState,
+                                  (skv_cmd_insert_cmpl_t*)Command->GetSendBuff(),
+                                  Command,
+                                  aCommandOrdinal,
+                                  aSeqNo );
+              Command->Transit( SKV_SERVER_COMMAND_STATE_INIT );
+              break;
+            }
+
+            create_multi_stage( aEPState, Command, aCommandOrdinal, Req, &LocalBuffer );
+            post_rdma_read( aEPState,
+                            aCommandOrdinal,
+                            (skv_cmd_multi_key_req_t *)Command->GetSendBuff(),
+                            &LocalBuffer,
+                            aSeqNo );
+            Command->Transit( SKV_SERVER_COMMAND_STATE_WAITING_RDMA_READ_CMPL );
+            break;
+          }
+          default:
+          {
+            StrongAssertLogLine( 0 )
+              << "skv_server_multi_key_command_sm:: Execute():: ERROR: State not recognized"
+              << " State: " << State
+              << " EventType: " << EventType
+              << EndLogLine;
+
+            break;
+          }
+        }
+
+        break;
+      }
+      case SKV_SERVER_COMMAND_STATE_WAITING_RDMA_READ_CMPL:
+      {
+        switch( EventType )
+        {
+          case SKV_SERVER_EVENT_TYPE_IT_DTO_RDMA_READ_CMPL:
+          {
+            skv_server_command_multi_key_t *MKState = &Command->mCommandState.mCommandMultiKey;
+            skv_local_kv_cookie_t *cookie = &Command->mLocalKVCookie;
+            cookie->Set( aCommandOrdinal, aEPState );
+
+            // the back-ends walk the rows unchecked, so reject the whole request up front
+            char *RequestBuffer = (char*)MKState->mLocalBuffer.GetAddr();
+            skv_status_t status = skv_multi_key_check_rows( RequestBuffer,
+                                                            MKState->mRequestSize,
+                                                            MKState->mResultSize,
+                                                            MKState->mOp,
+                                                            MKState->mKeyCount );
+            if( status == SKV_SUCCESS )
+              status = aLocalKV->MultiKey( MKState->mPDSId,
+                                           MKState->mOp,
+                                           MKState->mFlags,
+                                           MKState->mKeyCount,
+                                           RequestBuffer,
+                                           RequestBuffer + MKState->mRequestSize,
+                                           cookie );
+            else
+              BegLogLine( SKV_SERVER_MULTI_KEY_LOG )
+                << "skv_server_multi_key_command_sm::Execute():: rejecting malformed rows"
+                << " KeyCount: " << MKState->mKeyCount
+                << " RequestSize: " << MKState->mRequestSize
+                << " ResultSize: " << MKState->mResultSize
+                << " status: " << skv_status_to_string( status )
+                << EndLogLine;
+            switch( status )
+            {
+              case SKV_ERRNO_LOCAL_KV_EVENT:
+                Command->Transit( SKV_SERVER_COMMAND_STATE_LOCAL_KV_DATA_OP );
+                break;
+
+              case SKV_ERRNO_COMMAND_LIMIT_REACHED:
+                rc_status = aEventQueueManager->Enqueue( aEvent );
+                break;
+
+              default:
+                rc_status = process_local_kv_result( status, aLocalKV, aEPState, Command, aCommandOrdinal, aSeqNo );
+                break;
+            }
+            break;
+          }
+          default:
+          {
+            StrongAssertLogLine( 0 )
+              << "skv_server_multi_key_command_sm::Execute(): ERROR:: EventType not recognized. "
+              << " EventType: " << EventType
+              << EndLogLine;
+          }
+        }
+
+        break;
+      }
+      case SKV_SERVER_COMMAND_STATE_LOCAL_KV_DATA_OP:
+      {
+        switch( EventType )
+        {
+          case SKV_SERVER_EVENT_TYPE_LOCAL_KV_CMPL:
+            rc_status = process_local_kv_result( Command->mLocalKVrc, aLocalKV, aEPState, Command, aCommandOrdinal, aSeqNo );
+            break;
+          default:
+            rc_status = SKV_ERRNO_STATE_MACHINE_ERROR;
+            break;
+        }
+        break;
+      }
+      case SKV_SERVER_COMMAND_STATE_WAITING_RDMA_WRITE_CMPL:
+      {
+        switch( EventType )
+        {
+          case SKV_SERVER_EVENT_TYPE_IT_DTO_RDMA_WRITE_CMPL:
+          {
+            aLocalKV->Deallocate( & Command->mCommandState.mCommandMultiKey.mLocalBuffer );
+            rc_status = command_completion( SKV_SUCCESS,
+                                            aEPState,
+                                            (skv_cmd_insert_cmpl_t*)Command->GetSendBuff(),
+                                            Command,
+                                            aCommandOrdinal,
+                                            aSeqNo );
+            Command->Transit( SKV_SERVER_COMMAND_STATE_INIT );
+            break;
+          }
+          default:
+          {
+            StrongAssertLogLine( 0 )
+              << "skv_server_multi_key_command_sm::Execute(): ERROR:: EventType not recognized. "
+              << " EventType: " << EventType
+              << EndLogLine;
+          }
+        }
+        break;
+      }
+      default:
+      {
+        StrongAssertLogLine( 0 )
+          << "skv_server_multi_key_command_sm:: Execute():: ERROR: State not recognized"
+          << " State: " << State
+          << EndLogLine;
+
+        break;
+      }
+    }
+
+    return rc_status;
+  }
+};
+#endif
@@ -41,15 +41,16 @@
 #include <skv/server/skv_local_kv_asyncmem.hpp>
 
 static
-void AsyncProcessing( skv_local_kv_asyncmem *aBackEnd )
+void AsyncProcessing( skv_local_kv_asyncmem *aBackEnd, int aWorker )
 {
   BegLogLine( SKV_LOCAL_KV_ASYNCMEM_PROCESSING_LOG )
     << "AsyncProcessing: Entering thread"
+    << " worker: " << aWorker
     << EndLogLine;
 
   double last_ts = MPI_Wtime();
 
-  skv_local_kv_request_queue_t* RequestQueue = aBackEnd->GetRequestQueue();
+  skv_local_kv_request_queue_t* RequestQueue = aBackEnd->GetRequestQueue( aWorker );
   while( aBackEnd->KeepProcessing() )
   {
     skv_status_t status;
@@ -89,6 +90,9 @@ void AsyncProcessing( skv_local_kv_asyncmem *aBackEnd )
         case SKV_LOCAL_KV_REQUEST_TYPE_BULK_INSERT:
           status = aBackEnd->PerformBulkInsert( nextRequest );
           break;
+        case SKV_LOCAL_KV_REQUEST_TYPE_MULTI_KEY:
+          status = aBackEnd->PerformMultiKey( nextRequest );
+          break;
         case SKV_LOCAL_KV_REQUEST_TYPE_RETRIEVE_N:
           status = aBackEnd->PerformRetrieveNKeys( nextRequest );
           break;
@@ -124,7 +128,14 @@ skv_local_kv_asyncmem::Init( int aRank,
     << EndLogLine;
 
   mEventQueue.Init();
-  mRequestQueue.Init();
+
+  // the request pool is split among the workers
+  for( int w = 0; w < SKV_LOCAL_KV_ASYNCMEM_WORKERS; w++ )
+  {
+    mRequestQueue[ w ] = new skv_local_kv_request_queue_t( SKV_LOCAL_KV_MAX_REQUESTS / SKV_LOCAL_KV_ASYNCMEM_WORKERS );
+    mRequestQueue[ w ]->Init();
+    mMultiShardQueueList.AddQueue( mRequestQueue[ w ] );
+  }
 
   /************************************************************
    * Initialize the local partition dataset manager
@@ -147,8 +158,15 @@ skv_local_kv_asyncmem::Init( int aRank,
   }
   /***********************************************************/
 
+  mDistribution = mPDSManager.GetDistribution();
+
   mKeepProcessing = true;
-  mReqProcessor = new std::thread(AsyncProcessing, this );
+  for( int w = 0; w < SKV_LOCAL_KV_ASYNCMEM_WORKERS; w++ )
+    mReqProcessor[ w ] = new std::thread(AsyncProcessing, this, w );
+
+  BegLogLine( SKV_LOCAL_KV_BACKEND_LOG )
+    << "skv_local_kv_asyncmem::Init(): started " << SKV_LOCAL_KV_ASYNCMEM_WORKERS << " workers"
+    << EndLogLine;
 
   return status;
 }
@@ -157,6 +175,13 @@ skv_status_t
 skv_local_kv_asyncmem::Exit()
 {
   mKeepProcessing = false;
+  mMultiShardQueueList.DumpBacklog( "skv_local_kv_asyncmem::Exit():" );
+  for( int w = 0; w < SKV_LOCAL_KV_ASYNCMEM_WORKERS; w++ )
+  {
+    mReqProcessor[ w ]->join();
+    delete mReqProcessor[ w ];
+    delete mRequestQueue[ w ];
+  }
   return mPDSManager.Finalize();
 }
 
@@ -172,14 +197,15 @@ skv_status_t
 skv_local_kv_asyncmem::GetDistribution(skv_distribution_t **aDist,
                                        skv_local_kv_cookie_t *aCookie )
 {
-  skv_local_kv_request_t *kvReq = mRequestQueue.AcquireRequestEntry();
+  skv_local_kv_request_queue_t *RequestQueue = GetMetaQueue();
+  skv_local_kv_request_t *kvReq = RequestQueue->AcquireRequestEntry();
   if( !kvReq )
     return SKV_ERRNO_COMMAND_LIMIT_REACHED;
 
   kvReq->InitCommon( SKV_LOCAL_KV_REQUEST_TYPE_GET_DISTRIBUTION, aCookie );
   // getdistribution doesn't have further parameters
 
-  mRequestQueue.QueueRequest( kvReq );
+  RequestQueue->QueueRequest( kvReq );
   return SKV_ERRNO_LOCAL_KV_EVENT;
 }
 
@@ -208,7 +234,8 @@ skv_local_kv_asyncmem::PDS_Open( char *aPDSName,
                                  skv_pds_id_t *aPDSId,
                                  skv_local_kv_cookie_t *aCookie )
 {
-  skv_local_kv_request_t *kvReq = mRequestQueue.AcquireRequestEntry();
+  skv_local_kv_request_queue_t *RequestQueue = GetMetaQueue();
+  skv_local_kv_request_t *kvReq = RequestQueue->AcquireRequestEntry();
   if( !kvReq )
     return SKV_ERRNO_COMMAND_LIMIT_REACHED;
 
@@ -218,7 +245,7 @@ skv_local_kv_asyncmem::PDS_Open( char *aPDSName,
   kvReq->mRequest.mOpen.mPrivs = aPrivs;
   kvReq->mRequest.mOpen.mFlags = aFlags;
 
-  mRequestQueue.QueueRequest( kvReq );
+  RequestQueue->QueueRequest( kvReq );
 
   BegLogLine( SKV_LOCAL_KV_BACKEND_LOG )
     << "skv_local_kv_asyncmem: Open Request stored:"
@@ -258,7 +285,8 @@ skv_local_kv_asyncmem::PDS_Stat( skv_pdscntl_cmd_t aCmd,
                                  skv_pds_attr_t *aPDSAttr,
                                  skv_local_kv_cookie_t *aCookie )
 {
-  skv_local_kv_request_t *kvReq = mRequestQueue.AcquireRequestEntry();
+  skv_local_kv_request_queue_t *RequestQueue = GetMetaQueue();
+  skv_local_kv_request_t *kvReq = RequestQueue->AcquireRequestEntry();
   if( !kvReq )
     return SKV_ERRNO_COMMAND_LIMIT_REACHED;
 
@@ -267,7 +295,7 @@ skv_local_kv_asyncmem::PDS_Stat( skv_pdscntl_cmd_t aCmd,
   memcpy( &kvReq->mData[ 0 ], aPDSAttr, sizeof( skv_pds_attr_t ) );
   kvReq->mRequest.mStat.mPDSAttr = (skv_pds_attr_t*)&kvReq->mData[ 0 ];
 
-  mRequestQueue.QueueRequest( kvReq );
+  RequestQueue->QueueRequest( kvReq );
 
   return SKV_ERRNO_LOCAL_KV_EVENT;
 }
@@ -285,7 +313,8 @@ skv_status_t
 skv_local_kv_asyncmem::PDS_Close( skv_pds_attr_t *aPDSAttr,
                                skv_local_kv_cookie_t *aCookie )
 {
-  skv_local_kv_request_t *kvReq = mRequestQueue.AcquireRequestEntry();
+  skv_local_kv_request_queue_t *RequestQueue = GetMetaQueue();
+  skv_local_kv_request_t *kvReq = RequestQueue->AcquireRequestEntry();
   if( !kvReq )
     return SKV_ERRNO_COMMAND_LIMIT_REACHED;
 
@@ -294,7 +323,7 @@ skv_local_kv_asyncmem::PDS_Close( skv_pds_attr_t *aPDSAttr,
   memcpy( &kvReq->mData[ 0 ], aPDSAttr, sizeof( skv_pds_attr_t ) );
   kvReq->mRequest.mStat.mPDSAttr = (skv_pds_attr_t*)&kvReq->mData[ 0 ];
 
-  mRequestQueue.QueueRequest( kvReq );
+  RequestQueue->QueueRequest( kvReq );
   return SKV_ERRNO_LOCAL_KV_EVENT;
 }
 
@@ -415,7 +444,8 @@ skv_local_kv_asyncmem::Insert( skv_cmd_RIU_req_t *aReq,
                             skv_lmr_triplet_t *aValueRDMADest,
                             skv_local_kv_cookie_t *aCookie )
 {
-  skv_local_kv_request_t *kvReq = mRequestQueue.AcquireRequestEntry();
+  skv_local_kv_request_queue_t *RequestQueue = GetKeyQueue( aReq->mKeyValue.mData, aReq->mKeyValue.mKeySize );
+  skv_local_kv_request_t *kvReq = RequestQueue->AcquireRequestEntry();
   if( !kvReq )
     return SKV_ERRNO_COMMAND_LIMIT_REACHED;
 
@@ -427,7 +457,7 @@ skv_local_kv_asyncmem::Insert( skv_cmd_RIU_req_t *aReq,
   kvReq->mRequest.mInsert.mCmdStatus = aCmdStatus;
   kvReq->mRequest.mInsert.mStoredValueRep = *aStoredValueRep;
 
-  mRequestQueue.QueueRequest( kvReq );
+  RequestQueue->QueueRequest( kvReq );
   return SKV_ERRNO_LOCAL_KV_EVENT;
 }
 
@@ -834,21 +864,34 @@ skv_local_kv_asyncmem::InsertPostProcess(  skv_local_kv_req_ctx_t aReqCtx,
   return InitKVEvent( aCookie, SKV_SUCCESS );
 }
 
+skv_status_t
+skv_local_kv_asyncmem::InsertCancel( skv_cmd_RIU_req_t *aReq,
+                                     skv_local_kv_req_ctx_t aReqCtx,
+                                     skv_lmr_triplet_t *aValueRDMADest,
+                                     skv_local_kv_cookie_t *aCookie )
+{
+  // the value was transferred into the stored record already, so the record has to go
+  return Remove( aReq->mPDSId, aReq->mKeyValue.mData, aReq->mKeyValue.mKeySize, aCookie );
+}
+
 
 skv_status_t
 skv_local_kv_asyncmem::BulkInsert( skv_pds_id_t aPDSId,
                                    skv_lmr_triplet_t *aLocalBuffer,
+                                   skv_bulk_inserter_flags_t aFlags,
                                    skv_local_kv_cookie_t *aCookie )
 {
-  skv_local_kv_request_t *kvReq = mRequestQueue.AcquireRequestEntry();
+  skv_local_kv_request_queue_t *RequestQueue = GetMultiShardQueue();
+  skv_local_kv_request_t *kvReq = RequestQueue->AcquireRequestEntry();
   if( !kvReq )
     return SKV_ERRNO_COMMAND_LIMIT_REACHED;
 
   kvReq->InitCommon( SKV_LOCAL_KV_REQUEST_TYPE_BULK_INSERT, aCookie );
   kvReq->mRequest.mBulkInsert.mPDSId = aPDSId;
   kvReq->mRequest.mBulkInsert.mLocalBuffer = *aLocalBuffer;
+  kvReq->mRequest.mBulkInsert.mFlags = aFlags;
 
-  mRequestQueue.QueueRequest( kvReq );
+  RequestQueue->QueueRequest( kvReq );
   return SKV_ERRNO_LOCAL_KV_EVENT;
 }
 
@@ -866,8 +909,13 @@ skv_local_kv_asyncmem::PerformBulkInsert( skv_local_kv_request_t *aReq )
     << " LocalBufferSize: " << LocalBufferSize
     << " LocalBuffer: " << (void *) LocalBufferAddr
     << " LocalBufferLMR: " << (void *) LocalBufferLMR
+    << " Flags: " << BIReq->mFlags
     << EndLogLine;
 
+  if( BIReq->mFlags & SKV_BULK_INSERTER_FLAGS_SORTED )
+    return InitKVEvent( aReq->mCookie,
+                        mPDSManager.BulkInsertSorted( BIReq->mPDSId, LocalBufferAddr, LocalBufferSize ) );
+
   // Layout of data in buffer { KeySize, ValueSize, Key, Value }
   int TotalProcessed = 0;
   skv_status_t LoopStatus = SKV_SUCCESS;
@@ -967,6 +1015,14 @@ skv_local_kv_asyncmem::PerformBulkInsert( skv_local_kv_request_t *aReq )
                      ValueSize,
                      (skv_local_kv_cookie_t*)NULL );
 
+    // another worker might have inserted the key since the check above
+    if( status == SKV_ERRNO_RECORD_ALREADY_EXISTS )
+    {
+      Deallocate( & NewRecordAllocRep );
+      LoopStatus = status;
+      continue;
+    }
+
     AssertLogLine( status == SKV_SUCCESS )
       << "skv_local_kv_asyncmem: ERROR:: "
       << " status: " << skv_status_to_string( status )
@@ -977,6 +1033,54 @@ skv_local_kv_asyncmem::PerformBulkInsert( skv_local_kv_request_t *aReq )
 }
 
 
+skv_status_t
+skv_local_kv_asyncmem::MultiKey( skv_pds_id_t aPDSId,
+                                 skv_command_type_t aOp,
+                                 skv_cmd_RIU_flags_t aFlags,
+                                 int aKeyCount,
+                                 char *aRequestBuffer,
+                                 char *aResultBuffer,
+                                 skv_local_kv_cookie_t *aCookie )
+{
+  // the keys belong to different shards, so the request goes to the shared queue like bulk-inserts
+  skv_local_kv_request_queue_t *RequestQueue = GetMultiShardQueue();
+  skv_local_kv_request_t *kvReq = RequestQueue->AcquireRequestEntry();
+  if( !kvReq )
+    return SKV_ERRNO_COMMAND_LIMIT_REACHED;
+
+  kvReq->InitCommon( SKV_LOCAL_KV_REQUEST_TYPE_MULTI_KEY, aCookie );
+  kvReq->mRequest.mMultiKey.mPDSId = aPDSId;
+  kvReq->mRequest.mMultiKey.mOp = aOp;
+  kvReq->mRequest.mMultiKey.mFlags = aFlags;
+  kvReq->mRequest.mMultiKey.mKeyCount = aKeyCount;
+  kvReq->mRequest.mMultiKey.mRequestBuffer = aRequestBuffer;
+  kvReq->mRequest.mMultiKey.mResultBuffer = aResultBuffer;
+
+  RequestQueue->QueueRequest( kvReq );
+  return SKV_ERRNO_LOCAL_KV_EVENT;
+}
+
+skv_status_t
+skv_local_kv_asyncmem::PerformMultiKey( skv_local_kv_request_t *aReq )
+{
+  skv_local_kv_multikey_request_t *MKReq = &aReq->mRequest.mMultiKey;
+
+  BegLogLine( SKV_LOCAL_KV_BACKEND_LOG )
+    << "skv_local_kv_asyncmem::PerformMultiKey(): "
+    << " PDSId: " << MKReq->mPDSId
+    << " Op: " << skv_command_type_to_string( MKReq->mOp )
+    << " KeyCount: " << MKReq->mKeyCount
+    << EndLogLine;
+
+  skv_status_t status = mPDSManager.MultiKey( MKReq->mPDSId,
+                                              MKReq->mOp,
+                                              MKReq->mFlags,
+                                              MKReq->mKeyCount,
+                                              MKReq->mRequestBuffer,
+                                              MKReq->mResultBuffer );
+  return InitKVEvent( aReq->mCookie, status );
+}
+
 skv_status_t
 skv_local_kv_asyncmem::Lookup( skv_pds_id_t aPDSId,
                             char *aKeyPtr,
@@ -985,7 +1089,8 @@ skv_local_kv_asyncmem::Lookup( skv_pds_id_t aPDSId,
                             skv_lmr_triplet_t *aStoredValueRep,
                             skv_local_kv_cookie_t *aCookie )
 {
-  skv_local_kv_request_t *kvReq = mRequestQueue.AcquireRequestEntry();
+  skv_local_kv_request_queue_t *RequestQueue = GetKeyQueue( aKeyPtr, aKeySize );
+  skv_local_kv_request_t *kvReq = RequestQueue->AcquireRequestEntry();
   if( !kvReq )
     return SKV_ERRNO_COMMAND_LIMIT_REACHED;
 
@@ -998,7 +1103,7 @@ skv_local_kv_asyncmem::Lookup( skv_pds_id_t aPDSId,
   kvReq->mRequest.mLookup.mKeySize = aKeySize;
   kvReq->mRequest.mLookup.mFlags = aFlags;
 
-  mRequestQueue.QueueRequest( kvReq );
+  RequestQueue->QueueRequest( kvReq );
   return SKV_ERRNO_LOCAL_KV_EVENT;
 }
 
@@ -1047,7 +1152,8 @@ skv_local_kv_asyncmem::Retrieve( skv_pds_id_t aPDSId,
                               int *aTotalSize,
                               skv_local_kv_cookie_t *aCookie )
 {
-  skv_local_kv_request_t *kvReq = mRequestQueue.AcquireRequestEntry();
+  skv_local_kv_request_queue_t *RequestQueue = GetKeyQueue( aKeyData, aKeySize );
+  skv_local_kv_request_t *kvReq = RequestQueue->AcquireRequestEntry();
   if( !kvReq )
     return SKV_ERRNO_COMMAND_LIMIT_REACHED;
 
@@ -1062,7 +1168,7 @@ skv_local_kv_asyncmem::Retrieve( skv_pds_id_t aPDSId,
   kvReq->mRequest.mRetrieve.mValueSize = aValueSize;
   kvReq->mRequest.mRetrieve.mFlags = aFlags;
 
-  mRequestQueue.QueueRequest( kvReq );
+  RequestQueue->QueueRequest( kvReq );
   return SKV_ERRNO_LOCAL_KV_EVENT;
 }
 
@@ -1138,7 +1244,8 @@ skv_local_kv_asyncmem::RetrieveNKeys( skv_pds_id_t aPDSId,
                                    skv_cursor_flags_t aFlags,
                                    skv_local_kv_cookie_t *aCookie )
 {
-  skv_local_kv_request_t *kvReq = mRequestQueue.AcquireRequestEntry();
+  skv_local_kv_request_queue_t *RequestQueue = GetMultiShardQueue();
+  skv_local_kv_request_t *kvReq = RequestQueue->AcquireRequestEntry();
   if( !kvReq )
     return SKV_ERRNO_COMMAND_LIMIT_REACHED;
 
@@ -1169,7 +1276,7 @@ skv_local_kv_asyncmem::RetrieveNKeys( skv_pds_id_t aPDSId,
     << EndLogLine;
 
 
-  mRequestQueue.QueueRequest( kvReq );
+  RequestQueue->QueueRequest( kvReq );
   return SKV_ERRNO_LOCAL_KV_EVENT;
 }
 
@@ -1219,7 +1326,8 @@ skv_local_kv_asyncmem::Remove( skv_pds_id_t aPDSId,
                             int aKeySize,
                             skv_local_kv_cookie_t *aCookie )
 {
-  skv_local_kv_request_t *kvReq = mRequestQueue.AcquireRequestEntry();
+  skv_local_kv_request_queue_t *RequestQueue = GetKeyQueue( aKeyData, aKeySize );
+  skv_local_kv_request_t *kvReq = RequestQueue->AcquireRequestEntry();
   if( !kvReq )
     return SKV_ERRNO_COMMAND_LIMIT_REACHED;
 
@@ -1231,7 +1339,7 @@ skv_local_kv_asyncmem::Remove( skv_pds_id_t aPDSId,
   kvReq->mRequest.mRemove.mKeyData = &kvReq->mData[ 0 ];
   kvReq->mRequest.mRemove.mKeySize = aKeySize;
 
-  mRequestQueue.QueueRequest( kvReq );
+  RequestQueue->QueueRequest( kvReq );
   return SKV_ERRNO_LOCAL_KV_EVENT;
 }
 
@@ -16,6 +16,10 @@
  * It provides the functionality if the inmem back-end but returns
  * results exclusively via the SKV event mechanism
  *
+ * Requests are processed by one worker thread per shard of the local
+ * store. Single-key requests are routed to the worker owning the shard
+ * of the key, which keeps the per-key request order of the server.
+ *
  */
 
 #ifndef SKV_LOCAL_KV_ASYNCMEM_HPP_
@@ -29,17 +33,38 @@
 
 typedef skv_partitioned_data_set_manager_if_t<skv_uber_pds_t> skv_pds_manager_if_t;
 
+#define SKV_LOCAL_KV_ASYNCMEM_WORKERS ( SKV_DATA_CONTAINER_SHARDS )
+
 class skv_local_kv_asyncmem {
 
   skv_pds_manager_if_t mPDSManager;
   int mMyRank;
 
-  skv_local_kv_request_queue_t mRequestQueue;
+  skv_distribution_t *mDistribution;
+
+  skv_local_kv_request_queue_t *mRequestQueue[ SKV_LOCAL_KV_ASYNCMEM_WORKERS ];
+  skv_local_kv_request_queue_list_t mMultiShardQueueList;
   skv_local_kv_event_queue_t mEventQueue;
 
-  std::thread *mReqProcessor;
+  std::thread *mReqProcessor[ SKV_LOCAL_KV_ASYNCMEM_WORKERS ];
   volatile bool mKeepProcessing;
 
+  // requests for one key always go to the same worker
+  inline skv_local_kv_request_queue_t* GetKeyQueue( const char *aKeyData, int aKeySize )
+  {
+    return mRequestQueue[ mDistribution->GetShard( aKeyData, aKeySize, SKV_LOCAL_KV_ASYNCMEM_WORKERS ) ];
+  }
+  // PDS meta data requests are serialized on the first worker
+  inline skv_local_kv_request_queue_t* GetMetaQueue()
+  {
+    return mRequestQueue[ 0 ];
+  }
+  // requests that touch several shards go to a lightly loaded worker
+  inline skv_local_kv_request_queue_t* GetMultiShardQueue()
+  {
+    return mMultiShardQueueList.GetBestQueue();
+  }
+
   inline skv_server_ccb_t* RetrieveCCB( skv_local_kv_cookie_t *aCookie )
   {
     skv_server_ccb_t *retval = NULL;
@@ -168,6 +193,10 @@ class skv_local_kv_asyncmem {
   }
 
 public:
+  skv_local_kv_asyncmem() : mMultiShardQueueList( SKV_LOCAL_KV_ASYNCMEM_WORKERS )
+  {
+  }
+
   skv_status_t Init( int aRank,
                      int aNodeCount,
                      skv_server_internal_event_manager_if_t *aInternalEventMgr,
@@ -184,6 +213,10 @@ public:
   {
     return mEventQueue.AckEvent( aEvent );
   }
+  void SetDoorbell( skv_server_doorbell_t *aDoorbell )
+  {
+    mEventQueue.SetDoorbell( aDoorbell );
+  }
 
   skv_status_t CancelContext( skv_local_kv_req_ctx_t *aReqCtx );
 
@@ -224,10 +257,24 @@ public:
                                   skv_lmr_triplet_t *aValueRDMADest,
                                   skv_local_kv_cookie_t *aCookie );
 
+  skv_status_t InsertCancel( skv_cmd_RIU_req_t *aReq,
+                             skv_local_kv_req_ctx_t aReqCtx,
+                             skv_lmr_triplet_t *aValueRDMADest,
+                             skv_local_kv_cookie_t *aCookie );
+
   skv_status_t BulkInsert( skv_pds_id_t aPDSId,
                            skv_lmr_triplet_t *aLocalBuffer,
+                           skv_bulk_inserter_flags_t aFlags,
                            skv_local_kv_cookie_t *aCookie );
 
+  skv_status_t MultiKey( skv_pds_id_t aPDSId,
+                         skv_command_type_t aOp,
+                         skv_cmd_RIU_flags_t aFlags,
+                         int aKeyCount,
+                         char *aRequestBuffer,
+                         char *aResultBuffer,
+                         skv_local_kv_cookie_t *aCookie );
+
   skv_status_t Retrieve( skv_pds_id_t aPDSId,
                          char* aKeyData,
                          int aKeySize,
@@ -277,9 +324,9 @@ public:
     return mKeepProcessing;
   }
 
-  skv_local_kv_request_queue_t* GetRequestQueue()
+  skv_local_kv_request_queue_t* GetRequestQueue( int aWorker )
   {
-    return &mRequestQueue;
+    return mRequestQueue[ aWorker ];
   }
   skv_status_t PerformOpen( skv_local_kv_request_t *aReq );
   skv_status_t PerformGetDistribution(skv_local_kv_request_t *aReq );
@@ -289,6 +336,7 @@ public:
   skv_status_t PerformLookup( skv_local_kv_request_t *aReq );
   skv_status_t PerformRetrieve( skv_local_kv_request_t *aReq );
   skv_status_t PerformBulkInsert( skv_local_kv_request_t *aReq );
+  skv_status_t PerformMultiKey( skv_local_kv_request_t *aReq );
   skv_status_t PerformRemove( skv_local_kv_request_t *aReq );
   skv_status_t PerformRetrieveNKeys( skv_local_kv_request_t *aReq );
 
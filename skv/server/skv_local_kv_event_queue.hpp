@@ -22,97 +22,85 @@
 
 #define SKV_LOCAL_KV_MAX_EVENTS ( 1048576 )
 
+#include <skv/common/skv_lockfree_ring.hpp>
+#include <skv/server/skv_server_doorbell.hpp>
+
+/***
+ * Completion events of all worker threads (producers) for the
+ * server main thread (the only consumer). Events live in the ring slots,
+ * GetEvent() hands out the oldest one in place and AckEvent() releases it.
+ * Events have to be acked in the order they were fetched.
+ ***/
 class skv_local_kv_event_queue_t {
-  skv_local_kv_event_t *mEventPool;
-  skv_array_stack_t< skv_local_kv_event_t*, SKV_LOCAL_KV_MAX_EVENTS > mFreeEvents;
-  skv_array_queue_t< skv_local_kv_event_t*, SKV_LOCAL_KV_MAX_EVENTS > mActiveEventQueue;
-  skv_mutex_t mQueueSerializer;
+  skv_mpsc_ring_t< skv_local_kv_event_t > mEventRing;
+  skv_server_doorbell_t *mDoorbell;
 
 public:
-  skv_local_kv_event_queue_t()
+  skv_local_kv_event_queue_t() : mEventRing( SKV_LOCAL_KV_MAX_EVENTS ), mDoorbell( NULL )
   {
-    mEventPool = new skv_local_kv_event_t[ SKV_LOCAL_KV_MAX_EVENTS ];
   }
   ~skv_local_kv_event_queue_t()
   {
-    delete [] mEventPool;
   }
 
   skv_status_t Init() {
-    for( int i=0; i<SKV_LOCAL_KV_MAX_EVENTS; i++ )
-    {
-      mEventPool[ i ].mType = SKV_SERVER_EVENT_TYPE_NONE;
-      mEventPool[ i ].mCookie = 0;
-      mFreeEvents.push( &(mEventPool[ i ]) );
-
-    }
     return SKV_SUCCESS;
   }
+
+  // rung for every queued event to wake up an idle server main loop
+  void SetDoorbell( skv_server_doorbell_t *aDoorbell )
+  {
+    mDoorbell = aDoorbell;
+  }
   skv_local_kv_event_t* GetEvent()
   {
-    skv_local_kv_event_t *Event = NULL;
+    skv_local_kv_event_t *Event = mEventRing.front();
 
-    mQueueSerializer.lock();
-    if( ! mActiveEventQueue.empty() )
+    if( Event != NULL )
     {
-      Event = mActiveEventQueue.front();
-      mActiveEventQueue.pop();
-
       BegLogLine( SKV_LOCAL_KV_QUEUES_LOG )
         << "skv_local_kv_event_queue_t::GetEvent(): Event fetched"
         << " @" << (void*)Event
         << " type: " << skv_server_event_type_to_string( Event->mType )
         << EndLogLine;
     }
-    mQueueSerializer.unlock();
 
     return Event;
   }
 
   skv_status_t AckEvent( skv_local_kv_event_t *aEvent )
   {
-    mQueueSerializer.lock();
+    AssertLogLine( aEvent == mEventRing.front() )
+      << "skv_local_kv_event_queue_t::AckEvent(): ERROR: event acked out of order"
+      << " @" << (void*)aEvent
+      << EndLogLine;
+
     aEvent->mType = SKV_SERVER_EVENT_TYPE_NONE;
     aEvent->mCookie = 0;
-    mFreeEvents.push(aEvent);
-    mQueueSerializer.unlock();
+    mEventRing.pop();
     return SKV_SUCCESS;
   }
 
   skv_status_t QueueEvent( skv_local_kv_cookie_t* aCookie )
   {
-    skv_status_t status = SKV_ERRNO_LOCAL_KV_EVENT;
+    skv_local_kv_event_t Event;
+    Event.mType = SKV_SERVER_EVENT_TYPE_LOCAL_KV_CMPL;
+    Event.mCookie = *aCookie;
 
-    skv_local_kv_event_t *Event = NULL;
-
-    mQueueSerializer.lock();
-    if( mFreeEvents.empty() )
-    {
-      mQueueSerializer.unlock();
+    if( ! mEventRing.push( Event ) )
       return SKV_ERRNO_PENDING_COMMAND_LIMIT_REACHED;
-    }
-
-    Event = mFreeEvents.top();
-    mFreeEvents.pop();
 
-    Event->mType = SKV_SERVER_EVENT_TYPE_LOCAL_KV_CMPL;
-    Event->mCookie = *aCookie;
-
-    mActiveEventQueue.push(Event);
-    mQueueSerializer.unlock();
+    if( mDoorbell != NULL )
+      mDoorbell->Ring();
 
     BegLogLine( SKV_LOCAL_KV_QUEUES_LOG )
       << "skv_local_kv_event_queue_t::QueueEvent(): Event created"
-      << " @" << (void*)Event
-      << " type: " << skv_server_event_type_to_string( Event->mType )
+      << " type: " << skv_server_event_type_to_string( Event.mType )
       << " cookie: " << *aCookie
       << EndLogLine;
 
-    return status;
+    return SKV_ERRNO_LOCAL_KV_EVENT;
   }
-
-
-
 };
 
 
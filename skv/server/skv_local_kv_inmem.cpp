@@ -728,9 +728,29 @@ skv_local_kv_inmem::Remove( skv_pds_id_t aPDSId,
                              aKeySize );
 }
 
+skv_status_t
+skv_local_kv_inmem::MultiKey( skv_pds_id_t aPDSId,
+                              skv_command_type_t aOp,
+                              skv_cmd_RIU_flags_t aFlags,
+                              int aKeyCount,
+                              char *aRequestBuffer,
+                              char *aResultBuffer,
+                              skv_local_kv_cookie_t *aCookie )
+{
+  BegLogLine( SKV_LOCAL_KV_BACKEND_LOG )
+    << "skv_local_kv_inmem::MultiKey(): "
+    << " PDSId: " << aPDSId
+    << " Op: " << skv_command_type_to_string( aOp )
+    << " KeyCount: " << aKeyCount
+    << EndLogLine;
+
+  return mPDSManager.MultiKey( aPDSId, aOp, aFlags, aKeyCount, aRequestBuffer, aResultBuffer );
+}
+
 skv_status_t
 skv_local_kv_inmem::BulkInsert( skv_pds_id_t aPDSId,
                                 skv_lmr_triplet_t *aLocalBuffer,
+                                skv_bulk_inserter_flags_t aFlags,
                                 skv_local_kv_cookie_t *aCookie )
 {
   int             LocalBufferSize = aLocalBuffer->GetLen();
@@ -743,8 +763,12 @@ skv_local_kv_inmem::BulkInsert( skv_pds_id_t aPDSId,
     << " LocalBufferSize: " << LocalBufferSize
     << " LocalBuffer: " << (void *) LocalBufferAddr
     << " LocalBufferLMR: " << (void *) LocalBufferLMR
+    << " aFlags: " << aFlags
     << EndLogLine;
 
+  if( aFlags & SKV_BULK_INSERTER_FLAGS_SORTED )
+    return mPDSManager.BulkInsertSorted( aPDSId, LocalBufferAddr, LocalBufferSize );
+
   // Layout of data in buffer { KeySize, ValueSize, Key, Value }
   int TotalProcessed = 0;
   skv_status_t LoopStatus = SKV_SUCCESS;
@@ -38,6 +38,7 @@ public:
   skv_local_kv_event_t* GetEvent();
   skv_status_t CancelContext( skv_local_kv_req_ctx_t *aReqCtx ) { return SKV_SUCCESS; }
   skv_status_t AckEvent( skv_local_kv_event_t *aEvent ) { return SKV_SUCCESS; }
+  void SetDoorbell( skv_server_doorbell_t *aDoorbell ) {}   // completes requests synchronously
 
   skv_status_t GetDistribution( skv_distribution_t**,
                                 skv_local_kv_cookie_t * );
@@ -76,10 +77,28 @@ public:
                                   skv_lmr_triplet_t *aValueRDMADest,
                                   skv_local_kv_cookie_t *aCookie ) { return SKV_SUCCESS; }
 
+  // the value was transferred into the stored record already
+  skv_status_t InsertCancel( skv_cmd_RIU_req_t *aReq,
+                             skv_local_kv_req_ctx_t aReqCtx,
+                             skv_lmr_triplet_t *aValueRDMADest,
+                             skv_local_kv_cookie_t *aCookie )
+  {
+    return Remove( aReq->mPDSId, aReq->mKeyValue.mData, aReq->mKeyValue.mKeySize, aCookie );
+  }
+
   skv_status_t BulkInsert( skv_pds_id_t aPDSId,
                            skv_lmr_triplet_t *aLocalBuffer,
+                           skv_bulk_inserter_flags_t aFlags,
                            skv_local_kv_cookie_t *aCookie );
 
+  skv_status_t MultiKey( skv_pds_id_t aPDSId,
+                         skv_command_type_t aOp,
+                         skv_cmd_RIU_flags_t aFlags,
+                         int aKeyCount,
+                         char *aRequestBuffer,
+                         char *aResultBuffer,
+                         skv_local_kv_cookie_t *aCookie );
+
   skv_status_t Retrieve( skv_pds_id_t aPDSId,
                          char* aKeyData,
                          int aKeySize,
@@ -62,14 +62,50 @@
 #include <skv/server/skv_local_kv_rocksdb.hpp>
 #endif
 
+/*
+ * holds the serialization lock of the local kv interface for the
+ * duration of one backend call (no-op if aLock is NULL)
+ */
+class skv_local_kv_serializer_t
+{
+  skv_mutex_t *mLock;
+
+public:
+  skv_local_kv_serializer_t( skv_mutex_t *aLock ) : mLock( aLock )
+  {
+    if( mLock )
+      mLock->lock();
+  }
+  ~skv_local_kv_serializer_t()
+  {
+    if( mLock )
+      mLock->unlock();
+  }
+};
+
 template<class skv_local_kv_manager, class skv_record_lock_manager = skv_server_lock_manager_t>
 class skv_local_kv_interface
 {
   skv_local_kv_manager mLocalKVManager;
   skv_record_lock_manager mLockManager;
 
+  // backends and the lock manager expect a single calling thread
+  // (e.g. single producer request queues). With multiple server reactors
+  // all calls are serialized, events are polled by one reactor at a time anyway.
+  skv_mutex_t mSerializeLock;
+  skv_mutex_t *mSerializer;
+
 public:
-  skv_local_kv_interface() {}
+  skv_local_kv_interface() : mSerializer( NULL ) {}
+
+  /**
+   * Enable serialization of backend calls
+   * Has to be called before Init() if more than one thread calls into the backend.
+   */
+  void SetMultiThreaded( bool aMultiThreaded )
+  {
+    mSerializer = aMultiThreaded ? &mSerializeLock : NULL;
+  }
 
   /**
    * Initializsation of the local KV manager
@@ -142,6 +178,18 @@ public:
     return mLocalKVManager.AckEvent( aEvent );
   }
 
+  /**
+   * Register the doorbell of the server main loop
+   * The back-end rings it whenever it queues an event, so the main loop
+   * can sleep while there's nothing to do.
+   *
+   * \param[in] aDoorbell  doorbell to ring (NULL disables the wakeup)
+   */
+  void SetDoorbell( skv_server_doorbell_t *aDoorbell )
+  {
+    mLocalKVManager.SetDoorbell( aDoorbell );
+  }
+
   /**
    * Cancellation of a request context
    * Allows the SKV framework to cancel a request context that was
@@ -149,6 +197,7 @@ public:
    */
   skv_status_t CancelContext( skv_local_kv_req_ctx_t *aReqCtx )
   {
+    skv_local_kv_serializer_t Serialize( mSerializer );
     return mLocalKVManager.CancelContext( aReqCtx );
   }
 
@@ -163,6 +212,7 @@ public:
   skv_status_t GetDistribution( skv_distribution_t **aDist,
                                 skv_local_kv_cookie_t *aCookie )
   {
+    skv_local_kv_serializer_t Serialize( mSerializer );
     return mLocalKVManager.GetDistribution( aDist, aCookie );
   }
 
@@ -194,6 +244,7 @@ public:
                        skv_lmr_triplet_t *aValueRDMADest,
                        skv_local_kv_cookie_t *aCookie )
   {
+    skv_local_kv_serializer_t Serialize( mSerializer );
     return mLocalKVManager.Insert( aReq, aCmdStatus, aStoredValueRep, aValueRDMADest, aCookie );
   }
 
@@ -215,6 +266,7 @@ public:
                        int aValueSize,
                        skv_local_kv_cookie_t *aCookie )
   {
+    skv_local_kv_serializer_t Serialize( mSerializer );
     return mLocalKVManager.Insert( aPDSId, aRecordRep, aKeySize, aValueSize, aCookie );
   }
 
@@ -234,23 +286,67 @@ public:
                                   skv_lmr_triplet_t *aValueRDMADest,
                                   skv_local_kv_cookie_t *aCookie )
   {
+    skv_local_kv_serializer_t Serialize( mSerializer );
     return mLocalKVManager.InsertPostProcess( aReqCtx, aValueRDMADest, aCookie );
   }
 
+  /** Cancellation of a multi-stage insert
+   * Replaces InsertPostProcess() if the transferred data turned out to be invalid
+   * (e.g. checksum mismatch). The back-end must not keep the new value: it either
+   * drops the data that was not yet committed or removes the record the data was
+   * transferred into.
+   *
+   * \param[in] aReq            insert request (PDS and key of the record)
+   * \param[in] aReqCtx         request context handle that allows the back-end to locate the state of the request
+   * \param[in] aValueRDMADest  rdma destination (e.g. for cleanup purposes)
+   * \param[in] aCookie         local-kv cookie
+   *
+   * \return status of operation
+   */
+  skv_status_t InsertCancel( skv_cmd_RIU_req_t *aReq,
+                             skv_local_kv_req_ctx_t aReqCtx,
+                             skv_lmr_triplet_t *aValueRDMADest,
+                             skv_local_kv_cookie_t *aCookie )
+  {
+    skv_local_kv_serializer_t Serialize( mSerializer );
+    return mLocalKVManager.InsertCancel( aReq, aReqCtx, aValueRDMADest, aCookie );
+  }
+
   /** Insert many key/values with one command
    * parse the list of aLocalBuffer to insert multiple key/values in a batch
    *
    * \param[in] aPDSId         PDS to insert
    * \param[in] aLocalBuffer   list of RDMA-coordinates that hold the key/value data
+   * \param[in] aFlags         SKV_BULK_INSERTER_FLAGS_SORTED: rows are sorted by key
+   *                           (backends may verify and fall back to the unsorted path)
    * \param[in] aCookie        local-kv cookie
    *
    * \return status of operation
    */
   skv_status_t BulkInsert( skv_pds_id_t aPDSId,
                            skv_lmr_triplet_t *aLocalBuffer,
+                           skv_bulk_inserter_flags_t aFlags,
                            skv_local_kv_cookie_t *aCookie )
   {
-    return mLocalKVManager.BulkInsert( aPDSId, aLocalBuffer, aCookie );
+    skv_local_kv_serializer_t Serialize( mSerializer );
+    return mLocalKVManager.BulkInsert( aPDSId, aLocalBuffer, aFlags, aCookie );
+  }
+
+  /* Multi-key insert or retrieve
+   * - aRequestBuffer holds aKeyCount packed rows (see skv_multi_key_* in skv_types.hpp)
+   * - the per-key status/size goes into aResultBuffer followed by retrieved values
+   * - the command status only reports failures that affect the whole request
+   */
+  skv_status_t MultiKey( skv_pds_id_t aPDSId,
+                         skv_command_type_t aOp,
+                         skv_cmd_RIU_flags_t aFlags,
+                         int aKeyCount,
+                         char *aRequestBuffer,
+                         char *aResultBuffer,
+                         skv_local_kv_cookie_t *aCookie )
+  {
+    skv_local_kv_serializer_t Serialize( mSerializer );
+    return mLocalKVManager.MultiKey( aPDSId, aOp, aFlags, aKeyCount, aRequestBuffer, aResultBuffer, aCookie );
   }
 
   /* Retrieval of data
@@ -269,6 +365,7 @@ public:
                          int *aTotalSize,
                          skv_local_kv_cookie_t *aCookie )
   {
+    skv_local_kv_serializer_t Serialize( mSerializer );
     return mLocalKVManager.Retrieve( aPDSId,
                                      aKeyData,
                                      aKeySize,
@@ -282,6 +379,7 @@ public:
 
   skv_status_t RetrievePostProcess( skv_local_kv_req_ctx_t aReqCtx )
   {
+    skv_local_kv_serializer_t Serialize( mSerializer );
     return mLocalKVManager.RetrievePostProcess( aReqCtx );
   }
 
@@ -295,6 +393,7 @@ public:
                               skv_cursor_flags_t aFlags,
                               skv_local_kv_cookie_t *aCookie )
   {
+    skv_local_kv_serializer_t Serialize( mSerializer );
     return mLocalKVManager.RetrieveNKeys( aPDSId, aStartingKeyData, aStartingKeySize,
                                           aRetrievedKeysSizesSegs,
                                           aRetrievedKeysCount,
@@ -306,6 +405,7 @@ public:
 
   skv_status_t RetrieveNKeysPostProcess( skv_local_kv_req_ctx_t aReqCtx )
   {
+    skv_local_kv_serializer_t Serialize( mSerializer );
     return mLocalKVManager.RetrieveNKeysPostProcess( aReqCtx );
   }
 
@@ -320,6 +420,7 @@ public:
                        skv_lmr_triplet_t *aStoredValueRep,
                        skv_local_kv_cookie_t *aCookie )
   {
+    skv_local_kv_serializer_t Serialize( mSerializer );
     return mLocalKVManager.Lookup( aPDSId, aKeyPtr, aKeySize, aFlags, aStoredValueRep, aCookie );
   }
 
@@ -329,6 +430,7 @@ public:
                        int aKeySize,
                        skv_local_kv_cookie_t *aCookie )
   {
+    skv_local_kv_serializer_t Serialize( mSerializer );
     return mLocalKVManager.Remove( aPDSId, aKeyData, aKeySize, aCookie );
   }
 
@@ -339,6 +441,7 @@ public:
                          skv_pds_id_t *aPDSId,
                          skv_local_kv_cookie_t *aCookie )
   {
+    skv_local_kv_serializer_t Serialize( mSerializer );
     return mLocalKVManager.PDS_Open( aPDSName, aPrivs, aFlags, aPDSId, aCookie );
   }
 
@@ -346,11 +449,13 @@ public:
                          skv_pds_attr_t *aPDSAttr,
                          skv_local_kv_cookie_t *aCookie )
   {
+    skv_local_kv_serializer_t Serialize( mSerializer );
     return mLocalKVManager.PDS_Stat( aCmd, aPDSAttr, aCookie );
   }
 
   skv_status_t PDS_Close( skv_pds_attr_t *aPDSAttr, skv_local_kv_cookie_t *aCookie )
   {
+    skv_local_kv_serializer_t Serialize( mSerializer );
     return mLocalKVManager.PDS_Close( aPDSAttr, aCookie );
   }
 
@@ -361,6 +466,7 @@ public:
                              skv_server_cursor_hdl_t *aCursorHandle,
                              skv_local_kv_cookie_t *aCookie )
   {
+    skv_local_kv_serializer_t Serialize( mSerializer );
     return mLocalKVManager.CreateCursor( aBuff, aBuffSize, aCursorHandle, aCookie );
   }
 
@@ -383,6 +489,7 @@ public:
                      const skv_server_ccb_t *aOwner,
                      skv_rec_lock_handle_t *aRecLock )
   {
+    skv_local_kv_serializer_t Serialize( mSerializer );
     return mLockManager.Lock( aPDSId, aKeyValue, aOwner, aRecLock );
   }
   /*
@@ -393,6 +500,7 @@ public:
   skv_status_t Unlock( const skv_rec_lock_handle_t aLock,
                        const skv_server_ccb_t *aOwner )
   {
+    skv_local_kv_serializer_t Serialize( mSerializer );
     return mLockManager.Unlock( aLock, aOwner );
   }
 
@@ -406,6 +514,7 @@ public:
   skv_status_t Allocate( int aBuffSize,
                          skv_lmr_triplet_t *aRDMARep )
   {
+    skv_local_kv_serializer_t Serialize( mSerializer );
     return mLocalKVManager.Allocate( aBuffSize, aRDMARep );
   }
 
@@ -415,6 +524,7 @@ public:
    */
   skv_status_t Deallocate( skv_lmr_triplet_t *aRDMARep )
   {
+    skv_local_kv_serializer_t Serialize( mSerializer );
     return mLocalKVManager.Deallocate( aRDMARep );
   }
 
@@ -422,6 +532,7 @@ public:
                                 char* aMem,
                                 int aSize )
   {
+    skv_local_kv_serializer_t Serialize( mSerializer );
     return mLocalKVManager.RDMABoundsCheck( aContext, aMem, aSize );
   }
 
@@ -430,6 +541,7 @@ public:
    */
   skv_status_t DumpImage( char* aCheckpointPath )
   {
+    skv_local_kv_serializer_t Serialize( mSerializer );
     return mLocalKVManager.DumpImage( aCheckpointPath );
   }
 };
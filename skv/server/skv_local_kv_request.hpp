@@ -24,6 +24,7 @@ typedef enum {
   SKV_LOCAL_KV_REQUEST_TYPE_CLOSE,
   SKV_LOCAL_KV_REQUEST_TYPE_INFO,
   SKV_LOCAL_KV_REQUEST_TYPE_BULK_INSERT,
+  SKV_LOCAL_KV_REQUEST_TYPE_MULTI_KEY,
   SKV_LOCAL_KV_REQUEST_TYPE_RETRIEVE_N,
   SKV_LOCAL_KV_REQUEST_TYPE_GET_DISTRIBUTION,
   SKV_LOCAL_KV_REQUEST_TYPE_ASYNC_INSERT_CLEANUP,
@@ -46,6 +47,7 @@ skv_local_kv_request_type_to_string( skv_local_kv_request_type_t aType )
     case SKV_LOCAL_KV_REQUEST_TYPE_CLOSE:          { return "SKV_LOCAL_KV_REQUEST_TYPE_CLOSE"; }
     case SKV_LOCAL_KV_REQUEST_TYPE_INFO:           { return "SKV_LOCAL_KV_REQUEST_TYPE_INFO"; }
     case SKV_LOCAL_KV_REQUEST_TYPE_BULK_INSERT:    { return "SKV_LOCAL_KV_REQUEST_TYPE_BULK_INSERT"; }
+    case SKV_LOCAL_KV_REQUEST_TYPE_MULTI_KEY:      { return "SKV_LOCAL_KV_REQUEST_TYPE_MULTI_KEY"; }
     case SKV_LOCAL_KV_REQUEST_TYPE_RETRIEVE_N:     { return "SKV_LOCAL_KV_REQUEST_TYPE_RETRIEVE_N"; }
     case SKV_LOCAL_KV_REQUEST_TYPE_GET_DISTRIBUTION: { return "SKV_LOCAL_KV_REQUEST_TYPE_GET_DISTRIBUTION"; }
     case SKV_LOCAL_KV_REQUEST_TYPE_ASYNC_INSERT_CLEANUP: { return "SKV_LOCAL_KV_REQUEST_TYPE_ASYNC_INSERT_CLEANUP"; }
@@ -102,6 +104,16 @@ struct skv_local_kv_remove_request_t {
 struct skv_local_kv_bulkinsert_request_t {
   skv_pds_id_t mPDSId;
   skv_lmr_triplet_t mLocalBuffer;
+  skv_bulk_inserter_flags_t mFlags;
+};
+
+struct skv_local_kv_multikey_request_t {
+  skv_pds_id_t mPDSId;
+  skv_command_type_t mOp;
+  skv_cmd_RIU_flags_t mFlags;
+  int mKeyCount;
+  char *mRequestBuffer;  // packed rows
+  char *mResultBuffer;   // result entries + value space
 };
 
 struct skv_local_kv_retrieveN_request_t {
@@ -131,6 +143,7 @@ struct skv_local_kv_request_t {
     skv_local_kv_retrieve_request_t mRetrieve;
     skv_local_kv_remove_request_t mRemove;
     skv_local_kv_bulkinsert_request_t mBulkInsert;
+    skv_local_kv_multikey_request_t mMultiKey;
     skv_local_kv_retrieveN_request_t mRetrieveN;
     skv_local_kv_create_cursor_request_t mCursor;
   } mRequest;
@@ -23,17 +23,28 @@
 #define SKV_LOCAL_KV_MAX_REQUESTS ( 1048576 )
 
 #include <algorithm>
-
+#include <skv/common/skv_lockfree_ring.hpp>
+
+/***
+ * Requests are handed from the server main thread (the only producer)
+ * to exactly one worker thread through a lock-free ring. A second ring
+ * returns acknowledged entries to the producer. Entries can be acked in
+ * a different order than they were fetched (stalled requests), the free
+ * ring doesn't care about that.
+ ***/
 class skv_local_kv_request_queue_t {
-  skv_array_stack_t< skv_local_kv_request_t*, SKV_LOCAL_KV_MAX_REQUESTS > mFreeRequests;
-  skv_array_queue_t< skv_local_kv_request_t*, SKV_LOCAL_KV_MAX_REQUESTS > mActiveRequests;
-  skv_local_kv_request_t *mRequestPool;
   size_t mLenght;
-  skv_mutex_t mQueueSerializer;
-  volatile int mFreeSlots;
+  skv_local_kv_request_t *mRequestPool;
+  skv_spsc_ring_t< skv_local_kv_request_t* > mFreeRequests;    // worker -> server
+  skv_spsc_ring_t< skv_local_kv_request_t* > mActiveRequests;  // server -> worker
+  uint64_t mDispatched;                                         // updated by the producer only
 
 public:
-  skv_local_kv_request_queue_t( const size_t aSize = SKV_LOCAL_KV_MAX_REQUESTS ) : mFreeSlots( 0 ), mLenght( std::min( (size_t)aSize, (size_t)SKV_LOCAL_KV_MAX_REQUESTS ) )
+  skv_local_kv_request_queue_t( const size_t aSize = SKV_LOCAL_KV_MAX_REQUESTS )
+    : mLenght( std::min( (size_t)aSize, (size_t)SKV_LOCAL_KV_MAX_REQUESTS ) ),
+      mFreeRequests( mLenght ),
+      mActiveRequests( mLenght ),
+      mDispatched( 0 )
   {
     mRequestPool = new skv_local_kv_request_t[ mLenght ];
   }
@@ -53,7 +64,6 @@ public:
       mRequestPool[ i ].mType = SKV_LOCAL_KV_REQUEST_TYPE_UNKNOWN;
       mFreeRequests.push( &(mRequestPool[ i ]) );
     }
-    mFreeSlots = mLenght;
 
     return SKV_SUCCESS;
   }
@@ -65,22 +75,17 @@ public:
 
   skv_local_kv_request_t* AcquireRequestEntry()
   {
-    if( mFreeRequests.empty() || (mActiveRequests.size() > mLenght-2) )
+    skv_local_kv_request_t *Req = NULL;
+    if( ! mFreeRequests.pop( Req ) )
       return NULL;
 
-    mQueueSerializer.lock();
-    skv_local_kv_request_t *Req = mFreeRequests.top();
-    --mFreeSlots;
-    mFreeRequests.pop();
-    mQueueSerializer.unlock();
-
     return Req;
   }
   void QueueRequest( skv_local_kv_request_t *aReq )
   {
-    mQueueSerializer.lock();
+    // can't overflow: the ring holds at least as many slots as the pool has entries
     mActiveRequests.push( aReq );
-    mQueueSerializer.unlock();
+    ++mDispatched;
   }
   bool IsEmpty()
   {
@@ -90,28 +95,27 @@ public:
   {
     skv_local_kv_request_t *Request = NULL;
 
-    mQueueSerializer.lock();
-    if( ! mActiveRequests.empty() )
+    if( mActiveRequests.pop( Request ) )
     {
-      Request = mActiveRequests.front();
-      mActiveRequests.pop();
-
       BegLogLine( SKV_LOCAL_KV_QUEUES_LOG )
         << "skv_local_kv_request_queue_t::GetRequest() Request fetched"
         << " @" << (void*)Request
         << EndLogLine;
     }
-    mQueueSerializer.unlock();
 
     return Request;
   }
 
+  // next request without removing it from the queue (worker only)
+  skv_local_kv_request_t* PeekRequest()
+  {
+    skv_local_kv_request_t * const *Request = mActiveRequests.front();
+    return ( Request != NULL ) ? *Request : NULL;
+  }
+
   skv_status_t AckRequest( skv_local_kv_request_t* aRequest )
   {
-    mQueueSerializer.lock();
     mFreeRequests.push( aRequest );
-    ++mFreeSlots;
-    mQueueSerializer.unlock();
 
     BegLogLine( SKV_LOCAL_KV_QUEUES_LOG )
       << "skv_local_kv_request_queue_t::AckRequest() Request returned"
@@ -123,34 +127,59 @@ public:
 
   inline int GetFreeSlots() const
   {
-    return mFreeSlots;
+    return mFreeRequests.size();
+  }
+
+  // requests that are queued or still being processed by the worker
+  inline int GetInFlight() const
+  {
+    return mLenght - mFreeRequests.size();
+  }
+  // requests the worker hasn't fetched yet
+  inline int GetQueueDepth() const
+  {
+    return mActiveRequests.size();
+  }
+  inline uint64_t GetDispatched() const
+  {
+    return mDispatched;
   }
 };
 
-// for now, just start with a round-robin implementation of a list of worker-request queues
-// later we might consider a "shortest-queue-first" scheme or other scheduling too
+/***
+ * Dispatches requests that can go to any worker.
+ * Uses power-of-two-choices on the number of in-flight requests of each
+ * queue: two random queues are sampled and the less loaded one wins.
+ * A worker that stalls (e.g. a rocksdb compaction) keeps its requests
+ * un-acked and stops receiving new ones, without a global scan per request.
+ ***/
 class skv_local_kv_request_queue_list_t
 {
-  skv_local_kv_request_queue_t **mSortedRequestQueueList;
-  skv_local_kv_request_queue_t *mBestQueue;
-  uint64_t mCurrentIndex;
+  skv_local_kv_request_queue_t **mRequestQueueList;
+  uint64_t mRandState;
   unsigned int mActiveQueueCount;
   unsigned int mMaxQueueCount;
 
+  // xorshift64, only needs to be cheap and good enough to spread the samples
+  inline unsigned int NextRandom()
+  {
+    mRandState ^= mRandState << 13;
+    mRandState ^= mRandState >> 7;
+    mRandState ^= mRandState << 17;
+    return (unsigned int)( mRandState >> 32 );
+  }
+
 public:
   skv_local_kv_request_queue_list_t( const unsigned int aMaxQueueCount )
   {
     mMaxQueueCount = aMaxQueueCount;
-    mSortedRequestQueueList = new skv_local_kv_request_queue_t* [ mMaxQueueCount ];
-    mCurrentIndex = 0;
+    mRequestQueueList = new skv_local_kv_request_queue_t* [ mMaxQueueCount ];
+    mRandState = 0x9E3779B97F4A7C15ull;
     mActiveQueueCount = 0;
-    mBestQueue = NULL;
   }
-  ~skv_local_kv_request_queue_list_t() {}
-
-  void sort()
+  ~skv_local_kv_request_queue_list_t()
   {
-    // sort the list start with highest number of FreeSlots
+    delete [] mRequestQueueList;
   }
 
   void AddQueue( const skv_local_kv_request_queue_t * aQueue )
@@ -160,21 +189,46 @@ public:
       << " limit=" << mMaxQueueCount
       << EndLogLine;
 
-    mSortedRequestQueueList[ mActiveQueueCount ] = (skv_local_kv_request_queue_t*)aQueue;
+    mRequestQueueList[ mActiveQueueCount ] = (skv_local_kv_request_queue_t*)aQueue;
     ++mActiveQueueCount;
-
-    if( mActiveQueueCount == 1 )
-      mBestQueue = mSortedRequestQueueList[ 0 ];
   }
 
   skv_local_kv_request_queue_t * GetBestQueue()
   {
-    skv_local_kv_request_queue_t *retval = mBestQueue;
+    if( mActiveQueueCount == 1 )
+      return mRequestQueueList[ 0 ];
+
+    unsigned int First = NextRandom() % mActiveQueueCount;
+    unsigned int Second = NextRandom() % ( mActiveQueueCount - 1 );
+    if( Second >= First )
+      ++Second;
+
+    skv_local_kv_request_queue_t *A = mRequestQueueList[ First ];
+    skv_local_kv_request_queue_t *B = mRequestQueueList[ Second ];
 
-    ++mCurrentIndex;
-    mBestQueue = mSortedRequestQueueList[ mCurrentIndex % mActiveQueueCount ];
+    return ( B->GetInFlight() < A->GetInFlight() ) ? B : A;
+  }
+
+  unsigned int GetQueueCount() const
+  {
+    return mActiveQueueCount;
+  }
+  const skv_local_kv_request_queue_t * GetQueue( const unsigned int aIndex ) const
+  {
+    return mRequestQueueList[ aIndex ];
+  }
 
-    return retval;
+  // per-worker backlog: dispatched, in-flight and not yet fetched requests
+  void DumpBacklog( const char *aContext ) const
+  {
+    for( unsigned int q = 0; q < mActiveQueueCount; q++ )
+      BegLogLine( 1 )
+        << aContext
+        << " worker[ " << q << " ]"
+        << " dispatched: " << mRequestQueueList[ q ]->GetDispatched()
+        << " inflight: " << mRequestQueueList[ q ]->GetInFlight()
+        << " queued: " << mRequestQueueList[ q ]->GetQueueDepth()
+        << EndLogLine;
   }
 };
 
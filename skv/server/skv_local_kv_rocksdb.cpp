@@ -21,6 +21,7 @@
 #define SKV_LOCAL_KV_ROCKSDB_PROCESSING_LOG ( 0 | SKV_LOGGING_ALL )
 #endif
 #include <memory>
+#include <algorithm>
 #include <string>
 
 #include <FxLogger.hpp>
@@ -81,6 +82,14 @@ void Run( skv_local_kv_rocksdb_worker_t *aWorker )
   {
     skv_status_t status;
 
+    // another worker waits for all pending batches to be written
+    uint64_t Fence = Master->GetBatchFence();
+    if( Fence != aWorker->GetBatchFenceSeen() )
+    {
+      aWorker->FlushWriteBatch();
+      aWorker->SetBatchFenceSeen( Fence );
+    }
+
     // Prioritized queue needs to be processed first (this mostly does the important post-processing and buffer release)
     skv_local_kv_request_queue_t *nextQueue = DedicatedQueue;
     skv_local_kv_request_t *nextRequest;
@@ -145,7 +154,7 @@ void Run( skv_local_kv_rocksdb_worker_t *aWorker )
           status = aWorker->PerformLookup( nextRequest );
           break;
         case SKV_LOCAL_KV_REQUEST_TYPE_RETRIEVE:
-          status = aWorker->PerformRetrieve( nextRequest );
+          status = aWorker->PerformRetrieveBatch( nextRequest, nextQueue );
           break;
         case SKV_LOCAL_KV_REQUEST_TYPE_REMOVE:
           status = aWorker->PerformRemove( nextRequest );
@@ -153,6 +162,9 @@ void Run( skv_local_kv_rocksdb_worker_t *aWorker )
         case SKV_LOCAL_KV_REQUEST_TYPE_BULK_INSERT:
           status = aWorker->PerformBulkInsert( nextRequest );
           break;
+        case SKV_LOCAL_KV_REQUEST_TYPE_MULTI_KEY:
+          status = aWorker->PerformMultiKey( nextRequest );
+          break;
         case SKV_LOCAL_KV_REQUEST_TYPE_RETRIEVE_N:
           status = aWorker->PerformRetrieveNKeys( nextRequest );
           break;
@@ -173,11 +185,19 @@ void Run( skv_local_kv_rocksdb_worker_t *aWorker )
       }
       if( status != SKV_ERRNO_NOT_DONE )
         nextQueue->AckRequest( nextRequest );
+
+      if( aWorker->WriteBatchDue() )
+        aWorker->FlushWriteBatch();
     }
+    else if( ! aWorker->WriteBatchEmpty() )
+      // no more requests to coalesce with
+      aWorker->FlushWriteBatch();
     else
       ::sched_yield();
   }
 
+  aWorker->FlushWriteBatch();
+
   BegLogLine( SKV_LOCAL_KV_ROCKSDB_PROCESSING_LOG )
     << "AsyncProcessing: Exiting thread"
     << EndLogLine;
@@ -216,11 +236,59 @@ skv_status_t skv_local_kv_rocksdb_worker_t::Init( const skv_local_kv_rocksdb_wor
     << " buffersize=" << mSettings.mRDMABufferSize
     << " qdepth=" << mSettings.mMaxRequests
     << " maxvalue=" << mSettings.mMaxValueSize
+    << " writebatch=" << mSettings.mWriteBatchSize
+    << " writedelay=" << mSettings.mWriteBatchDelay
     << EndLogLine;
 
   return status;
 }
 
+skv_status_t skv_local_kv_rocksdb_worker_t::FlushWriteBatch()
+{
+  if( mPendingEvents.empty() )
+    return SKV_SUCCESS;
+
+  skv_status_t status = SKV_SUCCESS;
+  if( mWriteBatch.Count() > 0 )
+  {
+    rocksdb::Status rs = mDBAccess->WriteData( &mWriteBatch );
+    status = rocksdb_status_to_skv( rs );
+
+    BegLogLine( ! rs.ok() )
+      << "skv_local_kv_rocksdb: ERROR writing batch: "
+      << " records: " << mWriteBatch.Count()
+      << " status: " << rs.ToString().c_str()
+      << EndLogLine;
+  }
+
+  BegLogLine( SKV_LOCAL_KV_BACKEND_LOG )
+    << "skv_local_kv_rocksdb: write batch committed:"
+    << " records: " << mWriteBatch.Count()
+    << " bytes: " << mWriteBatch.GetDataSize()
+    << " requests: " << mPendingEvents.size()
+    << " status: " << skv_status_to_string( status )
+    << EndLogLine;
+
+  // ack only after the batch landed, a failed batch fails all its requests
+  for( size_t i = 0; i < mPendingEvents.size(); i++ )
+  {
+    skv_local_kv_rocksdb_pending_t *Pending = &mPendingEvents[ i ];
+    skv_status_t rc = ( status == SKV_SUCCESS ) ? Pending->mStatus : status;
+    if( Pending->mRDMAEvent )
+    {
+      skv_lmr_triplet_t ValueRDMADest;
+      InitKVRDMAEvent( &Pending->mCookie, &ValueRDMADest, 0, 0, rc );
+    }
+    else
+      InitKVEvent( &Pending->mCookie, rc );
+  }
+
+  mWriteBatch.Clear();
+  mWriteBatchKeys.clear();
+  mPendingEvents.clear();
+  return status;
+}
+
 skv_status_t
 skv_local_kv_rocksdb::Init( int aRank,
                             int aNodeCount,
@@ -251,7 +319,7 @@ skv_local_kv_rocksdb::Init( int aRank,
     << "skv_local_kv_rocksdb::Init(): queues and distribution initialized..."
     << EndLogLine;
 
-  status = mDBAccess.Init( config->GetServerPersistentFileLocalPath(), mMyRank );
+  status = mDBAccess.Init( config->GetServerPersistentFileLocalPath(), mMyRank, config->GetWriteSync() );
   if( status != SKV_SUCCESS )
     return status;
 
@@ -275,6 +343,8 @@ skv_local_kv_rocksdb::Init( int aRank,
   }
   worker_config.mMaxValueSize = SKV_LOCAL_KV_MAX_VALUE_SIZE;
   worker_config.mMaxRequests = worker_config.mRDMABufferSize / worker_config.mMaxValueSize;
+  worker_config.mWriteBatchSize = config->GetWriteBatchSize();
+  worker_config.mWriteBatchDelay = config->GetWriteBatchDelay();
 
   // make sure we have at least 16 command slots
   if( worker_config.mMaxRequests < SKV_LOCAL_KV_MIN_OUTSTANDING_REQUESTS )
@@ -310,10 +380,19 @@ skv_local_kv_rocksdb::Init( int aRank,
 skv_status_t
 skv_local_kv_rocksdb::Exit()
 {
+  // workers commit and ack their pending write batch on the way out,
+  // the DB has to stay open until all of them are gone
+  mKeepProcessing = false;
+  for( int w=0; w < SKV_LOCAL_KV_WORKER_POOL_SIZE; w++ )
+    if( mWorkerPool[ w ] )
+      mWorkerPool[ w ]->Join();
+  if( mMasterProcessing )
+    mMasterProcessing->FlushWriteBatch();
+
+  mRequestQueueList.DumpBacklog( "skv_local_kv_rocksdb::Exit():" );
+
   skv_status_t status = mDBAccess.Exit();
   mDistributionManager.Finalize();
-  // todo: stop all workers and clean the requestqueuelist
-  mKeepProcessing = false;
   return status;
 }
 
@@ -326,6 +405,25 @@ skv_local_kv_rocksdb::~skv_local_kv_rocksdb()
       delete mWorkerPool[ w ];
 }
 
+/*
+ * makes every worker write its pending batch (e.g. before a column family gets dropped)
+ * returns once all workers have passed the fence
+ */
+void
+skv_local_kv_rocksdb::FenceWriteBatches( skv_local_kv_rocksdb_worker_t *aCaller )
+{
+  aCaller->FlushWriteBatch();
+  uint64_t Fence = mBatchFence.fetch_add( 1, std::memory_order_acq_rel ) + 1;
+
+  for( int w=0; w < SKV_LOCAL_KV_WORKER_POOL_SIZE; w++ )
+    while( mKeepProcessing && ( mWorkerPool[ w ]->GetBatchFenceSeen() < Fence ) )
+    {
+      // pass fences of concurrent callers, our batch is empty already
+      aCaller->SetBatchFenceSeen( GetBatchFence() );
+      ::sched_yield();
+    }
+}
+
 skv_status_t
 skv_local_kv_rocksdb::CancelContext( skv_local_kv_req_ctx_t *aReqCtx )
 {
@@ -443,6 +541,16 @@ skv_status_t skv_local_kv_rocksdb_worker_t::PerformOpen( skv_local_kv_request_t
     case SKV_ERRNO_RECORD_ALREADY_EXISTS:
       // wipe out existing data and pds entries for this pds
       rs = mDBAccess->DeletePDS( pdsKey, PDSIdToString( pdsData->mPDSId ) );
+      if( rs.ok() )
+      {
+        // batched records of the PDS must not be written after its column family is gone
+        mMaster->FenceWriteBatches( this );
+        rs = mDBAccess->DropPDSData( pdsData->mPDSId );
+      }
+
+      AssertLogLine( rs.ok() )
+       << "skv_local_kv_rocksdb: Removal of existing PDS failed: " << rs.ToString().c_str()
+       << EndLogLine;
 
       // NO break here: we want to create a new pds entry
 
@@ -463,6 +571,8 @@ skv_status_t skv_local_kv_rocksdb_worker_t::PerformOpen( skv_local_kv_request_t
       // insert the new PDS entry to the PDS table (name and reverse lookup entry)
       pdsDataString = std::string( (const char*) pdsData, sizeof(skv_pds_attr_t) );
       rs = mDBAccess->CreatePDS(pdsKey, PDSIdToString( pdsData->mPDSId ), rocksdb::Slice( pdsDataString ) );
+      if( rs.ok() )
+        rs = mDBAccess->CreatePDSData( pdsData->mPDSId, pdsData->mPDSName );
 
       AssertLogLine( rs.ok() )
        << "skv_local_kv_rocksdb: Creation of new PDS entry failed."
@@ -627,10 +737,10 @@ skv_status_t skv_local_kv_rocksdb_worker_t::PerformLookup( skv_local_kv_request_
                                 aReq->mRequest.mLookup.mKeyData,
                                 aReq->mRequest.mLookup.mKeySize );
 
-  std::string *value = new std::string();
+  skv_local_kv_rocksdb_value_t value;
 
   // Check if the key exists
-  rocksdb::Status rs = mDBAccess->LookupData( key, value );
+  rocksdb::Status rs = mDBAccess->LookupData( key, &value );
 
   if( rs.ok() )
   {
@@ -649,7 +759,6 @@ skv_status_t skv_local_kv_rocksdb_worker_t::PerformLookup( skv_local_kv_request_
     << EndLogLine;
 
   status = InitKVEvent( aReq->mCookie, &StoredValueRep, status );
-  delete value;
   ReleaseKey( key );
   return status;
 }
@@ -742,9 +851,13 @@ skv_status_t skv_local_kv_rocksdb_worker_t::PerformInsert( skv_local_kv_request_
       << EndLogLine;
 
     rocksdb::Slice value = rocksdb::Slice( &(kvData->mData[ kvData->mKeySize ]), kvData->mValueSize );
-    rocksdb::Status rs = mDBAccess->PutData( *key, value );
+    BatchPut( *key, value );
     ReleaseKey( *key );
     delete key;
+
+    // completes when the write batch is committed
+    DeferKVEvent( aReq->mCookie, SKV_SUCCESS, true );
+    return SKV_SUCCESS;
   }
   else
   {
@@ -813,9 +926,36 @@ skv_local_kv_rocksdb::InsertPostProcess( skv_local_kv_req_ctx_t aReqCtx,
   return status;
 }
 
+skv_status_t
+skv_local_kv_rocksdb::InsertCancel( skv_cmd_RIU_req_t *aReq,
+                                    skv_local_kv_req_ctx_t aReqCtx,
+                                    skv_lmr_triplet_t *aValueRDMADest,
+                                    skv_local_kv_cookie_t *aCookie )
+{
+  BegLogLine( SKV_LOCAL_KV_BACKEND_LOG )
+    << "skv_local_kv_rocksdb: cancelling insert: lmr:" << *aValueRDMADest
+    << " reqCtx: " << aReqCtx
+    << EndLogLine;
+
+  // the value is still in the rdma buffer: skip the Put and only release the resources
+  skv_local_kv_rocksdb_reqctx_t *ReqCtx = (skv_local_kv_rocksdb_reqctx_t*)aReqCtx;
+  rocksdb::Slice *key = (rocksdb::Slice*)ReqCtx->mUserData;
+  mMasterProcessing->ReleaseKey( *key );
+  delete key;
+
+  skv_local_kv_rocksdb_worker_t *DestWorker = ReqCtx->mWorker;
+  skv_lmr_triplet_t *lmr = new skv_lmr_triplet_t;
+  *lmr = *aValueRDMADest;
+  ReqCtx->mUserData = (void*)lmr;
+
+  return DestWorker->QueueDedicatedRequest( (skv_local_kv_req_ctx_t)ReqCtx,
+                                            SKV_LOCAL_KV_REQUEST_TYPE_ASYNC_INSERT_CLEANUP );
+}
+
 skv_status_t
 skv_local_kv_rocksdb::BulkInsert( skv_pds_id_t aPDSId,
                                   skv_lmr_triplet_t *aLocalBuffer,
+                                  skv_bulk_inserter_flags_t aFlags,
                                   skv_local_kv_cookie_t *aCookie )
 {
   skv_local_kv_request_queue_t *RequestQueue = mRequestQueueList.GetBestQueue();
@@ -826,6 +966,7 @@ skv_local_kv_rocksdb::BulkInsert( skv_pds_id_t aPDSId,
   kvReq->InitCommon( SKV_LOCAL_KV_REQUEST_TYPE_BULK_INSERT, aCookie );
   kvReq->mRequest.mBulkInsert.mPDSId = aPDSId;
   kvReq->mRequest.mBulkInsert.mLocalBuffer = *aLocalBuffer;
+  kvReq->mRequest.mBulkInsert.mFlags = aFlags;
 
   RequestQueue->QueueRequest( kvReq );
   return SKV_ERRNO_LOCAL_KV_EVENT;
@@ -844,8 +985,13 @@ skv_status_t skv_local_kv_rocksdb_worker_t::PerformBulkInsert( skv_local_kv_requ
     << " LocalBufferSize: " << LocalBufferSize
     << " LocalBuffer: " << (void *) LocalBufferAddr
     << " LocalBufferLMR: " << (void *) LocalBufferLMR
+    << " Flags: " << BIReq->mFlags
     << EndLogLine;
 
+  if(( BIReq->mFlags & SKV_BULK_INSERTER_FLAGS_SORTED ) &&
+     ( PerformBulkInsertSorted( aReq ) != SKV_ERRNO_NOT_DONE ))
+    return SKV_SUCCESS;
+
   // Layout of data in buffer { KeySize, ValueSize, Key, Value }
   int TotalProcessed = 0;
   skv_status_t LoopStatus = SKV_SUCCESS;
@@ -876,8 +1022,8 @@ skv_status_t skv_local_kv_rocksdb_worker_t::PerformBulkInsert( skv_local_kv_requ
                                                        KeyPtr,
                                                        KeySize ) );
 
-    std::string value;
-    rocksdb::Status rs = mDBAccess->LookupData( *key, &value );
+    skv_local_kv_rocksdb_value_t value;
+    rocksdb::Status rs = InWriteBatch( *key ) ? rocksdb::Status::OK() : mDBAccess->LookupData( *key, &value );
 
     int TotalSize = KeySize + ValueSize;
 
@@ -912,6 +1058,8 @@ skv_status_t skv_local_kv_rocksdb_worker_t::PerformBulkInsert( skv_local_kv_requ
         << EndLogLine;
 
       // SKV_SERVER_BULK_INSERT_DISPATCH_ERROR_RESP( SKV_ERRNO_RECORD_ALREADY_EXISTS, 0 );
+      ReleaseKey( *key );
+      delete key;
       continue;
     }
 
@@ -919,12 +1067,7 @@ skv_status_t skv_local_kv_rocksdb_worker_t::PerformBulkInsert( skv_local_kv_requ
      * Insert the record into local store.
      ****************************************************/
     rocksdb::Slice ins_value = rocksdb::Slice( ValuePtr, ValueSize );
-    rs = mDBAccess->PutData( *key, ins_value );
-
-    AssertLogLine( rs.ok() )
-      << "skv_local_kv_asyncmem: ERROR:: "
-      << " status: " << rs.ToString().c_str()
-      << EndLogLine;
+    BatchPut( *key, ins_value );
 
     BegLogLine( SKV_LOCAL_KV_BACKEND_LOG )
       << "skv_local_kv_rocksdb: BulkInserted: "
@@ -936,11 +1079,291 @@ skv_status_t skv_local_kv_rocksdb_worker_t::PerformBulkInsert( skv_local_kv_requ
     /****************************************************/
 
     ReleaseKey( *key );
+    delete key;
+  }
+
+  // the whole buffer goes into the write batch and completes with it
+  DeferKVEvent( aReq->mCookie, LoopStatus, false );
+  return SKV_SUCCESS;
+}
+
+/***************************************************
+ * skv_local_kv_rocksdb_worker_t::PerformBulkInsertSorted::
+ * Desc: sorted-run path of a bulk insert. Existing keys are found
+ *       with a single iterator sweep instead of one lookup per row.
+ *       Large runs are ingested as SST file, small ones go into
+ *       the write batch.
+ * input: request with a buffer sorted by key
+ * returns: SKV_ERRNO_NOT_DONE if the buffer isn't strictly sorted
+ *          and has to take the unsorted path, SKV_SUCCESS otherwise
+ ***************************************************/
+skv_status_t skv_local_kv_rocksdb_worker_t::PerformBulkInsertSorted( skv_local_kv_request_t *aReq )
+{
+  struct skv_local_kv_bulkinsert_request_t *BIReq = &aReq->mRequest.mBulkInsert;
+  int   LocalBufferSize = BIReq->mLocalBuffer.GetLen();
+  char* LocalBufferAddr = (char *)BIReq->mLocalBuffer.GetAddr();
+
+  std::vector< rocksdb::Slice > Keys;
+  std::vector< rocksdb::Slice > Values;
+  bool Sorted = true;
+
+  int TotalProcessed = 0;
+  while( Sorted && ( TotalProcessed < LocalBufferSize ) )
+  {
+    char* KeyPtr    = NULL;
+    char* ValuePtr  = NULL;
+    int   KeySize   = -1;
+    int   ValueSize = -1;
+
+    int RowLen = skv_bulk_insert_get_key_value_refs( LocalBufferAddr,
+                                                     &KeyPtr,
+                                                     KeySize,
+                                                     &ValuePtr,
+                                                     ValueSize );
+
+    AssertLogLine( ( KeySize > 0 ) && ( KeySize <= SKV_KEY_LIMIT ) )
+      << "skv_local_kv_rocksdb: ERROR: "
+      << " KeySize: " << KeySize
+      << " SKV_KEY_LIMIT: " << SKV_KEY_LIMIT
+      << " TotalProcessed: " << TotalProcessed
+      << " LocalBufferSize: "  << LocalBufferSize
+      << EndLogLine;
+
+    Keys.push_back( MakeKey( BIReq->mPDSId, KeyPtr, KeySize ) );
+    Values.push_back( rocksdb::Slice( ValuePtr, ValueSize ) );
+    Sorted = ( Keys.size() < 2 ) || ( Keys[ Keys.size() - 2 ].compare( Keys.back() ) < 0 );
+
+    LocalBufferAddr += RowLen;
+    TotalProcessed += RowLen;
+  }
+
+  if( !Sorted || Keys.empty() )
+  {
+    BegLogLine( SKV_LOCAL_KV_BACKEND_LOG )
+      << "skv_local_kv_rocksdb: sorted bulk insert buffer isn't sorted. Falling back to unsorted path."
+      << " row: " << Keys.size()
+      << EndLogLine;
+
+    for( size_t n = 0; n < Keys.size(); n++ )
+      ReleaseKey( Keys[ n ] );
+    return SKV_ERRNO_NOT_DONE;
+  }
+
+  // earlier batched records have to be visible to the sweep and older than the ingested file
+  FlushWriteBatch();
+
+  skv_status_t LoopStatus = SKV_SUCCESS;
+  std::vector< rocksdb::Slice > NewKeys;
+  std::vector< rocksdb::Slice > NewValues;
+  rocksdb::Iterator *iter = mDBAccess->NewIterator( &Keys[ 0 ], &Keys[ 0 ] );
+  for( size_t n = 0; n < Keys.size(); n++ )
+  {
+    if( iter->Valid() && ( iter->key().compare( Keys[ n ] ) < 0 ) )
+      iter->Seek( Keys[ n ] );
+
+    if( iter->Valid() && ( iter->key() == Keys[ n ] ) )
+    {
+      LoopStatus = SKV_ERRNO_RECORD_ALREADY_EXISTS;
+      continue;
+    }
+    NewKeys.push_back( Keys[ n ] );
+    NewValues.push_back( Values[ n ] );
+  }
+  delete iter;
+
+  bool Ingested = false;
+#ifdef SKV_LOCAL_KV_ROCKSDB_SST_INGEST
+  if(( LocalBufferSize >= SKV_LOCAL_KV_ROCKSDB_INGEST_MIN_SIZE ) && ( ! NewKeys.empty() ))
+  {
+    rocksdb::Status rs = mDBAccess->IngestSortedData( NewKeys, NewValues );
+    Ingested = rs.ok();
+
+    BegLogLine( ! rs.ok() )
+      << "skv_local_kv_rocksdb: SST ingest failed, using write batch. "
+      << " records: " << NewKeys.size()
+      << " status: " << rs.ToString().c_str()
+      << EndLogLine;
   }
-  return InitKVEvent( aReq->mCookie, LoopStatus );
+#endif
+
+  if( !Ingested )
+    for( size_t n = 0; n < NewKeys.size(); n++ )
+      BatchPut( NewKeys[ n ], NewValues[ n ] );
+
+  BegLogLine( SKV_LOCAL_KV_BACKEND_LOG )
+    << "skv_local_kv_rocksdb: sorted BulkInsert: "
+    << " rows: " << Keys.size()
+    << " inserted: " << NewKeys.size()
+    << " ingested: " << Ingested
+    << EndLogLine;
+
+  // the write batch keeps copies of the keys
+  for( size_t n = 0; n < Keys.size(); n++ )
+    ReleaseKey( Keys[ n ] );
+
+  if( Ingested || NewKeys.empty() )
+    InitKVEvent( aReq->mCookie, LoopStatus );
+  else
+    DeferKVEvent( aReq->mCookie, LoopStatus, false );
+  return SKV_SUCCESS;
 }
 
 
+struct skv_local_kv_rocksdb_multiget_key_t
+{
+  rocksdb::Slice mKey;
+  rocksdb::ColumnFamilyHandle *mCF;
+  int mReq;
+};
+
+skv_status_t
+skv_local_kv_rocksdb::MultiKey( skv_pds_id_t aPDSId,
+                                skv_command_type_t aOp,
+                                skv_cmd_RIU_flags_t aFlags,
+                                int aKeyCount,
+                                char *aRequestBuffer,
+                                char *aResultBuffer,
+                                skv_local_kv_cookie_t *aCookie )
+{
+  skv_local_kv_request_queue_t *RequestQueue = mRequestQueueList.GetBestQueue();
+  skv_local_kv_request_t *kvReq = RequestQueue->AcquireRequestEntry();
+  if( !kvReq )
+    return SKV_ERRNO_COMMAND_LIMIT_REACHED;
+
+  kvReq->InitCommon( SKV_LOCAL_KV_REQUEST_TYPE_MULTI_KEY, aCookie );
+  kvReq->mRequest.mMultiKey.mPDSId = aPDSId;
+  kvReq->mRequest.mMultiKey.mOp = aOp;
+  kvReq->mRequest.mMultiKey.mFlags = aFlags;
+  kvReq->mRequest.mMultiKey.mKeyCount = aKeyCount;
+  kvReq->mRequest.mMultiKey.mRequestBuffer = aRequestBuffer;
+  kvReq->mRequest.mMultiKey.mResultBuffer = aResultBuffer;
+
+  RequestQueue->QueueRequest( kvReq );
+  return SKV_ERRNO_LOCAL_KV_EVENT;
+}
+
+/*
+ * retrieves resolve their keys with one MultiGet per SKV_LOCAL_KV_ROCKSDB_MULTIGET_MAX rows
+ * inserts go into the write batch and complete with it
+ */
+skv_status_t skv_local_kv_rocksdb_worker_t::PerformMultiKey( skv_local_kv_request_t *aReq )
+{
+  skv_local_kv_multikey_request_t *MKReq = &aReq->mRequest.mMultiKey;
+  skv_multi_key_result_t *Results = (skv_multi_key_result_t*)MKReq->mResultBuffer;
+  char *Row = MKReq->mRequestBuffer;
+
+  BegLogLine( SKV_LOCAL_KV_BACKEND_LOG )
+    << "skv_local_kv_rocksdb::PerformMultiKey(): "
+    << " PDSId: " << MKReq->mPDSId
+    << " Op: " << skv_command_type_to_string( MKReq->mOp )
+    << " KeyCount: " << MKReq->mKeyCount
+    << EndLogLine;
+
+  if( MKReq->mOp == SKV_COMMAND_INSERT )
+  {
+    bool Overwrite = ( MKReq->mFlags & ( SKV_COMMAND_RIU_UPDATE | SKV_COMMAND_RIU_INSERT_OVERWRITE_VALUE_ON_DUP ) );
+
+    for( int i = 0; i < MKReq->mKeyCount; i++ )
+    {
+      char *KeyPtr = NULL;
+      char *ValuePtr = NULL;
+      int KeySize = -1;
+      int ValueSize = -1;
+      Row += skv_multi_key_get_row( Row, MKReq->mOp, &KeyPtr, KeySize, &ValuePtr, ValueSize );
+
+      rocksdb::Slice key = MakeKey( MKReq->mPDSId, KeyPtr, KeySize );
+
+      skv_status_t status = SKV_SUCCESS;
+      if( ! Overwrite )
+      {
+        skv_local_kv_rocksdb_value_t value;
+        if( InWriteBatch( key ) || mDBAccess->LookupData( key, &value ).ok() )
+          status = SKV_ERRNO_RECORD_ALREADY_EXISTS;
+      }
+      if( status == SKV_SUCCESS )
+        BatchPut( key, rocksdb::Slice( ValuePtr, ValueSize ) );
+
+      ReleaseKey( key );
+
+      Results[ i ].mStatus = status;
+      Results[ i ].mValueSize = ValueSize;
+      Results[ i ].EndianConvert();
+    }
+
+    DeferKVEvent( aReq->mCookie, SKV_SUCCESS, false );
+    return SKV_SUCCESS;
+  }
+
+  char *ValueSpace = MKReq->mResultBuffer + MKReq->mKeyCount * sizeof( skv_multi_key_result_t );
+
+  for( int first = 0; first < MKReq->mKeyCount; first += SKV_LOCAL_KV_ROCKSDB_MULTIGET_MAX )
+  {
+    int Count = std::min( MKReq->mKeyCount - first, SKV_LOCAL_KV_ROCKSDB_MULTIGET_MAX );
+
+    skv_local_kv_rocksdb_multiget_key_t Keys[ SKV_LOCAL_KV_ROCKSDB_MULTIGET_MAX ];
+    char *ValueDest[ SKV_LOCAL_KV_ROCKSDB_MULTIGET_MAX ];
+    int ValueMax[ SKV_LOCAL_KV_ROCKSDB_MULTIGET_MAX ];
+    for( int r = 0; r < Count; r++ )
+    {
+      char *KeyPtr = NULL;
+      char *ValuePtr = NULL;
+      int KeySize = -1;
+      Row += skv_multi_key_get_row( Row, MKReq->mOp, &KeyPtr, KeySize, &ValuePtr, ValueMax[ r ] );
+
+      ValueDest[ r ] = ValueSpace;
+      ValueSpace += ValueMax[ r ];
+
+      Keys[ r ].mKey = MakeKey( MKReq->mPDSId, KeyPtr, KeySize );
+      Keys[ r ].mCF = mDBAccess->GetColumnFamily( Keys[ r ].mKey );
+      Keys[ r ].mReq = first + r;
+    }
+
+    std::sort( Keys, Keys + Count,
+               []( const skv_local_kv_rocksdb_multiget_key_t &a, const skv_local_kv_rocksdb_multiget_key_t &b )
+               {
+                 if( a.mCF->GetID() != b.mCF->GetID() )
+                   return a.mCF->GetID() < b.mCF->GetID();
+                 return a.mKey.compare( b.mKey ) < 0;
+               } );
+
+    rocksdb::ColumnFamilyHandle *CFs[ SKV_LOCAL_KV_ROCKSDB_MULTIGET_MAX ];
+    rocksdb::Slice SortedKeys[ SKV_LOCAL_KV_ROCKSDB_MULTIGET_MAX ];
+    for( int k = 0; k < Count; k++ )
+    {
+      CFs[ k ] = Keys[ k ].mCF;
+      SortedKeys[ k ] = Keys[ k ].mKey;
+    }
+
+    skv_local_kv_rocksdb_multiget_value_t Values[ SKV_LOCAL_KV_ROCKSDB_MULTIGET_MAX ];
+    rocksdb::Status rs[ SKV_LOCAL_KV_ROCKSDB_MULTIGET_MAX ];
+    mDBAccess->MultiGetData( Count, CFs, SortedKeys, Values, rs );
+
+    for( int k = 0; k < Count; k++ )
+    {
+      int i = Keys[ k ].mReq;
+      int r = i - first;
+      skv_status_t status = SKV_ERRNO_ELEM_NOT_FOUND;
+      int StoredSize = 0;
+      if( rs[ k ].ok() )
+      {
+        status = SKV_SUCCESS;
+        StoredSize = Values[ k ].size();
+        memcpy( ValueDest[ r ], Values[ k ].data(), std::min( StoredSize, ValueMax[ r ] ) );
+      }
+      else if( ! rs[ k ].IsNotFound() )
+        status = SKV_ERRNO_UNSPECIFIED_ERROR;
+
+      Results[ i ].mStatus = status;
+      Results[ i ].mValueSize = StoredSize;
+      Results[ i ].EndianConvert();
+
+      ReleaseKey( Keys[ k ].mKey );
+    }
+  }
+
+  return InitKVEvent( aReq->mCookie, SKV_SUCCESS );
+}
+
 skv_status_t
 skv_local_kv_rocksdb::Retrieve( skv_pds_id_t aPDSId,
                                 char* aKeyData,
@@ -974,46 +1397,147 @@ skv_local_kv_rocksdb::Retrieve( skv_pds_id_t aPDSId,
 skv_status_t skv_local_kv_rocksdb_worker_t::PerformRetrieve( skv_local_kv_request_t *aReq )
 {
   skv_status_t status;
-  size_t TotalSize = 0;
-  skv_lmr_triplet_t *StoredValueRep;
 
   BegLogLine(SKV_LOCAL_KV_BACKEND_LOG )
     << "skv_local_kv_rocksdb:: retrieving: " << aReq->mRequest.mRetrieve.mValueSize
     << EndLogLine;
 
-  rocksdb::Slice *key = new rocksdb::Slice( MakeKey( aReq->mRequest.mRetrieve.mPDSId,
-                                                     aReq->mRequest.mRetrieve.mKeyData,
-                                                     aReq->mRequest.mRetrieve.mKeySize ) );
-  skv_local_kv_rocksdb_reqctx_t *reqCtx = NULL;
-
-
-  char *value;
-  size_t reqOffset = aReq->mRequest.mRetrieve.mValueOffset;
-  size_t reqSize = aReq->mRequest.mRetrieve.mValueSize;
-
-  if( ! mDataBuffer->ReqWillFit( (reqSize * 3) >> 1 ) )
+  if( ! mDataBuffer->ReqWillFit( RetrieveSpace( aReq ) ) )
   {
     BegLogLine( SKV_LOCAL_KV_BACKEND_LOG )
-      << "RDMA-Buffer space shortage: req=" << reqSize
+      << "RDMA-Buffer space shortage: req=" << aReq->mRequest.mRetrieve.mValueSize
       << " left=" << mDataBuffer->MaxSizeFit()
       << EndLogLine;
     mStalledCommand = aReq;
     return SKV_ERRNO_NOT_DONE;
   }
 
-  std::string TmpValue;
+  rocksdb::Slice *key = new rocksdb::Slice( MakeKey( aReq->mRequest.mRetrieve.mPDSId,
+                                                     aReq->mRequest.mRetrieve.mKeyData,
+                                                     aReq->mRequest.mRetrieve.mKeySize ) );
+
+  skv_local_kv_rocksdb_value_t PinnedValue;
   rocksdb::Status rs;
-  rs = mDBAccess->GetData( *key, &TmpValue );
+  rs = mDBAccess->GetData( *key, &PinnedValue );
 
-  if( rs.ok() )
+  status = CompleteRetrieve( aReq, *key, rs, PinnedValue );
+
+  ReleaseKey( *key );
+  delete key;
+  return status;
+}
+
+/*
+ * takes the retrieve requests that are queued right behind aReq and resolves
+ * their keys with a single MultiGet (sorted, duplicate keys are looked up once)
+ * aReq gets acked by the caller, the additional requests are acked here
+ */
+skv_status_t skv_local_kv_rocksdb_worker_t::PerformRetrieveBatch( skv_local_kv_request_t *aReq,
+                                                                  skv_local_kv_request_queue_t *aQueue )
+{
+  skv_local_kv_request_t *Batch[ SKV_LOCAL_KV_ROCKSDB_MULTIGET_MAX ];
+  int ReqCount = 0;
+  size_t Space = RetrieveSpace( aReq );
+
+  Batch[ ReqCount++ ] = aReq;
+
+  skv_local_kv_request_t *next;
+  while( ( ReqCount < SKV_LOCAL_KV_ROCKSDB_MULTIGET_MAX ) &&
+         ( ( next = aQueue->PeekRequest() ) != NULL ) &&
+         ( next->mType == SKV_LOCAL_KV_REQUEST_TYPE_RETRIEVE ) )
+  {
+    Space += RetrieveSpace( next );
+    if( ! mDataBuffer->ReqWillFit( Space ) )
+      break;
+    Batch[ ReqCount++ ] = aQueue->GetRequest();
+  }
+
+  // nothing to batch with or not even the first one fits (stalls)
+  if( ReqCount == 1 )
+    return PerformRetrieve( aReq );
+
+  BegLogLine( SKV_LOCAL_KV_BACKEND_LOG )
+    << "skv_local_kv_rocksdb:: batched retrieve of " << ReqCount << " requests"
+    << EndLogLine;
+
+  skv_local_kv_rocksdb_multiget_key_t Keys[ SKV_LOCAL_KV_ROCKSDB_MULTIGET_MAX ];
+  for( int r = 0; r < ReqCount; r++ )
+  {
+    skv_local_kv_retrieve_request_t *RReq = &Batch[ r ]->mRequest.mRetrieve;
+    Keys[ r ].mKey = MakeKey( RReq->mPDSId, RReq->mKeyData, RReq->mKeySize );
+    Keys[ r ].mCF = mDBAccess->GetColumnFamily( Keys[ r ].mKey );
+    Keys[ r ].mReq = r;
+  }
+
+  std::sort( Keys, Keys + ReqCount,
+             []( const skv_local_kv_rocksdb_multiget_key_t &a, const skv_local_kv_rocksdb_multiget_key_t &b )
+             {
+               if( a.mCF->GetID() != b.mCF->GetID() )
+                 return a.mCF->GetID() < b.mCF->GetID();
+               return a.mKey.compare( b.mKey ) < 0;
+             } );
+
+  rocksdb::ColumnFamilyHandle *UniqueCFs[ SKV_LOCAL_KV_ROCKSDB_MULTIGET_MAX ];
+  rocksdb::Slice UniqueKeys[ SKV_LOCAL_KV_ROCKSDB_MULTIGET_MAX ];
+  int ReqToUnique[ SKV_LOCAL_KV_ROCKSDB_MULTIGET_MAX ];
+  int UniqueCount = 0;
+  for( int k = 0; k < ReqCount; k++ )
+  {
+    if( ( UniqueCount == 0 ) ||
+        ( Keys[ k ].mCF != UniqueCFs[ UniqueCount - 1 ] ) ||
+        ( Keys[ k ].mKey.compare( UniqueKeys[ UniqueCount - 1 ] ) != 0 ) )
+    {
+      UniqueCFs[ UniqueCount ] = Keys[ k ].mCF;
+      UniqueKeys[ UniqueCount ] = Keys[ k ].mKey;
+      UniqueCount++;
+    }
+    ReqToUnique[ Keys[ k ].mReq ] = UniqueCount - 1;
+  }
+
+  skv_local_kv_rocksdb_multiget_value_t Values[ SKV_LOCAL_KV_ROCKSDB_MULTIGET_MAX ];
+  rocksdb::Status rs[ SKV_LOCAL_KV_ROCKSDB_MULTIGET_MAX ];
+  mDBAccess->MultiGetData( UniqueCount, UniqueCFs, UniqueKeys, Values, rs );
+
+  skv_status_t status = SKV_SUCCESS;
+  for( int r = 0; r < ReqCount; r++ )
+  {
+    int u = ReqToUnique[ r ];
+    skv_status_t rc = CompleteRetrieve( Batch[ r ], UniqueKeys[ u ], rs[ u ], Values[ u ] );
+    if( r == 0 )
+      status = rc;
+    else
+      aQueue->AckRequest( Batch[ r ] );
+  }
+
+  for( int k = 0; k < ReqCount; k++ )
+    ReleaseKey( Keys[ k ].mKey );
+
+  return status;
+}
+
+// copies the requested part of a value into the RDMA buffer and creates the retrieve event
+skv_status_t skv_local_kv_rocksdb_worker_t::CompleteRetrieve( skv_local_kv_request_t *aReq,
+                                                              const rocksdb::Slice &aKey,
+                                                              const rocksdb::Status &aRS,
+                                                              const rocksdb::Slice &aValue )
+{
+  skv_status_t status;
+  size_t TotalSize = 0;
+  skv_lmr_triplet_t *StoredValueRep = NULL;
+  skv_local_kv_rocksdb_reqctx_t *reqCtx = NULL;
+
+  size_t reqOffset = aReq->mRequest.mRetrieve.mValueOffset;
+  size_t reqSize = aReq->mRequest.mRetrieve.mValueSize;
+
+  if( aRS.ok() )
   {
     BegLogLine( SKV_LOCAL_KV_BACKEND_LOG )
-      << "skv_local_kv_rocksdb: rocksdb.Get() complete. len=" << TmpValue.length()
+      << "skv_local_kv_rocksdb: rocksdb.Get() complete. len=" << aValue.size()
       << EndLogLine;
 
     status = SKV_SUCCESS;
 
-    TotalSize = TmpValue.length();
+    TotalSize = aValue.size();
 
     if( ( reqOffset >= TotalSize ) ||
         ( ( aReq->mRequest.mRetrieve.mFlags & SKV_COMMAND_RIU_RETRIEVE_SPECIFIC_VALUE_LEN ) && ( reqSize + reqOffset > TotalSize )) )
@@ -1038,15 +1562,15 @@ skv_status_t skv_local_kv_rocksdb_worker_t::PerformRetrieve( skv_local_kv_reques
 
       StoredValueRep = new skv_lmr_triplet_t;
       mDataBuffer->AcquireDataArea( reqSize, StoredValueRep );
-      memcpy( (char*)StoredValueRep->GetAddr(), TmpValue.c_str()+reqOffset, reqSize );
+      memcpy( (char*)StoredValueRep->GetAddr(), aValue.data()+reqOffset, reqSize );
 
 #if SKV_LOCAL_KV_BACKEND_LOG
-      HexDump RDBFxString( (void*)TmpValue.c_str(), TmpValue.length() );
-      HexDump FxString( (void*)value->c_str(), reqSize );
-      HexDump KeyString( (void*)key->data(), key->size());
+      HexDump RDBFxString( (void*)aValue.data(), aValue.size() );
+      HexDump FxString( (void*)StoredValueRep->GetAddr(), reqSize );
+      HexDump KeyString( (void*)aKey.data(), aKey.size());
 
       BegLogLine( 1 )
-        << "rdb size: " << TmpValue.length()
+        << "rdb size: " << aValue.size()
         << " key:" << KeyString
         << " content: " << RDBFxString
         << EndLogLine;
@@ -1061,13 +1585,10 @@ skv_status_t skv_local_kv_rocksdb_worker_t::PerformRetrieve( skv_local_kv_reques
   {
     status = SKV_ERRNO_ELEM_NOT_FOUND;
     BegLogLine( SKV_LOCAL_KV_BACKEND_LOG )
-      << "skv_local_kv_rocksdb: requested key not found: " << key->ToString().c_str()
+      << "skv_local_kv_rocksdb: requested key not found: " << aKey.ToString().c_str()
       << EndLogLine;
   }
 
-  ReleaseKey( *key );
-  delete key;
-
   int RoomForValue = ((skv_header_as_cmd_buffer_t*)aReq)->GetRoomForData( sizeof( skv_cmd_retrieve_value_rdma_write_ack_t) );
 
   if(( status == SKV_SUCCESS ) && ( RoomForValue < reqSize ))
@@ -1352,8 +1873,8 @@ skv_status_t skv_local_kv_rocksdb_worker_t::PerformRemove( skv_local_kv_request_
   // since SKV does, we need to check if the key is available and set the status accordingly
 
 
-  std::string *value = new std::string;
-  bool found_entry = ( mDBAccess->LookupData( *key, value ).ok() );
+  skv_local_kv_rocksdb_value_t value;
+  bool found_entry = ( mDBAccess->LookupData( *key, &value ).ok() );
 
   BegLogLine( SKV_LOCAL_KV_BACKEND_LOG )
     << "skv_local_kv_rocksdb: delete item precheck=" << found_entry
@@ -1374,7 +1895,6 @@ skv_status_t skv_local_kv_rocksdb_worker_t::PerformRemove( skv_local_kv_request_
 
   ReleaseKey( *key );
   delete key;
-  delete value;
 
   status = InitKVEvent( aReq->mCookie, status );
   return status;
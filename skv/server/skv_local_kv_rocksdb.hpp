@@ -30,8 +30,14 @@
 #define SKV_LOCAL_KV_MAX_VALUE_SIZE ( 1 * 1048576ul )
 #define SKV_LOCAL_KV_WORKER_POOL_SIZE ( 24 )
 
+// max number of queued retrieve requests that a worker resolves with one MultiGet
+#define SKV_LOCAL_KV_ROCKSDB_MULTIGET_MAX ( 32 )
+
 #include <thread>
+#include <vector>
+#include <unordered_set>
 #include <rocksdb/db.h>
+#include <rocksdb/write_batch.h>
 
 #include <skv/server/skv_rdma_buffer_allocator.hpp>
 #include <skv/server/skv_local_kv_rocksdb_access.hpp>
@@ -61,6 +67,15 @@ struct skv_local_kv_rocksdb_worker_settings_t {
   uint64_t mRDMABufferSize;
   uint64_t mMaxRequests;
   uint64_t mMaxValueSize;
+  uint64_t mWriteBatchSize;    // bytes
+  uint64_t mWriteBatchDelay;   // usec
+};
+
+// completion of a request whose data sits in the worker's write batch
+struct skv_local_kv_rocksdb_pending_t {
+  skv_local_kv_cookie_t mCookie;
+  skv_status_t mStatus;
+  bool mRDMAEvent;    // insert completes with an (empty) RDMA event, bulk insert with a plain one
 };
 
 class skv_local_kv_rocksdb_worker_t {
@@ -73,11 +88,21 @@ class skv_local_kv_rocksdb_worker_t {
   skv_local_kv_event_queue_t *mEventQueue;
   skv_local_kv_request_t *mStalledCommand;
 
+  // group commit: inserts are collected here and acked after the batch is written
+  rocksdb::WriteBatch mWriteBatch;
+  std::unordered_set< std::string > mWriteBatchKeys;
+  std::vector< skv_local_kv_rocksdb_pending_t > mPendingEvents;
+  uint64_t mWriteBatchStart;
+  std::atomic<uint64_t> mBatchFenceSeen;   // last write batch fence this worker passed
+
   skv_local_kv_rocksdb_worker_settings_t mSettings;
 
 public:
   skv_local_kv_rocksdb_worker_t( const uint32_t aQueueLengths )
-    : mStalledCommand( NULL ),
+    : mRequestProcessor( NULL ),
+      mStalledCommand( NULL ),
+      mWriteBatchStart( 0 ),
+      mBatchFenceSeen( 0 ),
       mRequestQueue( aQueueLengths ),
   // worst case: each worker gets a request that got initially processed by one worker
   // note that constructor limits the length to max lenght
@@ -89,19 +114,76 @@ public:
   skv_status_t Init( const skv_local_kv_rocksdb_worker_settings_t &aSettings,
                      skv_local_kv_rocksdb *aBackEnd, bool aThreaded = false );
 
+  // wait for the processing thread to commit its last batch and exit
+  // (the backend has to stop processing first)
+  void Join()
+  {
+    if( mRequestProcessor )
+    {
+      mRequestProcessor->join();
+      delete mRequestProcessor;
+      mRequestProcessor = NULL;
+    }
+  }
+
   skv_status_t PerformOpen( skv_local_kv_request_t *aReq );
   skv_status_t PerformStat( skv_local_kv_request_t *aReq );
   skv_status_t PerformClose( skv_local_kv_request_t *aReq );
   skv_status_t PerformInsert( skv_local_kv_request_t *aReq );
   skv_status_t PerformLookup( skv_local_kv_request_t *aReq );
   skv_status_t PerformRetrieve( skv_local_kv_request_t *aReq );
+  skv_status_t PerformRetrieveBatch( skv_local_kv_request_t *aReq, skv_local_kv_request_queue_t *aQueue );
   skv_status_t PerformBulkInsert( skv_local_kv_request_t *aReq );
+  skv_status_t PerformBulkInsertSorted( skv_local_kv_request_t *aReq );
+  skv_status_t PerformMultiKey( skv_local_kv_request_t *aReq );
   skv_status_t PerformRemove( skv_local_kv_request_t *aReq );
   skv_status_t PerformRetrieveNKeys( skv_local_kv_request_t *aReq );
   skv_status_t PerformAsyncInsertCleanup( skv_local_kv_request_t *aReq );
   skv_status_t PerformAsyncRetrieveCleanup( skv_local_kv_request_t *aReq );
   skv_status_t PerformAsyncRetrieveNKeysCleanup( skv_local_kv_request_t *aReq );
 
+  void BatchPut( const rocksdb::Slice &aKey, const rocksdb::Slice &aValue )
+  {
+    mWriteBatch.Put( mDBAccess->GetColumnFamily( aKey ), aKey, aValue );
+    mWriteBatchKeys.insert( aKey.ToString() );
+  }
+  bool InWriteBatch( const rocksdb::Slice &aKey ) const
+  {
+    return ( mWriteBatchKeys.find( aKey.ToString() ) != mWriteBatchKeys.end() );
+  }
+  void DeferKVEvent( skv_local_kv_cookie_t *aCookie, skv_status_t aRC, bool aRDMAEvent )
+  {
+    if( mPendingEvents.empty() )
+      mWriteBatchStart = PkTimeGetNanos();
+
+    skv_local_kv_rocksdb_pending_t Pending;
+    Pending.mCookie = *aCookie;
+    Pending.mStatus = aRC;
+    Pending.mRDMAEvent = aRDMAEvent;
+    mPendingEvents.push_back( Pending );
+  }
+  bool WriteBatchDue() const
+  {
+    if( mPendingEvents.empty() )
+      return false;
+    return ( mWriteBatch.GetDataSize() >= mSettings.mWriteBatchSize ) ||
+           ( PkTimeGetNanos() - mWriteBatchStart >= mSettings.mWriteBatchDelay * 1000 );
+  }
+  bool WriteBatchEmpty() const
+  {
+    return mPendingEvents.empty();
+  }
+  skv_status_t FlushWriteBatch();
+
+  uint64_t GetBatchFenceSeen() const
+  {
+    return mBatchFenceSeen.load( std::memory_order_acquire );
+  }
+  void SetBatchFenceSeen( uint64_t aFence )
+  {
+    mBatchFenceSeen.store( aFence, std::memory_order_release );
+  }
+
   skv_local_kv_rocksdb* GetMaster() const
   {
     return mMaster;
@@ -281,6 +363,15 @@ public:
   }
 
 private:
+  skv_status_t CompleteRetrieve( skv_local_kv_request_t *aReq,
+                                 const rocksdb::Slice &aKey,
+                                 const rocksdb::Status &aRS,
+                                 const rocksdb::Slice &aValue );
+  size_t RetrieveSpace( skv_local_kv_request_t *aReq ) const
+  {
+    return ( aReq->mRequest.mRetrieve.mValueSize * 3 ) >> 1;
+  }
+
   skv_pds_id_t PDSNameToID( std::string aPDSName );
   std::string PDSIdToString( skv_pds_id_t aPDSId );
 
@@ -295,6 +386,7 @@ class skv_local_kv_rocksdb {
   skv_distribution_t mDistributionManager;
 
   volatile bool mKeepProcessing;
+  std::atomic<uint64_t> mBatchFence;   // workers flush their write batch when this moves
   skv_local_kv_rocksdb_worker_t *mMasterProcessing;
   skv_local_kv_rocksdb_worker_t *mWorkerPool[ SKV_LOCAL_KV_WORKER_POOL_SIZE ];
 
@@ -304,6 +396,11 @@ public:
   skv_local_kv_rocksdb() : mRequestQueueList( SKV_LOCAL_KV_WORKER_POOL_SIZE )
   {
     mMyRank = -1;
+    mKeepProcessing = false;
+    mBatchFence = 0;
+    mMasterProcessing = NULL;
+    for( int w=0; w < SKV_LOCAL_KV_WORKER_POOL_SIZE; w++ )
+      mWorkerPool[ w ] = NULL;
   }
   ~skv_local_kv_rocksdb();
   /****************************************************************************
@@ -326,6 +423,10 @@ public:
   {
     return mEventQueue.AckEvent( aEvent );
   }
+  void SetDoorbell( skv_server_doorbell_t *aDoorbell )
+  {
+    mEventQueue.SetDoorbell( aDoorbell );
+  }
 
   skv_status_t CancelContext( skv_local_kv_req_ctx_t *aReqCtx );
 
@@ -366,10 +467,24 @@ public:
                                   skv_lmr_triplet_t *aValueRDMADest,
                                   skv_local_kv_cookie_t *aCookie );
 
+  skv_status_t InsertCancel( skv_cmd_RIU_req_t *aReq,
+                             skv_local_kv_req_ctx_t aReqCtx,
+                             skv_lmr_triplet_t *aValueRDMADest,
+                             skv_local_kv_cookie_t *aCookie );
+
   skv_status_t BulkInsert( skv_pds_id_t aPDSId,
                              skv_lmr_triplet_t *aLocalBuffer,
+                             skv_bulk_inserter_flags_t aFlags,
                              skv_local_kv_cookie_t *aCookie );
 
+  skv_status_t MultiKey( skv_pds_id_t aPDSId,
+                         skv_command_type_t aOp,
+                         skv_cmd_RIU_flags_t aFlags,
+                         int aKeyCount,
+                         char *aRequestBuffer,
+                         char *aResultBuffer,
+                         skv_local_kv_cookie_t *aCookie );
+
   skv_status_t Retrieve( skv_pds_id_t aPDSId,
                          char* aKeyData,
                          int aKeySize,
@@ -421,6 +536,8 @@ public:
   /******************************/
   /* NON-BACK-END API functions */
   bool KeepProcessing() { return mKeepProcessing; }
+  uint64_t GetBatchFence() const { return mBatchFence.load( std::memory_order_acquire ); }
+  void FenceWriteBatches( skv_local_kv_rocksdb_worker_t *aCaller );
   skv_local_kv_event_queue_t* GetEventQueue() { return &mEventQueue; }
   it_pz_handle_t GetPZ() { return mPZ; }
   skv_local_kv_rocksdb_access_t* GetDBAccess() { return &mDBAccess; }
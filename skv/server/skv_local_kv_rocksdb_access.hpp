@@ -20,16 +20,63 @@
 
 typedef basic_string< char, char_traits<char>, skv_rdma_buffer_allocator_t<char>> skv_rdma_string;
 
+/* Get() into a PinnableSlice leaves the value in the block cache/memtable
+ * instead of copying it into a std::string, so a retrieve only copies
+ * the value once: into the RDMA buffer
+ */
+#if ( ROCKSDB_MAJOR > 5 ) || ( ( ROCKSDB_MAJOR == 5 ) && ( ROCKSDB_MINOR >= 4 ) )
+#define SKV_LOCAL_KV_ROCKSDB_PINNED_GET
+typedef rocksdb::PinnableSlice skv_local_kv_rocksdb_value_t;
+#else
+typedef std::string skv_local_kv_rocksdb_value_t;
+#endif
+
+/* MultiGet() over several column families into PinnableSlices;
+ * older versions only have the vector interface that copies into std::strings
+ */
+#if ( ROCKSDB_MAJOR > 6 ) || ( ( ROCKSDB_MAJOR == 6 ) && ( ROCKSDB_MINOR >= 4 ) )
+#define SKV_LOCAL_KV_ROCKSDB_BATCHED_MULTIGET
+typedef rocksdb::PinnableSlice skv_local_kv_rocksdb_multiget_value_t;
+#else
+typedef std::string skv_local_kv_rocksdb_multiget_value_t;
+#endif
+
+/* sorted bulk inserts of at least INGEST_MIN_SIZE bytes are written into an
+ * SST file that is ingested into the PDS column family; this skips WAL and memtable
+ */
+#if ( ROCKSDB_MAJOR >= 5 )
+#define SKV_LOCAL_KV_ROCKSDB_SST_INGEST
+#endif
+#define SKV_LOCAL_KV_ROCKSDB_INGEST_MIN_SIZE ( 256 * 1024 )
+
 #define SKV_LOCAL_KV_ROCKSDB_STATISTICS
 
 #include <rocksdb/table.h>
 #include <rocksdb/filter_policy.h>
 #include <rocksdb/cache.h>
+#include <rocksdb/write_batch.h>
+#include <rocksdb/convenience.h>
+
+#ifdef SKV_LOCAL_KV_ROCKSDB_SST_INGEST
+#include <rocksdb/sst_file_writer.h>
+#endif
+
+#include <map>
+#include <mutex>
+#include <atomic>
+#include <cstdio>
+#include <skv/common/skv_config.hpp>
 
 #ifdef SKV_LOCAL_KV_ROCKSDB_STATISTICS
 #include <rocksdb/statistics.h>
 #endif
 
+/* Every PDS lives in its own column family of the data DB ("pds.<owner>.<id>").
+ * The column family is found by the PDS id prefix of the data keys.
+ * PDSs created before column families were used stay in the default column family.
+ */
+typedef std::map< skv_pds_id_t, rocksdb::ColumnFamilyHandle* > skv_local_kv_rocksdb_cf_map_t;
+
 class skv_local_kv_rocksdb_access_t {
 
   rocksdb::DB *mPDSDBHndl;   // handle for server PDS to maintain existing user PDSs
@@ -38,14 +85,77 @@ class skv_local_kv_rocksdb_access_t {
   rocksdb::ReadOptions mIteratorOpts = rocksdb::ReadOptions();
   rocksdb::WriteOptions mPDSwropts = rocksdb::WriteOptions();
   rocksdb::WriteOptions mDeleteOpts = rocksdb::WriteOptions();
+  rocksdb::WriteOptions mBatchOpts = rocksdb::WriteOptions();
+
+  rocksdb::ColumnFamilyOptions mDataCFOpts;      // base options of the PDS column families
+  // read-mostly: key operations look up the current map without locking, PDS creation and
+  // removal publish a modified copy; replaced maps might still be in use and are freed at Exit()
+  std::atomic< const skv_local_kv_rocksdb_cf_map_t* > mColumnFamilies;
+  std::vector< const skv_local_kv_rocksdb_cf_map_t* > mRetiredColumnFamilies;
+  // all handles incl. dropped ones; workers might still use a dropped handle, so they're deleted at Exit()
+  std::vector< rocksdb::ColumnFamilyHandle* > mColumnFamilyHandles;
+  skv_mutex_t mColumnFamilyLock;
+  std::atomic<uint64_t> mIngestCount;
+  // temporary SST files of the ingest path; next to the data table (hard link on ingest), not inside it
+  std::string mIngestDir;
+
+  std::string ColumnFamilyName( const skv_pds_id_t &aPDSId )
+  {
+    return std::string( "pds." ) + std::to_string( aPDSId.mOwnerNodeId ) + "." + std::to_string( aPDSId.mIdOnOwner );
+  }
+  bool ColumnFamilyNameToPDSId( const std::string &aName, skv_pds_id_t *aPDSId )
+  {
+    return ( sscanf( aName.c_str(), "pds.%u.%u", &aPDSId->mOwnerNodeId, &aPDSId->mIdOnOwner ) == 2 );
+  }
+
+  // base options plus the SKV_SERVER_PDS_OPTIONS of the matching PDS name
+  rocksdb::ColumnFamilyOptions PDSColumnFamilyOptions( const char *aPDSName )
+  {
+    rocksdb::ColumnFamilyOptions cfopts = mDataCFOpts;
+    std::string name( aPDSName, strnlen( aPDSName, SKV_MAX_PDS_NAME_SIZE ) );
+    std::string optstr = skv_configuration_t::GetSKVConfiguration()->GetPDSOptions( name.c_str() );
+    if( optstr.empty() )
+      return cfopts;
+
+    rocksdb::Status rs = rocksdb::GetColumnFamilyOptionsFromString( mDataCFOpts, optstr, &cfopts );
+    if( ! rs.ok() )
+    {
+      BegLogLine( 1 )
+        << "skv_local_kv_rocksdb_access_t: invalid PDS options for " << name.c_str()
+        << " options: " << optstr.c_str()
+        << " error: " << rs.ToString().c_str()
+        << " using defaults."
+        << EndLogLine;
+      cfopts = mDataCFOpts;
+    }
+    return cfopts;
+  }
+
+  // mColumnFamilyLock has to be held
+  void PublishColumnFamilies( const skv_local_kv_rocksdb_cf_map_t *aColumnFamilies )
+  {
+    mRetiredColumnFamilies.push_back( mColumnFamilies.exchange( aColumnFamilies, std::memory_order_acq_rel ) );
+  }
+
+  void AddColumnFamily( const skv_pds_id_t &aPDSId, rocksdb::ColumnFamilyHandle *aCF )
+  {
+    std::lock_guard<skv_mutex_t> lock( mColumnFamilyLock );
+    mColumnFamilyHandles.push_back( aCF );
+    skv_local_kv_rocksdb_cf_map_t *cfs = new skv_local_kv_rocksdb_cf_map_t( *mColumnFamilies.load( std::memory_order_acquire ) );
+    (*cfs)[ aPDSId ] = aCF;
+    PublishColumnFamilies( cfs );
+  }
 
 public:
-  skv_local_kv_rocksdb_access_t() : mPDSDBHndl(), mDataDBHndl()
+  skv_local_kv_rocksdb_access_t() : mPDSDBHndl(), mDataDBHndl(), mColumnFamilies( new skv_local_kv_rocksdb_cf_map_t ), mIngestCount( 0 )
   {
     mDataDBHndl = NULL;
     mPDSDBHndl = NULL;
   }
-  ~skv_local_kv_rocksdb_access_t() {}
+  ~skv_local_kv_rocksdb_access_t()
+  {
+    delete mColumnFamilies.load();
+  }
 
   rocksdb::DB* GetPDSDBHndl()
   {
@@ -56,7 +166,7 @@ public:
     return mDataDBHndl;
   }
 
-  skv_status_t Init( const std::string &aPDSBaseName, int aRank )
+  skv_status_t Init( const std::string &aPDSBaseName, int aRank, bool aSyncWrites = false )
   {
     skv_status_t status = SKV_SUCCESS;
 
@@ -100,13 +210,34 @@ public:
     dbopts.stats_dump_period_sec = 300;
 #endif
 
-    // open the node's data table
+    // open the node's data table with the column families of the existing PDSs
     PDSName = aPDSBaseName;
     PDSName.append( ".PDSdata.");
     PDSName.append( std::to_string( aRank ) );
 
+    mDataCFOpts = rocksdb::ColumnFamilyOptions( dbopts );
+
+    std::vector< std::string > CFNames;
+    if( ! rocksdb::DB::ListColumnFamilies( dbopts, PDSName, &CFNames ).ok() )
+      CFNames.push_back( rocksdb::kDefaultColumnFamilyName );   // new data table
+
+    std::vector< rocksdb::ColumnFamilyDescriptor > CFDescs;
+    std::vector< skv_pds_id_t > CFPDSIds( CFNames.size() );
+    for( size_t n = 0; n < CFNames.size(); n++ )
+    {
+      rocksdb::ColumnFamilyOptions cfopts = mDataCFOpts;
+      std::string attrStr;
+      if( ColumnFamilyNameToPDSId( CFNames[ n ], &CFPDSIds[ n ] ) && ( mPDSDBHndl != NULL ) &&
+          GetPDS( std::string( (const char*)&CFPDSIds[ n ], sizeof( skv_pds_id_t ) ), &attrStr ).ok() )
+        cfopts = PDSColumnFamilyOptions( ((skv_pds_attr_t*)attrStr.data())->mPDSName );
+      CFDescs.push_back( rocksdb::ColumnFamilyDescriptor( CFNames[ n ], cfopts ) );
+    }
+
+    std::vector< rocksdb::ColumnFamilyHandle* > CFHandles;
     if ( ! rocksdb::DB::Open(dbopts,
                              PDSName,
+                             CFDescs,
+                             &CFHandles,
                              &mDataDBHndl).ok() )
     {
       BegLogLine( SKV_LOCAL_KV_BACKEND_LOG )
@@ -114,8 +245,35 @@ public:
         << EndLogLine;
       status = SKV_ERRNO_PDS_DOES_NOT_EXIST;
     }
+    else
+    {
+      for( size_t n = 0; n < CFHandles.size(); n++ )
+      {
+        if( CFNames[ n ] == rocksdb::kDefaultColumnFamilyName )
+          mColumnFamilyHandles.push_back( CFHandles[ n ] );
+        else
+          AddColumnFamily( CFPDSIds[ n ], CFHandles[ n ] );
+      }
+
+#ifdef SKV_LOCAL_KV_ROCKSDB_SST_INGEST
+      // files left behind by an earlier run were never ingested
+      mIngestDir = PDSName + ".ingest";
+      rocksdb::Env *env = mDataDBHndl->GetEnv();
+      std::vector< std::string > Stale;
+      env->CreateDirIfMissing( mIngestDir );
+      if( env->GetChildren( mIngestDir, &Stale ).ok() )
+        for( size_t n = 0; n < Stale.size(); n++ )
+          if( Stale[ n ].compare( 0, 11, "skv_ingest." ) == 0 )
+            std::remove( ( mIngestDir + "/" + Stale[ n ] ).c_str() );
+#endif
+    }
 
+#if ( ROCKSDB_MAJOR >= 3 )
+    // a prefix_extractor in the PDS options must not limit the iterators to a single prefix
+    mIteratorOpts.total_order_seek = true;
+#endif
     mDeleteOpts.sync = false;
+    mBatchOpts.sync = aSyncWrites;
 
     return status;
   }
@@ -124,11 +282,34 @@ public:
   {
     if( mPDSDBHndl )
       delete mPDSDBHndl;
+    for( size_t n = 0; n < mColumnFamilyHandles.size(); n++ )
+      delete mColumnFamilyHandles[ n ];
+    mColumnFamilyHandles.clear();
+    PublishColumnFamilies( new skv_local_kv_rocksdb_cf_map_t );
+    for( size_t n = 0; n < mRetiredColumnFamilies.size(); n++ )
+      delete mRetiredColumnFamilies[ n ];
+    mRetiredColumnFamilies.clear();
     if( mDataDBHndl )
       delete mDataDBHndl;
     return SKV_SUCCESS;
   }
 
+  // column family of a data key (or of a bare PDS id)
+  rocksdb::ColumnFamilyHandle* GetColumnFamily( const rocksdb::Slice &aKey )
+  {
+    if( aKey.size() >= sizeof( skv_pds_id_t ) )
+    {
+      skv_pds_id_t pdsid;
+      memcpy( &pdsid, aKey.data(), sizeof( skv_pds_id_t ) );
+
+      const skv_local_kv_rocksdb_cf_map_t *cfs = mColumnFamilies.load( std::memory_order_acquire );
+      skv_local_kv_rocksdb_cf_map_t::const_iterator cf = cfs->find( pdsid );
+      if( cf != cfs->end() )
+        return cf->second;
+    }
+    return mDataDBHndl->DefaultColumnFamily();
+  }
+
 
   rocksdb::Status GetPDS( const rocksdb::Slice &aKey, std::string *aValue )
   {
@@ -159,40 +340,125 @@ public:
   }
   rocksdb::Status ClosePDS( const rocksdb::Slice &aPDSId )
   {
-    // we currently ignore the pdsid because we don't use separate file per PDS. This might change later!!
-
     rocksdb::FlushOptions flOpts = rocksdb::FlushOptions();
     rocksdb::Status rs = mPDSDBHndl->Flush( flOpts );
     if( rs.ok() )
-      rs = mDataDBHndl->Flush( flOpts );
+      rs = mDataDBHndl->Flush( flOpts, GetColumnFamily( aPDSId ) );
+    return rs;
+  }
+  // new column family for the data of a new PDS
+  rocksdb::Status CreatePDSData( const skv_pds_id_t &aPDSId, const char *aPDSName )
+  {
+    rocksdb::ColumnFamilyHandle *cf = NULL;
+    rocksdb::Status rs = mDataDBHndl->CreateColumnFamily( PDSColumnFamilyOptions( aPDSName ),
+                                                          ColumnFamilyName( aPDSId ),
+                                                          &cf );
+    if( rs.ok() )
+      AddColumnFamily( aPDSId, cf );
     return rs;
   }
+  // removes all data of a PDS by dropping its column family
+  // (pending write batches with records of the PDS have to be written before)
+  rocksdb::Status DropPDSData( const skv_pds_id_t &aPDSId )
+  {
+    rocksdb::ColumnFamilyHandle *cf = NULL;
+    {
+      std::lock_guard<skv_mutex_t> lock( mColumnFamilyLock );
+      const skv_local_kv_rocksdb_cf_map_t *cfs = mColumnFamilies.load( std::memory_order_acquire );
+      skv_local_kv_rocksdb_cf_map_t::const_iterator it = cfs->find( aPDSId );
+      if( it == cfs->end() )
+        return rocksdb::Status::OK();   // nothing to drop for PDSs in the default column family
+      cf = it->second;
+      skv_local_kv_rocksdb_cf_map_t *newcfs = new skv_local_kv_rocksdb_cf_map_t( *cfs );
+      newcfs->erase( aPDSId );
+      PublishColumnFamilies( newcfs );
+    }
+    return mDataDBHndl->DropColumnFamily( cf );
+  }
   bool DataKeyMayExist( const rocksdb::Slice &aKey )
   {
     bool getval = false;
     std::string value;
-    return mDataDBHndl->KeyMayExist( mPDSrdopts, aKey, &value, &getval );
+    return mDataDBHndl->KeyMayExist( mPDSrdopts, GetColumnFamily( aKey ), aKey, &value, &getval );
   }
   /* since rocksdb doesn't have the option to retrieve the value size,
-   * we'll have to retrieve into a tmp string and then copy to rdma registered buffer
+   * we'll have to retrieve (pinned if possible) and then copy to rdma registered buffer
    */
-  rocksdb::Status GetData( const rocksdb::Slice &aKey, std::string *aTmpValue )
+  rocksdb::Status GetData( const rocksdb::Slice &aKey, skv_local_kv_rocksdb_value_t *aValue )
   {
-    rocksdb::Status rs = mDataDBHndl->Get( mPDSrdopts, aKey, aTmpValue );
+    rocksdb::Status rs = mDataDBHndl->Get( mPDSrdopts, GetColumnFamily( aKey ), aKey, aValue );
     return rs;
   }
-  rocksdb::Status LookupData( const rocksdb::Slice &aKey, std::string *aValue )
+  // aKeys have to be sorted by column family id and key
+  void MultiGetData( const size_t aCount,
+                     rocksdb::ColumnFamilyHandle **aCFs,
+                     const rocksdb::Slice *aKeys,
+                     skv_local_kv_rocksdb_multiget_value_t *aValues,
+                     rocksdb::Status *aStatus )
   {
-    rocksdb::Status rs = mDataDBHndl->Get( mPDSrdopts, aKey, aValue );
-    return rs;
+#ifdef SKV_LOCAL_KV_ROCKSDB_BATCHED_MULTIGET
+    mDataDBHndl->MultiGet( mPDSrdopts, aCount, aCFs, aKeys, aValues, aStatus, true );
+#else
+    std::vector< rocksdb::ColumnFamilyHandle* > CFs( aCFs, aCFs + aCount );
+    std::vector< rocksdb::Slice > Keys( aKeys, aKeys + aCount );
+    std::vector< std::string > Values;
+    std::vector< rocksdb::Status > rs = mDataDBHndl->MultiGet( mPDSrdopts, CFs, Keys, &Values );
+    for( size_t n = 0; n < aCount; n++ )
+    {
+      aStatus[ n ] = rs[ n ];
+      aValues[ n ].swap( Values[ n ] );
+    }
+#endif
+  }
+  rocksdb::Status LookupData( const rocksdb::Slice &aKey, skv_local_kv_rocksdb_value_t *aValue )
+  {
+    return GetData( aKey, aValue );
   }
   rocksdb::Status PutData( const rocksdb::Slice &aKey, const rocksdb::Slice &aValue )
   {
-    return mDataDBHndl->Put( mPDSwropts, aKey, aValue );
+    return mDataDBHndl->Put( mPDSwropts, GetColumnFamily( aKey ), aKey, aValue );
+  }
+  // group commit of the records collected by a worker, one WAL append for the whole batch
+  rocksdb::Status WriteData( rocksdb::WriteBatch *aBatch )
+  {
+    return mDataDBHndl->Write( mBatchOpts, aBatch );
   }
+#ifdef SKV_LOCAL_KV_ROCKSDB_SST_INGEST
+  // aKeys have to be strictly ascending and of the same PDS
+  rocksdb::Status IngestSortedData( const std::vector< rocksdb::Slice > &aKeys,
+                                    const std::vector< rocksdb::Slice > &aValues )
+  {
+    rocksdb::ColumnFamilyHandle *cf = GetColumnFamily( aKeys[ 0 ] );
+    std::string FileName = mIngestDir + "/skv_ingest." + std::to_string( mIngestCount++ ) + ".sst";
+
+    rocksdb::Status rs;
+    {
+      rocksdb::SstFileWriter Writer( rocksdb::EnvOptions(), mDataDBHndl->GetOptions( cf ), cf );
+      rs = Writer.Open( FileName );
+      for( size_t n = 0; rs.ok() && ( n < aKeys.size() ); n++ )
+#if ( ROCKSDB_MAJOR > 5 ) || ( ( ROCKSDB_MAJOR == 5 ) && ( ROCKSDB_MINOR >= 14 ) )
+        rs = Writer.Put( aKeys[ n ], aValues[ n ] );
+#else
+        rs = Writer.Add( aKeys[ n ], aValues[ n ] );
+#endif
+      if( rs.ok() )
+        rs = Writer.Finish();
+    }
+    if( rs.ok() )
+    {
+      rocksdb::IngestExternalFileOptions IngestOpts;
+      IngestOpts.move_files = true;
+      rs = mDataDBHndl->IngestExternalFile( cf, { FileName }, IngestOpts );
+    }
+    // every path ends here: a moved file is linked into the DB, so this only drops our name of it,
+    // otherwise it removes the partial or rejected file
+    std::remove( FileName.c_str() );
+    return rs;
+  }
+#endif
   rocksdb::Status DeleteData( const rocksdb::Slice &aKey )
   {
-    return mDataDBHndl->Delete( mDeleteOpts, aKey );
+    return mDataDBHndl->Delete( mDeleteOpts, GetColumnFamily( aKey ), aKey );
   }
   rocksdb::Iterator* NewIterator( const rocksdb::Slice *aStartKey, const rocksdb::Slice *aPDSId )
   {
@@ -201,7 +467,7 @@ public:
 #endif
     mIteratorOpts.tailing = true;
 
-    rocksdb::Iterator *iter = mDataDBHndl->NewIterator( mIteratorOpts );
+    rocksdb::Iterator *iter = mDataDBHndl->NewIterator( mIteratorOpts, GetColumnFamily( *aPDSId ) );
     if( aStartKey != NULL )
     {
       iter->Seek( *aStartKey );
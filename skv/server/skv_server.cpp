@@ -17,6 +17,7 @@
 #include <netdb.h>
 #include <netinet/in.h>
 #include <ifaddrs.h>
+#include <poll.h>
 #include <mpi.h>
 #include <skv/common/skv_types.hpp>
 #include <skv/utils/skv_trace_clients.hpp>
@@ -50,6 +51,7 @@
 #include <skv/server/commands/skv_server_retrieve_dist_command_sm.hpp>
 #include <skv/server/commands/skv_server_insert_command_sm.hpp>
 #include <skv/server/commands/skv_server_bulk_insert_command_sm.hpp>
+#include <skv/server/commands/skv_server_multi_key_command_sm.hpp>
 #include <skv/server/commands/skv_server_retrieve_command_sm.hpp>
 #include <skv/server/commands/skv_server_retrieve_n_keys_command_sm.hpp>
 #include <skv/server/commands/skv_server_remove_command_sm.hpp>
@@ -58,20 +60,18 @@
 
 
 #ifdef SKV_SERVER_LOOP_STATISTICS
-typedef struct
-{
-  uint64_t zeroPollCount;
-  uint64_t overallRunLoops;
-  uint64_t reqDeferCount;
-  uint64_t overallCommands;
-  uint64_t maxCommandBatch;
-} server_stats_t;
-
-server_stats_t ServerStatistics = {0,0,0,0,0};
+#define SERVER_STATS_SRC_ECHO( x, src, name ) " " name ": " \
+  << x.srcEvents[ src ] << "/" << x.srcPolls[ src ] << "/" << x.srcEmptyPolls[ src ]
 
 #define SERVER_STATS_ECHO( x ) " empty loops: " << x.zeroPollCount << " of " << x.overallRunLoops \
   << " deferred: " << x.reqDeferCount << " of " << x.overallCommands    \
-  << " maxBatch: " << x.maxCommandBatch
+  << " maxBatch: " << x.maxCommandBatch                                 \
+  << " events/polls/empty:"                                             \
+  << SERVER_STATS_SRC_ECHO( x, SKV_SERVER_INTERNAL_EVENT_SRC_INDEX, "int" ) \
+  << SERVER_STATS_SRC_ECHO( x, SKV_SERVER_NETWORK_EVENT_SRC_INDEX, "net" ) \
+  << SERVER_STATS_SRC_ECHO( x, SKV_SERVER_COMMAND_EVENT_SRC_INDEX, "cmd" ) \
+  << SERVER_STATS_SRC_ECHO( x, SKV_SERVER_LOCAL_KV_EVENT_SRC_INDEX, "lkv" ) \
+  << " sleeps: " << x.idleSleeps << " woken: " << x.idleWakeups
 
 
 #define SERVER_STATS_RESET( x ) \
@@ -79,15 +79,28 @@ server_stats_t ServerStatistics = {0,0,0,0,0};
               x.zeroPollCount   = 0; \
               x.reqDeferCount   = 0; \
               x.overallCommands = 0; \
-              x.maxCommandBatch = 0;
+              x.maxCommandBatch = 0; \
+              memset( x.srcPolls, 0, sizeof( x.srcPolls ) ); \
+              memset( x.srcEmptyPolls, 0, sizeof( x.srcEmptyPolls ) ); \
+              memset( x.srcEvents, 0, sizeof( x.srcEvents ) ); \
+              x.idleSleeps      = 0; \
+              x.idleWakeups     = 0;
 #endif
 
+// fixed point unit of the scheduler credit (one event)
+#define SKV_SERVER_SCHED_SCALE ( SKV_SERVER_EVENT_SOURCE_MAX_PRIORITY )
+// credit is capped so that a source can't hoard more than two full batches
+#define SKV_SERVER_SCHED_MAX_CREDIT ( 2 * SKV_SERVER_EVENTS_MAX_COUNT * SKV_SERVER_SCHED_SCALE )
+// debt is capped so that a large forced batch doesn't starve a source
+#define SKV_SERVER_SCHED_MAX_DEBT ( SKV_SERVER_EVENTS_MAX_COUNT * SKV_SERVER_SCHED_SCALE )
+
 int    skv_server_heap_manager_t::mFd = 0;
 mspace skv_server_heap_manager_t::mMspace;
 char*  skv_server_heap_manager_t::mMspaceBase = NULL;
 uint64_t skv_server_heap_manager_t::mMspaceLen = 0;
 uint64_t skv_server_heap_manager_t::mTotalLen = 0;
 char*  skv_server_heap_manager_t::mMemoryAllocation = NULL;
+skv_mutex_t skv_server_heap_manager_t::mAllocLock;
 
 #ifndef SKV_EVD_POLL_THREAD_LOG
 #define SKV_EVD_POLL_THREAD_LOG ( 0 | SKV_LOGGING_ALL )
@@ -295,7 +308,27 @@ void
 skv_server_t::
 SetState( skv_server_state_t aState )
 {
-  mState = aState;
+  __atomic_store_n( &mState, aState, __ATOMIC_RELEASE );
+}
+
+/***
+ * skv_server_t::ResumeRunState::
+ * Desc: Back to RUN after pending events got processed,
+ * any reactor may call this, so it must not overwrite
+ * an ERROR or EXIT that another reactor has set meanwhile
+ * input:
+ * returns:
+ ***/
+void
+skv_server_t::
+ResumeRunState()
+{
+  skv_server_state_t State = __atomic_load_n( &mState, __ATOMIC_ACQUIRE );
+  while(( State != SKV_SERVER_STATE_RUN ) &&
+        ( State != SKV_SERVER_STATE_ERROR ) &&
+        ( State != SKV_SERVER_STATE_EXIT ) &&
+        ( ! __atomic_compare_exchange_n( &mState, &State, SKV_SERVER_STATE_RUN, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE ) ))
+    ;
 }
 
 /***
@@ -308,7 +341,7 @@ skv_server_state_t
 skv_server_t::
 GetState()
 {
-  return mState;
+  return __atomic_load_n( &mState, __ATOMIC_ACQUIRE );
 }
 
 /***
@@ -346,15 +379,164 @@ PollOnITEventClass( it_evd_handle_t  aEvdHdl,
   }
 }
 
+/***
+ * skv_server_t::GetEventOwner::
+ * Desc: Find the reactor that has to process an event,
+ * i.e. the reactor that owns the EP of the event.
+ * New connections are assigned round robin.
+ * input: the reactor that polled the event
+ * returns: index of the owning reactor
+ ***/
+int
+skv_server_t::
+GetEventOwner( skv_server_reactor_t *aReactor, skv_server_event_t* aEvent )
+{
+  skv_server_ep_state_t *EPState = NULL;
+
+  switch( aEvent->mEventType )
+  {
+    case SKV_SERVER_EVENT_TYPE_IT_CMR_CONN_REQUEST:
+    {
+      // only called with the network source lock held
+      int Owner = mNextReactor;
+      mNextReactor = ( mNextReactor + 1 ) % mReactorCount;
+      return Owner;
+    }
+    case SKV_SERVER_EVENT_TYPE_IT_CMM_CONN_ACCEPT_ARRIVAL:
+    case SKV_SERVER_EVENT_TYPE_IT_CMM_CONN_ESTABLISHED:
+    case SKV_SERVER_EVENT_TYPE_IT_CMM_CONN_DISCONNECT:
+    case SKV_SERVER_EVENT_TYPE_IT_CMM_CONN_PEER_REJECT:
+    case SKV_SERVER_EVENT_TYPE_IT_CMM_CONN_BROKEN:
+      EPState = mEPStateMap->GetEPStateForEPHdl( aEvent->mEventMetadata.mEP.mIT_EP );
+      break;
+
+    case SKV_SERVER_EVENT_TYPE_IT_DTO_RDMA_WRITE_CMPL:
+      EPState = (skv_server_ep_state_t*) aEvent->mEventMetadata.mRdmaWriteCmplCookie.GetContext();
+      break;
+
+    case SKV_SERVER_EVENT_TYPE_IT_DTO_RDMA_READ_CMPL:
+    case SKV_SERVER_EVENT_TYPE_IT_DTO_SQ_CMPL:
+    case SKV_SERVER_EVENT_TYPE_IT_DTO_INSERT_CMD:
+    case SKV_SERVER_EVENT_TYPE_IT_DTO_BULK_INSERT_CMD:
+    case SKV_SERVER_EVENT_TYPE_IT_DTO_MULTI_KEY_CMD:
+    case SKV_SERVER_EVENT_TYPE_IT_DTO_RETRIEVE_CMD:
+    case SKV_SERVER_EVENT_TYPE_IT_DTO_REMOVE_CMD:
+    case SKV_SERVER_EVENT_TYPE_ACTIVE_BCAST_CMD:
+    case SKV_SERVER_EVENT_TYPE_IT_DTO_RETRIEVE_N_KEYS_CMD:
+    case SKV_SERVER_EVENT_TYPE_IT_DTO_RETRIEVE_DIST_CMD:
+    case SKV_SERVER_EVENT_TYPE_IT_DTO_OPEN_CMD:
+    case SKV_SERVER_EVENT_TYPE_IT_DTO_PDSCNTL_CMD:
+    case SKV_SERVER_EVENT_TYPE_LOCAL_KV_ERROR:
+    case SKV_SERVER_EVENT_TYPE_LOCAL_KV_CMPL:
+      EPState = aEvent->mEventMetadata.mCommandFinder.mEPStatePtr;
+      break;
+
+    default:
+      // errors and events without EP are processed by whoever got them
+      break;
+  }
+
+  if( EPState == NULL )
+    return aReactor->mIndex;
+
+  return EPState->mReactor;
+}
+
+/***
+ * skv_server_t::ForwardEvent::
+ * Desc: Append an event to the inbox of a reactor
+ * input: index of the owning reactor
+ * returns:
+ ***/
+void
+skv_server_t::
+ForwardEvent( int aOwner, skv_server_event_t* aEvent )
+{
+  skv_server_reactor_t *Owner = &mReactors[ aOwner ];
+
+  Owner->mInboxLock.lock();
+  Owner->mInbox.push_back( *aEvent );
+  Owner->mInboxCount = Owner->mInbox.size();
+  Owner->mInboxLock.unlock();
+
+  Owner->mDoorbell.Ring();
+}
+
+/***
+ * skv_server_t::DrainInbox::
+ * Desc: Fetch events that other reactors forwarded to this one
+ * input:
+ * returns: number of events copied to aEvents
+ ***/
+int
+skv_server_t::
+DrainInbox( skv_server_reactor_t *aReactor,
+            skv_server_event_t* aEvents, int aMaxEventCount )
+{
+  if( aReactor->mInboxCount == 0 )
+    return 0;
+
+  int EventCount = 0;
+  aReactor->mInboxLock.lock();
+  while( ( EventCount < aMaxEventCount ) && ( ! aReactor->mInbox.empty() ) )
+  {
+    aEvents[ EventCount++ ] = aReactor->mInbox.front();
+    aReactor->mInbox.pop_front();
+  }
+  aReactor->mInboxCount = aReactor->mInbox.size();
+  aReactor->mInboxLock.unlock();
+
+  return EventCount;
+}
+
+/***
+ * skv_server_t::PollSharedEventSource::
+ * Desc: Poll an event source that's shared by all reactors (network, local kv)
+ * if no other reactor is polling it right now.
+ * All events go to the inbox of their owner (including the calling reactor)
+ * before the source is released, so the events of an EP stay in order.
+ * input: aEvents is scratch space for aMaxEventCount events
+ * returns: number of polled events
+ ***/
+int
+skv_server_t::
+PollSharedEventSource( skv_server_reactor_t *aReactor, int aSource,
+                       skv_server_event_t* aEvents, int aMaxEventCount )
+{
+  if( mSharedSourceLock[ aSource ].trylock() != 0 )
+    return 0;
+
+  int EventCount = 0;
+  skv_status_t status = mEventSources[ aSource ]->GetEvent( aEvents, &EventCount, aMaxEventCount );
+
+  if( status == SKV_SUCCESS )
+    for( int i = 0; i < EventCount; i++ )
+      ForwardEvent( GetEventOwner( aReactor, &aEvents[ i ] ), &aEvents[ i ] );
+  else
+    EventCount = 0;
+
+  mSharedSourceLock[ aSource ].unlock();
+  return EventCount;
+}
+
 /***
  * skv_server_t::GetEvent::
- * Desc: Poll either an IT_API event or an MPI event
+ * Desc: Poll the event sources of a reactor
+ * The sources are scheduled by deficit round robin:
+ * every call credits each source with SCALE/priority (the old
+ * 1-in-priority polling rate for idle sources) plus SCALE per event of
+ * backlog. The backlog is the pending count of the source or, if the
+ * source can't tell, the number of events of its last poll.
+ * A source is polled once it has credit for one event, for up to as
+ * many events as it has credit for, and is charged for what it returned
+ * (at least one event, so empty polls keep the idle rate).
  * input:
  * returns: SKV_SUCCESS or SKV_ERR_NO_EVENT
  ***/
 skv_status_t
 skv_server_t::
-GetEvent( skv_server_event_t* aEvents, int* aEventCount, int aMaxEventCount )
+GetEvent( skv_server_reactor_t *aReactor,
+          skv_server_event_t* aEvents, int* aEventCount, int aMaxEventCount )
 {
   gSKVServerEventOtherStart.HitOE( SKV_SERVER_TRACE,
                                    "SKVServerNonCommand",
@@ -362,9 +544,6 @@ GetEvent( skv_server_event_t* aEvents, int* aEventCount, int aMaxEventCount )
                                    gSKVServerEventOtherStart );
 
 
-  // initialize global counter for priority
-  static int priority_index = 0;
-
 #ifdef PKTRACE_ON
   static unsigned long long TraceCount = 0;
 // #ifdef SKV_SERVER_USE_AGGREGATE_EVD
@@ -395,39 +574,202 @@ GetEvent( skv_server_event_t* aEvents, int* aEventCount, int aMaxEventCount )
   for( int evt_src = 0; evt_src < SKV_SERVER_EVENT_SOURCES; evt_src++ )
   {
     int evtCount = 0;
+    skv_server_generic_event_source_t *EventSource = aReactor->mEventSources[ evt_src ];
+
+    int backlog = EventSource->GetPendingCount();
+    if( backlog < 0 )
+      backlog = aReactor->mLastEventCount[ evt_src ];
+    if( backlog > SKV_SERVER_EVENTS_MAX_COUNT )
+      backlog = SKV_SERVER_EVENTS_MAX_COUNT;
+
+    int deficit = aReactor->mDeficit[ evt_src ]
+      + SKV_SERVER_SCHED_SCALE / EventSource->GetPriority()
+      + backlog * SKV_SERVER_SCHED_SCALE;
+    if( deficit > SKV_SERVER_SCHED_MAX_CREDIT )
+      deficit = SKV_SERVER_SCHED_MAX_CREDIT;
+    aReactor->mDeficit[ evt_src ] = deficit;
+
+    if( deficit < SKV_SERVER_SCHED_SCALE )
+      continue;
+
+    int eventLimit = deficit / SKV_SERVER_SCHED_SCALE;
+    if( eventLimit > SKV_SERVER_EVENTS_MAX_COUNT )
+      eventLimit = SKV_SERVER_EVENTS_MAX_COUNT;
+    if( eventLimit < EventSource->GetMinEventCount() )
+      eventLimit = EventSource->GetMinEventCount();
+
+    // no room left in this round, keep the credit for the next one
+    if( eventLimit > aMaxEventCount - *aEventCount )
+      continue;
+
+    BegLogLine( SKV_GET_EVENT_LOG )
+      << "skv_server_t::GetEvent(): "
+      << " fetching evt_src: " << evt_src
+      << " backlog: " << backlog
+      << " deficit: " << deficit
+      << EndLogLine;
 
-    // check if priority is met and fetch request
-    if( priority_index % mEventSources[evt_src]->GetPriority() == 0 )
+    skv_server_event_t *nextEventAddr = &(aEvents[*aEventCount]);
+    int polled = 0;
+
+    if(( mReactorCount > 1 ) &&
+       (( evt_src == SKV_SERVER_NETWORK_EVENT_SRC_INDEX ) || ( evt_src == SKV_SERVER_LOCAL_KV_EVENT_SRC_INDEX )))
     {
-      BegLogLine( SKV_GET_EVENT_LOG )
-        << "skv_server_t::GetEvent(): "
-        << " fetching evt_src: " << evt_src
-        << " prio_index: " << priority_index
-        << EndLogLine;
+      // shared sources only fill the inboxes
+      polled = PollSharedEventSource( aReactor, evt_src, nextEventAddr, eventLimit );
+      ChargeEventSource( aReactor, evt_src, polled );
+      continue;
+    }
 
-      skv_server_event_t *nextEventAddr = &(aEvents[*aEventCount]);
-      // todo: using a fixed limit obsoletes the idea of "slots correlated to priority"
-      //       however, this concept was already obsoleted by the command and network event sources!
-      int eventLimit = SKV_SERVER_EVENTS_MAX_COUNT;
-      status = mEventSources[evt_src]->GetEvent( nextEventAddr, &evtCount, eventLimit );
-
-      BegLogLine( SKV_GET_EVENT_LOG )
-        << "skv_server_t::GetEvent(): "
-        << " fetching complete: " << evtCount
-        << " srclimit=" << eventLimit
-        << " total=" << *aEventCount
-        << " limit=" << aMaxEventCount
-        << EndLogLine;
+    status = EventSource->GetEvent( nextEventAddr, &evtCount, eventLimit );
+    if( status == SKV_SUCCESS )
+      polled = evtCount;
+    ChargeEventSource( aReactor, evt_src, polled );
 
-      if( status == SKV_SUCCESS )
-        *aEventCount += evtCount;
+    // the backend queues cursor events to the internal queue of reactor 0
+    if(( mReactorCount > 1 ) && ( status == SKV_SUCCESS ))
+    {
+      int ownCount = 0;
+      for( int i = 0; i < evtCount; i++ )
+      {
+        int Owner = GetEventOwner( aReactor, &nextEventAddr[ i ] );
+        if( Owner != aReactor->mIndex )
+          ForwardEvent( Owner, &nextEventAddr[ i ] );
+        else
+          nextEventAddr[ ownCount++ ] = nextEventAddr[ i ];
+      }
+      evtCount = ownCount;
+    }
+
+    BegLogLine( SKV_GET_EVENT_LOG )
+      << "skv_server_t::GetEvent(): "
+      << " fetching complete: " << evtCount
+      << " srclimit=" << eventLimit
+      << " total=" << *aEventCount
+      << " limit=" << aMaxEventCount
+      << EndLogLine;
+
+    if( status == SKV_SUCCESS )
+      *aEventCount += evtCount;
+  }
+
+  if( mReactorCount > 1 )
+  {
+    int inboxCount = DrainInbox( aReactor, &(aEvents[*aEventCount]), aMaxEventCount - *aEventCount );
+    if( inboxCount > 0 )
+    {
+      *aEventCount += inboxCount;
+      status = SKV_SUCCESS;
     }
   }
 
-  priority_index = (priority_index + 1) % (SKV_SERVER_EVENT_SOURCE_MAX_PRIORITY * mPriorityCDN);
   return status;
 }
 
+/***
+ * skv_server_t::PrepareIdleWait::
+ * Desc: Announce that the reactor is about to sleep
+ * Events that show up from now on ring one of the doorbells. The
+ * caller has to poll all sources once more before it calls IdleWait()
+ * (or EndIdleWait() if that round found events), so the credits are
+ * topped up to have every source polled in that round.
+ * input:
+ * returns:
+ ***/
+void
+skv_server_t::
+PrepareIdleWait( skv_server_reactor_t *aReactor )
+{
+  aReactor->mDoorbell.PrepareWait();
+  mSharedDoorbell.PrepareWait();
+
+  for( int evt_src = 0; evt_src < SKV_SERVER_EVENT_SOURCES; evt_src++ )
+  {
+    aReactor->mEventSources[ evt_src ]->PrepareWait();
+    if( aReactor->mDeficit[ evt_src ] < SKV_SERVER_SCHED_SCALE )
+      aReactor->mDeficit[ evt_src ] = SKV_SERVER_SCHED_SCALE;
+  }
+}
+
+void
+skv_server_t::
+EndIdleWait( skv_server_reactor_t *aReactor )
+{
+  aReactor->mDoorbell.EndWait();
+  mSharedDoorbell.EndWait();
+}
+
+/***
+ * skv_server_t::IdleWait::
+ * Desc: Sleep until one of the doorbells rings or mPollMaxSleep passed
+ * input:
+ * returns:
+ ***/
+void
+skv_server_t::
+IdleWait( skv_server_reactor_t *aReactor )
+{
+  struct pollfd Doorbells[ 2 ];
+  Doorbells[ 0 ].fd = aReactor->mDoorbell.GetFd();
+  Doorbells[ 0 ].events = POLLIN;
+  Doorbells[ 0 ].revents = 0;
+  Doorbells[ 1 ].fd = mSharedDoorbell.GetFd();
+  Doorbells[ 1 ].events = POLLIN;
+  Doorbells[ 1 ].revents = 0;
+
+  struct timespec Timeout;
+  Timeout.tv_sec = mPollMaxSleep / 1000000;
+  Timeout.tv_nsec = ( mPollMaxSleep % 1000000 ) * 1000;
+
+  int rc = ppoll( Doorbells, 2, &Timeout, NULL );
+  if( rc > 0 )
+  {
+    if( Doorbells[ 0 ].revents & POLLIN )
+      aReactor->mDoorbell.Drain();
+    if( Doorbells[ 1 ].revents & POLLIN )
+      mSharedDoorbell.Drain();
+  }
+
+  EndIdleWait( aReactor );
+
+  BegLogLine( SKV_GET_EVENT_LOG )
+    << "skv_server_t::IdleWait(): "
+    << " reactor: " << aReactor->mIndex
+    << " rc: " << rc
+    << EndLogLine;
+
+#ifdef SKV_SERVER_LOOP_STATISTICS
+  aReactor->mStatistics.idleSleeps++;
+  if( rc > 0 )
+    aReactor->mStatistics.idleWakeups++;
+#endif
+}
+
+/***
+ * skv_server_t::ChargeEventSource::
+ * Desc: Bill a polled event source for the events it returned
+ * input: number of events of the poll (before forwarding)
+ * returns:
+ ***/
+void
+skv_server_t::
+ChargeEventSource( skv_server_reactor_t *aReactor, int aSource, int aEventCount )
+{
+  int deficit = aReactor->mDeficit[ aSource ] - ( aEventCount > 0 ? aEventCount : 1 ) * SKV_SERVER_SCHED_SCALE;
+  if( deficit < -SKV_SERVER_SCHED_MAX_DEBT )
+    deficit = -SKV_SERVER_SCHED_MAX_DEBT;
+
+  aReactor->mDeficit[ aSource ] = deficit;
+  aReactor->mLastEventCount[ aSource ] = aEventCount;
+
+#ifdef SKV_SERVER_LOOP_STATISTICS
+  aReactor->mStatistics.srcPolls[ aSource ]++;
+  aReactor->mStatistics.srcEvents[ aSource ] += aEventCount;
+  if( aEventCount == 0 )
+    aReactor->mStatistics.srcEmptyPolls[ aSource ]++;
+#endif
+}
+
 /***
  * skv_server_t::GetMPIEvent::
  * Desc: Poll for an MPI event
@@ -446,12 +788,13 @@ GetMPIEvent( skv_server_event_t* aEvents, int* aEventCount, int aMaxEventCount )
  * skv_server_t::ProcessEvent::
  * Desc: This is the entry point of an event
  * into the server state machine
- * input:
+ * input: the reactor that owns the EP of the event
  * returns: SKV_SUCCESS on success or error code
  ***/
 skv_status_t
 skv_server_t::
-ProcessEvent( skv_server_state_t  aState,
+ProcessEvent( skv_server_reactor_t *aReactor,
+              skv_server_state_t  aState,
               skv_server_event_t* aEvent )
 {
   skv_status_t status = SKV_SUCCESS;
@@ -532,7 +875,7 @@ ProcessEvent( skv_server_state_t  aState,
             << "skv_server_t::ProcessEvent(): DISCONNECTED CONNECTION: "
             << " EP: " << (void *) aEvent->mEventMetadata.mEP.mIT_EP
 #ifdef SKV_SERVER_LOOP_STATISTICS
-            << SERVER_STATS_ECHO( ServerStatistics )
+            << " reactor: " << aReactor->mIndex << SERVER_STATS_ECHO( aReactor->mStatistics )
 #endif
             << EndLogLine;
           // NO BREAK HERE - JUST CONTINUE PROCESSING WITH CM-state machine
@@ -564,7 +907,7 @@ ProcessEvent( skv_server_state_t  aState,
           status = skv_server_establish_client_connection_sm::Execute( StateForEP,
                                                                        ConnCommandOrdinal,
                                                                        aEvent,
-                                                                       &mSeqNo );
+                                                                       &aReactor->mSeqNo );
 
           AssertLogLine( status == SKV_SUCCESS )
             << "skv_server_t::ProcessEvent::ERROR:: "
@@ -574,16 +917,19 @@ ProcessEvent( skv_server_state_t  aState,
 
           if( aEvent->mEventType != SKV_SERVER_EVENT_TYPE_IT_CMM_CONN_ESTABLISHED )
           {
+            if( aReactor->mEPStateMap != mEPStateMap )
+              mEPStateMap->erase( aEvent->mEventMetadata.mEP.mIT_EP );
+
             // This should normally happen in the state machine.
             // THINK about how to get the data structures there.
-            mNetworkEventManager.FinalizeEPState( mEPStateMap,
+            mNetworkEventManager.FinalizeEPState( aReactor->mEPStateMap,
                                                   aEvent->mEventMetadata.mEP.mIT_EP,
                                                   StateForEP );
             // exit(0);
           }
 
 #ifdef SKV_SERVER_LOOP_STATISTICS
-          SERVER_STATS_RESET( ServerStatistics );
+          SERVER_STATS_RESET( aReactor->mStatistics );
 #endif
 
           break;
@@ -605,12 +951,19 @@ ProcessEvent( skv_server_state_t  aState,
           BegLogLine(SKV_PROCESS_IT_EVENT_LOG)
             << "About to call InitNewStateForEP"
             << EndLogLine ;
-          status = mNetworkEventManager.InitNewStateForEP( mEPStateMap,
+          status = mNetworkEventManager.InitNewStateForEP( aReactor->mEPStateMap,
                                                            &StateForEP );
           BegLogLine(SKV_PROCESS_IT_EVENT_LOG)
             << "Back from InitNewStateForEP"
+            << " reactor: " << aReactor->mIndex
             << EndLogLine ;
 
+          // the command fetching of the reactor only sees its own EPs,
+          // connection events are looked up in the map of all EPs
+          StateForEP->mReactor = aReactor->mIndex;
+          if( aReactor->mEPStateMap != mEPStateMap )
+            mEPStateMap->insert( StateForEP->mEPHdl, StateForEP );
+
           int ConnCommandOrdinal = StateForEP->GetConnCommandOrdinal();
 
           skv_server_ccb_t* ConnCommand = StateForEP->GetCommandForOrdinal( ConnCommandOrdinal );
@@ -632,7 +985,7 @@ ProcessEvent( skv_server_state_t  aState,
           status = skv_server_establish_client_connection_sm::Execute( StateForEP,
                                                                        ConnCommandOrdinal,
                                                                        aEvent,
-                                                                       &mSeqNo );
+                                                                       &aReactor->mSeqNo );
 
           AssertLogLine( status == SKV_SUCCESS )
             << "skv_server_t::ProcessEvent(): ERROR:: "
@@ -662,18 +1015,18 @@ ProcessEvent( skv_server_state_t  aState,
                                                                     EPStatePtr,
                                                                     CmdOrd,
                                                                     aEvent,
-                                                                    &mSeqNo,
+                                                                    &aReactor->mSeqNo,
                                                                     mNetworkEventManager.GetPZ() );
               break;
             }
             case SKV_COMMAND_INSERT:
             {
-              status = skv_server_insert_command_sm::Execute( & mInternalEventManager,
+              status = skv_server_insert_command_sm::Execute( aReactor->mInternalEventManager,
                                                               &mLocalKV,
                                                               EPStatePtr,
                                                               CmdOrd,
                                                               aEvent,
-                                                              &mSeqNo,
+                                                              &aReactor->mSeqNo,
                                                               mMyRank );
               break;
             }
@@ -686,15 +1039,25 @@ ProcessEvent( skv_server_state_t  aState,
                 << " ClientOrd: " << EPStatePtr->mClientGroupOrdinal
                 << EndLogLine;
 
-              status = skv_server_bulk_insert_command_sm::Execute( &mInternalEventManager,
+              status = skv_server_bulk_insert_command_sm::Execute( aReactor->mInternalEventManager,
                                                                    &mLocalKV,
                                                                    EPStatePtr,
                                                                    CmdOrd,
                                                                    aEvent,
-                                                                   &mSeqNo,
+                                                                   &aReactor->mSeqNo,
                                                                    mMyRank );
               break;
             }
+            case SKV_COMMAND_MULTI_KEY:
+            {
+              status = skv_server_multi_key_command_sm::Execute( aReactor->mInternalEventManager,
+                                                                 &mLocalKV,
+                                                                 EPStatePtr,
+                                                                 CmdOrd,
+                                                                 aEvent,
+                                                                 &aReactor->mSeqNo );
+              break;
+            }
             default:
             {
               StrongAssertLogLine( 0 )
@@ -738,12 +1101,12 @@ ProcessEvent( skv_server_state_t  aState,
                   << "skv_server_t::ProcessEvent(): calling execute in for receive "
                   << EndLogLine;
 
-                status = skv_server_retrieve_command_sm::Execute( &mInternalEventManager,
+                status = skv_server_retrieve_command_sm::Execute( aReactor->mInternalEventManager,
                                                                   &mLocalKV,
                                                                   EPStatePtr,
                                                                   CmdOrd,
                                                                   aEvent,
-                                                                  &mSeqNo,
+                                                                  &aReactor->mSeqNo,
                                                                   mNetworkEventManager.GetPZ(),
                                                                   mMyRank );
 
@@ -757,9 +1120,17 @@ ProcessEvent( skv_server_state_t  aState,
                                                                          EPStatePtr,
                                                                          CmdOrd,
                                                                          aEvent,
-                                                                         &mSeqNo,
+                                                                         &aReactor->mSeqNo,
                                                                          mNetworkEventManager.GetPZ() );
                 break;
+              case SKV_COMMAND_MULTI_KEY:
+                status = skv_server_multi_key_command_sm::Execute( aReactor->mInternalEventManager,
+                                                                   &mLocalKV,
+                                                                   EPStatePtr,
+                                                                   CmdOrd,
+                                                                   aEvent,
+                                                                   &aReactor->mSeqNo );
+                break;
               default:
                 StrongAssertLogLine( 1 )
                   << "ProcessEvents(): Unexpected command type in write completion event."
@@ -790,7 +1161,7 @@ ProcessEvent( skv_server_state_t  aState,
 
               if( Func == EPSTATE_CountSendCompletionsCallback )
               {
-                SetState( SKV_SERVER_STATE_RUN );
+                ResumeRunState();
               }
             }
           }
@@ -834,12 +1205,12 @@ ProcessEvent( skv_server_state_t  aState,
           // status = EPStatePtr->EPResourceCheckAndQueue( aEvent );
           // if( status == SKV_SUCCESS )
           //   {
-          status = skv_server_insert_command_sm::Execute( &mInternalEventManager,
+          status = skv_server_insert_command_sm::Execute( aReactor->mInternalEventManager,
                                                           &mLocalKV,
                                                           EPStatePtr,
                                                           CmdOrd,
                                                           aEvent,
-                                                          &mSeqNo,
+                                                          &aReactor->mSeqNo,
                                                           mMyRank );
           AssertLogLine( status == SKV_SUCCESS )
             << "skv_server_t::ProcessEvent::ERROR:: "
@@ -862,12 +1233,12 @@ ProcessEvent( skv_server_state_t  aState,
             << " ClientOrd: " << EPStatePtr->mClientGroupOrdinal
             << EndLogLine;
 
-          status = skv_server_bulk_insert_command_sm::Execute( &mInternalEventManager,
+          status = skv_server_bulk_insert_command_sm::Execute( aReactor->mInternalEventManager,
                                                                &mLocalKV,
                                                                EPStatePtr,
                                                                CmdOrd,
                                                                aEvent,
-                                                               &mSeqNo,
+                                                               &aReactor->mSeqNo,
                                                                mMyRank );
 
           AssertLogLine( status == SKV_SUCCESS )
@@ -878,17 +1249,37 @@ ProcessEvent( skv_server_state_t  aState,
 
           break;
         }
+        case SKV_SERVER_EVENT_TYPE_IT_DTO_MULTI_KEY_CMD:
+        {
+          skv_server_ep_state_t* EPStatePtr = aEvent->mEventMetadata.mCommandFinder.mEPStatePtr;
+          int CmdOrd = aEvent->mEventMetadata.mCommandFinder.mCommandOrd;
+
+          status = skv_server_multi_key_command_sm::Execute( aReactor->mInternalEventManager,
+                                                             &mLocalKV,
+                                                             EPStatePtr,
+                                                             CmdOrd,
+                                                             aEvent,
+                                                             &aReactor->mSeqNo );
+
+          AssertLogLine( status == SKV_SUCCESS )
+            << "skv_server_t::ProcessEvent::ERROR:: "
+            << " Event: " << skv_server_event_type_to_string( aEvent->mEventType )
+            << " status: " << skv_status_to_string( status )
+            << EndLogLine;
+
+          break;
+        }
         case SKV_SERVER_EVENT_TYPE_IT_DTO_RETRIEVE_CMD:
         {
           skv_server_ep_state_t* EPStatePtr = aEvent->mEventMetadata.mCommandFinder.mEPStatePtr;
           int CmdOrd = aEvent->mEventMetadata.mCommandFinder.mCommandOrd;
 
-          status = skv_server_retrieve_command_sm::Execute( &mInternalEventManager,
+          status = skv_server_retrieve_command_sm::Execute( aReactor->mInternalEventManager,
                                                             &mLocalKV,
                                                             EPStatePtr,
                                                             CmdOrd,
                                                             aEvent,
-                                                            &mSeqNo,
+                                                            &aReactor->mSeqNo,
                                                             mNetworkEventManager.GetPZ(),
                                                             mMyRank );
 
@@ -905,12 +1296,12 @@ ProcessEvent( skv_server_state_t  aState,
           skv_server_ep_state_t* EPStatePtr = aEvent->mEventMetadata.mCommandFinder.mEPStatePtr;
           int                     CmdOrd     = aEvent->mEventMetadata.mCommandFinder.mCommandOrd;
 
-          status = skv_server_remove_command_sm::Execute( &mInternalEventManager,
+          status = skv_server_remove_command_sm::Execute( aReactor->mInternalEventManager,
                                                           &mLocalKV,
                                                           EPStatePtr,
                                                           CmdOrd,
                                                           aEvent,
-                                                          &mSeqNo,
+                                                          &aReactor->mSeqNo,
                                                           mMyRank );
 
           AssertLogLine( status == SKV_SUCCESS )
@@ -930,7 +1321,7 @@ ProcessEvent( skv_server_state_t  aState,
                                                                 EPStatePtr,
                                                                 CmdOrd,
                                                                 aEvent,
-                                                                &mSeqNo,
+                                                                &aReactor->mSeqNo,
                                                                 mNetworkEventManager.GetPZ() );
 
           AssertLogLine( status == SKV_SUCCESS )
@@ -950,7 +1341,7 @@ ProcessEvent( skv_server_state_t  aState,
                                                                    EPStatePtr,
                                                                    CmdOrd,
                                                                    aEvent,
-                                                                   &mSeqNo,
+                                                                   &aReactor->mSeqNo,
                                                                    mNetworkEventManager.GetPZ() );
 
           AssertLogLine( status == SKV_SUCCESS )
@@ -966,12 +1357,12 @@ ProcessEvent( skv_server_state_t  aState,
           skv_server_ep_state_t* EPStatePtr = aEvent->mEventMetadata.mCommandFinder.mEPStatePtr;
           int CmdOrd = aEvent->mEventMetadata.mCommandFinder.mCommandOrd;
 
-          status = skv_server_retrieve_dist_command_sm::Execute( &mInternalEventManager,
+          status = skv_server_retrieve_dist_command_sm::Execute( aReactor->mInternalEventManager,
                                                                  &mLocalKV,
                                                                  EPStatePtr,
                                                                  CmdOrd,
                                                                  aEvent,
-                                                                 &mSeqNo );
+                                                                 &aReactor->mSeqNo );
 
           AssertLogLine( status == SKV_SUCCESS )
             << "skv_server_t::ProcessEvent::ERROR:: "
@@ -987,12 +1378,12 @@ ProcessEvent( skv_server_state_t  aState,
           skv_server_ep_state_t* EPStatePtr = aEvent->mEventMetadata.mCommandFinder.mEPStatePtr;
           int CmdOrd = aEvent->mEventMetadata.mCommandFinder.mCommandOrd;
 
-          status = skv_server_open_command_sm::Execute( &mInternalEventManager,
+          status = skv_server_open_command_sm::Execute( aReactor->mInternalEventManager,
                                                         &mLocalKV,
                                                         EPStatePtr,
                                                         CmdOrd,
                                                         aEvent,
-                                                        &mSeqNo );
+                                                        &aReactor->mSeqNo );
 
           AssertLogLine( status == SKV_SUCCESS )
             << "skv_server_t::ProcessEvent::ERROR:: "
@@ -1012,7 +1403,7 @@ ProcessEvent( skv_server_state_t  aState,
                                                            EPStatePtr,
                                                            CmdOrd,
                                                            aEvent,
-                                                           &mSeqNo );
+                                                           &aReactor->mSeqNo );
 
           AssertLogLine( status == SKV_SUCCESS )
             << "skv_server_t::ProcessEvent::ERROR:: "
@@ -1044,30 +1435,38 @@ ProcessEvent( skv_server_state_t  aState,
           {
             // walk through all potential commands that might come back from local kv...
             case SKV_COMMAND_INSERT:
-              status = skv_server_insert_command_sm::Execute( &mInternalEventManager,
+              status = skv_server_insert_command_sm::Execute( aReactor->mInternalEventManager,
                                                               &mLocalKV,
                                                               EPStatePtr,
                                                               CmdOrd,
                                                               aEvent,
-                                                              &mSeqNo,
+                                                              &aReactor->mSeqNo,
                                                               mMyRank );
               break;
             case SKV_COMMAND_BULK_INSERT:
-              status = skv_server_bulk_insert_command_sm::Execute( &mInternalEventManager,
+              status = skv_server_bulk_insert_command_sm::Execute( aReactor->mInternalEventManager,
                                                                    &mLocalKV,
                                                                    EPStatePtr,
                                                                    CmdOrd,
                                                                    aEvent,
-                                                                   &mSeqNo,
+                                                                   &aReactor->mSeqNo,
                                                                    mMyRank );
               break;
+            case SKV_COMMAND_MULTI_KEY:
+              status = skv_server_multi_key_command_sm::Execute( aReactor->mInternalEventManager,
+                                                                 &mLocalKV,
+                                                                 EPStatePtr,
+                                                                 CmdOrd,
+                                                                 aEvent,
+                                                                 &aReactor->mSeqNo );
+              break;
             case SKV_COMMAND_RETRIEVE:
-              status = skv_server_retrieve_command_sm::Execute( &mInternalEventManager,
+              status = skv_server_retrieve_command_sm::Execute( aReactor->mInternalEventManager,
                                                                 &mLocalKV,
                                                                 EPStatePtr,
                                                                 CmdOrd,
                                                                 aEvent,
-                                                                &mSeqNo,
+                                                                &aReactor->mSeqNo,
                                                                 mNetworkEventManager.GetPZ(),
                                                                 mMyRank );
               break;
@@ -1076,40 +1475,40 @@ ProcessEvent( skv_server_state_t  aState,
                                                                        EPStatePtr,
                                                                        CmdOrd,
                                                                        aEvent,
-                                                                       &mSeqNo,
+                                                                       &aReactor->mSeqNo,
                                                                        mNetworkEventManager.GetPZ() );
               break;
             case SKV_COMMAND_RETRIEVE_DIST:
-              status = skv_server_retrieve_dist_command_sm::Execute( &mInternalEventManager,
+              status = skv_server_retrieve_dist_command_sm::Execute( aReactor->mInternalEventManager,
                                                                      &mLocalKV,
                                                                      EPStatePtr,
                                                                      CmdOrd,
                                                                      aEvent,
-                                                                     &mSeqNo );
+                                                                     &aReactor->mSeqNo );
               break;
             case SKV_COMMAND_REMOVE:
-              status = skv_server_remove_command_sm::Execute( &mInternalEventManager,
+              status = skv_server_remove_command_sm::Execute( aReactor->mInternalEventManager,
                                                               &mLocalKV,
                                                               EPStatePtr,
                                                               CmdOrd,
                                                               aEvent,
-                                                              &mSeqNo,
+                                                              &aReactor->mSeqNo,
                                                               mMyRank );
               break;
             case SKV_COMMAND_OPEN:
-              status = skv_server_open_command_sm::Execute( &mInternalEventManager,
+              status = skv_server_open_command_sm::Execute( aReactor->mInternalEventManager,
                                                             &mLocalKV,
                                                             EPStatePtr,
                                                             CmdOrd,
                                                             aEvent,
-                                                            &mSeqNo );
+                                                            &aReactor->mSeqNo );
               break;
             case SKV_COMMAND_ACTIVE_BCAST:
               status = skv_server_active_bcast_command_sm::Execute( &mLocalKV,
                                                                     EPStatePtr,
                                                                     CmdOrd,
                                                                     aEvent,
-                                                                    &mSeqNo,
+                                                                    &aReactor->mSeqNo,
                                                                     mNetworkEventManager.GetPZ() );
               break;
             case SKV_COMMAND_CLOSE:
@@ -1118,7 +1517,7 @@ ProcessEvent( skv_server_state_t  aState,
                                                                EPStatePtr,
                                                                CmdOrd,
                                                                aEvent,
-                                                               &mSeqNo );
+                                                               &aReactor->mSeqNo );
               break;
             case SKV_COMMAND_UPDATE:
             case SKV_COMMAND_CURSOR_PREFETCH:
@@ -1213,7 +1612,7 @@ ProcessPendingEvents( skv_server_ep_state_t * aEPStatePtr )
       << "skv_server_t::ProcessPendingEvents():: Starting to process pending event: " << ( void* )pEvent
       << EndLogLine;
 
-    status = ProcessEvent( State, pEvent );
+    status = ProcessEvent( &mReactors[ aEPStatePtr->mReactor ], State, pEvent );
 
     BegLogLine( SKV_SERVER_PENDING_EVENTS_LOG )
       << "skv_server_t::ProcessPendingEvents():: ProcessEvent return: " << skv_status_to_string( status )
@@ -1225,7 +1624,7 @@ ProcessPendingEvents( skv_server_ep_state_t * aEPStatePtr )
   // transition to general RUN status if more events pending
   if( aEPStatePtr->GetPendingEventsCount() == 0 )
   {
-    SetState( SKV_SERVER_STATE_RUN );
+    ResumeRunState();
   }
   return SKV_SUCCESS;
 }
@@ -1233,6 +1632,7 @@ ProcessPendingEvents( skv_server_ep_state_t * aEPStatePtr )
 /***
  * skv_server_t::Run::
  * Desc: Starts the state machine on the server
+ * the calling thread runs reactor 0, the other reactors get their own threads
  * input:
  * returns: SKV_SUCCESS on success or error code
  ***/
@@ -1242,12 +1642,65 @@ Run()
 {
   BegLogLine( SKV_SERVER_RUN_LOG )
     << "skv_server_t::Run():: Entering... "
+    << " reactors: " << mReactorCount
     << EndLogLine;
 
   SetState( SKV_SERVER_STATE_RUN );
 
-  int IterCount = 0;
-  int PollLoops = 0;
+  for( int r = 1; r < mReactorCount; r++ )
+  {
+    int rc = pthread_create( &mReactors[ r ].mThread, NULL, ReactorThread, (void*) &mReactors[ r ] );
+
+    StrongAssertLogLine( rc == 0 )
+      << "skv_server_t::Run():: ERROR:: failed to start reactor: " << r
+      << " rc: " << rc
+      << EndLogLine;
+  }
+
+  skv_status_t status = RunReactor( &mReactors[ 0 ] );
+
+  for( int r = 1; r < mReactorCount; r++ )
+    pthread_join( mReactors[ r ].mThread, NULL );
+
+  return status;
+}
+
+/***
+ * skv_server_t::ReactorThread::
+ * Desc: Thread function of the reactors 1..n-1
+ * input: the reactor
+ * returns:
+ ***/
+void*
+skv_server_t::
+ReactorThread( void* arg )
+{
+  skv_server_reactor_t *Reactor = (skv_server_reactor_t*) arg;
+
+  Reactor->mServer->RunReactor( Reactor );
+
+  return NULL;
+}
+
+/***
+ * skv_server_t::RunReactor::
+ * Desc: The event loop of one reactor
+ * input:
+ * returns: SKV_SUCCESS on success or error code
+ ***/
+skv_status_t
+skv_server_t::
+RunReactor( skv_server_reactor_t *aReactor )
+{
+  BegLogLine( SKV_SERVER_RUN_LOG )
+    << "skv_server_t::RunReactor():: Entering... "
+    << " reactor: " << aReactor->mIndex
+    << EndLogLine;
+
+  // spin-then-sleep: after mPollSpin empty loops the reactor announces
+  // its wait, polls once more and sleeps if that round is empty too
+  uint64_t IdleLoops = 0;
+  bool WaitPrepared = false;
 
   skv_server_event_t *Events = new skv_server_event_t[ SKV_SERVER_EVENTS_MAX_COUNT * SKV_SERVER_EVENT_SOURCES ];
   // skv_server_event_t PendingEvents[ SKV_SERVER_EVENTS_MAX_COUNT ];
@@ -1277,7 +1730,7 @@ Run()
 // #endif
 
 #ifdef SKV_SERVER_LOOP_STATISTICS
-      ServerStatistics.overallRunLoops++;
+      aReactor->mStatistics.overallRunLoops++;
 #endif
 
     skv_status_t status;
@@ -1288,7 +1741,36 @@ Run()
 
     // might look strange, but this allows to just exchange GetEvent and GetCommand without changing the parameters
     // Get event-based activities
-    status = GetEvent( &(Events[CommandCount]), &EventCount, SKV_SERVER_EVENTS_MAX_COUNT * SKV_SERVER_EVENT_SOURCES );
+    status = GetEvent( aReactor, &(Events[CommandCount]), &EventCount, SKV_SERVER_EVENTS_MAX_COUNT * SKV_SERVER_EVENT_SOURCES );
+
+#ifdef SKV_SERVER_LOOP_STATISTICS
+    if( EventCount == 0 )
+      aReactor->mStatistics.zeroPollCount++;
+#endif
+
+    if( EventCount > 0 )
+    {
+      IdleLoops = 0;
+      if( WaitPrepared )
+      {
+        EndIdleWait( aReactor );
+        WaitPrepared = false;
+      }
+    }
+    else if( mPollMaxSleep > 0 )
+    {
+      if( WaitPrepared )
+      {
+        IdleWait( aReactor );
+        WaitPrepared = false;
+        IdleLoops = 0;
+      }
+      else if( ++IdleLoops >= mPollSpin )
+      {
+        PrepareIdleWait( aReactor );
+        WaitPrepared = true;
+      }
+    }
 
     if( EventCount > 0 )
     {
@@ -1305,7 +1787,7 @@ Run()
             0,
             gSKVServerEventStart );
 
-        status = ProcessEvent( State, &Events[i] );
+        status = ProcessEvent( aReactor, State, &Events[i] );
 
         gSKVServerEventFinis.HitOE( SKV_SERVER_TRACE,
             "SKVServerEventProcessing",
@@ -1382,6 +1864,19 @@ Init( int   aRank,
 
   mSKVConfiguration = skv_configuration_t::GetSKVConfiguration();
 
+  mReactorCount = mSKVConfiguration->GetServerReactors();
+  mNextReactor = 0;
+
+  mPollSpin = mSKVConfiguration->GetServerPollSpin();
+  mPollMaxSleep = mSKVConfiguration->GetServerPollMaxSleep();
+  if(( mPollMaxSleep > 0 ) && ( mSharedDoorbell.Init() != SKV_SUCCESS ))
+  {
+    BegLogLine( 1 )
+      << "skv_server_t::Init():: WARNING:: no doorbell, idle server will keep polling"
+      << EndLogLine;
+    mPollMaxSleep = 0;
+  }
+
   /***********************************************************
    *  INITIALIZE EVENT MANAGERS,  SOURCES (AND SINKS)
    ***********************************************************/
@@ -1405,8 +1900,67 @@ Init( int   aRank,
     << "mEPStateMap != NULL"
     << EndLogLine;
 
-  mEventSources[ SKV_SERVER_COMMAND_EVENT_SRC_INDEX ] = new skv_server_command_event_source_t( mEPStateMap,
-                                                                                               SKV_SERVER_COMMAND_SRC_PRIORITY);
+  // Initialize the reactors
+  // with more than one reactor, each of them fetches the commands of its own EPs
+  // and mEPStateMap holds all EPs to look up the owner of connection events
+  mReactors = new skv_server_reactor_t[ mReactorCount ];
+  StrongAssertLogLine( mReactors != NULL )
+    << "skv_server_t::Init():: ERROR:: "
+    << "mReactors != NULL"
+    << EndLogLine;
+
+  for( int r = 0; r < mReactorCount; r++ )
+  {
+    skv_server_reactor_t *Reactor = &mReactors[ r ];
+
+    Reactor->mIndex = r;
+    Reactor->mServer = this;
+    Reactor->mSeqNo = 0;
+    for( int evt_src = 0; evt_src < SKV_SERVER_EVENT_SOURCES; evt_src++ )
+    {
+      Reactor->mDeficit[ evt_src ] = 0;
+      Reactor->mLastEventCount[ evt_src ] = 0;
+    }
+    Reactor->mInboxCount = 0;
+#ifdef SKV_SERVER_LOOP_STATISTICS
+    SERVER_STATS_RESET( Reactor->mStatistics );
+#endif
+
+    for( int evt_src = 0; evt_src < SKV_SERVER_EVENT_SOURCES; evt_src++ )
+      Reactor->mEventSources[ evt_src ] = mEventSources[ evt_src ];
+
+    if( r == 0 )
+      Reactor->mInternalEventManager = &mInternalEventManager;
+    else
+    {
+      Reactor->mInternalEventManager = new skv_server_internal_event_manager_if_t;
+      Reactor->mInternalEventManager->Init();
+      Reactor->mEventSources[ SKV_SERVER_INTERNAL_EVENT_SRC_INDEX ] = new skv_server_internal_event_source_t();
+      ((skv_server_internal_event_source_t*)(Reactor->mEventSources[ SKV_SERVER_INTERNAL_EVENT_SRC_INDEX ]))->Init( Reactor->mInternalEventManager,
+                                                                                                                    SKV_SERVER_INTERNAL_SRC_PRIORITY );
+    }
+
+    if( mReactorCount == 1 )
+      Reactor->mEPStateMap = mEPStateMap;
+    else
+      Reactor->mEPStateMap = new skv_server_epstate_map_t;
+
+    Reactor->mEventSources[ SKV_SERVER_COMMAND_EVENT_SRC_INDEX ] = new skv_server_command_event_source_t( Reactor->mEPStateMap,
+                                                                                                         SKV_SERVER_COMMAND_SRC_PRIORITY);
+
+    if(( mPollMaxSleep > 0 ) && ( Reactor->mDoorbell.Init() != SKV_SUCCESS ))
+    {
+      BegLogLine( 1 )
+        << "skv_server_t::Init():: WARNING:: no doorbell for reactor: " << r
+        << ", idle server will keep polling"
+        << EndLogLine;
+      mPollMaxSleep = 0;
+    }
+  }
+  mEventSources[ SKV_SERVER_COMMAND_EVENT_SRC_INDEX ] = mReactors[ 0 ].mEventSources[ SKV_SERVER_COMMAND_EVENT_SRC_INDEX ];
+
+  // the backend is shared by all reactors
+  mLocalKV.SetMultiThreaded( mReactorCount > 1 );
 
   skv_status_t status = mLocalKV.Init( Rank,
                                        PartitionSize,
@@ -1429,6 +1983,32 @@ Init( int   aRank,
   mEventSources[ SKV_SERVER_LOCAL_KV_EVENT_SRC_INDEX ] = new skv_server_local_kv_event_source_t();
   ((skv_server_local_kv_event_source_t*)(mEventSources[ SKV_SERVER_LOCAL_KV_EVENT_SRC_INDEX ]))->Init( &mLocalKV,
                                                                                                        SKV_SERVER_LOCAL_KV_SRC_PRIORITY );
+  for( int r = 0; r < mReactorCount; r++ )
+    mReactors[ r ].mEventSources[ SKV_SERVER_LOCAL_KV_EVENT_SRC_INDEX ] = mEventSources[ SKV_SERVER_LOCAL_KV_EVENT_SRC_INDEX ];
+
+  // wakeup of idle reactors:
+  // network and local kv events go to the shared doorbell (any reactor can poll them),
+  // commands and internal events to the doorbell of the owning reactor
+  if( mPollMaxSleep > 0 )
+  {
+    mEventSources[ SKV_SERVER_NETWORK_EVENT_SRC_INDEX ]->SetDoorbell( &mSharedDoorbell );
+    mEventSources[ SKV_SERVER_LOCAL_KV_EVENT_SRC_INDEX ]->SetDoorbell( &mSharedDoorbell );
+
+    for( int r = 0; r < mReactorCount; r++ )
+    {
+      skv_server_reactor_t *Reactor = &mReactors[ r ];
+
+      Reactor->mEventSources[ SKV_SERVER_INTERNAL_EVENT_SRC_INDEX ]->SetDoorbell( &Reactor->mDoorbell );
+      Reactor->mEventSources[ SKV_SERVER_COMMAND_EVENT_SRC_INDEX ]->SetDoorbell( &Reactor->mDoorbell );
+      ((skv_server_command_event_source_t*)(Reactor->mEventSources[ SKV_SERVER_COMMAND_EVENT_SRC_INDEX ]))->SetPollBackoff( mPollSpin,
+                                                                                                                         mPollMaxSleep );
+    }
+  }
+
+  BegLogLine( 1 )
+    << "server_init(): idle reactors sleep after: " << mPollSpin
+    << " empty loops for up to: " << mPollMaxSleep << " usec"
+    << EndLogLine;
 
   // common denominator to calc number of event slots for event fetching, also used to assure priority when counter is wrapped
   mPriorityCDN = 1;
@@ -1453,8 +2033,6 @@ Init( int   aRank,
   }
   /***********************************************************/
 
-  mSeqNo = 0;
-
   /************************************************************
    * Initialize startup
    ***********************************************************/
@@ -16,6 +16,7 @@
 
 #include <mpi.h>
 #include <pthread.h>
+#include <deque>
 
 #include <skv/common/skv_config.hpp>
 
@@ -80,6 +81,67 @@ typedef enum
   SKV_SERVER_EVENT_SOURCES   // always the last (== number of possible indices)
 } skv_server_event_source_index_t;
 
+#ifdef SKV_SERVER_LOOP_STATISTICS
+typedef struct
+{
+  uint64_t zeroPollCount;
+  uint64_t overallRunLoops;
+  uint64_t reqDeferCount;
+  uint64_t overallCommands;
+  uint64_t maxCommandBatch;
+
+  // per event source: polls, polls without events and fetched events
+  uint64_t srcPolls[ SKV_SERVER_EVENT_SOURCES ];
+  uint64_t srcEmptyPolls[ SKV_SERVER_EVENT_SOURCES ];
+  uint64_t srcEvents[ SKV_SERVER_EVENT_SOURCES ];
+
+  // idle waits of the main loop and how many of them ended by a wakeup (not the timeout)
+  uint64_t idleSleeps;
+  uint64_t idleWakeups;
+} server_stats_t;
+#endif
+
+class skv_server_t;
+
+/*
+ * A reactor runs the event loop for the subset of endpoints it owns:
+ * - its own EPState map and command event source (with fetch thread)
+ * - its own internal event queue and sequence number
+ * The network and local kv event sources are shared. They are polled by
+ * one reactor at a time which forwards each event to the inbox of the
+ * reactor that owns the endpoint.
+ * With a single reactor, the reactor 0 uses the sources of the server
+ * directly and nothing is forwarded.
+ */
+struct skv_server_reactor_t
+{
+  int                                          mIndex;
+  skv_server_t                                *mServer;
+  pthread_t                                    mThread;
+
+  skv_server_internal_event_manager_if_t      *mInternalEventManager;
+  skv_server_epstate_map_t                    *mEPStateMap;
+  skv_server_generic_event_source_t           *mEventSources[ SKV_SERVER_EVENT_SOURCES ];
+
+  int                                          mSeqNo;
+
+  // scheduler state per event source (see GetEvent)
+  int                                          mDeficit[ SKV_SERVER_EVENT_SOURCES ];
+  int                                          mLastEventCount[ SKV_SERVER_EVENT_SOURCES ];
+
+  // events forwarded by other reactors (in the order they were polled)
+  skv_mutex_t                                  mInboxLock;
+  std::deque< skv_server_event_t >             mInbox;
+  volatile int                                 mInboxCount;
+
+  // wakes up the idle reactor for its own commands, internal events and inbox
+  skv_server_doorbell_t                        mDoorbell;
+
+#ifdef SKV_SERVER_LOOP_STATISTICS
+  server_stats_t                               mStatistics;
+#endif
+};
+
 class skv_server_t
 {
 public:
@@ -110,22 +172,56 @@ public:
   // The mighty context table.
   skv_server_epstate_map_t   *mEPStateMap;
 
-  skv_server_state_t         mState;
+  skv_server_state_t         mState;     // shared by all reactors, atomic access only
+
+  // reactors and the locks that hand the shared event sources to one reactor at a time
+  int                        mReactorCount;
+  skv_server_reactor_t      *mReactors;
+  int                        mNextReactor;    // round robin assignment of new connections
+  skv_mutex_t                mSharedSourceLock[ SKV_SERVER_EVENT_SOURCES ];
 
-  int                        mSeqNo;
+  // idle reactors sleep after mPollSpin empty loops for up to mPollMaxSleep usec
+  // (0: busy polling) until the shared (network, local kv) or their own doorbell rings
+  uint64_t                   mPollSpin;
+  uint64_t                   mPollMaxSleep;
+  skv_server_doorbell_t      mSharedDoorbell;
 
   int                        mMyRank;
   int                        mMyNodeCount;
 
   skv_status_t Run();
 
+  skv_status_t RunReactor( skv_server_reactor_t *aReactor );
+
+  static void* ReactorThread( void* arg );
+
   // 3 Classes of Events
   skv_status_t GetMPIEvent( skv_server_event_t* aEvents, int* aEventCount, int aMaxEventCount );
 
-  skv_status_t GetEvent( skv_server_event_t* aEvents, int* aEventCount, int aMaxEventCount );
+  skv_status_t GetEvent( skv_server_reactor_t *aReactor,
+                         skv_server_event_t* aEvents, int* aEventCount, int aMaxEventCount );
+
+  void ChargeEventSource( skv_server_reactor_t *aReactor, int aSource, int aEventCount );
 
-  skv_status_t ProcessEvent( skv_server_state_t  aState,
-                                    skv_server_event_t* aEvent );
+  skv_status_t ProcessEvent( skv_server_reactor_t *aReactor,
+                             skv_server_state_t  aState,
+                             skv_server_event_t* aEvent );
+
+  // multi-reactor event routing
+  int GetEventOwner( skv_server_reactor_t *aReactor, skv_server_event_t* aEvent );
+
+  void ForwardEvent( int aOwner, skv_server_event_t* aEvent );
+
+  int  PollSharedEventSource( skv_server_reactor_t *aReactor, int aSource,
+                              skv_server_event_t* aEvents, int aMaxEventCount );
+
+  int  DrainInbox( skv_server_reactor_t *aReactor,
+                   skv_server_event_t* aEvents, int aMaxEventCount );
+
+  // sleeping of idle reactors
+  void PrepareIdleWait( skv_server_reactor_t *aReactor );
+  void EndIdleWait( skv_server_reactor_t *aReactor );
+  void IdleWait( skv_server_reactor_t *aReactor );
 
   skv_status_t ProcessPendingEvents( skv_server_event_t * aEvent );
   skv_status_t ProcessPendingEvents( skv_server_ep_state_t * aEPStatePtr );
@@ -143,6 +239,8 @@ public:
 
   void             SetState( skv_server_state_t aState );
 
+  void             ResumeRunState();
+
   skv_server_state_t     GetState();
 
 public:
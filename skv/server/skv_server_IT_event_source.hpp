@@ -21,7 +21,10 @@
 class skv_server_IT_event_source_t :
     public skv_server_event_source_t<skv_server_network_event_manager_if_t>
 {
+  skv_server_doorbell_t *mDoorbell;
+
 public:
+  skv_server_IT_event_source_t() : mDoorbell( NULL ) {}
   virtual skv_status_t
   GetEvent( skv_server_event_t* aEvents, int* aEventCount, int aMaxEventCount )
   {
@@ -29,6 +32,21 @@ public:
     return PrepareEvents( aEvents, aEventCount );
   }
 
+  // the AEVD is always polled for a full batch
+  virtual int
+  GetMinEventCount() { return SKV_SERVER_AEVD_EVENTS_MAX_COUNT; }
+
+  virtual void
+  SetDoorbell( skv_server_doorbell_t *aDoorbell ) { mDoorbell = aDoorbell; }
+
+  // the AEVD notification is one-shot
+  virtual void
+  PrepareWait()
+  {
+    if( mDoorbell != NULL )
+      itx_aevd_notify( mEventManager->GetAEVD(), mDoorbell->GetFd() );
+  }
+
 private:
   int FetchEvents( int aMaxEventCount );
   skv_status_t PrepareEvents( skv_server_event_t *aEvents, int *aEventCount );
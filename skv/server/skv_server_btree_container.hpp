@@ -0,0 +1,664 @@
+/************************************************
+ * Copyright (c) IBM Corp. 2014
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * which accompanies this distribution, and is available at
+ * http://www.eclipse.org/legal/epl-v10.html
+ *************************************************/
+
+#ifndef __SKV_SERVER_BTREE_CONTAINER_HPP__
+#define __SKV_SERVER_BTREE_CONTAINER_HPP__
+
+#include <cstddef>
+#include <new>
+#include <utility>
+#include <FxLogger.hpp>
+
+// number of keys per leaf and inner node
+#ifndef SKV_BTREE_LEAF_SLOTS
+#define SKV_BTREE_LEAF_SLOTS     ( 64 )
+#endif
+#ifndef SKV_BTREE_INNER_SLOTS
+#define SKV_BTREE_INNER_SLOTS    ( 64 )
+#endif
+
+#define SKV_BTREE_MAX_DEPTH      ( 32 )
+
+/***
+ * Ordered index implementing the subset of the std::set interface that
+ * the tree based container uses (insert, find, lower_bound, erase and
+ * forward iteration).
+ *
+ * KeyT    - the stored key (copied by value into the nodes)
+ * TraitsT - provides prefix_t, MakePrefix( key, *prefix ) and a three-way
+ *           Compare( keyA, prefixA, keyB, prefixB )
+ * AllocT  - char allocator used for the nodes (i.e. skv_allocator_t<char>
+ *           to keep the index inside the server mspace)
+ *
+ * Each slot keeps a packed prefix next to its key. The prefixes sit in a
+ * dense array per node, so a binary search rarely has to touch the key
+ * or the record memory it points to.
+ *
+ * Inner separators are copies of the first key of their right subtree.
+ * Keys reference record memory that is freed after erase(), therefore
+ * erase() updates or removes the separator that refers to the erased key.
+ * Nodes are not merged on erase, empty nodes are released.
+ *
+ * Nodes that overflow at their right edge are not split in half but
+ * continued in a new node, so keys arriving in ascending order (sorted
+ * bulk loads) fill the nodes completely. insert( hint, key ) skips the
+ * descent if the key belongs right before the hint.
+ *
+ * Iterators are invalidated by insert() and erase().
+ ***/
+template< class KeyT, class TraitsT, class AllocT >
+class skv_btree_container_t
+{
+public:
+  typedef typename TraitsT::prefix_t prefix_t;
+  typedef KeyT                       key_type;
+  typedef KeyT                       value_type;
+  typedef size_t                     size_type;
+
+private:
+  struct node_t
+  {
+    int mIsLeaf;
+    int mCount;              // inner nodes have mCount+1 children
+  };
+
+  struct leaf_t : public node_t
+  {
+    leaf_t*  mPrev;
+    leaf_t*  mNext;
+    prefix_t mPrefix[ SKV_BTREE_LEAF_SLOTS ];
+    KeyT     mKeys[ SKV_BTREE_LEAF_SLOTS ];
+  };
+
+  struct inner_t : public node_t
+  {
+    prefix_t mPrefix[ SKV_BTREE_INNER_SLOTS ];
+    KeyT     mKeys[ SKV_BTREE_INNER_SLOTS ];
+    node_t*  mChild[ SKV_BTREE_INNER_SLOTS + 1 ];
+  };
+
+  struct path_t
+  {
+    inner_t* mNode;
+    int      mIndex;
+  };
+
+  node_t*   mRoot;
+  leaf_t*   mFirstLeaf;
+  leaf_t*   mLastLeaf;
+  size_type mSize;
+  int       mDepth;          // number of inner levels above the leaves
+
+public:
+  class iterator
+  {
+    friend class skv_btree_container_t;
+
+    leaf_t* mLeaf;
+    int     mSlot;
+
+    iterator( leaf_t* aLeaf, int aSlot )
+      : mLeaf( aLeaf ), mSlot( aSlot )
+    {
+      // skip forward if the slot is behind the last key of the leaf
+      while( mLeaf != NULL && mSlot >= mLeaf->mCount )
+      {
+        mLeaf = mLeaf->mNext;
+        mSlot = 0;
+      }
+    }
+
+  public:
+    iterator() : mLeaf( NULL ), mSlot( 0 ) {}
+
+    const KeyT&
+    operator*() const
+    {
+      return mLeaf->mKeys[ mSlot ];
+    }
+
+    const KeyT*
+    operator->() const
+    {
+      return &mLeaf->mKeys[ mSlot ];
+    }
+
+    iterator&
+    operator++()
+    {
+      mSlot++;
+      while( mLeaf != NULL && mSlot >= mLeaf->mCount )
+      {
+        mLeaf = mLeaf->mNext;
+        mSlot = 0;
+      }
+      return *this;
+    }
+
+    iterator
+    operator++( int )
+    {
+      iterator tmp = *this;
+      ++(*this);
+      return tmp;
+    }
+
+    bool
+    operator==( const iterator& aIter ) const
+    {
+      return ( mLeaf == aIter.mLeaf ) && ( mSlot == aIter.mSlot );
+    }
+
+    bool
+    operator!=( const iterator& aIter ) const
+    {
+      return !( *this == aIter );
+    }
+  };
+  typedef iterator const_iterator;
+
+  skv_btree_container_t()
+  {
+    mRoot = mFirstLeaf = mLastLeaf = NewLeaf();
+    mSize = 0;
+    mDepth = 0;
+  }
+
+  ~skv_btree_container_t()
+  {
+    FreeSubtree( mRoot, mDepth );
+  }
+
+  size_type
+  size() const
+  {
+    return mSize;
+  }
+
+  bool
+  empty() const
+  {
+    return ( mSize == 0 );
+  }
+
+  iterator
+  begin() const
+  {
+    return iterator( mFirstLeaf, 0 );
+  }
+
+  iterator
+  end() const
+  {
+    return iterator();
+  }
+
+  void
+  clear()
+  {
+    FreeSubtree( mRoot, mDepth );
+    mRoot = mFirstLeaf = mLastLeaf = NewLeaf();
+    mSize = 0;
+    mDepth = 0;
+  }
+
+  iterator
+  find( const KeyT& aKey ) const
+  {
+    prefix_t Prefix;
+    TraitsT::MakePrefix( aKey, &Prefix );
+
+    leaf_t* Leaf = Descend( aKey, Prefix, NULL );
+    int Slot = LowerSlot( Leaf, aKey, Prefix );
+
+    if( ( Slot < Leaf->mCount ) &&
+        ( TraitsT::Compare( Leaf->mKeys[ Slot ], Leaf->mPrefix[ Slot ], aKey, Prefix ) == 0 ) )
+      return iterator( Leaf, Slot );
+
+    return end();
+  }
+
+  iterator
+  lower_bound( const KeyT& aKey ) const
+  {
+    prefix_t Prefix;
+    TraitsT::MakePrefix( aKey, &Prefix );
+
+    leaf_t* Leaf = Descend( aKey, Prefix, NULL );
+    return iterator( Leaf, LowerSlot( Leaf, aKey, Prefix ) );
+  }
+
+  std::pair<iterator, bool>
+  insert( const KeyT& aKey )
+  {
+    prefix_t Prefix;
+    TraitsT::MakePrefix( aKey, &Prefix );
+
+    path_t Path[ SKV_BTREE_MAX_DEPTH ];
+    leaf_t* Leaf = Descend( aKey, Prefix, Path );
+    int Slot = LowerSlot( Leaf, aKey, Prefix );
+
+    if( ( Slot < Leaf->mCount ) &&
+        ( TraitsT::Compare( Leaf->mKeys[ Slot ], Leaf->mPrefix[ Slot ], aKey, Prefix ) == 0 ) )
+      return std::make_pair( iterator( Leaf, Slot ), false );
+
+    if( Leaf->mCount == SKV_BTREE_LEAF_SLOTS )
+    {
+      // appending at the right edge: keep the full leaf and start a new one
+      if( Slot == Leaf->mCount )
+      {
+        leaf_t* Right = SplitLeaf( Leaf, Leaf->mCount );
+        Right->mKeys[ 0 ] = aKey;
+        Right->mPrefix[ 0 ] = Prefix;
+        Right->mCount = 1;
+        mSize++;
+
+        InsertIntoParent( Path, mDepth - 1, Leaf, aKey, Prefix, Right );
+        return std::make_pair( iterator( Right, 0 ), true );
+      }
+
+      leaf_t* Right = SplitLeaf( Leaf, Leaf->mCount / 2 );
+      InsertIntoParent( Path, mDepth - 1, Leaf, Right->mKeys[ 0 ], Right->mPrefix[ 0 ], Right );
+
+      // the new key never becomes the first key of Right, so the separator stays valid
+      if( Slot > Leaf->mCount )
+      {
+        Slot -= Leaf->mCount;
+        Leaf = Right;
+      }
+    }
+
+    for( int i = Leaf->mCount; i > Slot; i-- )
+    {
+      Leaf->mKeys[ i ] = Leaf->mKeys[ i - 1 ];
+      Leaf->mPrefix[ i ] = Leaf->mPrefix[ i - 1 ];
+    }
+    Leaf->mKeys[ Slot ] = aKey;
+    Leaf->mPrefix[ Slot ] = Prefix;
+    Leaf->mCount++;
+    mSize++;
+
+    return std::make_pair( iterator( Leaf, Slot ), true );
+  }
+
+  // std::set semantics: aKey goes right before aHint. Sorted runs pass the
+  // successor of the previously inserted key (or end()). A wrong hint only
+  // costs the regular descent.
+  iterator
+  insert( iterator aHint, const KeyT& aKey )
+  {
+    leaf_t* Leaf = aHint.mLeaf;
+    int Slot = aHint.mSlot;
+
+    if( Leaf == NULL )
+    {
+      Leaf = mLastLeaf;
+      Slot = Leaf->mCount;
+    }
+
+    // a gap between two leaves belongs to the side the parent separator
+    // picks (which can be stale after erase), so leave that to the descent
+    if( ( Leaf->mCount < SKV_BTREE_LEAF_SLOTS ) &&
+        ( ( Slot > 0 ) || ( Leaf->mPrev == NULL ) ) &&
+        ( ( Slot < Leaf->mCount ) || ( Leaf->mNext == NULL ) ) )
+    {
+      prefix_t Prefix;
+      TraitsT::MakePrefix( aKey, &Prefix );
+
+      int Lower = -1;
+      if( Slot > 0 )
+      {
+        Lower = TraitsT::Compare( Leaf->mKeys[ Slot - 1 ], Leaf->mPrefix[ Slot - 1 ], aKey, Prefix );
+        if( Lower == 0 )
+          return iterator( Leaf, Slot - 1 );
+      }
+
+      int Upper = 1;
+      if( Slot < Leaf->mCount )
+      {
+        Upper = TraitsT::Compare( Leaf->mKeys[ Slot ], Leaf->mPrefix[ Slot ], aKey, Prefix );
+        if( Upper == 0 )
+          return iterator( Leaf, Slot );
+      }
+
+      if( ( Lower < 0 ) && ( Upper > 0 ) )
+      {
+        for( int i = Leaf->mCount; i > Slot; i-- )
+        {
+          Leaf->mKeys[ i ] = Leaf->mKeys[ i - 1 ];
+          Leaf->mPrefix[ i ] = Leaf->mPrefix[ i - 1 ];
+        }
+        Leaf->mKeys[ Slot ] = aKey;
+        Leaf->mPrefix[ Slot ] = Prefix;
+        Leaf->mCount++;
+        mSize++;
+
+        return iterator( Leaf, Slot );
+      }
+    }
+
+    return insert( aKey ).first;
+  }
+
+  size_type
+  erase( const KeyT& aKey )
+  {
+    prefix_t Prefix;
+    TraitsT::MakePrefix( aKey, &Prefix );
+
+    path_t Path[ SKV_BTREE_MAX_DEPTH ];
+    leaf_t* Leaf = Descend( aKey, Prefix, Path );
+    int Slot = LowerSlot( Leaf, aKey, Prefix );
+
+    if( ( Slot >= Leaf->mCount ) ||
+        ( TraitsT::Compare( Leaf->mKeys[ Slot ], Leaf->mPrefix[ Slot ], aKey, Prefix ) != 0 ) )
+      return 0;
+
+    for( int i = Slot; i < Leaf->mCount - 1; i++ )
+    {
+      Leaf->mKeys[ i ] = Leaf->mKeys[ i + 1 ];
+      Leaf->mPrefix[ i ] = Leaf->mPrefix[ i + 1 ];
+    }
+    Leaf->mCount--;
+    mSize--;
+
+    if( Slot == 0 )
+    {
+      // The erased key was the minimum of each subtree on the path up to the
+      // deepest ancestor where we did not descend into the leftmost child.
+      // That ancestor holds a copy of the key as separator. If the leaf ran
+      // empty, the successor lives in the next leaf; if there's no successor
+      // inside the subtree, the separator is dropped by RemoveLeaf() anyway.
+      leaf_t* MinLeaf = ( Leaf->mCount > 0 ) ? Leaf : Leaf->mNext;
+      for( int l = mDepth - 1; l >= 0; l-- )
+      {
+        if( Path[ l ].mIndex > 0 )
+        {
+          if( MinLeaf != NULL )
+          {
+            Path[ l ].mNode->mKeys[ Path[ l ].mIndex - 1 ] = MinLeaf->mKeys[ 0 ];
+            Path[ l ].mNode->mPrefix[ Path[ l ].mIndex - 1 ] = MinLeaf->mPrefix[ 0 ];
+          }
+          break;
+        }
+      }
+    }
+
+    if( ( Leaf->mCount == 0 ) && ( mDepth > 0 ) )
+      RemoveLeaf( Leaf, Path );
+
+    return 1;
+  }
+
+private:
+  static node_t*
+  AllocateNode( size_t aSize )
+  {
+    AllocT Allocator;
+    void* Mem = (void*) Allocator.allocate( aSize );
+
+    StrongAssertLogLine( Mem != NULL )
+      << "skv_btree_container_t::AllocateNode(): ERROR: Not enough memory for: "
+      << " size: " << aSize
+      << EndLogLine;
+
+    return (node_t*) Mem;
+  }
+
+  static leaf_t*
+  NewLeaf()
+  {
+    leaf_t* Leaf = new ( AllocateNode( sizeof( leaf_t ) ) ) leaf_t();
+    Leaf->mIsLeaf = 1;
+    Leaf->mCount = 0;
+    Leaf->mPrev = NULL;
+    Leaf->mNext = NULL;
+    return Leaf;
+  }
+
+  static inner_t*
+  NewInner()
+  {
+    inner_t* Inner = new ( AllocateNode( sizeof( inner_t ) ) ) inner_t();
+    Inner->mIsLeaf = 0;
+    Inner->mCount = 0;
+    return Inner;
+  }
+
+  static void
+  FreeNode( node_t* aNode )
+  {
+    AllocT Allocator;
+    if( aNode->mIsLeaf )
+    {
+      ((leaf_t*) aNode)->~leaf_t();
+      Allocator.deallocate( (char*) aNode, sizeof( leaf_t ) );
+    }
+    else
+    {
+      ((inner_t*) aNode)->~inner_t();
+      Allocator.deallocate( (char*) aNode, sizeof( inner_t ) );
+    }
+  }
+
+  static void
+  FreeSubtree( node_t* aNode, int aDepth )
+  {
+    if( aDepth > 0 )
+    {
+      inner_t* Inner = (inner_t*) aNode;
+      for( int i = 0; i <= Inner->mCount; i++ )
+        FreeSubtree( Inner->mChild[ i ], aDepth - 1 );
+    }
+    FreeNode( aNode );
+  }
+
+  // first slot with key >= aKey
+  template< class NodeT >
+  static int
+  LowerSlot( const NodeT* aNode, const KeyT& aKey, const prefix_t& aPrefix )
+  {
+    int Lo = 0;
+    int Hi = aNode->mCount;
+    while( Lo < Hi )
+    {
+      int Mid = ( Lo + Hi ) >> 1;
+      if( TraitsT::Compare( aNode->mKeys[ Mid ], aNode->mPrefix[ Mid ], aKey, aPrefix ) < 0 )
+        Lo = Mid + 1;
+      else
+        Hi = Mid;
+    }
+    return Lo;
+  }
+
+  // first slot with key > aKey
+  template< class NodeT >
+  static int
+  UpperSlot( const NodeT* aNode, const KeyT& aKey, const prefix_t& aPrefix )
+  {
+    int Lo = 0;
+    int Hi = aNode->mCount;
+    while( Lo < Hi )
+    {
+      int Mid = ( Lo + Hi ) >> 1;
+      if( TraitsT::Compare( aNode->mKeys[ Mid ], aNode->mPrefix[ Mid ], aKey, aPrefix ) <= 0 )
+        Lo = Mid + 1;
+      else
+        Hi = Mid;
+    }
+    return Lo;
+  }
+
+  leaf_t*
+  Descend( const KeyT& aKey, const prefix_t& aPrefix, path_t* aPath ) const
+  {
+    node_t* Node = mRoot;
+    for( int l = 0; l < mDepth; l++ )
+    {
+      inner_t* Inner = (inner_t*) Node;
+      int Index = UpperSlot( Inner, aKey, aPrefix );
+      if( aPath != NULL )
+      {
+        aPath[ l ].mNode = Inner;
+        aPath[ l ].mIndex = Index;
+      }
+      Node = Inner->mChild[ Index ];
+    }
+    return (leaf_t*) Node;
+  }
+
+  // moves the keys from aKeep on into a new right neighbour
+  leaf_t*
+  SplitLeaf( leaf_t* aLeaf, int aKeep )
+  {
+    leaf_t* Right = NewLeaf();
+
+    for( int i = aKeep; i < aLeaf->mCount; i++ )
+    {
+      Right->mKeys[ i - aKeep ] = aLeaf->mKeys[ i ];
+      Right->mPrefix[ i - aKeep ] = aLeaf->mPrefix[ i ];
+    }
+    Right->mCount = aLeaf->mCount - aKeep;
+    aLeaf->mCount = aKeep;
+
+    Right->mNext = aLeaf->mNext;
+    Right->mPrev = aLeaf;
+    if( aLeaf->mNext != NULL )
+      aLeaf->mNext->mPrev = Right;
+    else
+      mLastLeaf = Right;
+    aLeaf->mNext = Right;
+
+    return Right;
+  }
+
+  static void
+  InsertIntoInner( inner_t* aInner, int aIndex, const KeyT& aKey, const prefix_t& aPrefix, node_t* aRight )
+  {
+    for( int i = aInner->mCount; i > aIndex; i-- )
+    {
+      aInner->mKeys[ i ] = aInner->mKeys[ i - 1 ];
+      aInner->mPrefix[ i ] = aInner->mPrefix[ i - 1 ];
+      aInner->mChild[ i + 1 ] = aInner->mChild[ i ];
+    }
+    aInner->mKeys[ aIndex ] = aKey;
+    aInner->mPrefix[ aIndex ] = aPrefix;
+    aInner->mChild[ aIndex + 1 ] = aRight;
+    aInner->mCount++;
+  }
+
+  // link aRight as right neighbour of aLeft which sits at aPath[ aLevel ]
+  void
+  InsertIntoParent( path_t* aPath, int aLevel, node_t* aLeft, const KeyT& aKey, const prefix_t& aPrefix, node_t* aRight )
+  {
+    if( aLevel < 0 )
+    {
+      StrongAssertLogLine( mDepth < SKV_BTREE_MAX_DEPTH )
+        << "skv_btree_container_t::InsertIntoParent(): ERROR: tree too deep"
+        << " mDepth: " << mDepth
+        << " mSize: " << mSize
+        << EndLogLine;
+
+      inner_t* Root = NewInner();
+      Root->mKeys[ 0 ] = aKey;
+      Root->mPrefix[ 0 ] = aPrefix;
+      Root->mChild[ 0 ] = aLeft;
+      Root->mChild[ 1 ] = aRight;
+      Root->mCount = 1;
+      mRoot = Root;
+      mDepth++;
+      return;
+    }
+
+    inner_t* Parent = aPath[ aLevel ].mNode;
+    int Index = aPath[ aLevel ].mIndex;
+
+    if( Parent->mCount < SKV_BTREE_INNER_SLOTS )
+    {
+      InsertIntoInner( Parent, Index, aKey, aPrefix, aRight );
+      return;
+    }
+
+    // split the full parent: the middle separator moves up, or the last
+    // one if the new child is appended at the right edge
+    inner_t* NewRight = NewInner();
+    int Mid = ( Index == Parent->mCount ) ? Parent->mCount - 1 : Parent->mCount / 2;
+
+    KeyT UpKey = Parent->mKeys[ Mid ];
+    prefix_t UpPrefix = Parent->mPrefix[ Mid ];
+
+    for( int i = Mid + 1; i < Parent->mCount; i++ )
+    {
+      NewRight->mKeys[ i - Mid - 1 ] = Parent->mKeys[ i ];
+      NewRight->mPrefix[ i - Mid - 1 ] = Parent->mPrefix[ i ];
+    }
+    for( int i = Mid + 1; i <= Parent->mCount; i++ )
+      NewRight->mChild[ i - Mid - 1 ] = Parent->mChild[ i ];
+
+    NewRight->mCount = Parent->mCount - Mid - 1;
+    Parent->mCount = Mid;
+
+    if( Index <= Mid )
+      InsertIntoInner( Parent, Index, aKey, aPrefix, aRight );
+    else
+      InsertIntoInner( NewRight, Index - Mid - 1, aKey, aPrefix, aRight );
+
+    InsertIntoParent( aPath, aLevel - 1, Parent, UpKey, UpPrefix, NewRight );
+  }
+
+  void
+  RemoveLeaf( leaf_t* aLeaf, path_t* aPath )
+  {
+    if( aLeaf->mPrev != NULL )
+      aLeaf->mPrev->mNext = aLeaf->mNext;
+    else
+      mFirstLeaf = aLeaf->mNext;
+    if( aLeaf->mNext != NULL )
+      aLeaf->mNext->mPrev = aLeaf->mPrev;
+    else
+      mLastLeaf = aLeaf->mPrev;
+
+    // release the empty leaf and every ancestor that has no other child
+    node_t* Victim = aLeaf;
+    for( int l = mDepth - 1; l >= 0; l-- )
+    {
+      inner_t* Parent = aPath[ l ].mNode;
+      int Index = aPath[ l ].mIndex;
+
+      FreeNode( Victim );
+
+      if( Parent->mCount > 0 )
+      {
+        // drop the separator left of the child (or right of it for child 0)
+        int KeyIndex = ( Index > 0 ) ? Index - 1 : 0;
+        for( int i = KeyIndex; i < Parent->mCount - 1; i++ )
+        {
+          Parent->mKeys[ i ] = Parent->mKeys[ i + 1 ];
+          Parent->mPrefix[ i ] = Parent->mPrefix[ i + 1 ];
+        }
+        for( int i = Index; i < Parent->mCount; i++ )
+          Parent->mChild[ i ] = Parent->mChild[ i + 1 ];
+        Parent->mCount--;
+        break;
+      }
+
+      Victim = Parent;
+    }
+
+    // collapse roots that are left with a single child
+    while( ( mDepth > 0 ) && ( mRoot->mCount == 0 ) )
+    {
+      node_t* Child = ((inner_t*) mRoot)->mChild[ 0 ];
+      FreeNode( mRoot );
+      mRoot = Child;
+      mDepth--;
+    }
+  }
+};
+
+#endif // __SKV_SERVER_BTREE_CONTAINER_HPP__
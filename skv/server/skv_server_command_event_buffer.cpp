@@ -125,6 +125,15 @@ skv_server_command_event_buffer_list_t::PrepareEvent( skv_server_event_t *curren
 
       break;
     }
+    case SKV_COMMAND_MULTI_KEY:
+    {
+      currentEvent->Init( SKV_SERVER_EVENT_TYPE_IT_DTO_MULTI_KEY_CMD,
+                          aEPState,
+                          CmdOrd,
+                          CmdEventType );
+
+      break;
+    }
     case SKV_COMMAND_RETRIEVE:
     {
       currentEvent->Init( SKV_SERVER_EVENT_TYPE_IT_DTO_RETRIEVE_CMD,
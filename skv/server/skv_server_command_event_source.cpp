@@ -136,11 +136,31 @@ void* skv_server_command_event_source_t::CommandFetchThread( void *aArgs )
     << "CommandFetchThread running..."
     << EndLogLine;
 
+  uint64_t IdlePolls = 0;
+  uint64_t Sleep = 1;
+
   while ( args->mKeepRunning )
   {
+    uint64_t CmdCounter = buffers->mCmdCounter;
+
     skv_server_ep_state_t *EPState = CEPM->GetNextEPStateAndFreezeForProcessing();
     buffers->FillCurrentEventBuffer( EPState );
     CEPM->UnfreezeAfterProcessing();
+
+    if( buffers->mCmdCounter != CmdCounter )
+    {
+      skv_server_doorbell_t *Doorbell = args->mDoorbell;
+      if( Doorbell != NULL )
+        Doorbell->Ring();
+
+      IdlePolls = 0;
+      Sleep = 1;
+    }
+    else if(( args->mPollMaxSleep > 0 ) && ( ++IdlePolls > args->mPollSpin ))
+    {
+      usleep( Sleep );
+      Sleep = std::min( Sleep * 2, args->mPollMaxSleep );
+    }
   }
   return NULL;
 }
@@ -14,6 +14,12 @@
 #ifndef __SKV_SERVER_COMMAND_EVENT_SOURCE_HPP__
 #define __SKV_SERVER_COMMAND_EVENT_SOURCE_HPP__
 
+// the fetch thread is the only one that notices new commands, its backoff
+// adds directly to the request latency of an idle server, so keep it short
+#ifndef SKV_SERVER_COMMAND_FETCH_MAX_SLEEP
+#define SKV_SERVER_COMMAND_FETCH_MAX_SLEEP ( 16 )
+#endif
+
 class skv_server_command_event_source_t;
 
 struct skv_server_command_thread_args_t
@@ -23,6 +29,9 @@ struct skv_server_command_thread_args_t
   pthread_mutex_t mMutex;
   int mMaxEventCount;
   volatile bool mKeepRunning;
+  skv_server_doorbell_t * volatile mDoorbell;
+  uint64_t mPollSpin;       // empty polls before the thread backs off
+  uint64_t mPollMaxSleep;   // usec, 0: busy polling
 };
 
 class skv_server_command_event_source_t :
@@ -43,6 +52,9 @@ public:
     mCommandFetchArgs.mEventSource = this;
     mCommandFetchArgs.mKeepRunning = true;
     mCommandFetchArgs.mMaxEventCount = SKV_SERVER_EVENTS_MAX_COUNT;
+    mCommandFetchArgs.mDoorbell = NULL;
+    mCommandFetchArgs.mPollSpin = 0;
+    mCommandFetchArgs.mPollMaxSleep = 0;
 
     if( GetEventManager() != NULL )
       pthread_create( &mPollThread, NULL, CommandFetchThread, (void*)&mCommandFetchArgs );
@@ -62,6 +74,27 @@ public:
             int* aEventCount,
             int aMaxEventCount );
 
+  // commands found by the fetch thread that haven't been picked up yet
+  virtual int
+  GetPendingCount() { return (int)( mBufferList.mCmdCounter - mBufferList.mFtcCounter ); }
+
+  // a ready buffer can only be delivered as a whole
+  virtual int
+  GetMinEventCount() { return SKV_SERVER_EVENTS_MAX_COUNT; }
+
+  // rung by the fetch thread when it found new commands
+  virtual void
+  SetDoorbell( skv_server_doorbell_t *aDoorbell ) { mCommandFetchArgs.mDoorbell = aDoorbell; }
+
+  // let the fetch thread sleep (exponential backoff up to aMaxSleep usec,
+  // capped at SKV_SERVER_COMMAND_FETCH_MAX_SLEEP) after aSpin polls without a new command
+  void
+  SetPollBackoff( uint64_t aSpin, uint64_t aMaxSleep )
+  {
+    mCommandFetchArgs.mPollSpin = aSpin;
+    mCommandFetchArgs.mPollMaxSleep = std::min( aMaxSleep, (uint64_t)SKV_SERVER_COMMAND_FETCH_MAX_SLEEP );
+  }
+
   static void* CommandFetchThread( void *aArgs );
 };
 
@@ -0,0 +1,100 @@
+/************************************************
+ * Copyright (c) IBM Corp. 2014
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * which accompanies this distribution, and is available at
+ * http://www.eclipse.org/legal/epl-v10.html
+ *************************************************/
+
+/*
+ * Wakeup of an idle server main loop
+ * The main loop announces that it's about to sleep (PrepareWait), polls
+ * its event sources once more and only then blocks on the eventfd.
+ * Producers (command fetch thread, local kv workers, other reactors) call
+ * Ring() after their event became visible. Ring() only writes to the
+ * eventfd if somebody announced a wait, so it's a fence and a load while
+ * the main loop is busy.
+ */
+
+#ifndef __SKV_SERVER_DOORBELL_HPP__
+#define __SKV_SERVER_DOORBELL_HPP__
+
+#include <atomic>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+#include <FxLogger.hpp>
+
+#ifndef SKV_SERVER_DOORBELL_LOG
+#define SKV_SERVER_DOORBELL_LOG ( 0 | SKV_LOGGING_ALL )
+#endif
+
+class skv_server_doorbell_t
+{
+  int              mFd;
+  std::atomic<int> mWaiters;
+
+public:
+  skv_server_doorbell_t() : mFd( -1 ), mWaiters( 0 ) {}
+  ~skv_server_doorbell_t()
+  {
+    if( mFd >= 0 )
+      close( mFd );
+  }
+
+  skv_status_t Init()
+  {
+    mFd = eventfd( 0, EFD_NONBLOCK | EFD_CLOEXEC );
+    if( mFd < 0 )
+    {
+      BegLogLine( 1 )
+        << "skv_server_doorbell_t::Init(): ERROR: eventfd failed"
+        << " errno: " << errno
+        << EndLogLine;
+      return SKV_ERRNO_UNSPECIFIED_ERROR;
+    }
+    return SKV_SUCCESS;
+  }
+
+  inline int GetFd() const { return mFd; }
+
+  // producer side: call after the event is visible to the main loop
+  inline void Ring()
+  {
+    // orders the publication of the event before the check for waiters
+    // (pairs with the fetch_add in PrepareWait)
+    std::atomic_thread_fence( std::memory_order_seq_cst );
+    if( mWaiters.load( std::memory_order_relaxed ) == 0 )
+      return;
+
+    BegLogLine( SKV_SERVER_DOORBELL_LOG )
+      << "skv_server_doorbell_t::Ring(): waking up fd: " << mFd
+      << EndLogLine;
+
+    uint64_t one = 1;
+    ssize_t rc = write( mFd, &one, sizeof( one ) );
+    (void) rc;
+  }
+
+  // consumer side: PrepareWait(), poll all sources once more, then
+  // block on GetFd() and call EndWait() in any case
+  inline void PrepareWait()
+  {
+    mWaiters.fetch_add( 1, std::memory_order_seq_cst );
+  }
+
+  inline void EndWait()
+  {
+    mWaiters.fetch_sub( 1, std::memory_order_relaxed );
+  }
+
+  // reset the eventfd after a wakeup
+  inline void Drain()
+  {
+    uint64_t count;
+    ssize_t rc = read( mFd, &count, sizeof( count ) );
+    (void) rc;
+  }
+};
+
+#endif // __SKV_SERVER_DOORBELL_HPP__
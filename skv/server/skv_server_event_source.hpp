@@ -42,6 +42,22 @@ public:
   inline
   int GetPriority() { return mPriority; }
 
+  // number of events that are ready to be fetched or -1 if the source can't tell
+  virtual
+  int GetPendingCount() { return -1; }
+
+  // smallest aMaxEventCount that GetEvent() accepts
+  virtual
+  int GetMinEventCount() { return 1; }
+
+  // doorbell to ring when new events show up while the main loop is idle
+  virtual
+  void SetDoorbell( skv_server_doorbell_t *aDoorbell ) { }
+
+  // called before the main loop goes to sleep (to re-arm one-shot notifications)
+  virtual
+  void PrepareWait() { }
+
   virtual ~skv_server_generic_event_source_t() { };
 };
 
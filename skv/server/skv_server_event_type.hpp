@@ -69,6 +69,7 @@ typedef enum
 
   SKV_SERVER_EVENT_TYPE_ACTIVE_BCAST_CMD,                       // 45
   SKV_SERVER_EVENT_TYPE_CURSOR_PREFETCH_CMD,
+  SKV_SERVER_EVENT_TYPE_IT_DTO_MULTI_KEY_CMD,
 
   SKV_SERVER_EVENT_TYPE_LOCAL_KV_CMPL,
   SKV_SERVER_EVENT_TYPE_LOCAL_KV_ERROR,
@@ -130,6 +131,7 @@ skv_server_event_type_to_string( skv_server_event_type_t aType )
     case SKV_SERVER_EVENT_TYPE_IT_DTO_PDSCNTL_CMD: { return "SKV_SERVER_EVENT_TYPE_IT_DTO_PDSCNTL_CMD";}
     case SKV_SERVER_EVENT_TYPE_ACTIVE_BCAST_CMD: { return "SKV_SERVER_EVENT_TYPE_ACTIVE_BCAST_CMD";}
     case SKV_SERVER_EVENT_TYPE_CURSOR_PREFETCH_CMD: { return "SKV_SERVER_EVENT_TYPE_CURSOR_PREFETCH_CMD";}
+    case SKV_SERVER_EVENT_TYPE_IT_DTO_MULTI_KEY_CMD: { return "SKV_SERVER_EVENT_TYPE_IT_DTO_MULTI_KEY_CMD";}
     case SKV_SERVER_EVENT_TYPE_LOCAL_KV_CMPL: { return "SKV_SERVER_EVENT_TYPE_LOCAL_KV_CMPL"; }
     case SKV_SERVER_EVENT_TYPE_LOCAL_KV_ERROR: { return "SKV_SERVER_EVENT_TYPE_LOCAL_KV_ERROR"; }
     case SKV_SERVER_EVENT_TYPE_LOCAL_KV_ASYNC_ERROR: { return "SKV_SERVER_EVENT_TYPE_LOCAL_KV_ASYNC_ERROR"; }
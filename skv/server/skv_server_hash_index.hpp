@@ -0,0 +1,208 @@
+/************************************************
+ * Copyright (c) IBM Corp. 2014
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * which accompanies this distribution, and is available at
+ * http://www.eclipse.org/legal/epl-v10.html
+ *************************************************/
+
+/*
+ * Open-addressing hash index for exact-key lookups of a PDS.
+ * Entries point into the record storage of the tree based container
+ * (record = { key, value }), the index holds no copies of keys or values.
+ */
+
+#ifndef __SKV_SERVER_HASH_INDEX_HPP__
+#define __SKV_SERVER_HASH_INDEX_HPP__
+
+#include <cstdlib>
+#include <cstring>
+#include <stdint.h>
+#include <FxLogger.hpp>
+
+#ifndef SKV_LOGGING_ALL
+#define SKV_LOGGING_ALL ( 0 )
+#endif
+
+#ifndef SKV_SERVER_HASH_INDEX_LOG
+#define SKV_SERVER_HASH_INDEX_LOG ( 0 | SKV_LOGGING_ALL )
+#endif
+
+#define SKV_HASH_INDEX_INITIAL_CAPACITY ( 1024 )
+
+// grow when more than 7/10 of the slots are used
+#define SKV_HASH_INDEX_LOAD_NUM ( 7 )
+#define SKV_HASH_INDEX_LOAD_DEN ( 10 )
+
+struct skv_hash_index_entry_t
+{
+  char*    mRecord;      // NULL marks an empty slot
+  uint32_t mHash;
+  int      mKeySize;
+  int      mValueSize;
+};
+
+class skv_hash_index_t
+{
+  skv_hash_index_entry_t* mTable;
+  size_t                  mCapacity;   // always a power of 2
+  size_t                  mCount;
+
+  // FNV-1a; the distribution hash can't be reused here because every key
+  // on this server maps to the same residue of it
+  static
+  uint32_t
+  Hash( const char* aKey, int aKeySize )
+  {
+    uint32_t h = 2166136261u;
+    for( int i = 0; i < aKeySize; i++ )
+    {
+      h ^= (unsigned char) aKey[ i ];
+      h *= 16777619u;
+    }
+    return h;
+  }
+
+  size_t
+  Find( const char* aKey, int aKeySize, uint32_t aHash ) const
+  {
+    size_t Mask = mCapacity - 1;
+    size_t Slot = aHash & Mask;
+    while( mTable[ Slot ].mRecord != NULL )
+    {
+      skv_hash_index_entry_t *Entry = &mTable[ Slot ];
+      if( ( Entry->mHash == aHash ) &&
+          ( Entry->mKeySize == aKeySize ) &&
+          ( memcmp( Entry->mRecord, aKey, aKeySize ) == 0 ) )
+        return Slot;
+      Slot = ( Slot + 1 ) & Mask;
+    }
+    return mCapacity;
+  }
+
+  void
+  Place( const skv_hash_index_entry_t& aEntry )
+  {
+    size_t Mask = mCapacity - 1;
+    size_t Slot = aEntry.mHash & Mask;
+    while( mTable[ Slot ].mRecord != NULL )
+      Slot = ( Slot + 1 ) & Mask;
+    mTable[ Slot ] = aEntry;
+  }
+
+  void
+  Grow()
+  {
+    skv_hash_index_entry_t* OldTable = mTable;
+    size_t OldCapacity = mCapacity;
+
+    mCapacity *= 2;
+    mTable = (skv_hash_index_entry_t*) calloc( mCapacity, sizeof( skv_hash_index_entry_t ) );
+
+    StrongAssertLogLine( mTable != NULL )
+      << "skv_hash_index_t::Grow(): ERROR: Not enough memory for: "
+      << " capacity: " << mCapacity
+      << EndLogLine;
+
+    for( size_t i = 0; i < OldCapacity; i++ )
+      if( OldTable[ i ].mRecord != NULL )
+        Place( OldTable[ i ] );
+
+    free( OldTable );
+
+    BegLogLine( SKV_SERVER_HASH_INDEX_LOG )
+      << "skv_hash_index_t::Grow(): "
+      << " mCapacity: " << mCapacity
+      << " mCount: " << mCount
+      << EndLogLine;
+  }
+
+public:
+  skv_hash_index_t()
+  {
+    mCapacity = SKV_HASH_INDEX_INITIAL_CAPACITY;
+    mCount = 0;
+    mTable = (skv_hash_index_entry_t*) calloc( mCapacity, sizeof( skv_hash_index_entry_t ) );
+
+    StrongAssertLogLine( mTable != NULL )
+      << "skv_hash_index_t(): ERROR: Not enough memory for: "
+      << " capacity: " << mCapacity
+      << EndLogLine;
+  }
+
+  ~skv_hash_index_t()
+  {
+    free( mTable );
+  }
+
+  size_t
+  GetCount() const
+  {
+    return mCount;
+  }
+
+  /***
+   * returns the entry of the key or NULL if the key is not indexed
+   ***/
+  const skv_hash_index_entry_t*
+  Lookup( const char* aKey, int aKeySize ) const
+  {
+    size_t Slot = Find( aKey, aKeySize, Hash( aKey, aKeySize ) );
+    return ( Slot < mCapacity ) ? &mTable[ Slot ] : NULL;
+  }
+
+  /***
+   * adds a record { key, value } to the index
+   * the caller makes sure the key is not yet indexed
+   ***/
+  void
+  Insert( char* aRecord, int aKeySize, int aValueSize )
+  {
+    if( ( mCount + 1 ) * SKV_HASH_INDEX_LOAD_DEN > mCapacity * SKV_HASH_INDEX_LOAD_NUM )
+      Grow();
+
+    skv_hash_index_entry_t Entry;
+    Entry.mRecord = aRecord;
+    Entry.mHash = Hash( aRecord, aKeySize );
+    Entry.mKeySize = aKeySize;
+    Entry.mValueSize = aValueSize;
+
+    Place( Entry );
+    mCount++;
+  }
+
+  /***
+   * removes the key from the index
+   * uses backward-shift deletion, so there are no tombstones to clean up
+   ***/
+  int
+  Remove( const char* aKey, int aKeySize )
+  {
+    size_t Hole = Find( aKey, aKeySize, Hash( aKey, aKeySize ) );
+    if( Hole >= mCapacity )
+      return 0;
+
+    size_t Mask = mCapacity - 1;
+    size_t Slot = ( Hole + 1 ) & Mask;
+    while( mTable[ Slot ].mRecord != NULL )
+    {
+      size_t Home = mTable[ Slot ].mHash & Mask;
+
+      // move the entry into the hole unless its home lies cyclically in ( Hole, Slot ]
+      bool Stays = ( Hole <= Slot ) ? ( ( Home > Hole ) && ( Home <= Slot ) )
+                                    : ( ( Home > Hole ) || ( Home <= Slot ) );
+      if( !Stays )
+      {
+        mTable[ Hole ] = mTable[ Slot ];
+        Hole = Slot;
+      }
+      Slot = ( Slot + 1 ) & Mask;
+    }
+    mTable[ Hole ].mRecord = NULL;
+    mCount--;
+
+    return 1;
+  }
+};
+
+#endif // __SKV_SERVER_HASH_INDEX_HPP__
@@ -24,6 +24,12 @@
 #include <sys/mman.h>
 #include <unistd.h>
 #include <math.h>
+#include <algorithm>
+#include <pthread.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <string>
+#include <skv/common/skv_mutex.hpp>
 
 #ifndef SKV_LOGGING_ALL
 #define SKV_LOGGING_ALL ( 0 )
@@ -38,10 +44,28 @@
 #endif
 
 #define PERSISTENT_FILEPATH_MAX_SIZE            512
-#define PERSISTENT_MAGIC_NUMBER                 0xfaceb0b1
+// bump with every change of the image layout (header, container, PDS tables)
+#define PERSISTENT_MAGIC_NUMBER                 0xfaceb0b2
+#define PERSISTENT_MAGIC_NUMBER_V1              0xfaceb0b1
 #define IONODE_IP                               "10.255.255.254"
 #define MY_HOSTNAME_SIZE 128
 
+/* The image stores absolute pointers (dlmalloc mspace, PDS tables, index),
+ * so a restart has to map it at the address it was created at.
+ * The heap is placed at a well-known address away from the regions the
+ * kernel hands out for (randomized) mmaps and shared libraries.
+ */
+#ifndef SKV_SERVER_HEAP_MAP_ADDR
+#if ( __SIZEOF_POINTER__ == 8 )
+#define SKV_SERVER_HEAP_MAP_ADDR ( 0x500000000000ull )
+#else
+#define SKV_SERVER_HEAP_MAP_ADDR ( 0 )
+#endif
+#endif
+
+// all-zero chunks of this size are left as holes in a dumped image
+#define SKV_SERVER_IMAGE_CHUNK_SIZE ( 1024 * 1024 )
+
 static
 int
 read_from_file( int sock, char * buff, int len )
@@ -69,6 +93,42 @@ read_from_file( int sock, char * buff, int len )
   return BytesRead;
 }
 
+static
+int
+write_to_file( int fd, const char * buff, size_t len, off_t offset )
+{
+  size_t BytesWritten = 0;
+  while( BytesWritten < len )
+  {
+    ssize_t write_rc = pwrite( fd,
+                               buff + BytesWritten,
+                               len - BytesWritten,
+                               offset + BytesWritten );
+    if( write_rc < 0 )
+    {
+      if( errno == EINTR )
+        continue;
+      return -1;
+    }
+    BytesWritten += write_rc;
+  }
+  return 0;
+}
+
+static
+bool
+is_zero_memory( const char * buff, size_t len )
+{
+  const uint64_t *Words = (const uint64_t*) buff;
+  for( size_t i = 0; i < len / sizeof( uint64_t ); i++ )
+    if( Words[ i ] != 0 )
+      return false;
+  for( size_t i = len & ~( sizeof( uint64_t ) - 1 ); i < len; i++ )
+    if( buff[ i ] != 0 )
+      return false;
+  return true;
+}
+
 struct skv_server_persistance_heap_hdr_t
 {
   void*             mDataMap;
@@ -86,6 +146,10 @@ struct skv_server_persistance_heap_hdr_t
   char*              mMspaceBase;
   unsigned long      mMspaceLen;
   mspace             mMspace;
+
+  int                mDataContainerType;
+  int                mDataContainerVersion;
+  int                mDataMapShards;
 };
 
 typedef enum
@@ -105,6 +169,10 @@ class skv_server_heap_manager_t
 
   static  int      mFd;
 
+  // the mspace is created without dlmalloc locking,
+  // backends with several worker threads allocate concurrently
+  static  skv_mutex_t mAllocLock;
+
 public:
 
   static
@@ -114,7 +182,9 @@ public:
 #ifdef DEBUG_USE_GLIBC_MALLOC
     void* Ptr = malloc( bytes );
 #else
+    mAllocLock.lock();
     void* Ptr = mspace_malloc( mMspace, bytes );
+    mAllocLock.unlock();
 #endif
 
     StrongAssertLogLine( Ptr != NULL )
@@ -143,7 +213,9 @@ public:
 #ifdef DEBUG_USE_GLIBC_MALLOC
       free(addr) ;
 #else
+    mAllocLock.lock();
     mspace_free( mMspace, addr );
+    mAllocLock.unlock();
 #endif
   }
 
@@ -164,6 +236,35 @@ public:
       << " errno: " << errno
       << EndLogLine;
   }
+  /*
+   * maps the heap at aAddr, never on top of an existing mapping
+   * returns MAP_FAILED if the address range is in use
+   */
+  static
+  char*
+  MapHeap( char* aAddr, int aFlags, int aFd )
+  {
+#ifdef MAP_FIXED_NOREPLACE
+    if( aAddr != NULL )
+      aFlags |= MAP_FIXED_NOREPLACE;
+#endif
+    char* Mem = (char *) mmap( aAddr,
+                               mTotalLen,
+                               PROT_READ | PROT_WRITE,
+                               aFlags,
+                               aFd,
+                               0 );
+
+    // kernels without MAP_FIXED_NOREPLACE treat the address as a hint
+    if( ( Mem != MAP_FAILED ) && ( aAddr != NULL ) && ( Mem != aAddr ) )
+    {
+      munmap( Mem, mTotalLen );
+      Mem = (char *) MAP_FAILED;
+      errno = EEXIST;
+    }
+    return Mem;
+  }
+
   static
   void
   Dump( char* aPath )
@@ -180,163 +281,65 @@ public:
 
     sprintf( persistentFilename, "%s/%s.%d", aPath, config->GetServerPersistentFilename(), MyRank );
 
-    char ScpCommand[ 512 ];
-    bzero( ScpCommand, 512 );
+    /* raw image of the heap that a restart can map directly
+     * zero chunks become holes, so the file only occupies the used part of the heap
+     * written to a temp file first: a restarted server may still have the old image mapped
+     */
+    std::string TmpFilename = std::string( persistentFilename ) + ".tmp";
 
-    char MyHostname[ MY_HOSTNAME_SIZE ];
-    bzero( MyHostname, MY_HOSTNAME_SIZE );
-    gethostname( MyHostname, MY_HOSTNAME_SIZE );
+    int fd = open( TmpFilename.c_str(),
+                   O_WRONLY | O_CREAT | O_TRUNC,
+                   S_IRUSR | S_IWUSR );
 
-    if( strcmp( MyHostname, "asfhost00" ) == 0 )
-    {
-      sprintf( ScpCommand,
-               "tar -czf - %s.%d | dd of=%s",
-               //"cp %s.%d %s",
-               config->GetServerPersistentFileLocalPath(),
-               MyRank,
-               persistentFilename );
-    }
-    else
-    {
-      // tar -czf - myfile | rsh 10.255.255.254 dd of=/gpfs/gpfs/packedfile.mynode
-#if 0
-      sprintf( ScpCommand,
-               // "tar -czf - %s.%d | rsh %s dd of=%s",
-               "tar -czf - %s.%d | rsh %s \"cat > %s\"",
-               config->GetServerPersistentFileLocalPath(),
-               MyRank,
-               IONODE_IP,
-               persistentFilename );
-#else
-      sprintf( ScpCommand,
-               // "rcp %s.%d %s:%s",
-               "tar -czf %s %s.%d",
-               persistentFilename,
-               config->GetServerPersistentFileLocalPath(),
-               MyRank );
-#endif
-    }
-    //     sprintf( ScpCommand,
-    //              "rcp %s %s:%s",
-    //              PERSISTENT_FILE_LOCAL_PATH,
-    //              IONODE_IP,
-    //              persistentFilename );
-
-    BegLogLine( SKV_SERVER_HEAP_MANAGER_LOG )
-      << "Dump(): "
-      << " ScpCommand: " << ScpCommand
-      << EndLogLine;
-
-    system( ScpCommand );
-
-    BegLogLine( SKV_SERVER_HEAP_MANAGER_LOG )
-      << "Dump(): rcp finished "
-      << EndLogLine;
-
-#if 0
-    bzero( mMemoryAllocation,  mTotalLen );
-    rc = munmap( mMemoryAllocation, mTotalLen );
-    StrongAssertLogLine( rc == 0 )
-      << "ERROR: rc: " << rc
+    StrongAssertLogLine( fd >= 0 )
+      << "Dump(): ERROR: Failed to open file: " << TmpFilename.c_str()
       << " errno: " << errno
       << EndLogLine;
 
-    rc = close( mFd );
+    int rc = ftruncate64( fd, mTotalLen );
+
     StrongAssertLogLine( rc == 0 )
-      << "ERROR: rc: " << rc
+      << "Dump(): ERROR: ftruncate failed: "
       << " errno: " << errno
       << EndLogLine;
 
-    char PersistentLocalFilePath[ 128 ];
-    sprintf( PersistentLocalFilePath, "%s.%d", config->GetServerPersistentFileLocalPath(), MyRank );
-
-    unlink( PersistentLocalFilePath );
-
-    // Copy the file from the ionode
-
-    bzero( ScpCommand, 512 );
-
-    char MyHostname[ MY_HOSTNAME_SIZE ];
-    bzero( MyHostname, MY_HOSTNAME_SIZE );
-    gethostname( MyHostname, MY_HOSTNAME_SIZE );
-
-    if( strcmp( MyHostname, "asfhost00" ) == 0 )
+    uint64_t Written = 0;
+    for( uint64_t Offset = 0; Offset < mTotalLen; Offset += SKV_SERVER_IMAGE_CHUNK_SIZE )
     {
-      sprintf( ScpCommand,
-               "cat %s | tar -zxOf - > %s.%d",
-               //"cp %s %s.%d",
-               persistentFilename,
-               config->GetServerPersistentFileLocalPath(),
-               MyRank );
-    }
-    else
-    {
-      sprintf( ScpCommand,
-               "rsh %s cat %s | tar -zxOf - > %s.%d",
-               IONODE_IP,
-               persistentFilename,
-               config->GetServerPersistentFileLocalPath(),
-               MyRank );
-    }
+      size_t Len = std::min( (uint64_t)SKV_SERVER_IMAGE_CHUNK_SIZE, mTotalLen - Offset );
+      if( is_zero_memory( mMemoryAllocation + Offset, Len ) )
+        continue;
 
-    BegLogLine( SKV_SERVER_HEAP_MANAGER_LOG )
-      << "Init(): "
-      << " ScpCommand: " << ScpCommand
-      << EndLogLine;
+      rc = write_to_file( fd, mMemoryAllocation + Offset, Len, Offset );
 
-    system( ScpCommand );
+      StrongAssertLogLine( rc == 0 )
+        << "Dump(): ERROR: write failed: "
+        << " offset: " << Offset
+        << " errno: " << errno
+        << EndLogLine;
 
-    mFd = open( PersistentLocalFilePath, O_RDWR );
+      Written += Len;
+    }
 
-    StrongAssertLogLine( mFd >= 0 )
-      << "ERROR: Failed to open file: "
-      << " PERSISTENT_FILE_LOCAL_PATH: " << config->GetServerPersistentFileLocalPath()
-      << " PersistentLocalFilePath: " << PersistentLocalFilePath
-      << " mFd: " << mFd
+    rc = fsync( fd );
+    StrongAssertLogLine( rc == 0 )
+      << "Dump(): ERROR: fsync failed: "
       << " errno: " << errno
       << EndLogLine;
 
-    skv_server_persistance_heap_hdr_t Hdr;
-
-    read_from_file( mFd, (char *) & Hdr, sizeof( skv_server_persistance_heap_hdr_t ) );
+    close( fd );
 
-    StrongAssertLogLine( Hdr.mMagicNum == PERSISTENT_MAGIC_NUMBER )
-      << "ERROR: Magic number mismatch: "
-      << " Hdr.mMagicNum: " << (void *) Hdr.mMagicNum
-      << " PERSISTENT_MAGIC_NUMBER: " << (void *) PERSISTENT_MAGIC_NUMBER
+    rc = rename( TmpFilename.c_str(), persistentFilename );
+    StrongAssertLogLine( rc == 0 )
+      << "Dump(): ERROR: rename to " << persistentFilename
+      << " failed: errno: " << errno
       << EndLogLine;
 
-    StrongAssertLogLine( Hdr.mNodeId == MyRank )
-      << "ERROR: NodeId mismatch: "
-      << " MyRank: " << MyRank
-      << " Hdr.mNodeId: " << Hdr.mNodeId
+    BegLogLine( SKV_SERVER_HEAP_MANAGER_LOG )
+      << "Dump(): image written: " << persistentFilename
+      << " heap: " << mTotalLen
+      << " data: " << Written
       << EndLogLine;
-
-    char* persistentFileMapAddress = (char *) Hdr.mMmapAddr;
-    int mmapFlags = MAP_FIXED | MAP_SHARED;
-
-    mMemoryAllocation = (char *) mmap( persistentFileMapAddress,
-                                       mTotalLen,
-                                       PROT_READ | PROT_WRITE,
-                                       mmapFlags,
-                                       mFd,
-                                       0 );
-
-    if( mMemoryAllocation == MAP_FAILED )
-    {
-      char CatPid[256];
-      bzero( CatPid, 256 );
-      sprintf( CatPid, "cat /proc/%d/maps > /tmp/skv_server_proc_maps.%d ", getpid(), getpid() );
-      system( CatPid );
-
-      StrongAssertLogLine( 0 )
-        << "Init(): ERROR: mmap failed "
-        << " mTotalLen: " << mTotalLen
-        << " errno: " << errno
-        << EndLogLine;
-    }
-#endif
-
   }
 
   static
@@ -406,73 +409,58 @@ public:
 
       sprintf( persistentFilename, "%s/%s.%d", aRestartImagePath, config->GetServerPersistentFilename(), MyRank );
 
-      // Remove the file from the local node
-      unlink( PersistentLocalFilePath );
-
-        // Copy the file from the ionode
+      mFd = open( persistentFilename, O_RDONLY );
+      if( mFd < 0 )
+      {
+        BegLogLine( 1 )
+          << "ERROR: Failed to open restart image: " << persistentFilename
+          << " errno: " << errno
+          << EndLogLine;
+        return SKV_ERRNO_NOT_DONE;
+      }
 
-      char ScpCommand[ 512 ];
-      bzero( ScpCommand, 512 );
+      skv_server_persistance_heap_hdr_t Hdr;
+      bzero( & Hdr, sizeof( skv_server_persistance_heap_hdr_t ) );
 
-      // rsh 10.255.255.254 cat /gpfs/gpfs/packedfile.mynode | tar -xzf -
-      char MyHostname[ MY_HOSTNAME_SIZE ];
-      bzero( MyHostname, MY_HOSTNAME_SIZE );
-      gethostname( MyHostname, MY_HOSTNAME_SIZE );
+      int HdrLen = read_from_file( mFd, (char *) & Hdr, sizeof( skv_server_persistance_heap_hdr_t ) );
 
-      if( strcmp( MyHostname, "asfhost00" ) == 0 )
+      /* only raw images of the current layout can be mapped. Compressed
+       * (tar.gz) images and raw images with the old magic number were
+       * written before the container, shard and header changes, their
+       * tables can't be interpreted by this version
+       */
+      if( ( HdrLen != sizeof( skv_server_persistance_heap_hdr_t ) ) ||
+          ( Hdr.mMagicNum != PERSISTENT_MAGIC_NUMBER ) )
       {
-        sprintf( ScpCommand,
-                 "cat %s | tar -zxOf - > %s.%d",
-                 // "cp %s %s.%d",
-                 persistentFilename,
-                 config->GetServerPersistentFileLocalPath(),
-                 MyRank );
+        const unsigned char* Bytes = (const unsigned char*) & Hdr;
+        BegLogLine( 1 )
+          << "Init(): ERROR: restart image has an incompatible format "
+          << " image: " << persistentFilename
+          << " magic: " << (void *) Hdr.mMagicNum
+          << " expected: " << (void *) PERSISTENT_MAGIC_NUMBER
+          << ( ( Hdr.mMagicNum == PERSISTENT_MAGIC_NUMBER_V1 ) ? " (raw image of an older version)" : "" )
+          << ( ( Bytes[ 0 ] == 0x1f && Bytes[ 1 ] == 0x8b ) ? " (compressed image of an older version)" : "" )
+          << EndLogLine;
+        close( mFd );
+        return SKV_ERRNO_NOT_DONE;
       }
-      else
+
+      /* raw image: mapped copy-on-write, pages get loaded when they're
+       * first touched and changes never go back to the image
+       */
+      struct stat ImageStat;
+      if( ( fstat( mFd, &ImageStat ) != 0 ) || ( (uint64_t)ImageStat.st_size != mTotalLen ) )
       {
-#if 0
-        sprintf( ScpCommand,
-                 "rsh %s cat %s | tar -zxOf - > %s.%d",
-                 IONODE_IP,
-                 persistentFilename,
-                 config->GetServerPersistentFileLocalPath(),
-                 MyRank );
-#else
-        sprintf( ScpCommand,
-                 // "rcp %s:%s %s.%d",
-                 "cat %s | tar -zxOf - > %s.%d",
-                 persistentFilename,
-                 config->GetServerPersistentFileLocalPath(),
-                 MyRank );
-#endif
+        BegLogLine( 1 )
+          << "Init(): ERROR: restart image size doesn't match the heap size "
+          << " image: " << persistentFilename
+          << " size: " << (uint64_t)ImageStat.st_size
+          << " mTotalLen: " << mTotalLen
+          << EndLogLine;
+        close( mFd );
+        return SKV_ERRNO_NOT_DONE;
       }
-
-      BegLogLine( SKV_SERVER_HEAP_MANAGER_LOG )
-        << "Init(): "
-        << " ScpCommand: " << ScpCommand
-        << EndLogLine;
-
-      system( ScpCommand );
-
-      mFd = open( PersistentLocalFilePath, O_RDWR );
-
-      StrongAssertLogLine( mFd >= 0 )
-        << "ERROR: Failed to open file: "
-        << " PERSISTENT_FILE_LOCAL_PATH: " << config->GetServerPersistentFileLocalPath()
-        << " PersistentLocalFilePath: " << PersistentLocalFilePath
-        << " mFd: " << mFd
-        << " errno: " << errno
-        << EndLogLine;
-
-      skv_server_persistance_heap_hdr_t Hdr;
-
-      read_from_file( mFd, (char *) & Hdr, sizeof( skv_server_persistance_heap_hdr_t ) );
-
-      StrongAssertLogLine( Hdr.mMagicNum == PERSISTENT_MAGIC_NUMBER )
-        << "ERROR: Magic number mismatch: "
-        << " Hdr.mMagicNum: " << (void *) Hdr.mMagicNum
-        << " PERSISTENT_MAGIC_NUMBER: " << (void *) PERSISTENT_MAGIC_NUMBER
-        << EndLogLine;
+      mmapFlags = MAP_PRIVATE | MAP_NORESERVE;
 
       StrongAssertLogLine( Hdr.mNodeId == (unsigned long)MyRank )
         << "ERROR: NodeId mismatch: "
@@ -481,7 +469,6 @@ public:
         << EndLogLine;
 
       persistentFileMapAddress = (char *) Hdr.mMmapAddr;
-      mmapFlags |= MAP_FIXED;
 
       lseek( mFd, 0, SEEK_SET );
     }
@@ -494,12 +481,20 @@ public:
       return SKV_ERRNO_NOT_IMPLEMENTED;
     }
 
-    mMemoryAllocation = (char *) mmap( persistentFileMapAddress,
-                                       mTotalLen,
-                                       PROT_READ | PROT_WRITE,
-                                       mmapFlags,
-                                       mFd,
-                                       0 );
+    if( aFlag & SKV_PERSISTANCE_FLAG_INIT )
+    {
+      mMemoryAllocation = MapHeap( (char *) SKV_SERVER_HEAP_MAP_ADDR, mmapFlags, mFd );
+      if( mMemoryAllocation == MAP_FAILED )
+      {
+        BegLogLine( 1 )
+          << "Init(): WARNING: heap address " << (void *) SKV_SERVER_HEAP_MAP_ADDR
+          << " is in use, restarts from this image may fail"
+          << EndLogLine;
+        mMemoryAllocation = MapHeap( NULL, mmapFlags, mFd );
+      }
+    }
+    else
+      mMemoryAllocation = MapHeap( persistentFileMapAddress, mmapFlags, mFd );
 
     if( mMemoryAllocation == MAP_FAILED )
     {
@@ -510,6 +505,7 @@ public:
 
       BegLogLine( 1 )
         << "Init(): ERROR: mmap failed "
+        << " address: " << (void *) persistentFileMapAddress
         << " mTotalLen: " << mTotalLen
         << " errno: " << errno
         << EndLogLine;
@@ -531,6 +527,9 @@ public:
         << " Hdr->mMmapAddr: " << (void *) Hdr->mMmapAddr
         << " mMemoryAllocation: " << (void *) mMemoryAllocation
         << EndLogLine;
+
+      // start reading the image in the background, requests don't wait for it
+      madvise( mMemoryAllocation, mTotalLen, MADV_WILLNEED );
     }
     else
     {
@@ -19,6 +19,12 @@ class skv_server_internal_event_source_t :
 {
 public:
 
+  virtual int
+  GetPendingCount() { return mEventManager->GetQueuedCount(); }
+
+  virtual void
+  SetDoorbell( skv_server_doorbell_t *aDoorbell ) { mEventManager->SetDoorbell( aDoorbell ); }
+
   virtual skv_status_t
   GetEvent( skv_server_event_t* aEvents, int* aEventCount, int aMaxEventCount )
   {
@@ -58,6 +58,12 @@ skv_server_local_kv_event_source_t::GetEvent( skv_server_event_t* aEvents,
   return SKV_SUCCESS;
 }
 
+void
+skv_server_local_kv_event_source_t::SetDoorbell( skv_server_doorbell_t *aDoorbell )
+{
+  mEventManager->SetDoorbell( aDoorbell );
+}
+
 skv_status_t
 skv_server_local_kv_event_source_t::PrepareEvent( skv_local_kv_event_t *aLocalEvent,
                                                   skv_server_event_t *aSEvent)
@@ -31,6 +31,9 @@ public:
             int* aEventCount,
             int aMaxEventCount );
 
+  virtual void
+  SetDoorbell( skv_server_doorbell_t *aDoorbell );
+
   virtual ~skv_server_local_kv_event_source_t() {}
 
 private:
@@ -40,6 +40,8 @@ Init( int aPartitionSize,
   /************************************************************
    * Initialize the interface adapter
    ***********************************************************/
+  itx_set_receiver_threads( SKVConfig->GetServerSocketReceivers() );
+
   it_status_t itstatus = it_ia_create( VP_NAME, 2, 0, & mIA_Hdl );
   StrongAssertLogLine( itstatus == IT_SUCCESS )
     << "skv_server_t::Init():: ERROR:: Failed in it_ia_create() "
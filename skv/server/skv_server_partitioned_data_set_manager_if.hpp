@@ -126,6 +126,166 @@ public:
                                                 aRemMemRepValue );
   }
 
+  /***
+   * Desc: inserts the rows of a bulk buffer that is sorted by key as one run
+   *   (see InsertSorted() of the data container). Rows that already exist
+   *   are skipped like in the row-by-row path.
+   * input: bulk rows (see skv_bulk_insert_* in skv_types.hpp)
+   * returns: SKV_SUCCESS, SKV_ERRNO_RECORD_ALREADY_EXISTS if any row was a
+   *   duplicate or the allocation error
+   ***/
+  skv_status_t BulkInsertSorted( skv_pds_id_t aPDSId,
+                                 char* aBuffer,
+                                 int aBufferSize )
+  {
+    std::vector<skv_lmr_triplet_t> Records;
+    std::vector<char*> RecordReps;
+    std::vector<int> KeySizes;
+    std::vector<int> ValueSizes;
+
+    skv_status_t status = SKV_SUCCESS;
+    int TotalProcessed = 0;
+    while( TotalProcessed < aBufferSize )
+    {
+      char* KeyPtr = NULL;
+      char* ValuePtr = NULL;
+      int KeySize = -1;
+      int ValueSize = -1;
+
+      TotalProcessed += skv_bulk_insert_get_key_value_refs( &aBuffer[ TotalProcessed ],
+                                                            &KeyPtr,
+                                                            KeySize,
+                                                            &ValuePtr,
+                                                            ValueSize );
+
+      skv_lmr_triplet_t NewRecordAllocRep;
+      status = Allocate( KeySize + ValueSize, & NewRecordAllocRep );
+      if( status != SKV_SUCCESS )
+        break;
+
+      char* LocalStoreAddr = (char *) NewRecordAllocRep.GetAddr();
+      memcpy( LocalStoreAddr, KeyPtr, KeySize );
+      memcpy( & LocalStoreAddr[ KeySize ], ValuePtr, ValueSize );
+
+      Records.push_back( NewRecordAllocRep );
+      RecordReps.push_back( LocalStoreAddr );
+      KeySizes.push_back( KeySize );
+      ValueSizes.push_back( ValueSize );
+    }
+
+    if( status != SKV_SUCCESS )
+    {
+      for( size_t i = 0; i < Records.size(); i++ )
+        Deallocate( & Records[ i ] );
+      return status;
+    }
+
+    std::vector<skv_status_t> RowStatus( Records.size() );
+    if( ! Records.empty() )
+      status = mPartitionedDataSetManager.InsertSorted( aPDSId,
+                                                        Records.size(),
+                                                        RecordReps.data(),
+                                                        KeySizes.data(),
+                                                        ValueSizes.data(),
+                                                        RowStatus.data() );
+
+    for( size_t i = 0; i < Records.size(); i++ )
+    {
+      if( RowStatus[ i ] != SKV_SUCCESS )
+      {
+        Deallocate( & Records[ i ] );
+        if( status == SKV_SUCCESS )
+          status = RowStatus[ i ];
+      }
+    }
+    return status;
+  }
+
+  /***
+   * Desc: processes the rows of a multi-key request one by one
+   * input: packed rows and the result buffer (see skv_multi_key_* in skv_types.hpp)
+   * returns: SKV_SUCCESS; per-key status goes into the result entries
+   ***/
+  skv_status_t MultiKey( skv_pds_id_t aPDSId,
+                         skv_command_type_t aOp,
+                         skv_cmd_RIU_flags_t aFlags,
+                         int aKeyCount,
+                         char* aRequestBuffer,
+                         char* aResultBuffer )
+  {
+    skv_multi_key_result_t* Results = (skv_multi_key_result_t*) aResultBuffer;
+    char* ValueSpace = aResultBuffer + aKeyCount * sizeof( skv_multi_key_result_t );
+    char* Row = aRequestBuffer;
+
+    for( int i = 0; i < aKeyCount; i++ )
+    {
+      char* KeyPtr = NULL;
+      char* ValuePtr = NULL;
+      int KeySize = -1;
+      int ValueSize = -1;
+
+      Row += skv_multi_key_get_row( Row, aOp, &KeyPtr, KeySize, &ValuePtr, ValueSize );
+
+      skv_lmr_triplet_t ValueRepInStore;
+      skv_status_t status = Retrieve( aPDSId,
+                                      KeyPtr,
+                                      KeySize,
+                                      0,
+                                      0,
+                                      (skv_cmd_RIU_flags_t)0,
+                                      &ValueRepInStore );
+
+      Results[ i ].mValueSize = 0;
+
+      if( aOp == SKV_COMMAND_RETRIEVE )
+      {
+        if( status == SKV_SUCCESS )
+        {
+          int StoredSize = ValueRepInStore.GetLen();
+          memcpy( ValueSpace,
+                  (char*) ValueRepInStore.GetAddr(),
+                  StoredSize < ValueSize ? StoredSize : ValueSize );
+          Results[ i ].mValueSize = StoredSize;
+        }
+        ValueSpace += ValueSize;
+      }
+      else
+      {
+        if( status == SKV_SUCCESS )
+        {
+          // same as for single inserts: duplicates only replace the value if requested
+          if( ! ( aFlags & ( SKV_COMMAND_RIU_UPDATE | SKV_COMMAND_RIU_INSERT_OVERWRITE_VALUE_ON_DUP ) ) )
+            status = SKV_ERRNO_RECORD_ALREADY_EXISTS;
+          else
+            status = Remove( aPDSId, KeyPtr, KeySize );
+        }
+        else if( status == SKV_ERRNO_ELEM_NOT_FOUND )
+          status = SKV_SUCCESS;
+
+        if( status == SKV_SUCCESS )
+        {
+          skv_lmr_triplet_t NewRecordAllocRep;
+          status = Allocate( KeySize + ValueSize, & NewRecordAllocRep );
+          if( status == SKV_SUCCESS )
+          {
+            char* LocalStoreAddr = (char *) NewRecordAllocRep.GetAddr();
+            memcpy( LocalStoreAddr, KeyPtr, KeySize );
+            memcpy( & LocalStoreAddr[ KeySize ], ValuePtr, ValueSize );
+
+            status = Insert( aPDSId, LocalStoreAddr, KeySize, ValueSize );
+            if( status != SKV_SUCCESS )
+              Deallocate( & NewRecordAllocRep );
+          }
+        }
+        Results[ i ].mValueSize = ValueSize;
+      }
+
+      Results[ i ].mStatus = status;
+      Results[ i ].EndianConvert();
+    }
+    return SKV_SUCCESS;
+  }
+
   skv_distribution_t* GetDistribution()
   {
     return mPartitionedDataSetManager.GetDistribution();
@@ -11,6 +11,7 @@
  *     arayshu, lschneid - initial implementation
  */
 #include <mpi.h>
+#include <mutex>
 #include <skv/client/skv_client_server_conn.hpp>
 #include <skv/common/skv_client_server_protocol.hpp>
 #include <skv/server/skv_server_tree_based_container.hpp>
@@ -88,6 +89,9 @@ Open( char*                 aPDSName,
       PDSId.mIdOnOwner = *(mLocalPDSCountPtr);
       *mLocalPDSCountPtr = *mLocalPDSCountPtr + 1;
 
+      if( aFlags & SKV_COMMAND_OPEN_FLAGS_HASH_INDEX )
+        PDSId.mIdOnOwner |= SKV_PDS_ID_HASH_INDEX_FLAG;
+
       int rc = mPDSNameTable->insert( std::make_pair( PdsNameStr, PDSId ) ).second;
 
       BegLogLine( SKV_SERVER_TREE_BASED_CONTAINER_OPEN_LOG )
@@ -309,6 +313,31 @@ Deallocate( skv_lmr_triplet_t* aRemMemRep )
   return SKV_SUCCESS;
 }
 
+skv_hash_index_t*
+skv_tree_based_container_t::
+GetHashIndex( skv_pds_id_t& aPDSId,
+              int           aShard,
+              bool          aCreate )
+{
+  skv_hash_index_table_t::iterator iter = mHashIndexTable[ aShard ].find( aPDSId );
+  if( iter != mHashIndexTable[ aShard ].end() )
+    return iter->second;
+
+  if( !aCreate )
+    return NULL;
+
+  skv_hash_index_t* Index = new skv_hash_index_t();
+  mHashIndexTable[ aShard ].insert( std::make_pair( aPDSId, Index ) );
+
+  BegLogLine( SKV_SERVER_TREE_BASED_CONTAINER_LOG )
+    << "skv_tree_based_container_t::GetHashIndex():: created hash index for"
+    << " aPDSId: " << aPDSId
+    << " aShard: " << aShard
+    << EndLogLine;
+
+  return Index;
+}
+
 static skv_status_t
 Deallocate( skv_lmr_triplet_t* aRemMemRep )
 {
@@ -337,7 +366,11 @@ Insert( skv_pds_id_t         aPDSId,
   UserKey.Init( aRowData,
                 aKeySize );
 
-  skv_tree_based_container_key_t* key = MakeKey( aPDSId, &UserKey );
+  int Shard = GetShard( aRowData, aKeySize );
+  std::lock_guard<skv_mutex_t> ShardGuard( mShardLock[ Shard ] );
+
+  skv_tree_based_container_key_t KeyBuffer;
+  skv_tree_based_container_key_t* key = MakeKey( &KeyBuffer, aPDSId, &UserKey );
 
   key->SetValueSize( aValueSize );
 
@@ -355,14 +388,17 @@ Insert( skv_pds_id_t         aPDSId,
     << "INSERT: "
     << " key: "     << (void*)key
     << " dataMap: " << (void*)mDataMap
+    << " Shard: " << Shard
     << EndLogLine;
 
-  int rc = mDataMap->insert( *key ).second;
+  int rc = mDataMap[ Shard ].insert( *key ).second;
 
   skv_status_t status = SKV_SUCCESS;
 
   if( ! rc )
     status = SKV_ERRNO_RECORD_ALREADY_EXISTS;
+  else if( aPDSId.HasHashIndex() )
+    GetHashIndex( aPDSId, Shard, true )->Insert( RowData, aKeySize, aValueSize );
 
   BegLogLine( SKV_SERVER_TREE_BASED_CONTAINER_LOG )
     << "skv_tree_based_container_t::Insert():: Leaving"
@@ -372,6 +408,82 @@ Insert( skv_pds_id_t         aPDSId,
   return status;
 }
 
+/***
+ * skv_tree_based_container_t::InsertSorted::
+ * Desc: Insert a run of records sorted by key. Each shard gets its
+ *   subsequence (still in order) under one lock acquisition, every
+ *   insert is hinted with the successor of the previous one so an
+ *   ascending load appends without descending the index.
+ * input: records in store memory, key and value sizes
+ * returns: SKV_SUCCESS, aStatus[ i ] is SKV_ERRNO_RECORD_ALREADY_EXISTS
+ *   for duplicates (the record memory stays with the caller)
+ ***/
+skv_status_t
+skv_tree_based_container_t::
+InsertSorted( skv_pds_id_t         aPDSId,
+              int                   aCount,
+              char**                aRowData,
+              int*                  aKeySizes,
+              int*                  aValueSizes,
+              skv_status_t*         aStatus )
+{
+  BegLogLine( SKV_SERVER_TREE_BASED_CONTAINER_LOG )
+    << "skv_tree_based_container_t::InsertSorted():: Entering"
+    << " aCount: " << aCount
+    << EndLogLine;
+
+  std::vector<int> ShardRows[ SKV_DATA_CONTAINER_SHARDS ];
+  for( int i = 0; i < aCount; i++ )
+    ShardRows[ GetShard( aRowData[ i ], aKeySizes[ i ] ) ].push_back( i );
+
+  for( int Shard = 0; Shard < SKV_DATA_CONTAINER_SHARDS; Shard++ )
+  {
+    if( ShardRows[ Shard ].empty() )
+      continue;
+
+    std::lock_guard<skv_mutex_t> ShardGuard( mShardLock[ Shard ] );
+
+    skv_data_container_t::iterator Hint = mDataMap[ Shard ].end();
+
+    for( size_t r = 0; r < ShardRows[ Shard ].size(); r++ )
+    {
+      int i = ShardRows[ Shard ][ r ];
+
+      skv_key_t UserKey;
+      UserKey.Init( aRowData[ i ], aKeySizes[ i ] );
+
+      skv_tree_based_container_key_t KeyBuffer;
+      skv_tree_based_container_key_t* key = MakeKey( &KeyBuffer, aPDSId, &UserKey );
+      key->SetValueSize( aValueSizes[ i ] );
+
+      size_t Before = mDataMap[ Shard ].size();
+
+      // the first key of the run needs a lookup, the others follow their predecessor
+      if( r == 0 )
+        Hint = mDataMap[ Shard ].insert( *key ).first;
+      else
+        Hint = mDataMap[ Shard ].insert( Hint, *key );
+
+      if( mDataMap[ Shard ].size() == Before )
+        aStatus[ i ] = SKV_ERRNO_RECORD_ALREADY_EXISTS;
+      else
+      {
+        aStatus[ i ] = SKV_SUCCESS;
+        if( aPDSId.HasHashIndex() )
+          GetHashIndex( aPDSId, Shard, true )->Insert( key->GetRecordPtr(), aKeySizes[ i ], aValueSizes[ i ] );
+      }
+
+      ++Hint;
+    }
+  }
+
+  BegLogLine( SKV_SERVER_TREE_BASED_CONTAINER_LOG )
+    << "skv_tree_based_container_t::InsertSorted():: Leaving"
+    << EndLogLine;
+
+  return SKV_SUCCESS;
+}
+
 template<class streamclass>
 static
 streamclass&
@@ -404,6 +516,7 @@ RetrieveNKeys( skv_pds_id_t       aPDSId,
     << " aStartingKeySize: " << aStartingKeySize
     << EndLogLine;
 
+  skv_tree_based_container_key_t StartingKeyBuffer;
   skv_tree_based_container_key_t* StartingKeyPtr;
 
   skv_key_t StartingUserKey;
@@ -412,93 +525,95 @@ RetrieveNKeys( skv_pds_id_t       aPDSId,
   if( (aFlags & SKV_CURSOR_RETRIEVE_FIRST_ELEMENT_FLAG)
       && !(aFlags & SKV_CURSOR_WITH_STARTING_KEY_FLAG) )
   {
-    StartingKeyPtr = MakeMagicKey( &aPDSId );
+    StartingKeyPtr = MakeMagicKey( &StartingKeyBuffer, &aPDSId );
   }
   else
   {
-    StartingKeyPtr = MakeKey( aPDSId, &StartingUserKey );
+    StartingKeyPtr = MakeKey( &StartingKeyBuffer, aPDSId, &StartingUserKey );
   }
 
   *aRetrievedKeysCount = 0;
-  skv_data_container_t::iterator iter = mDataMap->lower_bound( *StartingKeyPtr );
+
+  // The PDS is spread over all shards, so the keys are merged in order.
+  // Shards are always locked in ascending order
+  for( int s = 0; s < SKV_DATA_CONTAINER_SHARDS; s++ )
+    mShardLock[ s ].lock();
+
+  skv_data_container_t::iterator iter[ SKV_DATA_CONTAINER_SHARDS ];
+  for( int s = 0; s < SKV_DATA_CONTAINER_SHARDS; s++ )
+    iter[ s ] = mDataMap[ s ].lower_bound( *StartingKeyPtr );
+
+  // returns the shard with the smallest next key of the PDS, -1 if there is none
+  struct NextShard
+  {
+    static int Get( skv_data_container_t* aDataMap,
+                    skv_data_container_t::iterator* aIter,
+                    skv_pds_id_t& aPDSId )
+    {
+      int Min = -1;
+      for( int s = 0; s < SKV_DATA_CONTAINER_SHARDS; s++ )
+      {
+        if( ( aIter[ s ] == aDataMap[ s ].end() ) ||
+            !( *( ( (skv_tree_based_container_key_t *) &(*aIter[ s ]) )->GetPDSId() ) == aPDSId ) )
+          continue;
+
+        if( ( Min < 0 ) || ( *aIter[ s ] < *aIter[ Min ] ) )
+          Min = s;
+      }
+      return Min;
+    }
+  };
+
+  int Shard = NextShard::Get( mDataMap, iter, aPDSId );
 
   BegLogLine( SKV_SERVER_TREE_BASED_CONTAINER_LOG )
-    << "skv_tree_based_container_t::RetrieveNKeys():: After mDataMap->lower_bound():: "
+    << "skv_tree_based_container_t::RetrieveNKeys():: After lower_bound():: "
     << " *StartingKeyPtr: " << *StartingKeyPtr
-    << " (iter != mDataMap->end()): " << (iter != mDataMap->end())
-    << " mDataMap->size(): " << mDataMap->size()
+    << " Shard: " << Shard
     << " aFlags: " << aFlags
     << EndLogLine;
 
-  if( iter != mDataMap->end() )
+  // We do not need to send the starting key (unless it's the first key)
+  if( ( Shard >= 0 ) && !(aFlags & SKV_CURSOR_RETRIEVE_FIRST_ELEMENT_FLAG) )
   {
-    // We do not need to send the starting key (unless it's the first key)
-    if( !(aFlags & SKV_CURSOR_RETRIEVE_FIRST_ELEMENT_FLAG) )
-      iter++;
+    iter[ Shard ]++;
+    Shard = NextShard::Get( mDataMap, iter, aPDSId );
+  }
 
-    // Check if the iterator is pointing to a queried PDSId
-    skv_tree_based_container_key_t * key = (skv_tree_based_container_key_t *) &(*iter);
-    skv_pds_id_t* PDSIdInKey = key->GetPDSId();
+  int IterCount = 0;
+  while( ( Shard >= 0 ) &&
+         ( IterCount < aListOfKeysMaxCount ) )
+  {
+    skv_tree_based_container_key_t * key = (skv_tree_based_container_key_t *) &(*iter[ Shard ]);
+
+    int Index = 2 * IterCount;
 
     BegLogLine( SKV_SERVER_TREE_BASED_CONTAINER_LOG )
       << "skv_tree_based_container_t::RetrieveNKeys():: "
-      << " PDSIdInKey: " << *PDSIdInKey
+      << " Index: " << Index
+      << " aListOfKeysMaxCount: " << aListOfKeysMaxCount
+      << " Shard: " << Shard
+      << " Key: " << *key
       << EndLogLine;
 
-    if( !(*PDSIdInKey == aPDSId) )
-    {
-      BegLogLine( SKV_SERVER_TREE_BASED_CONTAINER_LOG )
-        << "skv_tree_based_container_t::RetrieveNKeys():: Leaving with SKV_ERRNO_END_OF_RECORDS"
-        << EndLogLine;
-
-      return SKV_ERRNO_END_OF_RECORDS;
-    }
-
-    int IterCount = 0;
-    while( (iter != mDataMap->end()) &&
-           (IterCount < aListOfKeysMaxCount) &&
-           (*(key->GetPDSId()) == aPDSId) )
-    {
-      int Index = 2 * IterCount;
-
-      BegLogLine( SKV_SERVER_TREE_BASED_CONTAINER_LOG )
-        << "skv_tree_based_container_t::RetrieveNKeys():: "
-        << " Index: " << Index
-        << " aListOfKeysMaxCount: " << aListOfKeysMaxCount
-        << " Key: " << *key
-        << EndLogLine;
-      BegLogLine(SKV_SERVER_TREE_BASED_CONTAINER_LOG)
-        << "Freestore &aRetrievedKeysSizesSegs[" << Index
-        << "]=" << & aRetrievedKeysSizesSegs[Index]
-        << EndLogLine ;
-
-      aRetrievedKeysSizesSegs[Index].InitAbs( mDataLMR,
-                                              (char *) &key->mUserKey.mSizeBE,
-                                              sizeof(int) );
-
-      aRetrievedKeysSizesSegs[Index + 1].InitAbs( mDataLMR,
-                                                  key->mUserKey.GetData(),
-                                                  key->mUserKey.GetSize() );
+    aRetrievedKeysSizesSegs[Index].InitAbs( mDataLMR,
+                                            (char *) &key->mUserKey.mSizeBE,
+                                            sizeof(int) );
 
-      BegLogLine(SKV_SERVER_TREE_BASED_CONTAINER_LOG)
-        << "Freestore"
-        << EndLogLine ;
-      IterCount++;
-      iter++;
-      key = (skv_tree_based_container_key_t *) &(*iter);
-    }
+    aRetrievedKeysSizesSegs[Index + 1].InitAbs( mDataLMR,
+                                                key->mUserKey.GetData(),
+                                                key->mUserKey.GetSize() );
 
-    *aRetrievedKeysCount          =     IterCount;
-    *aRetrievedKeysSizesSegsCount = 2 * IterCount;
+    IterCount++;
+    iter[ Shard ]++;
+    Shard = NextShard::Get( mDataMap, iter, aPDSId );
   }
-  else
-  {
-    BegLogLine( SKV_SERVER_TREE_BASED_CONTAINER_LOG )
-      << "skv_tree_based_container_t::RetrieveNKeys():: Leaving with SKV_ERRNO_END_OF_RECORDS"
-      << EndLogLine;
 
-    return SKV_ERRNO_END_OF_RECORDS;
-  }
+  for( int s = SKV_DATA_CONTAINER_SHARDS - 1; s >= 0; s-- )
+    mShardLock[ s ].unlock();
+
+  *aRetrievedKeysCount          =     IterCount;
+  *aRetrievedKeysSizesSegsCount = 2 * IterCount;
 
   BegLogLine( SKV_SERVER_TREE_BASED_CONTAINER_LOG )
     << "skv_tree_based_container_t::RetrieveNKeys():: Leaving with " << *aRetrievedKeysCount << " Keys."
@@ -563,11 +678,12 @@ class QueuedDeallocator
     }
   };
 
+// one queue per shard, each is only used under its shard lock
 static skv_status_t
-QueuedDeallocate(char * aRecordPtr)
+QueuedDeallocate(int aShard, char * aRecordPtr)
   {
-    static QueuedDeallocator<8> QD ;
-    return QD.QueuedDeallocate(aRecordPtr) ;
+    static QueuedDeallocator<8> QD[ SKV_DATA_CONTAINER_SHARDS ] ;
+    return QD[ aShard ].QueuedDeallocate(aRecordPtr) ;
   }
 
 /***
@@ -592,12 +708,40 @@ Remove( skv_pds_id_t             aPDSId,
   skv_key_t UserKey;
   UserKey.Init( aKeyData, aKeySize );
 
+  int Shard = GetShard( aKeyData, aKeySize );
+  std::lock_guard<skv_mutex_t> ShardGuard( mShardLock[ Shard ] );
+
   // create key and find entry
-  skv_tree_based_container_key_t* key = MakeKey( aPDSId, & UserKey );
+  skv_tree_based_container_key_t KeyBuffer;
+  skv_tree_based_container_key_t* key = MakeKey( &KeyBuffer, aPDSId, & UserKey );
+
+  char* RecordPtr = NULL;
+
+  if( aPDSId.HasHashIndex() )
+  {
+    // the hash index provides the record, no need for a tree lookup before the erase
+    skv_hash_index_t* Index = GetHashIndex( aPDSId, Shard, false );
+    const skv_hash_index_entry_t* Entry = ( Index != NULL ) ? Index->Lookup( aKeyData, aKeySize ) : NULL;
+
+    if( Entry != NULL )
+    {
+      RecordPtr = Entry->mRecord;
+      Index->Remove( aKeyData, aKeySize );
+    }
+  }
+  else
+  {
+    skv_data_container_t::iterator iter = mDataMap[ Shard ].find( *key );
 
-  skv_data_container_t::iterator iter = mDataMap->find( *key );
+    if( iter != mDataMap[ Shard ].end() )
+    {
+      // set key, get addr of record and deallocate potential RMR
+      key = (skv_tree_based_container_key_t *) &(*iter);
+      RecordPtr = key->GetRecordPtr();
+    }
+  }
 
-  if( iter == mDataMap->end() )
+  if( RecordPtr == NULL )
   {
     BegLogLine( SKV_SERVER_TREE_BASED_CONTAINER_LOG )
       << "skv_tree_based_container_t::Remove():: Leaving with SKV_ERRNO_ELEM_NOT_FOUND"
@@ -606,13 +750,7 @@ Remove( skv_pds_id_t             aPDSId,
     return SKV_ERRNO_ELEM_NOT_FOUND;
   }
 
-  // set key, get addr of record and deallocate potential RMR
-  key = (skv_tree_based_container_key_t *) &(*iter);
-
-  char* RecordPtr = key->GetRecordPtr();
-  int KeySize = key->GetKeySize();
-
-  int rc = mDataMap->erase( *key );
+  int rc = mDataMap[ Shard ].erase( *key );
 
   if( rc != 1 )
   {
@@ -626,7 +764,7 @@ Remove( skv_pds_id_t             aPDSId,
     << "skv_tree_based_container_t::Remove():: Deallocating RMR and Leaving... "
     << EndLogLine;
 
-  return QueuedDeallocate((char *) RecordPtr) ;
+  return QueuedDeallocate( Shard, (char *) RecordPtr ) ;
 //   return Deallocate( & TmpRMR );
 //   return SKV_SUCCESS ;
 }
@@ -654,47 +792,77 @@ Retrieve( skv_pds_id_t             aPDSId,
     << "skv_tree_based_container_t::Retrieve():: Entering... "
     << EndLogLine;
 
-  skv_key_t UserKey;
-  UserKey.Init( aKeyData, aKeySize );
+  char* RecordPtr;
+  int   KeySize;
+  int   SizeInStore;
 
-  skv_tree_based_container_key_t* key = MakeKey( aPDSId, & UserKey );
+  int Shard = GetShard( aKeyData, aKeySize );
+  std::lock_guard<skv_mutex_t> ShardGuard( mShardLock[ Shard ] );
 
-  BegLogLine( SKV_SERVER_TREE_BASED_CONTAINER_LOG )
-    << "skv_tree_based_container_t::Retrieve():: "
-    << " key: " << *key
-    << EndLogLine;
+  if( aPDSId.HasHashIndex() )
+  {
+    skv_hash_index_t* Index = GetHashIndex( aPDSId, Shard, false );
+    const skv_hash_index_entry_t* Entry = ( Index != NULL ) ? Index->Lookup( aKeyData, aKeySize ) : NULL;
 
-#if 0
-  int count = 0;
-  for( skv_data_container_t::iterator iter1 = mDataMap->begin();
-      iter1 != mDataMap->end();
-      iter1++ )
+    if( Entry == NULL )
+    {
+      BegLogLine( SKV_SERVER_TREE_BASED_CONTAINER_LOG )
+        << "skv_tree_based_container_t::Retrieve():: Leaving with SKV_ERRNO_ELEM_NOT_FOUND (hash index)"
+        << EndLogLine;
+
+      return SKV_ERRNO_ELEM_NOT_FOUND;
+    }
+
+    RecordPtr   = Entry->mRecord;
+    KeySize     = Entry->mKeySize;
+    SizeInStore = Entry->mValueSize;
+  }
+  else
   {
+    skv_key_t UserKey;
+    UserKey.Init( aKeyData, aKeySize );
+
+    skv_tree_based_container_key_t KeyBuffer;
+    skv_tree_based_container_key_t* key = MakeKey( &KeyBuffer, aPDSId, & UserKey );
+
     BegLogLine( SKV_SERVER_TREE_BASED_CONTAINER_LOG )
       << "skv_tree_based_container_t::Retrieve():: "
-      << " iter[ " << count << " ].Key: " << iter1->first
-      << " iter[ " << count << " ].Value: " << iter1->second
+      << " key: " << *key
       << EndLogLine;
 
-    count++;
-  }
+#if 0
+    int count = 0;
+    for( skv_data_container_t::iterator iter1 = mDataMap->begin();
+        iter1 != mDataMap->end();
+        iter1++ )
+    {
+      BegLogLine( SKV_SERVER_TREE_BASED_CONTAINER_LOG )
+        << "skv_tree_based_container_t::Retrieve():: "
+        << " iter[ " << count << " ].Key: " << iter1->first
+        << " iter[ " << count << " ].Value: " << iter1->second
+        << EndLogLine;
+
+      count++;
+    }
 #endif
 
-  skv_data_container_t::iterator iter = mDataMap->find( *key );
+    skv_data_container_t::iterator iter = mDataMap[ Shard ].find( *key );
 
-  if( iter == mDataMap->end() )
-  {
-    BegLogLine( SKV_SERVER_TREE_BASED_CONTAINER_LOG )
-      << "skv_tree_based_container_t::Retrieve():: Leaving with SKV_ERRNO_ELEM_NOT_FOUND"
-      << EndLogLine;
+    if( iter == mDataMap[ Shard ].end() )
+    {
+      BegLogLine( SKV_SERVER_TREE_BASED_CONTAINER_LOG )
+        << "skv_tree_based_container_t::Retrieve():: Leaving with SKV_ERRNO_ELEM_NOT_FOUND"
+        << EndLogLine;
 
-    return SKV_ERRNO_ELEM_NOT_FOUND;
-  }
+      return SKV_ERRNO_ELEM_NOT_FOUND;
+    }
 
-  key = (skv_tree_based_container_key_t *) &(*iter);
+    key = (skv_tree_based_container_key_t *) &(*iter);
 
-  char* RecordPtr = key->GetRecordPtr();
-  int   KeySize   = key->GetKeySize();
+    RecordPtr   = key->GetRecordPtr();
+    KeySize     = key->GetKeySize();
+    SizeInStore = key->GetValueSize();
+  }
 
   AssertLogLine( KeySize == aKeySize )
     << "skv_tree_based_container_t::Retrieve(): ERROR: "
@@ -709,8 +877,6 @@ Retrieve( skv_pds_id_t             aPDSId,
     << " StartOfValueInStore != NULL "
     << EndLogLine;
 
-  int SizeInStore = key->GetValueSize();
-
   AssertLogLine( SizeInStore >= 0 && SizeInStore < SKV_VALUE_LIMIT )
     << "skv_tree_based_container_t::Retrieve:: ERROR: "
     << " SizeInStore: " << SizeInStore
@@ -793,6 +959,7 @@ skv_status_t
 skv_tree_based_container_t::
 Init( it_pz_handle_t                            aPZ_Hdl,
       skv_server_internal_event_manager_if_t*  aInternalEventManager,
+      skv_distribution_t*                      aDistribution,
       int                                       aMyNodeId,
       char*                                     aRestartImagePath,
       skv_persistance_flag_t                   aFlag )
@@ -800,6 +967,7 @@ Init( it_pz_handle_t                            aPZ_Hdl,
   mMyNodeId             = aMyNodeId;
   mPZ_Hdl               = aPZ_Hdl;
   mInternalEventManager = aInternalEventManager;
+  mDistribution         = aDistribution;
 
   // mMaxDataLoad = SKV_MAX_DATA_LOAD * 1024 * 1024;
   char* PersistanceHdr = NULL;
@@ -812,17 +980,21 @@ Init( it_pz_handle_t                            aPZ_Hdl,
   if( aFlag & SKV_PERSISTANCE_FLAG_INIT )
   {
     // Construction of the
-    mDataMap = (skv_data_container_t *) skv_server_heap_manager_t::Allocate( sizeof( skv_data_container_t ) );
+    mDataMap = (skv_data_container_t *) skv_server_heap_manager_t::Allocate( SKV_DATA_CONTAINER_SHARDS * sizeof( skv_data_container_t ) );
 
     StrongAssertLogLine( mDataMap != NULL )
       << "Init(): ERROR: Not enough memory for: "
-      << " size: " << sizeof( skv_data_container_t )
+      << " size: " << SKV_DATA_CONTAINER_SHARDS * sizeof( skv_data_container_t )
       << EndLogLine;
 
-    // Call the constructor
-    new((void*)mDataMap)skv_data_container_t();
+    // Call the constructors
+    for( int s = 0; s < SKV_DATA_CONTAINER_SHARDS; s++ )
+      new((void*)&mDataMap[ s ])skv_data_container_t();
 
     mHeapHdr->mDataMap = mDataMap;
+    mHeapHdr->mDataMapShards = SKV_DATA_CONTAINER_SHARDS;
+    mHeapHdr->mDataContainerType = SKV_DATA_CONTAINER_TYPE;
+    mHeapHdr->mDataContainerVersion = SKV_DATA_CONTAINER_VERSION;
 
     mPDSNameTable = (skv_pds_name_table_t *) skv_server_heap_manager_t::Allocate( sizeof( skv_pds_name_table_t ) );
 
@@ -852,14 +1024,41 @@ Init( it_pz_handle_t                            aPZ_Hdl,
   }
   else if( aFlag & SKV_PERSISTANCE_FLAG_RESTART )
   {
+    // the nodes in the image are only valid for the container they were written with
+    if( ( mHeapHdr->mDataContainerType != SKV_DATA_CONTAINER_TYPE ) ||
+        ( mHeapHdr->mDataContainerVersion != SKV_DATA_CONTAINER_VERSION ) )
+    {
+      BegLogLine( 1 )
+        << "Init(): ERROR: Restart image was written with a different data container "
+        << " image type: " << (void*)(uintptr_t) mHeapHdr->mDataContainerType
+        << " version: " << (void*)(uintptr_t) mHeapHdr->mDataContainerVersion
+        << " expected type: " << (void*)(uintptr_t) SKV_DATA_CONTAINER_TYPE
+        << " version: " << (void*)(uintptr_t) SKV_DATA_CONTAINER_VERSION
+        << EndLogLine;
+      return SKV_ERRNO_NOT_DONE;
+    }
+
     mDataMap = (skv_data_container_t *) mHeapHdr->mDataMap;
+
+    StrongAssertLogLine( mHeapHdr->mDataMapShards == SKV_DATA_CONTAINER_SHARDS )
+      << "Init(): ERROR: Restart image has a different shard count "
+      << " image: " << mHeapHdr->mDataMapShards
+      << " SKV_DATA_CONTAINER_SHARDS: " << SKV_DATA_CONTAINER_SHARDS
+      << EndLogLine;
+
     mPDSNameTable = (skv_pds_name_table_t *) mHeapHdr->mPDSNameTable;
 
+    // hash indices are not part of the image, only PDSs with a hash index need a walk over their records
+    bool RebuildHashIndex = false;
+
     skv_pds_name_table_t::iterator iter = mPDSNameTable->begin();
     skv_pds_name_table_t::iterator iter_end = mPDSNameTable->end();
 
     while( iter != iter_end )
     {
+      if( iter->second.HasHashIndex() )
+        RebuildHashIndex = true;
+
       fxlogger_string_t PdsName;
       PdsName.Init( (char*) iter->first.c_str(), iter->first.size() );
 
@@ -871,36 +1070,56 @@ Init( it_pz_handle_t                            aPZ_Hdl,
       iter++;
     }
 
-    skv_data_container_t::iterator iter_data = mDataMap->begin();
-    skv_data_container_t::iterator iter_data_end = mDataMap->end();
+    /* the image is mapped lazily, a full walk (checksum verification) would
+     * read the whole image before the server is ready
+     */
+#ifdef SKV_SERVER_RESTART_VERIFY_IMAGE
+    const bool VerifyImage = true;
+#else
+    const bool VerifyImage = false;
+#endif
 
     int RowCount = 0;
     unsigned long long checksum = 0;
     unsigned long long TotalSize = 0;
-    while( iter_data != iter_data_end )
+    for( int Shard = 0; ( VerifyImage || RebuildHashIndex ) && ( Shard < SKV_DATA_CONTAINER_SHARDS ); Shard++ )
     {
-      skv_tree_based_container_key_t * KeyPtr = (skv_tree_based_container_key_t *) &(*iter_data);
+      skv_data_container_t::iterator iter_data = mDataMap[ Shard ].begin();
+      skv_data_container_t::iterator iter_data_end = mDataMap[ Shard ].end();
 
-      int RowSize = KeyPtr->GetRecordSize();
-      TotalSize += RowSize;
-      char* RowData = KeyPtr->GetRecordPtr();
+      while( iter_data != iter_data_end )
+      {
+        skv_tree_based_container_key_t * KeyPtr = (skv_tree_based_container_key_t *) &(*iter_data);
 
-      HexDump hd( RowData, RowSize );
+        int RowSize = KeyPtr->GetRecordSize();
+        TotalSize += RowSize;
+        char* RowData = KeyPtr->GetRecordPtr();
 
-      BegLogLine( 0 )
-        << "Row: " << RowCount
-        << " Ptr: " << (void *) RowData
-        << " Size: " << RowSize
-        << " hd: " << hd
-        << EndLogLine;
+        HexDump hd( RowData, RowSize );
 
-      for( int i = 0; i < RowSize; i++ )
-      {
-        checksum += RowData[i];
-      }
+        BegLogLine( 0 )
+          << "Row: " << RowCount
+          << " Ptr: " << (void *) RowData
+          << " Size: " << RowSize
+          << " hd: " << hd
+          << EndLogLine;
 
-      iter_data++;
-      RowCount++;
+        if( VerifyImage )
+          for( int i = 0; i < RowSize; i++ )
+          {
+            checksum += RowData[i];
+          }
+
+        // hash indices are not part of the image, rebuild them from the tree
+        skv_pds_id_t* PDSIdInKey = KeyPtr->GetPDSId();
+        if( PDSIdInKey->HasHashIndex() )
+          GetHashIndex( *PDSIdInKey, Shard, true )->Insert( RowData,
+                                                            KeyPtr->GetKeySize(),
+                                                            KeyPtr->GetValueSize() );
+
+        iter_data++;
+        RowCount++;
+      }
     }
 
     BegLogLine( SKV_SERVER_TREE_BASED_CONTAINER_INIT_LOG )
@@ -909,7 +1128,7 @@ Init( it_pz_handle_t                            aPZ_Hdl,
       << " "
       << EndLogLine;
 
-    StrongAssertLogLine( checksum == mHeapHdr->mRowDataChecksum )
+    StrongAssertLogLine( !VerifyImage || ( checksum == mHeapHdr->mRowDataChecksum ) )
       << "Init(): ERROR: Checksum mismatch "
       << " checksum: " << checksum
       << " mHeapHdr->mRowDataChecksum: " << mHeapHdr->mRowDataChecksum
@@ -971,6 +1190,16 @@ Finalize()
         << "Freeing mDataLMR=" << (void *) mDataLMR
         << EndLogLine ;
     it_lmr_free(mDataLMR) ;
+
+  for( int s = 0; s < SKV_DATA_CONTAINER_SHARDS; s++ )
+  {
+    for( skv_hash_index_table_t::iterator iter = mHashIndexTable[ s ].begin();
+         iter != mHashIndexTable[ s ].end();
+         iter++ )
+      delete iter->second;
+    mHashIndexTable[ s ].clear();
+  }
+
 #if 0
   if( mDataMap != NULL )
   {
@@ -988,13 +1217,16 @@ Finalize()
  * skv_tree_based_container_t::MakeKey::
  * Desc: Given a aPDSId put the next element in aKey and aValue
  * input:
+ * aKeyBuffer -> caller provided key storage
  * aPDSId -> Representation of the PDSId
  * aKey   -> Representation of user defined key
  * returns: Pointer to a key structure
  ***/
 skv_tree_based_container_key_t*
 skv_tree_based_container_t::
-MakeKey( skv_pds_id_t & aPDSId, skv_key_t* aKey )
+MakeKey( skv_tree_based_container_key_t* aKeyBuffer,
+         skv_pds_id_t &                  aPDSId,
+         skv_key_t*                      aKey )
 {
   AssertLogLine( aKey != NULL )
     << "skv_tree_based_container_t::MakeKey():: ERROR: "
@@ -1008,10 +1240,10 @@ MakeKey( skv_pds_id_t & aPDSId, skv_key_t* aKey )
     << " SKV_KEY_LIMIT: " << SKV_KEY_LIMIT
     << EndLogLine;
 
-  mTempKeyBuffer.SetPDSId( aPDSId );
-  mTempKeyBuffer.SetUserKey( aKey );
+  aKeyBuffer->SetPDSId( aPDSId );
+  aKeyBuffer->SetUserKey( aKey );
 
-  return &mTempKeyBuffer;
+  return aKeyBuffer;
 }
 
 /***
@@ -1021,21 +1253,23 @@ MakeKey( skv_pds_id_t & aPDSId, skv_key_t* aKey )
  * NOTE: This key is for temporary use only, designed
  * for the temporary need of a lookup
  * input:
+ * aKeyBuffer -> caller provided key storage
  * aPDSId -> Representation of the PDSId
  * returns: Pointer to a key structure
  ***/
 skv_tree_based_container_key_t*
 skv_tree_based_container_t::
-MakeMagicKey( skv_pds_id_t* aPDSId )
+MakeMagicKey( skv_tree_based_container_key_t* aKeyBuffer,
+              skv_pds_id_t*                   aPDSId )
 {
   AssertLogLine( aPDSId != NULL )
     << "skv_tree_based_container_t::MakeMagicKey():: ERROR: "
     << " aPDSId != NULL"
     << EndLogLine;
 
-  mTempKeyBuffer.MakeMagicKey( aPDSId );
+  aKeyBuffer->MakeMagicKey( aPDSId );
 
-  return &mTempKeyBuffer;
+  return aKeyBuffer;
 }
 
 
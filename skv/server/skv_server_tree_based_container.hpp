@@ -14,11 +14,22 @@
 #ifndef __SKV_TREE_BASED_CONTAINER__
 #define __SKV_TREE_BASED_CONTAINER__
 #include <skv/common/skv_types.hpp>
+#include <skv/common/skv_mutex.hpp>
+#include <skv/common/skv_distribution_manager.hpp>
 
 #include <skv/server/skv_server_heap_manager.hpp>
 #include <skv/server/skv_server_tree_based_container_key.hpp>
+#include <skv/server/skv_server_hash_index.hpp>
 #include <skv/server/skv_server_cursor_manager_if.hpp>
 
+// Number of independent partitions of the local store
+// Each shard has its own ordered index, hash indices and lock, keys are
+// assigned by skv_distribution_t::GetShard(). Multi-threaded backends run
+// one worker per shard so that the shard locks stay uncontended
+#ifndef SKV_DATA_CONTAINER_SHARDS
+#define SKV_DATA_CONTAINER_SHARDS ( 1 )
+#endif
+
 // class skv_server_pds_compare_t
 //   {
 //   bool operator()(const skv_pds_id_t& lhs, const skv_pds_id_t& rhs) const
@@ -29,7 +40,10 @@
 
 class skv_tree_based_container_t
 {
+  // array of SKV_DATA_CONTAINER_SHARDS containers
   skv_data_container_t*                         mDataMap;
+  skv_mutex_t                                   mShardLock[ SKV_DATA_CONTAINER_SHARDS ];
+  skv_distribution_t*                           mDistribution;
   // In bytes
   size_t                                        mMaxDataLoad;
 
@@ -42,11 +56,11 @@ class skv_tree_based_container_t
 
   // This is used to get an iterator to the records associated
   // to a skv_pds_id_t. Assumes the rest of the records follow in sorted order
-  skv_tree_based_container_key_t* MakeMagicKey( skv_pds_id_t* );
-  skv_tree_based_container_key_t* MakeKey( skv_pds_id_t& aPDSId, skv_key_t* aKey );
-
-  // ASSUME: Since the SKV Server is single threaded, this is safe
-  skv_tree_based_container_key_t mTempKeyBuffer;
+  skv_tree_based_container_key_t* MakeMagicKey( skv_tree_based_container_key_t* aKeyBuffer,
+                                                skv_pds_id_t* );
+  skv_tree_based_container_key_t* MakeKey( skv_tree_based_container_key_t* aKeyBuffer,
+                                           skv_pds_id_t& aPDSId,
+                                           skv_key_t* aKey );
 
   skv_server_cursor_manager_if_t mServCursorMgrIF;
 
@@ -77,6 +91,14 @@ class skv_tree_based_container_t
 
   skv_server_persistance_heap_hdr_t* mHeapHdr;
 
+  // Hash indices of the PDSs opened with SKV_COMMAND_OPEN_FLAGS_HASH_INDEX
+  // They live on the regular heap and get rebuilt from mDataMap at restart
+  typedef std::map<skv_pds_id_t, skv_hash_index_t*> skv_hash_index_table_t;
+
+  skv_hash_index_table_t mHashIndexTable[ SKV_DATA_CONTAINER_SHARDS ];
+
+  skv_hash_index_t* GetHashIndex( skv_pds_id_t& aPDSId, int aShard, bool aCreate );
+
 public:
   skv_tree_based_container_t()
   {
@@ -102,12 +124,18 @@ public:
 
   skv_status_t Init( it_pz_handle_t aPZ_Hdl,
                      skv_server_internal_event_manager_if_t* aInternalEventManager,
+                     skv_distribution_t* aDistribution,
                      int aMyNodeId,
                      char* aRestartImagePath,
                      skv_persistance_flag_t aFlag );
 
   skv_status_t Finalize();
 
+  int GetShard( const char* aKeyData, int aKeySize ) const
+  {
+    return mDistribution->GetShard( aKeyData, aKeySize, SKV_DATA_CONTAINER_SHARDS );
+  }
+
   skv_status_t Remove( skv_pds_id_t aPDSId,
                        char* aKeyData,
                        int aKeySize );
@@ -117,6 +145,14 @@ public:
                        int aKeySize,
                        int aValueSize );
 
+  // aRecordReps are sorted by key; per-record status goes to aStatus
+  skv_status_t InsertSorted( skv_pds_id_t aPDSId,
+                             int aCount,
+                             char** aRecordReps,
+                             int* aKeySizes,
+                             int* aValueSizes,
+                             skv_status_t* aStatus );
+
   skv_status_t Allocate( int aSize,
                          skv_lmr_triplet_t* aRemMemRep );
 
@@ -176,6 +176,11 @@ public:
 
       int rc = (mUserKey < aKey.mUserKey);
 
+      // skv_store_t only compares the common length, a key that is a
+      // prefix of another one has to sort first to get a strict order
+      if( !rc && !(aKey.mUserKey < mUserKey) )
+        rc = (mUserKey.mSize() < aKey.mUserKey.mSize());
+
       BegLogLine( SKV_TREE_BASED_CONTAINER_KEY_LOG )
         << "skv_tree_based_container_t::Key::operator<():: "
         << " mUserKey: " << mUserKey
@@ -198,8 +203,112 @@ public:
   }
 };
 
+#ifdef SKV_DATA_CONTAINER_BTREE
+
+/***
+ * Packed representation of a key for the B+tree nodes:
+ * the PDS id, the host-order key size and the first 8 bytes of the
+ * user key in big-endian order (compares like memcmp on those bytes)
+ ***/
+struct skv_tree_based_container_key_prefix_t
+{
+  skv_pds_id_t mPDSId;
+  int          mKeySize;    // SKV_MAGIC_VALUE for magic keys
+  uint64_t     mPrefix;
+};
+
+struct skv_tree_based_container_key_traits_t
+{
+  typedef skv_tree_based_container_key_prefix_t prefix_t;
+
+  static
+  void
+  MakePrefix( const skv_tree_based_container_key_t& aKey,
+              prefix_t* aPrefix )
+  {
+    aPrefix->mPDSId = aKey.mPDSId;
+    aPrefix->mPrefix = 0;
+
+    if( aKey.IsMagicValueSet() )
+    {
+      aPrefix->mKeySize = SKV_MAGIC_VALUE;
+      return;
+    }
+
+    aPrefix->mKeySize = aKey.mUserKey.mSize();
+
+    const unsigned char* Data = (const unsigned char*) aKey.mUserKey.mData;
+    int Len = min( aPrefix->mKeySize, (int)sizeof( uint64_t ) );
+    for( int i = 0; i < Len; i++ )
+      aPrefix->mPrefix |= ( (uint64_t) Data[ i ] ) << ( 56 - 8 * i );
+  }
+
+  // three-way version of skv_tree_based_container_key_t::operator<()
+  static
+  int
+  Compare( const skv_tree_based_container_key_t& aKeyA,
+           const prefix_t& aPrefixA,
+           const skv_tree_based_container_key_t& aKeyB,
+           const prefix_t& aPrefixB )
+  {
+    if( aPrefixA.mPDSId != aPrefixB.mPDSId )
+      return ( aPrefixA.mPDSId < aPrefixB.mPDSId ) ? -1 : 1;
+
+    // the magic key sorts before every record of its PDS
+    int MagicA = ( aPrefixA.mKeySize == SKV_MAGIC_VALUE );
+    int MagicB = ( aPrefixB.mKeySize == SKV_MAGIC_VALUE );
+    if( MagicA || MagicB )
+      return MagicB - MagicA;
+
+    int MinLen = min( aPrefixA.mKeySize, aPrefixB.mKeySize );
+
+    if( aPrefixA.mPrefix != aPrefixB.mPrefix )
+    {
+      if( MinLen >= (int)sizeof( uint64_t ) )
+        return ( aPrefixA.mPrefix < aPrefixB.mPrefix ) ? -1 : 1;
+
+      uint64_t Mask = ~( ~( (uint64_t) 0 ) >> ( 8 * MinLen ) );
+      uint64_t A = aPrefixA.mPrefix & Mask;
+      uint64_t B = aPrefixB.mPrefix & Mask;
+      if( A != B )
+        return ( A < B ) ? -1 : 1;
+    }
+
+    if( MinLen > (int)sizeof( uint64_t ) )
+    {
+      int rc = memcmp( aKeyA.mUserKey.mData + sizeof( uint64_t ),
+                       aKeyB.mUserKey.mData + sizeof( uint64_t ),
+                       MinLen - sizeof( uint64_t ) );
+      if( rc != 0 )
+        return rc;
+    }
+
+    // equal common part: the shorter key sorts first
+    return aPrefixA.mKeySize - aPrefixB.mKeySize;
+  }
+};
+
+#include <skv/server/skv_server_btree_container.hpp>
+
+typedef skv_btree_container_t< skv_tree_based_container_key_t,
+                               skv_tree_based_container_key_traits_t,
+                               skv_allocator_t< char > > skv_data_container_t;
+
+/* recorded in the persistent image, a restart only accepts an image of
+ * the same container type and node layout
+ */
+#define SKV_DATA_CONTAINER_TYPE    ( 0x42545245 )  // "BTRE"
+#define SKV_DATA_CONTAINER_VERSION ( ( 1 << 24 ) | ( SKV_BTREE_LEAF_SLOTS << 12 ) | SKV_BTREE_INNER_SLOTS )
+
+#else
+
 typedef std::set< skv_tree_based_container_key_t,
                   less< skv_tree_based_container_key_t >,
                   skv_allocator_t< skv_tree_based_container_key_t > > skv_data_container_t;
 
+#define SKV_DATA_CONTAINER_TYPE    ( 0x53544453 )  // "STDS"
+#define SKV_DATA_CONTAINER_VERSION ( 1 )
+
+#endif
+
 #endif
@@ -66,6 +66,7 @@ static uint64_t gServerCoalescSum = 0;
 //#define DISABLE_SERVER_COALESCING
 
 #include <skv/common/skv_mutex.hpp>
+#include <skv/server/skv_server_doorbell.hpp>
 #include <skv/server/skv_server_event_type.hpp>
 #include <skv/server/skv_server_heap_manager.hpp>
 // !! FURTHER INCLUDES FURTHER DOWN IN THE FILE !!
@@ -116,7 +117,8 @@ typedef enum
   SKV_SERVER_COMMAND_STATE_WAITING_RDMA_WRITE_CMPL,
   SKV_SERVER_COMMAND_STATE_LOCAL_KV_INDEX_OP,
   SKV_SERVER_COMMAND_STATE_LOCAL_KV_DATA_OP,
-  SKV_SERVER_COMMAND_STATE_LOCAL_KV_READY
+  SKV_SERVER_COMMAND_STATE_LOCAL_KV_READY,
+  SKV_SERVER_COMMAND_STATE_DATA_STREAMING
 } skv_server_command_state_t;
 
 static
@@ -134,6 +136,7 @@ skv_server_command_state_to_string( skv_server_command_state_t aState )
     case SKV_SERVER_COMMAND_STATE_LOCAL_KV_INDEX_OP: { return "SKV_SERVER_COMMAND_STATE_LOCAL_KV_INDEX_OP"; }
     case SKV_SERVER_COMMAND_STATE_LOCAL_KV_DATA_OP: { return "SKV_SERVER_COMMAND_STATE_LOCAL_KV_DATA_OP"; }
     case SKV_SERVER_COMMAND_STATE_LOCAL_KV_READY: { return "SKV_SERVER_COMMAND_STATE_LOCAL_KV_READY"; }
+    case SKV_SERVER_COMMAND_STATE_DATA_STREAMING: { return "SKV_SERVER_COMMAND_STATE_DATA_STREAMING"; }
     default:
     {
       StrongAssertLogLine( 0 )
@@ -307,24 +310,77 @@ struct skv_server_command_insert_t
   skv_server_to_client_cmd_hdr_t     mHdr;
   skv_cmd_RIU_flags_t                mFlags;
   skv_rec_lock_handle_t              mRecLockHdl;
+  skv_status_t                       mValueStatus;   // checksum result of an rdma-read value
+};
+
+/* A bulk insert buffer is streamed in chunks of up to CHUNK_SIZE bytes
+ * cut at row boundaries (a larger row is read as a chunk of its own).
+ * Up to BULK_INSERT_CHUNKS chunks per command are in flight or waiting
+ * for the local kv, so the next chunk transfers while the previous one
+ * is inserted and server memory doesn't depend on the buffer size.
+ * CHUNK_SIZE has to hold a row header ( 2 ints + SKV_KEY_LIMIT ).
+ */
+#ifndef SKV_SERVER_BULK_INSERT_CHUNK_SIZE
+#define SKV_SERVER_BULK_INSERT_CHUNK_SIZE ( 1024 * 1024 )
+#endif
+
+#ifndef SKV_SERVER_BULK_INSERT_CHUNKS
+#define SKV_SERVER_BULK_INSERT_CHUNKS ( 4 )
+#endif
+
+struct skv_server_bulk_insert_chunk_t
+{
+  skv_lmr_triplet_t                  mBuffer;    // as allocated
+  int                                mDataLen;   // bytes of complete rows
 };
 
 struct skv_server_command_bulk_insert_t
 {
   skv_server_to_client_cmd_hdr_t     mHdr;
-  skv_lmr_triplet_t                  mLocalBuffer;
+  skv_lmr_triplet_t                  mLocalBuffer;   // rows of the chunk in the local kv
   skv_pds_id_t                       mPDSId;
+  int                                mFlags;   // skv_bulk_inserter_flags_t
 
-  // Needed for debugging
   uint64_t                            mRemoteBufferAddr;
   it_rmr_context_t                    mRemoteBufferRMR;
+  int                                 mRemoteBufferSize;
+
+  // streaming state
+  int                                 mReadOffset;     // remote offset of the chunk in flight
+  int                                 mReadLen;
+  skv_server_bulk_insert_chunk_t      mReadChunk;
+  skv_server_bulk_insert_chunk_t      mChunks[ SKV_SERVER_BULK_INSERT_CHUNKS ];  // read, waiting for insert
+  int                                 mChunkFirst;
+  int                                 mChunkCount;
+  int                                 mChunksHeld;     // credits in use: reading + waiting + inserting
+  bool                                mReading;
+  bool                                mInserting;
+  bool                                mRetryPending;   // a local kv retry event is queued
+  skv_status_t                        mTransferStatus; // first transfer error, ends the stream
+  skv_status_t                        mInsertStatus;   // last local kv error
 
 #ifdef SKV_BULK_LOAD_CHECKSUM
   uint64_t                            mRemoteBufferChecksum;
+  uint64_t                            mBufferChecksum;
 #endif
 
 };
 
+struct skv_server_command_multi_key_t
+{
+  skv_server_to_client_cmd_hdr_t     mHdr;
+  skv_lmr_triplet_t                  mLocalBuffer;   // request rows followed by the results
+  skv_pds_id_t                       mPDSId;
+  skv_command_type_t                 mOp;
+  skv_cmd_RIU_flags_t                mFlags;
+  int                                mKeyCount;
+  int                                mRequestSize;
+  int                                mResultSize;
+
+  uint64_t                           mRemoteResultAddr;
+  it_rmr_context_t                   mRemoteRMR;
+};
+
 struct skv_server_command_remove_t
 {
   skv_server_to_client_cmd_hdr_t     mHdr;
@@ -409,6 +465,7 @@ struct skv_server_ccb_t
   {
     skv_server_command_insert_t         mCommandInsert;
     skv_server_command_bulk_insert_t    mCommandBulkInsert;
+    skv_server_command_multi_key_t      mCommandMultiKey;
     skv_server_command_remove_t         mCommandRemove;
     skv_server_command_active_bcast_t   mCommandActiveBcast;
   } mCommandState;
@@ -780,6 +837,8 @@ struct skv_server_ep_state_t
   volatile int mCurrentCommandSlot;
   volatile skv_server_endpoint_status_t mEPState_status;
 
+  int mReactor;  // index of the server reactor that processes all events of this EP
+
   void
   SetClientInfo( int aClientOrdInGroup, skv_client_group_id_t aClientGroupId, it_rmr_triplet_t *aResponseRMR )
   {
@@ -944,6 +1003,7 @@ struct skv_server_ep_state_t
 
     mEPHdl = aEP;
     mPZHdl = aPZ;
+    mReactor = 0;
 
     mAssociatedStateList = new skv_server_finalizable_associated_ep_state_list_t;
 
@@ -1902,16 +1962,23 @@ struct skv_cmd_retrieve_resp_t
   }
 };
 
+// the queue is locked because the backend (cursor manager) and other
+// reactors can enqueue events while the owning reactor dequeues
 class skv_server_internal_event_manager_if_t
 {
   typedef STL_QUEUE( skv_server_event_t* )  EventQueue_T;
   EventQueue_T* mQueue;
+  skv_mutex_t   mQueueLock;
+  volatile int  mQueued;   // allows the dequeue side to skip the lock when empty
+  skv_server_doorbell_t *mDoorbell;
 
 public:
   void
   Init()
   {
     mQueue = new EventQueue_T;
+    mQueued = 0;
+    mDoorbell = NULL;
     StrongAssertLogLine( mQueue != NULL )
       << "skv_server_user_event_manager_if_t::Init():: "
       << EndLogLine;
@@ -1927,12 +1994,24 @@ public:
     }
   }
 
+  // wakes up the owning reactor if it's waiting for events
+  void
+  SetDoorbell( skv_server_doorbell_t *aDoorbell )
+  {
+    mDoorbell = aDoorbell;
+  }
+
   skv_status_t
   Enqueue( skv_server_event_t* aEvent )
   {
     skv_server_event_t *newEvent = new skv_server_event_t;
     memcpy( newEvent, aEvent, sizeof( skv_server_event_t) );
+    mQueueLock.lock();
     mQueue->push( newEvent );
+    mQueued = mQueue->size();
+    mQueueLock.unlock();
+    if( mDoorbell != NULL )
+      mDoorbell->Ring();
     BegLogLine( SKV_SERVER_PENDING_EVENTS_LOG )
       << "skv_server_internal_event_manager_if_t::Enqueue(): "
       << " queue 0x" << (void*)this
@@ -1942,6 +2021,13 @@ public:
     return SKV_SUCCESS;
   }
 
+  // lock free, may be outdated by the time the caller looks at it
+  int
+  GetQueuedCount()
+  {
+    return mQueued;
+  }
+
   int
   GetEventQueueSize()
   {
@@ -1958,10 +2044,16 @@ public:
   skv_status_t
   Dequeue( skv_server_event_t** aEvent )
   {
+    if( mQueued == 0 )
+      return SKV_ERRNO_NO_EVENT;
+
+    mQueueLock.lock();
     if( GetEventQueueSize() > 0 )
     {
       *aEvent = mQueue->front();
       mQueue->pop();
+      mQueued = mQueue->size();
+      mQueueLock.unlock();
 
       BegLogLine( SKV_SERVER_PENDING_EVENTS_LOG )
         << "skv_server_user_event_manager_if_t::Dequeue():: "
@@ -1971,8 +2063,8 @@ public:
 
       return SKV_SUCCESS;
     }
-    else
-      return SKV_ERRNO_NO_EVENT;
+    mQueueLock.unlock();
+    return SKV_ERRNO_NO_EVENT;
   }
 };
 
@@ -51,6 +51,23 @@ Insert( skv_pds_id_t             aPDSId,
 
 }
 
+skv_status_t
+skv_uber_pds_t::
+InsertSorted( skv_pds_id_t       aPDSId,
+              int                 aCount,
+              char**              aRecordReps,
+              int*                aKeySizes,
+              int*                aValueSizes,
+              skv_status_t*       aStatus )
+{
+  return mLocalData.InsertSorted( aPDSId,
+                                  aCount,
+                                  aRecordReps,
+                                  aKeySizes,
+                                  aValueSizes,
+                                  aStatus );
+}
+
 skv_status_t
 skv_uber_pds_t::
 Allocate( int                aSize,
@@ -193,11 +210,12 @@ Init( int            aNodeId,
   if( aCheckpointPath != NULL )
     persistanceFlag = SKV_PERSISTANCE_FLAG_RESTART;
 
-  skv_status_t rc = mLocalData.Init( aPZ_Hdl, aInternalEventQueue, aNodeId, aCheckpointPath, persistanceFlag );
+  // the local store picks its shards with the distribution
+  skv_status_t rc = mDistributionManager.Init( aNodeCount );
   if( rc )
     return rc;
 
-  rc = mDistributionManager.Init( aNodeCount );
+  rc = mLocalData.Init( aPZ_Hdl, aInternalEventQueue, &mDistributionManager, aNodeId, aCheckpointPath, persistanceFlag );
   if( rc )
     return rc;
 
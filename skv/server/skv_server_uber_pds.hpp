@@ -106,6 +106,13 @@ public:
                        int                       aKeySize,
                        int                       aValueSize );
 
+  skv_status_t InsertSorted( skv_pds_id_t       aPDSId,
+                             int                 aCount,
+                             char**              aRecordReps,
+                             int*                aKeySizes,
+                             int*                aValueSizes,
+                             skv_status_t*       aStatus );
+
   skv_status_t Allocate( int                       aSize,
                          skv_lmr_triplet_t*       aMemRep );
 
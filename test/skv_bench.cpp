@@ -22,6 +22,9 @@
 #include <string>
 #include <iostream>
 #include <iomanip>
+#include <thread>
+#include <vector>
+#include <pthread.h>
 
 #ifndef SKV_BENCH_LOG
 #define SKV_BENCH_LOG ( 0 )
@@ -51,6 +54,7 @@
 #define DEFAULT_TIME_LIMIT ( 1 )
 #define DEFAULT_PDS_NAME "SKV_BENCH_PDS"
 #define DEFAULT_RESULT_LOG_LEVEL ( 0 )
+#define DEFAULT_THREADS ( 1 )
 
 // queue length for gliding average
 #define SKV_BENCH_STAT_LEN ( 7 )
@@ -213,6 +217,7 @@ public:
   int mBatchSize;
   bool mDataCheck;
   int mResultLogLevel;
+  int mThreads;
 
 // Settings and defaults set internally
   int mRank;
@@ -231,14 +236,15 @@ public:
     mDataCheck( DEFAULT_DATA_CHECK ),
     mTimeLimit( DEFAULT_TIME_LIMIT ),
     mPDSName( DEFAULT_PDS_NAME ),
-    mResultLogLevel ( DEFAULT_RESULT_LOG_LEVEL )
+    mResultLogLevel ( DEFAULT_RESULT_LOG_LEVEL ),
+    mThreads( DEFAULT_THREADS )
   {}
 
   int Parse( int aArgC, char **aArgV )
   {
     int rc = 0;
     int op;
-    while ((op = getopt(aArgC, aArgV, "b:cd:e:hk:q:t:v:")) != -1)
+    while ((op = getopt(aArgC, aArgV, "b:cd:e:hk:q:t:v:T:")) != -1)
     {
       char *endp;
       switch(op)
@@ -257,6 +263,7 @@ public:
           std::cout << " -t <seconds>                       : time limit for each test loop (default: " << (DEFAULT_TIME_LIMIT) << ")" << std::endl;
           std::cout << " -e <percent>                       : max allowed error to achieve converged measurement in percent (default: " << DEFAULT_AVG_ERROR << ")" << std::endl;
           std::cout << " -d <log-level>                     : amount of console output (default: " << (DEFAULT_RESULT_LOG_LEVEL) << ")" << std::endl;
+          std::cout << " -T <threads>                       : number of client threads sharing one skv client; queue depth is per thread (default: " << (DEFAULT_THREADS) << ")" << std::endl;
           std::cout << std::endl;
           break;
         }
@@ -284,6 +291,9 @@ public:
         case 't':
           mTimeLimit = atoi( optarg );
           break;
+        case 'T':
+          mThreads = atoi( optarg );
+          break;
       }
     }
     if( mBatchSize < 0 )
@@ -295,6 +305,7 @@ public:
   {
     return ( ( mBatchSize > 0)
         && ( mTimeLimit >= 0)
+        && ( mThreads > 0)
         );
   }
   uint64_t GetKeySpace( const int aBits ) const
@@ -322,6 +333,7 @@ operator<<( streamclass& os, const skv_bench_config_t& aIn )
   os << "Data Check: " << (aIn.mDataCheck?"ON":"OFF") << std::endl;
   os << "Time Limit: " << aIn.mTimeLimit << "s"<< std::endl;
   os << "Max Error:  " << aIn.mAvgError << "%"<< std::endl;
+  os << "Threads:    " << aIn.mThreads << std::endl;
   return(os);
 }
 
@@ -342,6 +354,12 @@ typedef enum {
   SKV_BENCH_STATE_REMOVE_COMPLETE   = 0x1002
 } skv_bench_state_t;
 
+typedef enum {
+  SKV_BENCH_PHASE_INSERT,
+  SKV_BENCH_PHASE_RETRIEVE,
+  SKV_BENCH_PHASE_REMOVE
+} skv_bench_phase_t;
+
 struct skv_bench_measurement_t {
   double mRequests;
   double mTime;
@@ -423,6 +441,10 @@ class skv_bench_t
   skv_client_cmd_ext_hdl_t *mHandleBuffer;
 
   skv_status_t mExitStatus;
+  pthread_mutex_t mExitStatusLock;
+
+  // number of inserted records per thread: limits the retrieve/remove phases
+  std::vector< size_t > mInserted;
 public:
   int mKeySize;
   int mValueSize;
@@ -477,6 +499,7 @@ public:
   {
     mState = SKV_BENCH_STATE_RESET;
     mExitStatus = SKV_SUCCESS;
+    pthread_mutex_init( &mExitStatusLock, NULL );
     mConfigRef = &aConfig;
 
     /*****************************************************************************
@@ -591,17 +614,22 @@ public:
 
     mExitStatus = SKV_SUCCESS;
 
+    // each thread gets its own queue depth worth of buffers
+    int Slots = mConfigRef->mQueueDepth * mConfigRef->mThreads;
+
     if( mKeyBuffer )
       delete mKeyBuffer;
-    mKeyBuffer = new char[ NEXT_X8_SIZE( aKeySize ) * mConfigRef->mQueueDepth ];
+    mKeyBuffer = new char[ NEXT_X8_SIZE( aKeySize ) * Slots ];
 
     if( mValueBuffer )
       delete mValueBuffer;
-    mValueBuffer = new char[ NEXT_X8_SIZE( aValueSize ) * mConfigRef->mQueueDepth ];
+    mValueBuffer = new char[ NEXT_X8_SIZE( aValueSize ) * Slots ];
 
     if( mHandleBuffer )
       delete mHandleBuffer;
-    mHandleBuffer = new skv_client_cmd_ext_hdl_t[ mConfigRef->mQueueDepth ];
+    mHandleBuffer = new skv_client_cmd_ext_hdl_t[ Slots ];
+
+    mInserted.assign( mConfigRef->mThreads, 0 );
 
     return SKV_SUCCESS;
   }
@@ -740,142 +768,161 @@ public:
   inline
   void SetExitStatus( skv_status_t aNew )
   {
+    if( aNew == SKV_SUCCESS )
+      return;
+
     // only change if there's no error yet
+    pthread_mutex_lock( &mExitStatusLock );
     if( mExitStatus == SKV_SUCCESS )
       mExitStatus = aNew;
+    pthread_mutex_unlock( &mExitStatusLock );
   }
   inline skv_status_t GetExitStatus() { return mExitStatus; }
 
-  skv_status_t Run()
+  skv_status_t PostBatch( skv_bench_phase_t aPhase,
+                          const char* aKeyBuffer,
+                          const char *aValueBuffer,
+                          skv_client_cmd_ext_hdl_t *aHandleBuffer,
+                          int aBatchSize )
+  {
+    switch( aPhase )
+    {
+      case SKV_BENCH_PHASE_INSERT:
+        return InsertBatch( aKeyBuffer, aValueBuffer, aHandleBuffer, aBatchSize );
+      case SKV_BENCH_PHASE_RETRIEVE:
+        return RetrieveBatch( aKeyBuffer, aValueBuffer, aHandleBuffer, aBatchSize );
+      case SKV_BENCH_PHASE_REMOVE:
+        return RemoveBatch( aKeyBuffer, aHandleBuffer, aBatchSize );
+    }
+    return SKV_ERRNO_UNSPECIFIED_ERROR;
+  }
+
+  /*********************************************************
+   * runs one phase for one thread:
+   * keeps queue depth requests in flight in batches until either the
+   * request limit or the time limit is reached
+   * returns the number of completed requests
+   */
+  size_t RunPhase( skv_bench_phase_t aPhase, int aThread )
   {
     skv_status_t status = SKV_SUCCESS;
-    /*********************************************************
-     * insert phase
-     */
-    MPI_Barrier( MPI_COMM_WORLD );
+    int QueueDepth = mConfigRef->mQueueDepth;
+    int BatchSize = mConfigRef->mBatchSize;
+    int MaxBatch = (int)(QueueDepth/BatchSize);
 
-    double TimeLimit = mConfigRef->mTimeLimit;
-    double CurrentTime = MPI_Wtime();
-    size_t Requests = 0;
-    size_t RequestLimit = mConfigRef->GetKeySpace( mKeySize * 8 );
-    int BatchIdx = 0;
-    int MaxBatch = (int)(mConfigRef->mQueueDepth/mConfigRef->mBatchSize);
+    // the key space of this rank is split between the threads
+    uint64_t ThreadKeySpace = mConfigRef->mKeySpaceLen / mConfigRef->mThreads;
+    uint64_t keyRangeStart = mConfigRef->mRank * mConfigRef->mKeySpaceLen + aThread * ThreadKeySpace;
+
+    // Never do more retrieve/remove requests than inserts!
+    size_t RequestLimit = ( aPhase == SKV_BENCH_PHASE_INSERT ) ? ThreadKeySpace : mInserted[ aThread ];
 
-    BegLogLine( SKV_BENCH_LOG ) << "Starting Insert phase... RequestLimit: " << RequestLimit << EndLogLine;
+    // there can't be a timeout for remove calls since this step needs to clean up all inserted data
+    double TimeLimit = ( aPhase == SKV_BENCH_PHASE_REMOVE ) ? 1e30 : mConfigRef->mTimeLimit;
 
     // set up lists of pointers for more convenient batch operation
-    char **KeyBufferList = new char*[MaxBatch];
-    char **ValueBufferList = new char*[MaxBatch];
-    skv_client_cmd_ext_hdl_t **HandleBufferList = new skv_client_cmd_ext_hdl_t*[MaxBatch];
+    char *KeyBuffer = &mKeyBuffer[ aThread * NEXT_X8_SIZE( mKeySize ) * QueueDepth ];
+    char *ValueBuffer = &mValueBuffer[ aThread * NEXT_X8_SIZE( mValueSize ) * QueueDepth ];
+    skv_client_cmd_ext_hdl_t *HandleBuffer = &mHandleBuffer[ aThread * QueueDepth ];
+
+    std::vector< char* > KeyBufferList( MaxBatch );
+    std::vector< char* > ValueBufferList( MaxBatch );
+    std::vector< skv_client_cmd_ext_hdl_t* > HandleBufferList( MaxBatch );
 
     for( int i=0; i<MaxBatch; i++)
     {
-      KeyBufferList[i] = &mKeyBuffer[ i * NEXT_X8_SIZE( mKeySize ) * mConfigRef->mBatchSize ];
-      ValueBufferList[i] = &mValueBuffer[ i * mValueSize * mConfigRef->mBatchSize ];
-      HandleBufferList[i] = &mHandleBuffer[ i * mConfigRef->mBatchSize ];
+      KeyBufferList[i] = &KeyBuffer[ i * NEXT_X8_SIZE( mKeySize ) * BatchSize ];
+      ValueBufferList[i] = &ValueBuffer[ i * mValueSize * BatchSize ];
+      HandleBufferList[i] = &HandleBuffer[ i * BatchSize ];
     }
 
+    size_t Requests = 0;
+    int BatchIdx = 0;
     double StartTime = MPI_Wtime();
-    uint64_t keyRangeStart = mConfigRef->mRank * mConfigRef->mKeySpaceLen;
-    InitKeyBuffer( mKeyBuffer, mConfigRef->mQueueDepth, keyRangeStart );
-    InitValueBuffer( mValueBuffer, mConfigRef->mQueueDepth );
+    double CurrentTime = StartTime;
+
+    InitKeyBuffer( KeyBuffer, QueueDepth, keyRangeStart );
+    if( aPhase == SKV_BENCH_PHASE_INSERT )
+      InitValueBuffer( ValueBuffer, QueueDepth );
 
     // fill the pipeline
     for( int batch = 0; batch < MaxBatch; batch++ )
-      SetExitStatus( InsertBatch( (const char*)(KeyBufferList[ batch ]),
-                                  (const char*)(ValueBufferList[ batch]),
-                                  HandleBufferList[ batch ],
-                                  mConfigRef->mBatchSize ) );
-    Requests += mConfigRef->mQueueDepth;
+      SetExitStatus( PostBatch( aPhase,
+                                (const char*)(KeyBufferList[ batch ]),
+                                (const char*)(ValueBufferList[ batch ]),
+                                HandleBufferList[ batch ],
+                                BatchSize ) );
+    Requests += QueueDepth;
     /// LOOP
-    while( (Requests + mConfigRef->mBatchSize <= RequestLimit) && ( CurrentTime - StartTime < TimeLimit) )
+    while( (Requests + BatchSize <= RequestLimit) && ( CurrentTime - StartTime < TimeLimit) )
     {
       /// wait for batch of requests
-      status = WaitForBatch( HandleBufferList[ BatchIdx ], mConfigRef->mBatchSize );
+      status = WaitForBatch( HandleBufferList[ BatchIdx ], BatchSize );
       SetExitStatus( status );
 
       /// recreate batch of requests
-      InitKeyBuffer( KeyBufferList[ BatchIdx ], mConfigRef->mBatchSize, keyRangeStart + Requests );
-      InitValueBuffer( ValueBufferList[ BatchIdx ], mConfigRef->mBatchSize );
+      InitKeyBuffer( KeyBufferList[ BatchIdx ], BatchSize, keyRangeStart + Requests );
+      if( aPhase == SKV_BENCH_PHASE_INSERT )
+        InitValueBuffer( ValueBufferList[ BatchIdx ], BatchSize );
 
       /// post batch of requests
-      status = InsertBatch( (const char*)(KeyBufferList[ BatchIdx ]),
-                            (const char*)(ValueBufferList[ BatchIdx ]),
-                            HandleBufferList[ BatchIdx ],
-                            mConfigRef->mBatchSize );
-
+      status = PostBatch( aPhase,
+                          (const char*)(KeyBufferList[ BatchIdx ]),
+                          (const char*)(ValueBufferList[ BatchIdx ]),
+                          HandleBufferList[ BatchIdx ],
+                          BatchSize );
       SetExitStatus( status );
+
       /// END LOOP
       BatchIdx = (BatchIdx + 1) % MaxBatch;
       CurrentTime = MPI_Wtime();
-      Requests += mConfigRef->mBatchSize;
+      Requests += BatchSize;
     }
     // flush the pipeline
     for( int batch = 0; batch < MaxBatch; batch++ )
       SetExitStatus( WaitForBatch( HandleBufferList[ batch ],
-                                   mConfigRef->mBatchSize ) );
+                                   BatchSize ) );
 
-    CurrentTime = MPI_Wtime();
-    BegLogLine(SKV_BENCH_LOG_LW)
-      << "Entering barrier"
-      << EndLogLine ;
-    MPI_Barrier( MPI_COMM_WORLD );
-    BegLogLine(SKV_BENCH_LOG_LW)
-      << "Exiting barrier"
-      << EndLogLine ;
-    mLocalData.mInsert.Calculate( CurrentTime-StartTime, mValueSize, (double)Requests );
-
-    /*********************************************************
-     * retrieve phase
-     */
-    BegLogLine( SKV_BENCH_LOG ) << "Starting Retrieve phase.." << EndLogLine;
+    if( aPhase == SKV_BENCH_PHASE_INSERT )
+      mInserted[ aThread ] = Requests;
 
-    CurrentTime = MPI_Wtime();
-    RequestLimit = Requests;  // Never do more retrieve/remove requests than inserts!
-    Requests = 0;
-    BatchIdx = 0;
-    InitKeyBuffer( mKeyBuffer, mConfigRef->mQueueDepth, keyRangeStart );
-
-    // fill the pipeline
-    StartTime = MPI_Wtime();
-#ifdef SKV_BENCH_SKIP_READ
-    goto skip_read;
-#endif
-    for( int batch = 0; batch < MaxBatch; batch++ )
-      SetExitStatus( RetrieveBatch( (const char*)(KeyBufferList[ batch ]),
-                                    (const char*)(ValueBufferList[ batch]),
-                                    HandleBufferList[ batch ],
-                                    mConfigRef->mBatchSize ) );
-    Requests += mConfigRef->mQueueDepth;
-    /// LOOP
-    while( (Requests + mConfigRef->mBatchSize <= RequestLimit) && ( CurrentTime - StartTime < TimeLimit) )
-    {
-      /// wait for batch of requests
-      status = WaitForBatch( HandleBufferList[ BatchIdx ], mConfigRef->mBatchSize );
-      SetExitStatus( status );
+    return Requests;
+  }
 
-      /// recreate batch of requests
-      InitKeyBuffer( KeyBufferList[ BatchIdx ], mConfigRef->mBatchSize, keyRangeStart + Requests );
+  static void RunPhaseThread( skv_bench_t *aBench, skv_bench_phase_t aPhase, int aThread, size_t *aRequests )
+  {
+    *aRequests = aBench->RunPhase( aPhase, aThread );
+  }
 
-      /// post batch of requests
-      status = RetrieveBatch( (const char*)(KeyBufferList[ BatchIdx ]),
-                              (const char*)(ValueBufferList[ BatchIdx ]),
-                              HandleBufferList[ BatchIdx ],
-                              mConfigRef->mBatchSize );
-      SetExitStatus( status );
+  /*********************************************************
+   * runs a phase with all configured threads on the shared client
+   * returns the elapsed time, aRequests is the total over all threads
+   */
+  double TimedPhase( skv_bench_phase_t aPhase, size_t *aRequests )
+  {
+    int Threads = mConfigRef->mThreads;
+    std::vector< size_t > Requests( Threads, 0 );
 
-      /// END LOOP
-      BatchIdx = (BatchIdx + 1) % MaxBatch;
-      CurrentTime = MPI_Wtime();
-      Requests += mConfigRef->mBatchSize;
+    double StartTime = MPI_Wtime();
+    if( Threads == 1 )
+      Requests[ 0 ] = RunPhase( aPhase, 0 );
+    else
+    {
+      std::vector< std::thread* > Workers;
+      for( int t = 0; t < Threads; t++ )
+        Workers.push_back( new std::thread( RunPhaseThread, this, aPhase, t, &Requests[ t ] ) );
+      for( int t = 0; t < Threads; t++ )
+      {
+        Workers[ t ]->join();
+        delete Workers[ t ];
+      }
     }
-    // flush the pipeline
-    for( int batch = 0; batch < MaxBatch; batch++ )
-      SetExitStatus( WaitForBatch( HandleBufferList[ batch ],
-                                  mConfigRef->mBatchSize ) );
+    double CurrentTime = MPI_Wtime();
+
+    *aRequests = 0;
+    for( int t = 0; t < Threads; t++ )
+      *aRequests += Requests[ t ];
 
-  skip_read:
-    CurrentTime = MPI_Wtime();
     BegLogLine(SKV_BENCH_LOG_LW)
       << "Entering barrier"
       << EndLogLine ;
@@ -883,64 +930,44 @@ public:
     BegLogLine(SKV_BENCH_LOG_LW)
       << "Exiting barrier"
       << EndLogLine ;
-    mLocalData.mRetrieve.Calculate( CurrentTime-StartTime, mValueSize, (double)Requests );
+
+    return CurrentTime - StartTime;
+  }
+
+  skv_status_t Run()
+  {
+    size_t Requests = 0;
+    double Time;
 
     /*********************************************************
-     * remove phase
+     * insert phase
      */
-    BegLogLine( SKV_BENCH_LOG ) << "Starting Remove phase.." << EndLogLine;
+    MPI_Barrier( MPI_COMM_WORLD );
 
-    CurrentTime = MPI_Wtime();
-    Requests = 0;
-    BatchIdx = 0;
-    InitKeyBuffer( mKeyBuffer, mConfigRef->mQueueDepth, keyRangeStart );
+    BegLogLine( SKV_BENCH_LOG ) << "Starting Insert phase... KeySpace: " << mConfigRef->mKeySpaceLen << EndLogLine;
 
-    // fill the pipeline
-    StartTime = MPI_Wtime();
-#ifdef SKV_BENCH_SKIP_REMOVE
-    goto skip_remove;
-#endif
-    for( int batch = 0; batch < MaxBatch; batch++ )
-      SetExitStatus( RemoveBatch( (const char*)(KeyBufferList[ batch ]),
-                                  HandleBufferList[ batch ],
-                                  mConfigRef->mBatchSize ) );
-    Requests += mConfigRef->mQueueDepth;
-    /// LOOP: there can't be a timeout for remove calls since this step needs to clean up all inserted data
-    while( (Requests + mConfigRef->mBatchSize <= RequestLimit) )// && ( CurrentTime - StartTime < TimeLimit) )
-    {
-      /// wait for batch of requests
-      status = WaitForBatch( HandleBufferList[ BatchIdx ], mConfigRef->mBatchSize );
-      SetExitStatus( status );
+    Time = TimedPhase( SKV_BENCH_PHASE_INSERT, &Requests );
+    mLocalData.mInsert.Calculate( Time, mValueSize, (double)Requests );
 
-      /// recreate batch of requests
-      InitKeyBuffer( KeyBufferList[ BatchIdx ], mConfigRef->mBatchSize, keyRangeStart + Requests );
+    /*********************************************************
+     * retrieve phase
+     */
+    BegLogLine( SKV_BENCH_LOG ) << "Starting Retrieve phase.." << EndLogLine;
 
-      /// post batch of requests
-      status = RemoveBatch( (const char*)(KeyBufferList[ BatchIdx ]),
-                            HandleBufferList[ BatchIdx ],
-                            mConfigRef->mBatchSize );
-      SetExitStatus( status );
+#ifndef SKV_BENCH_SKIP_READ
+    Time = TimedPhase( SKV_BENCH_PHASE_RETRIEVE, &Requests );
+    mLocalData.mRetrieve.Calculate( Time, mValueSize, (double)Requests );
+#endif
 
-      /// END LOOP
-      BatchIdx = (BatchIdx + 1) % MaxBatch;
-      CurrentTime = MPI_Wtime();
-      Requests += mConfigRef->mBatchSize;
-    }
-    // flush the pipeline
-    for( int batch = 0; batch < MaxBatch; batch++ )
-      SetExitStatus( WaitForBatch( HandleBufferList[ batch ],
-                                   mConfigRef->mBatchSize ) );
+    /*********************************************************
+     * remove phase
+     */
+    BegLogLine( SKV_BENCH_LOG ) << "Starting Remove phase.." << EndLogLine;
 
-  skip_remove:
-    CurrentTime = MPI_Wtime();
-    BegLogLine(SKV_BENCH_LOG_LW)
-      << "Entering barrier"
-      << EndLogLine ;
-    MPI_Barrier( MPI_COMM_WORLD );
-    BegLogLine(SKV_BENCH_LOG_LW)
-      << "Exiting barrier"
-      << EndLogLine ;
-    mLocalData.mRemove.Calculate( CurrentTime-StartTime, mValueSize, (double)Requests );
+#ifndef SKV_BENCH_SKIP_REMOVE
+    Time = TimedPhase( SKV_BENCH_PHASE_REMOVE, &Requests );
+    mLocalData.mRemove.Calculate( Time, mValueSize, (double)Requests );
+#endif
 
     MPI_Allreduce( & mLocalData.mInsert, & mGlobalData.mInsert, 4, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD );
     MPI_Allreduce( & mLocalData.mRetrieve, & mGlobalData.mRetrieve, 4, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD );
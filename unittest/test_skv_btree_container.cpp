@@ -0,0 +1,324 @@
+/************************************************
+ * Copyright (c) IBM Corp. 2014
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * which accompanies this distribution, and is available at
+ * http://www.eclipse.org/legal/epl-v10.html
+ *************************************************/
+
+/*
+ * test_skv_btree_container.cpp
+ *
+ * compares the B+tree data container against std::set and reports
+ * insert/lookup throughput for both, for random and for sorted
+ * (hinted, as in a sorted bulk insert) insert order
+ *
+ * usage: test_skv_btree_container [ <record count for benchmark> ]
+ */
+
+#ifndef SKV_CLIENT_UNI
+#define SKV_CLIENT_UNI
+#endif
+
+#ifndef SKV_NON_MPI
+#define SKV_NON_MPI
+#endif
+
+#ifndef SKV_DATA_CONTAINER_BTREE
+#define SKV_DATA_CONTAINER_BTREE
+#endif
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <algorithm>
+#include <memory>
+#include <set>
+#include <vector>
+#include <FxLogger.hpp>
+#include "skv/common/skv_types.hpp"
+#include "skv/server/skv_server_tree_based_container_key.hpp"
+
+using namespace std;
+
+typedef skv_tree_based_container_key_t test_key_t;
+
+typedef skv_btree_container_t< test_key_t,
+                               skv_tree_based_container_key_traits_t,
+                               std::allocator<char> > test_btree_t;
+
+typedef std::set< test_key_t > test_stlset_t;
+
+static test_key_t
+make_key( int aPDS, char* aData, int aSize )
+{
+  test_key_t Key;
+  skv_pds_id_t PDSId;
+  PDSId.Init( 0, aPDS );
+  Key.SetPDSId( PDSId );
+  Key.GetUserKey()->Init( aData, aSize );
+  Key.SetValueSize( 0 );
+  return Key;
+}
+
+static bool
+same_key( const test_key_t& aA, const test_key_t& aB )
+{
+  return ( aA.mPDSId == aB.mPDSId ) && ( aA.mUserKey.mData == aB.mUserKey.mData );
+}
+
+static bool
+equal_key( const test_key_t& aA, const test_key_t& aB )
+{
+  return !( aA < aB ) && !( aB < aA );
+}
+
+// random mix of insert/erase/find/lower_bound checked against std::set
+int function_test( int aLoops, int aKeyPool )
+{
+  int rc = 0;
+  test_btree_t tree;
+  test_stlset_t ref;
+
+  // short keys over a small alphabet to get plenty of shared prefixes
+  vector<char*> Data( aKeyPool );
+  vector<int> Size( aKeyPool );
+  for( int i = 0; i < aKeyPool; i++ )
+  {
+    Size[ i ] = 1 + random() % 20;
+    Data[ i ] = new char[ Size[ i ] ];
+    for( int b = 0; b < Size[ i ]; b++ )
+      Data[ i ][ b ] = 'a' + random() % 3;
+  }
+
+  for( int l = 0; l < aLoops; l++ )
+  {
+    int idx = random() % aKeyPool;
+    test_key_t Key = make_key( random() % 3, Data[ idx ], Size[ idx ] );
+
+    switch( random() % 4 )
+    {
+      case 0:
+      case 1:
+      {
+        bool a = tree.insert( Key ).second;
+        bool b = ref.insert( Key ).second;
+        if( a != b ) rc++;
+        break;
+      }
+      case 2:
+      {
+        if( tree.erase( Key ) != ref.erase( Key ) ) rc++;
+        break;
+      }
+      case 3:
+      {
+        test_btree_t::iterator t = tree.find( Key );
+        test_stlset_t::iterator s = ref.find( Key );
+        if( ( t == tree.end() ) != ( s == ref.end() ) ) rc++;
+        else if( t != tree.end() && !same_key( *t, *s ) ) rc++;
+
+        t = tree.lower_bound( Key );
+        s = ref.lower_bound( Key );
+        if( ( t == tree.end() ) != ( s == ref.end() ) ) rc++;
+        else if( t != tree.end() && !same_key( *t, *s ) ) rc++;
+
+        // cursor start: first record of a PDS
+        test_key_t Magic;
+        Magic.MakeMagicKey( &Key.mPDSId );
+        t = tree.lower_bound( Magic );
+        s = ref.lower_bound( Magic );
+        if( ( t == tree.end() ) != ( s == ref.end() ) ) rc++;
+        else if( t != tree.end() && !same_key( *t, *s ) ) rc++;
+        break;
+      }
+    }
+  }
+
+  if( tree.size() != ref.size() ) rc++;
+
+  test_btree_t::iterator t = tree.begin();
+  for( test_stlset_t::iterator s = ref.begin(); s != ref.end(); s++, t++ )
+  {
+    if( t == tree.end() || !same_key( *t, *s ) )
+    {
+      rc++;
+      break;
+    }
+  }
+
+  // drain completely to exercise node removal
+  for( int i = 0; i < aKeyPool; i++ )
+    for( int p = 0; p < 3; p++ )
+    {
+      test_key_t Key = make_key( p, Data[ i ], Size[ i ] );
+      if( tree.erase( Key ) != ref.erase( Key ) ) rc++;
+    }
+  if( tree.size() != 0 || tree.begin() != tree.end() ) rc++;
+
+  for( int i = 0; i < aKeyPool; i++ )
+    delete [] Data[ i ];
+
+  return rc;
+}
+
+// sorted runs with duplicates, inserted with hints into a partially filled tree
+int sorted_run_test( int aRuns, int aRunLength )
+{
+  int rc = 0;
+  test_btree_t tree;
+  test_stlset_t ref;
+
+  const int KeySize = 8;
+  vector<char*> Data;
+
+  for( int r = 0; r < aRuns; r++ )
+  {
+    vector<test_key_t> Run;
+    for( int i = 0; i < aRunLength; i++ )
+    {
+      char* d = new char[ KeySize ];
+      for( int b = 0; b < KeySize; b++ )
+        d[ b ] = 'a' + random() % 4;
+      Data.push_back( d );
+      Run.push_back( make_key( 1, d, KeySize ) );
+    }
+    sort( Run.begin(), Run.end() );
+
+    // same pattern as the server: plain insert of the first row, then hint at the successor
+    test_btree_t::iterator Hint = tree.insert( Run[ 0 ] ).first;
+    bool b = ref.insert( Run[ 0 ] ).second;
+    (void)b;
+    ++Hint;
+    for( int i = 1; i < aRunLength; i++ )
+    {
+      size_t before = tree.size();
+      Hint = tree.insert( Hint, Run[ i ] );
+      bool a = ( tree.size() != before );
+      if( !equal_key( *Hint, Run[ i ] ) ) rc++;
+      if( a != ref.insert( Run[ i ] ).second ) rc++;
+      ++Hint;
+    }
+  }
+
+  if( tree.size() != ref.size() ) rc++;
+
+  test_btree_t::iterator t = tree.begin();
+  for( test_stlset_t::iterator s = ref.begin(); s != ref.end(); s++, t++ )
+  {
+    if( t == tree.end() || !same_key( *t, *s ) )
+    {
+      rc++;
+      break;
+    }
+  }
+
+  for( size_t i = 0; i < Data.size(); i++ )
+  {
+    test_key_t Key = make_key( 1, Data[ i ], KeySize );
+    if( tree.erase( Key ) != ref.erase( Key ) ) rc++;
+  }
+  if( tree.size() != 0 || tree.begin() != tree.end() ) rc++;
+
+  for( size_t i = 0; i < Data.size(); i++ )
+    delete [] Data[ i ];
+
+  return rc;
+}
+
+template< class ContainerT >
+int benchmark( const char* aName, int aCount, char* aKeys, int* aOrder )
+{
+  const int KeySize = 16;
+  ContainerT* c = new ContainerT();
+
+  uint64_t start = PkTimeGetNanos();
+  for( int i = 0; i < aCount; i++ )
+    c->insert( make_key( 1, &aKeys[ (size_t)aOrder[ i ] * KeySize ], KeySize ) );
+  uint64_t inserted = PkTimeGetNanos();
+
+  int found = 0;
+  for( int i = aCount - 1; i >= 0; i-- )
+    found += ( c->find( make_key( 1, &aKeys[ (size_t)aOrder[ i ] * KeySize ], KeySize ) ) != c->end() );
+  uint64_t looked_up = PkTimeGetNanos();
+
+  cout << aName << ": records=" << c->size()
+       << " insert=" << (uint64_t)( aCount * 1e9 / ( inserted - start ) ) << " ops/s"
+       << " lookup=" << (uint64_t)( aCount * 1e9 / ( looked_up - inserted ) ) << " ops/s"
+       << endl;
+
+  delete c;
+  return ( found == aCount ) ? 0 : 1;
+}
+
+// sorted input, hinted append like a sorted bulk insert
+template< class ContainerT >
+int benchmark_sorted( const char* aName, int aCount, char* aKeys )
+{
+  const int KeySize = 16;
+  vector<test_key_t> Sorted;
+  for( int i = 0; i < aCount; i++ )
+    Sorted.push_back( make_key( 1, &aKeys[ (size_t)i * KeySize ], KeySize ) );
+  sort( Sorted.begin(), Sorted.end() );
+
+  ContainerT* c = new ContainerT();
+
+  uint64_t start = PkTimeGetNanos();
+  typename ContainerT::iterator Hint = c->end();
+  for( int i = 0; i < aCount; i++ )
+  {
+    Hint = c->insert( Hint, Sorted[ i ] );
+    ++Hint;
+  }
+  uint64_t inserted = PkTimeGetNanos();
+
+  cout << aName << ": records=" << c->size()
+       << " sorted insert=" << (uint64_t)( aCount * 1e9 / ( inserted - start ) ) << " ops/s"
+       << endl;
+
+  int rc = ( c->size() == (size_t)aCount ) ? 0 : 1;
+  delete c;
+  return rc;
+}
+
+int main( int argc, char **argv )
+{
+  int rc = 0;
+
+  for( int pool = 10; pool <= 100000; pool *= 10 )
+  {
+    rc += function_test( 200000, pool );
+    cout << "Function_Test with key pool " << pool << " completed with rc=" << rc << " [" << (rc==0?"PASS":"FAIL") << "]" << endl;
+  }
+
+  for( int len = 1; len <= 10000; len *= 10 )
+  {
+    rc += sorted_run_test( 20, len );
+    cout << "Sorted_Run_Test with run length " << len << " completed with rc=" << rc << " [" << (rc==0?"PASS":"FAIL") << "]" << endl;
+  }
+
+  int count = 1000000;
+  if( argc > 1 )
+    count = atoi( argv[ 1 ] );
+
+  const int KeySize = 16;
+  char* Keys = new char[ (size_t)count * KeySize ];
+  int* Order = new int[ count ];
+  for( size_t i = 0; i < (size_t)count * KeySize; i++ )
+    Keys[ i ] = random();
+  for( int i = 0; i < count; i++ )
+    Order[ i ] = i;
+  for( int i = count - 1; i > 0; i-- )
+    swap( Order[ i ], Order[ random() % ( i + 1 ) ] );
+
+  rc += benchmark< test_stlset_t >( "std::set", count, Keys, Order );
+  rc += benchmark< test_btree_t >( "btree   ", count, Keys, Order );
+  rc += benchmark_sorted< test_stlset_t >( "std::set", count, Keys );
+  rc += benchmark_sorted< test_btree_t >( "btree   ", count, Keys );
+  cout << "Benchmark completed with rc=" << rc << " [" << (rc==0?"PASS":"FAIL") << "]" << endl;
+
+  delete [] Keys;
+  delete [] Order;
+  return rc;
+}
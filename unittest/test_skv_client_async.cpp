@@ -0,0 +1,147 @@
+/************************************************
+ * Copyright (c) IBM Corp. 2014
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * which accompanies this distribution, and is available at
+ * http://www.eclipse.org/legal/epl-v10.html
+ *************************************************/
+
+/*
+ * test_skv_client_async.cpp
+ *
+ * checks continuation chaining (and coroutine resumption if built
+ * with C++20) of client futures without a server: the command
+ * completions are simulated by completing the future states
+ *
+ * built twice: test_skv_client_async with the project's default
+ * standard (callback interface only) and test_skv_client_async_coro
+ * with C++20 (SKV_TEST_CLIENT_COROUTINES, coroutine awaiters included)
+ */
+
+#ifndef SKV_CLIENT_UNI
+#define SKV_CLIENT_UNI
+#endif
+
+#ifndef SKV_NON_MPI
+#define SKV_NON_MPI
+#endif
+
+#include <iostream>
+#include <FxLogger.hpp>
+#include <skv/client/skv_client_async.hpp>
+
+#if defined( SKV_TEST_CLIENT_COROUTINES ) && !defined( SKV_CLIENT_COROUTINES )
+#error "test_skv_client_async_coro has to be built with C++20 coroutine support"
+#endif
+
+using namespace std;
+
+static skv_client_future_state_ptr_t
+new_state()
+{
+  return std::make_shared< skv_client_future_state_t >( (skv_client_t*) NULL );
+}
+
+int chain_test()
+{
+  int rc = 0;
+
+  skv_client_future_state_ptr_t Index = new_state();
+  skv_client_future_state_ptr_t Record = new_state();
+
+  skv_status_t Seen = SKV_ERRNO_NOT_DONE;
+  skv_status_t Final = SKV_ERRNO_NOT_DONE;
+
+  skv_client_future_t( Index )
+    .Then( [&]( skv_status_t aStatus ) { Seen = aStatus; return skv_client_future_t( Record ); } )
+    .OnComplete( [&]( skv_status_t aStatus ) { Final = aStatus; } );
+
+  if( Seen != SKV_ERRNO_NOT_DONE ) rc++;
+
+  Index->Complete( SKV_SUCCESS );
+  if(( Seen != SKV_SUCCESS ) || ( Final != SKV_ERRNO_NOT_DONE )) rc++;
+
+  Record->Complete( SKV_ERRNO_ELEM_NOT_FOUND );
+  if( Final != SKV_ERRNO_ELEM_NOT_FOUND ) rc++;
+
+  return rc;
+}
+
+int ready_test()
+{
+  int rc = 0;
+
+  // continuations of completed futures run right away
+  skv_status_t Final = SKV_ERRNO_NOT_DONE;
+  skv_client_future_t::Ready( SKV_ERRNO_KEY_TOO_LARGE )
+    .Then( []( skv_status_t aStatus ) { return skv_client_future_t(); } )
+    .OnComplete( [&]( skv_status_t aStatus ) { Final = aStatus; } );
+
+  if( Final != SKV_ERRNO_KEY_TOO_LARGE ) rc++;
+
+  return rc;
+}
+
+#ifdef SKV_CLIENT_COROUTINES
+static skv_client_task_t
+lookup( skv_client_future_state_ptr_t aIndex, skv_client_future_state_ptr_t aRecord, int *aStep )
+{
+  *aStep = 1;
+  skv_status_t status = co_await skv_client_future_t( aIndex );
+  *aStep = 2;
+  if( status == SKV_SUCCESS )
+    status = co_await skv_client_future_t( aRecord );
+  *aStep = 3;
+  co_return status;
+}
+
+static skv_client_task_t
+outer( skv_client_future_state_ptr_t aIndex, skv_client_future_state_ptr_t aRecord, int *aStep )
+{
+  skv_status_t status = co_await lookup( aIndex, aRecord, aStep );
+  co_return status;
+}
+
+int coroutine_test()
+{
+  int rc = 0;
+  int Step = 0;
+
+  skv_client_future_state_ptr_t Index = new_state();
+  skv_client_future_state_ptr_t Record = new_state();
+
+  skv_client_task_t Task = outer( Index, Record, &Step );
+  if(( Step != 1 ) || Task.IsDone() ) rc++;
+
+  Index->Complete( SKV_SUCCESS );
+  if(( Step != 2 ) || Task.IsDone() ) rc++;
+
+  Record->Complete( SKV_SUCCESS );
+  if(( Step != 3 ) || !Task.IsDone() || ( Task.GetStatus() != SKV_SUCCESS )) rc++;
+
+  // completed before awaiting: no suspension
+  Step = 0;
+  skv_client_task_t Task2 = lookup( skv_client_future_t::Ready( SKV_ERRNO_ELEM_NOT_FOUND ).GetState(), Record, &Step );
+  if(( Step != 3 ) || !Task2.IsDone() || ( Task2.GetStatus() != SKV_ERRNO_ELEM_NOT_FOUND )) rc++;
+
+  return rc;
+}
+#endif
+
+int main( int argc, char **argv )
+{
+  int rc = 0;
+
+  rc += chain_test();
+  cout << "Chain_Test completed with rc=" << rc << " [" << (rc==0?"PASS":"FAIL") << "]" << endl;
+
+  rc += ready_test();
+  cout << "Ready_Test completed with rc=" << rc << " [" << (rc==0?"PASS":"FAIL") << "]" << endl;
+
+#ifdef SKV_CLIENT_COROUTINES
+  rc += coroutine_test();
+  cout << "Coroutine_Test completed with rc=" << rc << " [" << (rc==0?"PASS":"FAIL") << "]" << endl;
+#endif
+
+  return rc;
+}
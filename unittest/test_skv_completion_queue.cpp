@@ -0,0 +1,100 @@
+/************************************************
+ * Copyright (c) IBM Corp. 2014
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * which accompanies this distribution, and is available at
+ * http://www.eclipse.org/legal/epl-v10.html
+ *************************************************/
+
+/*
+ * test_skv_completion_queue.cpp
+ *
+ * checks ordering and eventfd readiness of the client completion queue
+ */
+
+#ifndef SKV_CLIENT_UNI
+#define SKV_CLIENT_UNI
+#endif
+
+#ifndef SKV_NON_MPI
+#define SKV_NON_MPI
+#endif
+
+#include <iostream>
+#include <poll.h>
+#include <FxLogger.hpp>
+#include <skv/client/skv_client_completion_queue.hpp>
+
+using namespace std;
+
+#define TEST_ENTRY_COUNT ( 8 )
+
+static bool
+is_readable( int aFD )
+{
+  struct pollfd pfd;
+  pfd.fd = aFD;
+  pfd.events = POLLIN;
+  pfd.revents = 0;
+  return ( poll( &pfd, 1, 0 ) == 1 ) && ( pfd.revents & POLLIN );
+}
+
+int fifo_test( skv_client_completion_queue_t *aCQ )
+{
+  int rc = 0;
+  // the queue only stores pointers, any distinct addresses work
+  static char Entries[ TEST_ENTRY_COUNT ];
+
+  if( aCQ->Pop() != NULL ) rc++;
+  if( is_readable( aCQ->GetEventFD() ) ) rc++;
+
+  for( int i = 0; i < TEST_ENTRY_COUNT; i++ )
+    aCQ->Push( (skv_client_ccb_t*) &Entries[ i ] );
+
+  for( int i = 0; i < TEST_ENTRY_COUNT; i++ )
+  {
+    // stays readable until the last entry is taken
+    if( !is_readable( aCQ->GetEventFD() ) ) rc++;
+    if( aCQ->Pop() != (skv_client_ccb_t*) &Entries[ i ] ) rc++;
+  }
+
+  if( is_readable( aCQ->GetEventFD() ) ) rc++;
+  if( aCQ->Pop() != NULL ) rc++;
+
+  return rc;
+}
+
+int rearm_test( skv_client_completion_queue_t *aCQ )
+{
+  int rc = 0;
+  static char Entry;
+
+  // empty -> non-empty transitions signal again
+  for( int i = 0; i < 3; i++ )
+  {
+    aCQ->Push( (skv_client_ccb_t*) &Entry );
+    if( !is_readable( aCQ->GetEventFD() ) ) rc++;
+    if( aCQ->Pop() != (skv_client_ccb_t*) &Entry ) rc++;
+    if( is_readable( aCQ->GetEventFD() ) ) rc++;
+  }
+
+  return rc;
+}
+
+int main( int argc, char **argv )
+{
+  int rc = 0;
+
+  skv_client_completion_queue_t CQ;
+  if( CQ.Init() != SKV_SUCCESS ) return 1;
+
+  rc += fifo_test( &CQ );
+  cout << "FIFO_Test completed with rc=" << rc << " [" << (rc==0?"PASS":"FAIL") << "]" << endl;
+
+  rc += rearm_test( &CQ );
+  cout << "Rearm_Test completed with rc=" << rc << " [" << (rc==0?"PASS":"FAIL") << "]" << endl;
+
+  CQ.Finalize();
+
+  return rc;
+}
@@ -0,0 +1,167 @@
+/************************************************
+ * Copyright (c) IBM Corp. 2014
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * which accompanies this distribution, and is available at
+ * http://www.eclipse.org/legal/epl-v10.html
+ *************************************************/
+
+/*
+ * test_skv_crc32c.cpp
+ *
+ * checks the crc32c of the bulk insert buffers against the reference
+ * vector, compares the hardware and the table implementation on
+ * unaligned buffers and reports the throughput of both next to the
+ * byte-sum the bulk insert used before
+ *
+ * usage: test_skv_crc32c [ <buffer size in bytes> [ <rounds> ] ]
+ */
+
+#ifndef SKV_CLIENT_UNI
+#define SKV_CLIENT_UNI
+#endif
+
+#ifndef SKV_NON_MPI
+#define SKV_NON_MPI
+#endif
+
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <time.h>
+#include <FxLogger.hpp>
+#include "skv/common/skv_types.hpp"
+#include "skv/common/skv_crc32c.hpp"
+
+using namespace std;
+
+static uint64_t now_ns()
+{
+  struct timespec ts;
+  clock_gettime( CLOCK_MONOTONIC, &ts );
+  return (uint64_t) ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+// the checksum of SKV_BULK_LOAD_CHECKSUM before crc32c
+static uint32_t byte_sum( uint32_t aSum, const void* aData, size_t aLen )
+{
+  uint64_t sum = aSum;
+  const char* p = (const char*) aData;
+  for( size_t i = 0; i < aLen; i++ )
+    sum += p[ i ];
+  return (uint32_t) sum;
+}
+
+static int function_test()
+{
+  int rc = 0;
+
+  // check value of the crc32c catalog (iSCSI, RFC 3720)
+  const char* Check = "123456789";
+  if( skv_crc32c_sw( 0, Check, 9 ) != 0xE3069283 )
+  {
+    cout << "table crc of check string: 0x" << hex << skv_crc32c_sw( 0, Check, 9 ) << dec << endl;
+    rc++;
+  }
+  if( skv_crc32c( 0, Check, 9 ) != 0xE3069283 )
+  {
+    cout << "crc of check string: 0x" << hex << skv_crc32c( 0, Check, 9 ) << dec << endl;
+    rc++;
+  }
+
+  unsigned char Zeros[ 32 ] = { 0 };
+  if( skv_crc32c( 0, Zeros, 32 ) != 0x8A9136AA )
+  {
+    cout << "crc of 32 zero bytes: 0x" << hex << skv_crc32c( 0, Zeros, 32 ) << dec << endl;
+    rc++;
+  }
+
+  size_t BufferSize = 64 * 1024;
+  unsigned char* Buffer = new unsigned char[ BufferSize ];
+  srand( 42 );
+  for( size_t i = 0; i < BufferSize; i++ )
+    Buffer[ i ] = rand() & 0xff;
+
+  // unaligned starts and odd lengths hit the head/tail byte loops
+  for( int i = 0; i < 10000 && rc == 0; i++ )
+  {
+    size_t Offset = rand() % 64;
+    size_t Len = rand() % ( BufferSize - Offset );
+    uint32_t sw = skv_crc32c_sw( 0, &Buffer[ Offset ], Len );
+    uint32_t hw = skv_crc32c_hw( 0, &Buffer[ Offset ], Len );
+    if( sw != hw )
+    {
+      cout << "hw/sw mismatch: offset=" << Offset << " len=" << Len << endl;
+      rc++;
+    }
+
+    // chunked like the server side of a streamed bulk insert
+    size_t Split = Len ? rand() % Len : 0;
+    uint32_t chunked = skv_crc32c( skv_crc32c( 0, &Buffer[ Offset ], Split ),
+                                   &Buffer[ Offset + Split ], Len - Split );
+    if( chunked != sw )
+    {
+      cout << "streamed crc mismatch: offset=" << Offset << " len=" << Len << " split=" << Split << endl;
+      rc++;
+    }
+  }
+
+  // a single flipped bit has to show up
+  uint32_t Before = skv_crc32c( 0, Buffer, BufferSize );
+  Buffer[ BufferSize / 2 ] ^= 0x10;
+  if( skv_crc32c( 0, Buffer, BufferSize ) == Before )
+  {
+    cout << "bit flip not detected" << endl;
+    rc++;
+  }
+
+  delete [] Buffer;
+  return rc;
+}
+
+typedef uint32_t (*checksum_fn_t)( uint32_t, const void*, size_t );
+
+static int benchmark( const char* aName, checksum_fn_t aFn, size_t aSize, int aRounds )
+{
+  unsigned char* Buffer = new unsigned char[ aSize ];
+  for( size_t i = 0; i < aSize; i++ )
+    Buffer[ i ] = i * 7;
+
+  uint32_t crc = 0;
+  uint64_t start = now_ns();
+  for( int r = 0; r < aRounds; r++ )
+    crc = aFn( crc, Buffer, aSize );
+  uint64_t end = now_ns();
+
+  cout << aName << ": " << (uint64_t)( (double)aSize * aRounds / ( end - start ) * 1e3 ) << " MB/s"
+       << " (crc=0x" << hex << crc << dec << ")"
+       << endl;
+
+  delete [] Buffer;
+  return 0;
+}
+
+int main( int argc, char **argv )
+{
+  int rc = 0;
+
+  cout << "crc32c instructions available: " << ( skv_crc32c_hw_available() ? "yes" : "no" ) << endl;
+
+  rc += function_test();
+  cout << "Function_Test completed with rc=" << rc << " [" << (rc==0?"PASS":"FAIL") << "]" << endl;
+
+  size_t size = 1024 * 1024;
+  int rounds = 256;
+  if( argc > 1 )
+    size = atoll( argv[ 1 ] );
+  if( argc > 2 )
+    rounds = atoi( argv[ 2 ] );
+
+  rc += benchmark( "byte sum     ", byte_sum, size, rounds );
+  rc += benchmark( "crc32c table ", skv_crc32c_sw, size, rounds );
+  if( skv_crc32c_hw_available() )
+    rc += benchmark( "crc32c hw    ", skv_crc32c_hw, size, rounds );
+
+  cout << "Benchmark completed with rc=" << rc << " [" << (rc==0?"PASS":"FAIL") << "]" << endl;
+  return rc;
+}
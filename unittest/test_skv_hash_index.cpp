@@ -0,0 +1,150 @@
+/************************************************
+ * Copyright (c) IBM Corp. 2014
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * which accompanies this distribution, and is available at
+ * http://www.eclipse.org/legal/epl-v10.html
+ *************************************************/
+
+/*
+ * test_skv_hash_index.cpp
+ *
+ * checks the per-PDS hash index against std::map and reports
+ * lookup throughput
+ *
+ * usage: test_skv_hash_index [ <record count for benchmark> ]
+ */
+
+#ifndef SKV_CLIENT_UNI
+#define SKV_CLIENT_UNI
+#endif
+
+#ifndef SKV_NON_MPI
+#define SKV_NON_MPI
+#endif
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+#include <FxLogger.hpp>
+#include "skv/server/skv_server_hash_index.hpp"
+
+using namespace std;
+
+// random mix of insert/remove/lookup checked against std::map
+// records are { key, value } like in the server storage
+int function_test( int aLoops, int aKeyPool )
+{
+  int rc = 0;
+  skv_hash_index_t index;
+  map<string, char*> ref;
+
+  vector<char*> Records( aKeyPool );
+  vector<int> Size( aKeyPool );
+  for( int i = 0; i < aKeyPool; i++ )
+  {
+    Size[ i ] = 1 + random() % 20;
+    Records[ i ] = new char[ Size[ i ] + sizeof(int) ];
+    for( int b = 0; b < Size[ i ]; b++ )
+      Records[ i ][ b ] = 'a' + random() % 3;
+    memcpy( &Records[ i ][ Size[ i ] ], &i, sizeof(int) );
+  }
+
+  for( int l = 0; l < aLoops; l++ )
+  {
+    int idx = random() % aKeyPool;
+    string Key( Records[ idx ], Size[ idx ] );
+
+    switch( random() % 3 )
+    {
+      case 0:
+      {
+        if( ref.find( Key ) == ref.end() )
+        {
+          ref[ Key ] = Records[ idx ];
+          index.Insert( Records[ idx ], Size[ idx ], sizeof(int) );
+        }
+        break;
+      }
+      case 1:
+      {
+        if( index.Remove( Records[ idx ], Size[ idx ] ) != (int)ref.erase( Key ) ) rc++;
+        break;
+      }
+      case 2:
+      {
+        const skv_hash_index_entry_t* Entry = index.Lookup( Records[ idx ], Size[ idx ] );
+        map<string, char*>::iterator it = ref.find( Key );
+        if( ( Entry == NULL ) != ( it == ref.end() ) ) rc++;
+        else if( Entry != NULL &&
+                 ( Entry->mRecord != it->second ||
+                   Entry->mKeySize != Size[ idx ] ||
+                   Entry->mValueSize != sizeof(int) ) ) rc++;
+        break;
+      }
+    }
+  }
+
+  if( index.GetCount() != ref.size() ) rc++;
+
+  for( map<string, char*>::iterator it = ref.begin(); it != ref.end(); it++ )
+    if( index.Lookup( it->first.data(), it->first.size() ) == NULL ) rc++;
+
+  // drain completely, every slot has to be reachable after the shifts
+  for( int i = 0; i < aKeyPool; i++ )
+    index.Remove( Records[ i ], Size[ i ] );
+  if( index.GetCount() != 0 ) rc++;
+
+  for( int i = 0; i < aKeyPool; i++ )
+    delete [] Records[ i ];
+
+  return rc;
+}
+
+int main( int argc, char **argv )
+{
+  int rc = 0;
+
+  for( int pool = 10; pool <= 100000; pool *= 10 )
+  {
+    rc += function_test( 200000, pool );
+    cout << "Function_Test with key pool " << pool << " completed with rc=" << rc << " [" << (rc==0?"PASS":"FAIL") << "]" << endl;
+  }
+
+  int count = 1000000;
+  if( argc > 1 )
+    count = atoi( argv[ 1 ] );
+
+  const int KeySize = 16;
+  char* Keys = new char[ (size_t)count * KeySize ];
+  for( size_t i = 0; i < (size_t)count * KeySize; i++ )
+    Keys[ i ] = random();
+
+  skv_hash_index_t* index = new skv_hash_index_t();
+
+  uint64_t start = PkTimeGetNanos();
+  for( int i = 0; i < count; i++ )
+    index->Insert( &Keys[ (size_t)i * KeySize ], KeySize, 0 );
+  uint64_t inserted = PkTimeGetNanos();
+
+  int found = 0;
+  for( int i = count - 1; i >= 0; i-- )
+    found += ( index->Lookup( &Keys[ (size_t)i * KeySize ], KeySize ) != NULL );
+  uint64_t looked_up = PkTimeGetNanos();
+
+  cout << "hash index: records=" << index->GetCount()
+       << " insert=" << (uint64_t)( count * 1e9 / ( inserted - start ) ) << " ops/s"
+       << " lookup=" << (uint64_t)( count * 1e9 / ( looked_up - inserted ) ) << " ops/s"
+       << endl;
+
+  rc += ( found == count ) ? 0 : 1;
+  cout << "Benchmark completed with rc=" << rc << " [" << (rc==0?"PASS":"FAIL") << "]" << endl;
+
+  delete index;
+  delete [] Keys;
+  return rc;
+}
@@ -0,0 +1,233 @@
+/************************************************
+ * Copyright (c) IBM Corp. 2014
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * which accompanies this distribution, and is available at
+ * http://www.eclipse.org/legal/epl-v10.html
+ *************************************************/
+
+/*
+ * test_skv_lockfree_ring.cpp
+ *
+ * checks the SPSC/MPSC rings of the local-kv queues and compares
+ * throughput and hand-off latency against a mutex protected
+ * skv_array_queue_t (the previous queue implementation)
+ *
+ * usage: test_skv_lockfree_ring [ <items per producer> [ <producers> ] ]
+ */
+
+#ifndef SKV_CLIENT_UNI
+#define SKV_CLIENT_UNI
+#endif
+
+#ifndef SKV_NON_MPI
+#define SKV_NON_MPI
+#endif
+
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <algorithm>
+#include <thread>
+#include <sched.h>
+#include <vector>
+#include <FxLogger.hpp>
+#include "skv/common/skv_types.hpp"
+#include "skv/common/skv_mutex.hpp"
+#include "skv/common/skv_array_queue.hpp"
+#include "skv/common/skv_lockfree_ring.hpp"
+
+using namespace std;
+
+#define TEST_QUEUE_SIZE ( 1024 )
+
+struct test_item_t
+{
+  uint64_t mSeq;
+  uint64_t mProducer;
+  uint64_t mTimestamp;
+};
+
+// like the request queues, the items are handed over by pointer
+typedef test_item_t* test_item_ptr_t;
+
+// reference: the queue scheme the local kv used before the rings
+class test_mutex_queue_t
+{
+  skv_array_queue_t< test_item_ptr_t, TEST_QUEUE_SIZE > mQueue;
+  skv_mutex_t mLock;
+
+public:
+  bool push( const test_item_ptr_t& aItem )
+  {
+    mLock.lock();
+    bool ok = ( mQueue.size() < TEST_QUEUE_SIZE - 1 );
+    if( ok )
+      mQueue.push( aItem );
+    mLock.unlock();
+    return ok;
+  }
+  bool pop( test_item_ptr_t& aItem )
+  {
+    mLock.lock();
+    bool ok = ! mQueue.empty();
+    if( ok )
+    {
+      aItem = mQueue.front();
+      mQueue.pop();
+    }
+    mLock.unlock();
+    return ok;
+  }
+};
+
+class test_spsc_queue_t : public skv_spsc_ring_t< test_item_ptr_t >
+{
+public:
+  test_spsc_queue_t() : skv_spsc_ring_t< test_item_ptr_t >( TEST_QUEUE_SIZE ) {}
+};
+
+class test_mpsc_queue_t : public skv_mpsc_ring_t< test_item_ptr_t >
+{
+public:
+  test_mpsc_queue_t() : skv_mpsc_ring_t< test_item_ptr_t >( TEST_QUEUE_SIZE ) {}
+};
+
+// single threaded: wrap-around, full and empty conditions
+int function_test()
+{
+  int rc = 0;
+
+  skv_spsc_ring_t< int > spsc( 5 );
+  if( spsc.capacity() != 8 ) rc++;
+
+  skv_mpsc_ring_t< int > mpsc( 8 );
+  if( mpsc.capacity() != 8 ) rc++;
+
+  int v;
+  int next_in = 0;
+  int next_out = 0;
+  for( int round = 0; round < 100; round++ )
+  {
+    int n = 1 + round % 8;
+    for( int i = 0; i < n; i++ )
+    {
+      if( ! spsc.push( next_in ) ) rc++;
+      if( ! mpsc.push( next_in ) ) rc++;
+      next_in++;
+    }
+    if( n == 8 )
+    {
+      if( spsc.push( -1 ) ) rc++;
+      if( mpsc.push( -1 ) ) rc++;
+    }
+    if( spsc.size() != (size_t)n || mpsc.size() != (size_t)n ) rc++;
+
+    for( int i = 0; i < n; i++ )
+    {
+      if( spsc.front() == NULL || *spsc.front() != next_out ) rc++;
+      if( ! spsc.pop( v ) || v != next_out ) rc++;
+      if( mpsc.front() == NULL || *mpsc.front() != next_out ) rc++;
+      mpsc.pop();
+      next_out++;
+    }
+    if( spsc.pop( v ) || spsc.front() != NULL || ! spsc.empty() ) rc++;
+    if( mpsc.front() != NULL || ! mpsc.empty() ) rc++;
+  }
+
+  return rc;
+}
+
+template< class QueueT >
+void producer( QueueT* aQueue, test_item_t* aItems, uint64_t aProducer, uint64_t aCount )
+{
+  for( uint64_t i = 0; i < aCount; i++ )
+  {
+    test_item_t *Item = &aItems[ i ];
+    Item->mProducer = aProducer;
+    Item->mSeq = i;
+    Item->mTimestamp = PkTimeGetNanos();
+    while( ! aQueue->push( Item ) )
+      ::sched_yield();
+  }
+}
+
+/***
+ * runs aProducers threads against one consumer
+ * every producer's items have to arrive complete and in order
+ ***/
+template< class QueueT >
+int benchmark( const char* aName, int aProducers, uint64_t aCount )
+{
+  int rc = 0;
+  QueueT* Queue = new QueueT();
+  vector< uint64_t > Expected( aProducers, 0 );
+  vector< uint32_t > Latency;
+  Latency.reserve( aProducers * aCount );
+  test_item_t* Items = new test_item_t[ aProducers * aCount ];
+
+  uint64_t start = PkTimeGetNanos();
+
+  vector< thread* > Producers;
+  for( int p = 0; p < aProducers; p++ )
+    Producers.push_back( new thread( producer< QueueT >, Queue, &Items[ p * aCount ], (uint64_t)p, aCount ) );
+
+  test_item_t *Item;
+  for( uint64_t n = 0; n < aProducers * aCount; )
+  {
+    if( ! Queue->pop( Item ) )
+    {
+      ::sched_yield();
+      continue;
+    }
+    uint64_t Delay = PkTimeGetNanos() - Item->mTimestamp;
+    Latency.push_back( (uint32_t)std::min( Delay, (uint64_t)0xffffffff ) );
+    if( Item->mSeq != Expected[ Item->mProducer ] ) rc++;
+    Expected[ Item->mProducer ] = Item->mSeq + 1;
+    n++;
+  }
+
+  uint64_t end = PkTimeGetNanos();
+
+  for( int p = 0; p < aProducers; p++ )
+  {
+    Producers[ p ]->join();
+    delete Producers[ p ];
+  }
+
+  sort( Latency.begin(), Latency.end() );
+  size_t Total = Latency.size();
+  cout << aName << ": producers=" << aProducers
+       << " " << (uint64_t)( Total * 1e9 / ( end - start ) ) << " ops/s"
+       << " latency[ns] p50=" << Latency[ Total / 2 ]
+       << " p99=" << Latency[ Total * 99 / 100 ]
+       << " p99.9=" << Latency[ Total * 999 / 1000 ]
+       << endl;
+
+  delete [] Items;
+  delete Queue;
+  return rc;
+}
+
+int main( int argc, char **argv )
+{
+  int rc = 0;
+
+  rc += function_test();
+  cout << "Function_Test completed with rc=" << rc << " [" << (rc==0?"PASS":"FAIL") << "]" << endl;
+
+  uint64_t count = 1000000;
+  int producers = 4;
+  if( argc > 1 )
+    count = atoll( argv[ 1 ] );
+  if( argc > 2 )
+    producers = atoi( argv[ 2 ] );
+
+  rc += benchmark< test_mutex_queue_t >( "mutex+array_queue", 1, count );
+  rc += benchmark< test_spsc_queue_t > ( "spsc ring        ", 1, count );
+  rc += benchmark< test_mutex_queue_t >( "mutex+array_queue", producers, count );
+  rc += benchmark< test_mpsc_queue_t > ( "mpsc ring        ", producers, count );
+
+  cout << "Benchmark completed with rc=" << rc << " [" << (rc==0?"PASS":"FAIL") << "]" << endl;
+  return rc;
+}
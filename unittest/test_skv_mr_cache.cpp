@@ -0,0 +1,158 @@
+/************************************************
+ * Copyright (c) IBM Corp. 2014
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * which accompanies this distribution, and is available at
+ * http://www.eclipse.org/legal/epl-v10.html
+ *************************************************/
+
+/*
+ * test_skv_mr_cache.cpp
+ *
+ * checks hit/miss/eviction/invalidation behavior of the client
+ * memory registration cache
+ */
+
+#ifndef SKV_CLIENT_UNI
+#define SKV_CLIENT_UNI
+#endif
+
+#ifndef SKV_NON_MPI
+#define SKV_NON_MPI
+#endif
+
+#include <iostream>
+#include <FxLogger.hpp>
+#include <skv/common/skv_types.hpp>
+#include <skv/client/skv_client_mr_cache.hpp>
+
+using namespace std;
+
+#define TEST_BUFFER_SIZE ( 1024 * 1024 )
+#define TEST_VALUE_SIZE ( 64 * 1024 )
+
+static char Buffer[ TEST_BUFFER_SIZE ];
+
+// without a cache limit, every request gets its own registration
+int uncached_test( it_pz_handle_t aPZ )
+{
+  int rc = 0;
+  skv_client_mr_cache_t Cache;
+  Cache.Init( aPZ, 0 );
+
+  it_lmr_handle_t lmr[ 2 ];
+  it_rmr_context_t rmr;
+  for( int i = 0; i < 2; i++ )
+    if( Cache.Acquire( Buffer, TEST_VALUE_SIZE, (it_ep_handle_t)IT_NULL_HANDLE, &lmr[ i ], &rmr ) != IT_SUCCESS ) rc++;
+
+  if( lmr[ 0 ] == lmr[ 1 ] ) rc++;
+  if( Cache.GetHits() != 0 ) rc++;
+
+  for( int i = 0; i < 2; i++ )
+    if( Cache.Release( lmr[ i ] ) != IT_SUCCESS ) rc++;
+
+  Cache.Finalize();
+  return rc;
+}
+
+int cached_test( it_pz_handle_t aPZ )
+{
+  int rc = 0;
+  skv_client_mr_cache_t Cache;
+  Cache.Init( aPZ, 4 * TEST_VALUE_SIZE );
+
+  it_lmr_handle_t lmr, lmr2;
+  it_rmr_context_t rmr;
+
+  // repeated use of the same buffer and of a sub-range hits
+  if( Cache.Acquire( Buffer, TEST_VALUE_SIZE, (it_ep_handle_t)IT_NULL_HANDLE, &lmr, &rmr ) != IT_SUCCESS ) rc++;
+  Cache.Release( lmr );
+  if( Cache.Acquire( Buffer, TEST_VALUE_SIZE, (it_ep_handle_t)IT_NULL_HANDLE, &lmr2, &rmr ) != IT_SUCCESS ) rc++;
+  if( lmr2 != lmr ) rc++;
+  Cache.Release( lmr2 );
+  if( Cache.Acquire( &Buffer[ 100 ], 1000, (it_ep_handle_t)IT_NULL_HANDLE, &lmr2, &rmr ) != IT_SUCCESS ) rc++;
+  if( lmr2 != lmr ) rc++;
+  Cache.Release( lmr2 );
+  if(( Cache.GetHits() != 2 ) || ( Cache.GetMisses() != 1 )) rc++;
+
+  // partial overlap misses
+  if( Cache.Acquire( &Buffer[ 100 ], TEST_VALUE_SIZE, (it_ep_handle_t)IT_NULL_HANDLE, &lmr2, &rmr ) != IT_SUCCESS ) rc++;
+  if( lmr2 == lmr ) rc++;
+  Cache.Release( lmr2 );
+
+  // walking through the buffer evicts the least recently used entries
+  it_lmr_handle_t busy;
+  if( Cache.Acquire( &Buffer[ TEST_BUFFER_SIZE - TEST_VALUE_SIZE ], TEST_VALUE_SIZE, (it_ep_handle_t)IT_NULL_HANDLE, &busy, &rmr ) != IT_SUCCESS ) rc++;
+  for( int i = 1; i < 8; i++ )
+  {
+    if( Cache.Acquire( &Buffer[ i * TEST_VALUE_SIZE ], TEST_VALUE_SIZE, (it_ep_handle_t)IT_NULL_HANDLE, &lmr2, &rmr ) != IT_SUCCESS ) rc++;
+    Cache.Release( lmr2 );
+  }
+  if( Cache.GetEvictions() < 4 ) rc++;
+
+  // the entry in use survives eviction and deregistration until it's released
+  uint64_t Hits = Cache.GetHits();
+  if( Cache.Acquire( &Buffer[ TEST_BUFFER_SIZE - TEST_VALUE_SIZE ], 16, (it_ep_handle_t)IT_NULL_HANDLE, &lmr2, &rmr ) != IT_SUCCESS ) rc++;
+  if(( lmr2 != busy ) || ( Cache.GetHits() != Hits + 1 )) rc++;
+  Cache.Release( lmr2 );
+
+  if( Cache.Deregister( &Buffer[ TEST_BUFFER_SIZE - 1 ], 1 ) != SKV_SUCCESS ) rc++;
+  if( Cache.Acquire( &Buffer[ TEST_BUFFER_SIZE - TEST_VALUE_SIZE ], 16, (it_ep_handle_t)IT_NULL_HANDLE, &lmr2, &rmr ) != IT_SUCCESS ) rc++;
+  if( lmr2 == busy ) rc++;
+  Cache.Release( lmr2 );
+  if( Cache.Release( busy ) != IT_SUCCESS ) rc++;
+
+  Cache.Finalize();
+  return rc;
+}
+
+int pinned_test( it_pz_handle_t aPZ )
+{
+  int rc = 0;
+  skv_client_mr_cache_t Cache;
+  Cache.Init( aPZ, 0 );
+
+  if( Cache.Register( Buffer, TEST_BUFFER_SIZE ) != SKV_SUCCESS ) rc++;
+
+  it_lmr_handle_t lmr, lmr2;
+  it_rmr_context_t rmr;
+  for( int i = 0; i < TEST_BUFFER_SIZE / TEST_VALUE_SIZE; i++ )
+  {
+    if( Cache.Acquire( &Buffer[ i * TEST_VALUE_SIZE ], TEST_VALUE_SIZE, (it_ep_handle_t)IT_NULL_HANDLE, &lmr2, &rmr ) != IT_SUCCESS ) rc++;
+    if( i == 0 )
+      lmr = lmr2;
+    else if( lmr2 != lmr ) rc++;
+    Cache.Release( lmr2 );
+  }
+  if(( Cache.GetMisses() != 0 ) || ( Cache.GetEvictions() != 0 )) rc++;
+
+  if( Cache.Deregister( Buffer, TEST_BUFFER_SIZE ) != SKV_SUCCESS ) rc++;
+  if( Cache.Deregister( Buffer, TEST_BUFFER_SIZE ) != SKV_ERRNO_ELEM_NOT_FOUND ) rc++;
+
+  Cache.Finalize();
+  return rc;
+}
+
+int main( int argc, char **argv )
+{
+  int rc = 0;
+
+  it_ia_handle_t IA_Hdl;
+  it_pz_handle_t PZ_Hdl;
+  if( it_ia_create( "vp_softrdma", 2, 0, &IA_Hdl ) != IT_SUCCESS ) return 1;
+  if( it_pz_create( IA_Hdl, &PZ_Hdl ) != IT_SUCCESS ) return 1;
+
+  rc += uncached_test( PZ_Hdl );
+  cout << "Uncached_Test completed with rc=" << rc << " [" << (rc==0?"PASS":"FAIL") << "]" << endl;
+
+  rc += cached_test( PZ_Hdl );
+  cout << "Cached_Test completed with rc=" << rc << " [" << (rc==0?"PASS":"FAIL") << "]" << endl;
+
+  rc += pinned_test( PZ_Hdl );
+  cout << "Pinned_Test completed with rc=" << rc << " [" << (rc==0?"PASS":"FAIL") << "]" << endl;
+
+  it_pz_free( PZ_Hdl );
+  it_ia_free( IA_Hdl );
+
+  return rc;
+}
@@ -0,0 +1,186 @@
+/************************************************
+ * Copyright (c) IBM Corp. 2014
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * which accompanies this distribution, and is available at
+ * http://www.eclipse.org/legal/epl-v10.html
+ *************************************************/
+
+/*
+ * test_skv_multi_key.cpp
+ *
+ * checks the row and result layout of the multi-key command buffers
+ */
+
+#ifndef SKV_CLIENT_UNI
+#define SKV_CLIENT_UNI
+#endif
+
+#ifndef SKV_NON_MPI
+#define SKV_NON_MPI
+#endif
+
+#include <iostream>
+#include <stdio.h>
+#include <string.h>
+#include <FxLogger.hpp>
+#include <skv/common/skv_types.hpp>
+
+using namespace std;
+
+#define TEST_KEY_COUNT ( 16 )
+#define TEST_BUFFER_SIZE ( 64 * 1024 )
+
+static char Buffer[ TEST_BUFFER_SIZE ];
+
+// retrieve rows carry the max value size but no value
+int retrieve_rows_test()
+{
+  int rc = 0;
+  char KeyBuf[ 32 ];
+  int Offset = 0;
+
+  for( int i = 0; i < TEST_KEY_COUNT; i++ )
+  {
+    int KeyLen = snprintf( KeyBuf, sizeof( KeyBuf ), "key_%d", i * 1000 );
+    Offset += skv_multi_key_pack_retrieve( &Buffer[ Offset ], KeyBuf, KeyLen, 100 + i );
+  }
+
+  int Pos = 0;
+  for( int i = 0; i < TEST_KEY_COUNT; i++ )
+  {
+    char *Key, *Value;
+    int KeyLen, ValueLen;
+    int KeyExpLen = snprintf( KeyBuf, sizeof( KeyBuf ), "key_%d", i * 1000 );
+
+    Pos += skv_multi_key_get_row( &Buffer[ Pos ], SKV_COMMAND_RETRIEVE, &Key, KeyLen, &Value, ValueLen );
+    if(( KeyLen != KeyExpLen ) || ( memcmp( Key, KeyBuf, KeyLen ) != 0 )) rc++;
+    if(( Value != NULL ) || ( ValueLen != 100 + i )) rc++;
+  }
+  if( Pos != Offset ) rc++;
+
+  return rc;
+}
+
+// insert rows share the bulk insert row format
+int insert_rows_test()
+{
+  int rc = 0;
+  char KeyBuf[ 32 ];
+  char ValueBuf[ 256 ];
+  int Offset = 0;
+
+  for( int i = 0; i < TEST_KEY_COUNT; i++ )
+  {
+    int KeyLen = snprintf( KeyBuf, sizeof( KeyBuf ), "key_%d", i );
+    memset( ValueBuf, 'a' + i, i * 10 );
+    Offset += skv_bulk_insert_pack( &Buffer[ Offset ], KeyBuf, KeyLen, ValueBuf, i * 10 );
+  }
+
+  int Pos = 0;
+  for( int i = 0; i < TEST_KEY_COUNT; i++ )
+  {
+    char *Key, *Value;
+    int KeyLen, ValueLen;
+    int KeyExpLen = snprintf( KeyBuf, sizeof( KeyBuf ), "key_%d", i );
+
+    Pos += skv_multi_key_get_row( &Buffer[ Pos ], SKV_COMMAND_INSERT, &Key, KeyLen, &Value, ValueLen );
+    if(( KeyLen != KeyExpLen ) || ( memcmp( Key, KeyBuf, KeyLen ) != 0 )) rc++;
+    if(( Value == NULL ) || ( ValueLen != i * 10 )) rc++;
+    else
+      for( int n = 0; n < ValueLen; n++ )
+        if( Value[ n ] != 'a' + i ) { rc++; break; }
+  }
+  if( Pos != Offset ) rc++;
+
+  return rc;
+}
+
+int result_test()
+{
+  int rc = 0;
+
+  if( skv_multi_key_result_size( SKV_COMMAND_INSERT, TEST_KEY_COUNT, 1000 ) != TEST_KEY_COUNT * (int)sizeof( skv_multi_key_result_t ) ) rc++;
+  if( skv_multi_key_result_size( SKV_COMMAND_RETRIEVE, TEST_KEY_COUNT, 1000 ) != TEST_KEY_COUNT * (int)sizeof( skv_multi_key_result_t ) + 1000 ) rc++;
+
+  // results go over the wire in network byte order
+  skv_multi_key_result_t Result;
+  Result.mStatus = SKV_ERRNO_ELEM_NOT_FOUND;
+  Result.mValueSize = 12345;
+  Result.EndianConvert();
+  Result.EndianConvert();
+  if(( Result.mStatus != SKV_ERRNO_ELEM_NOT_FOUND ) || ( Result.mValueSize != 12345 )) rc++;
+
+  return rc;
+}
+
+// the server rejects rows that don't fit the transferred sizes
+int check_rows_test()
+{
+  int rc = 0;
+  char KeyBuf[ 32 ];
+  int Offset = 0;
+  int ValueSpace = 0;
+
+  for( int i = 0; i < TEST_KEY_COUNT; i++ )
+  {
+    int KeyLen = snprintf( KeyBuf, sizeof( KeyBuf ), "key_%d", i );
+    Offset += skv_multi_key_pack_retrieve( &Buffer[ Offset ], KeyBuf, KeyLen, 100 );
+    ValueSpace += 100;
+  }
+  int ResultSize = skv_multi_key_result_size( SKV_COMMAND_RETRIEVE, TEST_KEY_COUNT, ValueSpace );
+
+  if( skv_multi_key_check_rows( Buffer, Offset, ResultSize, SKV_COMMAND_RETRIEVE, TEST_KEY_COUNT ) != SKV_SUCCESS ) rc++;
+  // value space doesn't fit
+  if( skv_multi_key_check_rows( Buffer, Offset, ResultSize - 1, SKV_COMMAND_RETRIEVE, TEST_KEY_COUNT ) == SKV_SUCCESS ) rc++;
+  // rows beyond the request size
+  if( skv_multi_key_check_rows( Buffer, Offset - 1, ResultSize, SKV_COMMAND_RETRIEVE, TEST_KEY_COUNT ) == SKV_SUCCESS ) rc++;
+  if( skv_multi_key_check_rows( Buffer, Offset, ResultSize * 2, SKV_COMMAND_RETRIEVE, TEST_KEY_COUNT * 2 ) == SKV_SUCCESS ) rc++;
+
+  // oversized key in the first row
+  int *KeyLenPtr = (int *) Buffer;
+  int KeyLen = ntohl( *KeyLenPtr );
+  *KeyLenPtr = htonl( SKV_KEY_LIMIT + 1 );
+  if( skv_multi_key_check_rows( Buffer, TEST_BUFFER_SIZE, ResultSize, SKV_COMMAND_RETRIEVE, TEST_KEY_COUNT ) != SKV_ERRNO_KEY_TOO_LARGE ) rc++;
+  *KeyLenPtr = htonl( -1 );
+  if( skv_multi_key_check_rows( Buffer, TEST_BUFFER_SIZE, ResultSize, SKV_COMMAND_RETRIEVE, TEST_KEY_COUNT ) != SKV_ERRNO_KEY_TOO_LARGE ) rc++;
+  *KeyLenPtr = htonl( KeyLen );
+
+  // insert values have to be within the request
+  char ValueBuf[ 64 ];
+  memset( ValueBuf, 'x', sizeof( ValueBuf ) );
+  Offset = skv_bulk_insert_pack( Buffer, KeyBuf, 4, ValueBuf, sizeof( ValueBuf ) );
+  ResultSize = skv_multi_key_result_size( SKV_COMMAND_INSERT, 1, 0 );
+  if( skv_multi_key_check_rows( Buffer, Offset, ResultSize, SKV_COMMAND_INSERT, 1 ) != SKV_SUCCESS ) rc++;
+  if( skv_multi_key_check_rows( Buffer, Offset - 1, ResultSize, SKV_COMMAND_INSERT, 1 ) == SKV_SUCCESS ) rc++;
+
+  // request header sizes: no wrap-around of the sum, no negative sizes
+  if( skv_multi_key_check_sizes( 1, 100, 100 ) != SKV_SUCCESS ) rc++;
+  if( skv_multi_key_check_sizes( 1, SKV_MULTI_KEY_TRANSFER_LIMIT / 2, SKV_MULTI_KEY_TRANSFER_LIMIT / 2 + 1 ) == SKV_SUCCESS ) rc++;
+  if( skv_multi_key_check_sizes( 1, 0x7fffffff, 0x7fffffff ) == SKV_SUCCESS ) rc++;
+  if( skv_multi_key_check_sizes( 1, -100, 200 ) == SKV_SUCCESS ) rc++;
+  if( skv_multi_key_check_sizes( 1, 100, -0x7fffffff ) == SKV_SUCCESS ) rc++;
+  if( skv_multi_key_check_sizes( 0, 100, 100 ) == SKV_SUCCESS ) rc++;
+  if( skv_multi_key_check_sizes( SKV_MULTI_KEY_LIMIT + 1, 100, 100 ) == SKV_SUCCESS ) rc++;
+
+  return rc;
+}
+
+int main( int argc, char **argv )
+{
+  int rc = 0;
+
+  rc += retrieve_rows_test();
+  cout << "Retrieve_Rows_Test completed with rc=" << rc << " [" << (rc==0?"PASS":"FAIL") << "]" << endl;
+
+  rc += insert_rows_test();
+  cout << "Insert_Rows_Test completed with rc=" << rc << " [" << (rc==0?"PASS":"FAIL") << "]" << endl;
+
+  rc += result_test();
+  cout << "Result_Test completed with rc=" << rc << " [" << (rc==0?"PASS":"FAIL") << "]" << endl;
+
+  rc += check_rows_test();
+  cout << "Check_Rows_Test completed with rc=" << rc << " [" << (rc==0?"PASS":"FAIL") << "]" << endl;
+
+  return rc;
+}
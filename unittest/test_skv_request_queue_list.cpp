@@ -0,0 +1,108 @@
+/************************************************
+ * Copyright (c) IBM Corp. 2014
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * which accompanies this distribution, and is available at
+ * http://www.eclipse.org/legal/epl-v10.html
+ *************************************************/
+
+/*
+ * test_skv_request_queue_list.cpp
+ *
+ * checks that the local-kv request dispatch steers requests away
+ * from a worker that doesn't make progress
+ */
+
+#ifndef SKV_CLIENT_UNI
+#define SKV_CLIENT_UNI
+#endif
+
+#ifndef SKV_NON_MPI
+#define SKV_NON_MPI
+#endif
+
+#include <iostream>
+#include <FxLogger.hpp>
+#include <skv/common/skv_types.hpp>
+#include <skv/common/skv_client_server_headers.hpp>
+#include <skv/client/skv_client_server_conn.hpp>
+#include <skv/common/skv_client_server_protocol.hpp>
+#include <skv/server/skv_server_types.hpp>
+#include <skv/server/skv_local_kv_request.hpp>
+#include <skv/server/skv_local_kv_request_queue.hpp>
+
+using namespace std;
+
+#define TEST_WORKERS ( 4 )
+#define TEST_QUEUE_LENGTH ( 1024 )
+
+/***
+ * worker 0 only processes every aSlowdown-th round, the others drain
+ * their queues every round
+ ***/
+int dispatch_test( int aRequests, int aSlowdown )
+{
+  int rc = 0;
+  skv_local_kv_request_queue_t *Queue[ TEST_WORKERS ];
+  skv_local_kv_request_queue_list_t List( TEST_WORKERS );
+
+  for( int w = 0; w < TEST_WORKERS; w++ )
+  {
+    Queue[ w ] = new skv_local_kv_request_queue_t( TEST_QUEUE_LENGTH );
+    Queue[ w ]->Init();
+    List.AddQueue( Queue[ w ] );
+  }
+
+  for( int n = 0; n < aRequests; n++ )
+  {
+    skv_local_kv_request_queue_t *Best = List.GetBestQueue();
+    skv_local_kv_request_t *Req = Best->AcquireRequestEntry();
+    if( Req == NULL )
+    {
+      rc++;
+      break;
+    }
+    Best->QueueRequest( Req );
+
+    for( int w = ( n % aSlowdown ) ? 1 : 0; w < TEST_WORKERS; w++ )
+    {
+      skv_local_kv_request_t *Next = Queue[ w ]->GetRequest();
+      if( Next )
+        Queue[ w ]->AckRequest( Next );
+    }
+  }
+
+  uint64_t Total = 0;
+  for( int w = 0; w < TEST_WORKERS; w++ )
+  {
+    Total += Queue[ w ]->GetDispatched();
+    cout << "  worker[ " << w << " ] dispatched: " << Queue[ w ]->GetDispatched()
+         << " inflight: " << Queue[ w ]->GetInFlight()
+         << " queued: " << Queue[ w ]->GetQueueDepth()
+         << endl;
+  }
+  if( Total != (uint64_t)aRequests ) rc++;
+
+  // the slow worker can't have received more than it was able to process (+1 in flight)
+  if( Queue[ 0 ]->GetDispatched() > (uint64_t)( aRequests / aSlowdown + 1 ) ) rc++;
+  if( Queue[ 0 ]->GetInFlight() > 1 ) rc++;
+
+  for( int w = 0; w < TEST_WORKERS; w++ )
+    delete Queue[ w ];
+
+  return rc;
+}
+
+int main( int argc, char **argv )
+{
+  int rc = 0;
+
+  int Slowdown[] = { 1, 10, 1000 };
+  for( int i = 0; i < 3; i++ )
+  {
+    rc += dispatch_test( 100000, Slowdown[ i ] );
+    cout << "Dispatch_Test with slowdown " << Slowdown[ i ] << " completed with rc=" << rc << " [" << (rc==0?"PASS":"FAIL") << "]" << endl;
+  }
+
+  return rc;
+}
@@ -0,0 +1,256 @@
+/************************************************
+ * Copyright (c) IBM Corp. 2014
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * which accompanies this distribution, and is available at
+ * http://www.eclipse.org/legal/epl-v10.html
+ *************************************************/
+
+/*
+ * test_skv_server_doorbell.cpp
+ *
+ * checks the wakeup protocol of the idle server main loop (no lost
+ * wakeups) and measures hand-off latency vs. cpu use of the consumer
+ * for different spin budgets (SKV_SERVER_POLL_SPIN) and request rates
+ *
+ * usage: test_skv_server_doorbell [ <requests per run> [ <max sleep usec> ] ]
+ */
+
+#ifndef SKV_CLIENT_UNI
+#define SKV_CLIENT_UNI
+#endif
+
+#ifndef SKV_NON_MPI
+#define SKV_NON_MPI
+#endif
+
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <algorithm>
+#include <thread>
+#include <vector>
+#include <poll.h>
+#include <time.h>
+#include <FxLogger.hpp>
+#include "skv/common/skv_types.hpp"
+#include "skv/common/skv_lockfree_ring.hpp"
+#include "skv/server/skv_server_doorbell.hpp"
+
+using namespace std;
+
+#define TEST_QUEUE_SIZE ( 1024 )
+
+static uint64_t thread_cpu_ns()
+{
+  struct timespec ts;
+  clock_gettime( CLOCK_THREAD_CPUTIME_ID, &ts );
+  return (uint64_t) ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+static bool readable( int aFd )
+{
+  struct pollfd pfd = { aFd, POLLIN, 0 };
+  return poll( &pfd, 1, 0 ) > 0;
+}
+
+struct test_result_t
+{
+  vector< uint32_t > mLatency;
+  uint64_t mCpu;
+  uint64_t mWall;
+  uint64_t mSleeps;
+  uint64_t mTimeouts;
+};
+
+/***
+ * the main loop of a reactor reduced to one event source:
+ * spin for aSpin empty rounds, announce the wait, poll once more
+ * and sleep for up to aMaxSleep usec if that round is empty too
+ ***/
+static void consumer( skv_spsc_ring_t< uint64_t >* aQueue, skv_server_doorbell_t* aDoorbell,
+                      uint64_t aSpin, uint64_t aMaxSleep, uint64_t aCount, test_result_t* aResult )
+{
+  uint64_t IdleLoops = 0;
+  bool WaitPrepared = false;
+  uint64_t Received = 0;
+  uint64_t CpuStart = thread_cpu_ns();
+  uint64_t WallStart = PkTimeGetNanos();
+
+  while( Received < aCount )
+  {
+    uint64_t Timestamp;
+    int EventCount = 0;
+    while( aQueue->pop( Timestamp ) )
+    {
+      uint64_t Delay = PkTimeGetNanos() - Timestamp;
+      aResult->mLatency.push_back( (uint32_t)std::min( Delay, (uint64_t)0xffffffff ) );
+      EventCount++;
+    }
+    Received += EventCount;
+
+    if( EventCount > 0 )
+    {
+      IdleLoops = 0;
+      if( WaitPrepared )
+      {
+        aDoorbell->EndWait();
+        WaitPrepared = false;
+      }
+    }
+    else if( aMaxSleep > 0 )
+    {
+      if( WaitPrepared )
+      {
+        struct pollfd pfd = { aDoorbell->GetFd(), POLLIN, 0 };
+        struct timespec Timeout = { (time_t)( aMaxSleep / 1000000 ), (long)( aMaxSleep % 1000000 ) * 1000 };
+        if( ppoll( &pfd, 1, &Timeout, NULL ) > 0 )
+          aDoorbell->Drain();
+        else
+          aResult->mTimeouts++;
+        aDoorbell->EndWait();
+        aResult->mSleeps++;
+        WaitPrepared = false;
+        IdleLoops = 0;
+      }
+      else if( ++IdleLoops >= aSpin )
+      {
+        aDoorbell->PrepareWait();
+        WaitPrepared = true;
+      }
+    }
+  }
+  if( WaitPrepared )
+    aDoorbell->EndWait();
+
+  aResult->mCpu = thread_cpu_ns() - CpuStart;
+  aResult->mWall = PkTimeGetNanos() - WallStart;
+}
+
+// requests arrive every aGap nsec (like the command fetch thread or a local kv worker)
+static void producer( skv_spsc_ring_t< uint64_t >* aQueue, skv_server_doorbell_t* aDoorbell,
+                      uint64_t aGap, uint64_t aCount )
+{
+  uint64_t Next = PkTimeGetNanos();
+  for( uint64_t i = 0; i < aCount; i++ )
+  {
+    Next += aGap;
+    while( PkTimeGetNanos() < Next )
+    {
+      if( Next - PkTimeGetNanos() > 100000 )
+        usleep( 50 );
+    }
+    while( ! aQueue->push( PkTimeGetNanos() ) )
+      ::sched_yield();
+    aDoorbell->Ring();
+  }
+}
+
+static int run( uint64_t aSpin, uint64_t aMaxSleep, uint64_t aGap, uint64_t aCount, test_result_t* aResult )
+{
+  skv_spsc_ring_t< uint64_t > Queue( TEST_QUEUE_SIZE );
+  skv_server_doorbell_t Doorbell;
+  if( Doorbell.Init() != SKV_SUCCESS )
+    return 1;
+
+  aResult->mLatency.clear();
+  aResult->mLatency.reserve( aCount );
+  aResult->mSleeps = 0;
+  aResult->mTimeouts = 0;
+
+  thread Consumer( consumer, &Queue, &Doorbell, aSpin, aMaxSleep, aCount, aResult );
+  producer( &Queue, &Doorbell, aGap, aCount );
+  Consumer.join();
+
+  return ( aResult->mLatency.size() == aCount ) ? 0 : 1;
+}
+
+int function_test()
+{
+  int rc = 0;
+
+  skv_server_doorbell_t Doorbell;
+  if( Doorbell.Init() != SKV_SUCCESS )
+    return 1;
+
+  // nobody waits: ringing must not leave a wakeup behind
+  Doorbell.Ring();
+  if( readable( Doorbell.GetFd() ) ) rc++;
+
+  // a waiter gets exactly one wakeup per Drain()
+  Doorbell.PrepareWait();
+  Doorbell.Ring();
+  Doorbell.Ring();
+  if( ! readable( Doorbell.GetFd() ) ) rc++;
+  Doorbell.Drain();
+  if( readable( Doorbell.GetFd() ) ) rc++;
+  Doorbell.EndWait();
+
+  // lost wakeup check: the consumer sleeps for up to 1s, so every
+  // timeout with a producer that rings within ~100us is a lost wakeup
+  test_result_t Result;
+  for( uint64_t spin = 0; spin <= 16; spin += 4 )
+  {
+    if( run( spin, 1000000, 20000, 5000, &Result ) != 0 ) rc++;
+    if( Result.mTimeouts != 0 )
+    {
+      cout << "lost wakeups: " << Result.mTimeouts << " of " << Result.mSleeps << " sleeps (spin=" << spin << ")" << endl;
+      rc++;
+    }
+  }
+
+  return rc;
+}
+
+int benchmark( uint64_t aSpin, uint64_t aMaxSleep, uint64_t aGap, uint64_t aCount )
+{
+  test_result_t Result;
+  int rc = run( aSpin, aMaxSleep, aGap, aCount, &Result );
+
+  sort( Result.mLatency.begin(), Result.mLatency.end() );
+  size_t Total = Result.mLatency.size();
+  if( Total == 0 )
+    return rc + 1;
+
+  cout << "gap[us]=" << aGap / 1000;
+  if( aMaxSleep == 0 )
+    cout << " busy polling      ";
+  else
+    cout << " spin=" << aSpin << "\t";
+  cout << " cpu=" << (uint64_t)( 100.0 * Result.mCpu / Result.mWall ) << "%"
+       << " sleeps=" << Result.mSleeps
+       << " latency[ns] p50=" << Result.mLatency[ Total / 2 ]
+       << " p99=" << Result.mLatency[ Total * 99 / 100 ]
+       << " max=" << Result.mLatency[ Total - 1 ]
+       << endl;
+
+  return rc;
+}
+
+int main( int argc, char **argv )
+{
+  int rc = 0;
+
+  rc += function_test();
+  cout << "Function_Test completed with rc=" << rc << " [" << (rc==0?"PASS":"FAIL") << "]" << endl;
+
+  uint64_t count = 2000;
+  uint64_t max_sleep = 1000;
+  if( argc > 1 )
+    count = atoll( argv[ 1 ] );
+  if( argc > 2 )
+    max_sleep = atoll( argv[ 2 ] );
+
+  uint64_t gaps[] = { 10000, 100000, 1000000 };
+  uint64_t spins[] = { 0, 1024, 16384, 262144 };
+
+  for( size_t g = 0; g < sizeof( gaps ) / sizeof( gaps[ 0 ] ); g++ )
+  {
+    rc += benchmark( 0, 0, gaps[ g ], count );
+    for( size_t s = 0; s < sizeof( spins ) / sizeof( spins[ 0 ] ); s++ )
+      rc += benchmark( spins[ s ], max_sleep, gaps[ g ], count );
+  }
+
+  cout << "Benchmark completed with rc=" << rc << " [" << (rc==0?"PASS":"FAIL") << "]" << endl;
+  return rc;
+}